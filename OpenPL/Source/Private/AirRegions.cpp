@@ -0,0 +1,153 @@
+/*
+  ==============================================================================
+  
+    AirRegions.cpp
+    Created: 18 Oct 2026 3:20:15pm
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#include "AirRegions.h"
+#include <boost/timer/timer.hpp>
+
+void AirRegions::Label(const PL_VOXEL_GRID& Grid)
+{
+    boost::timer::cpu_timer Timer;
+    
+    XSize = Grid.Size(0,0);
+    YSize = Grid.Size(0,1);
+    ZSize = Grid.Size(0,2);
+    
+    const int NumVoxels = static_cast<int>(Grid.Voxels.size());
+    
+    Labels.assign(NumVoxels, Geometry);
+    
+    // Labels start at 1, so slot 0 is the geometry
+    uint32_t NextLabel = 1;
+    
+    std::vector<int> Queue;
+    
+    for (int StartIndex = 0; StartIndex < NumVoxels; ++StartIndex)
+    {
+        if (Grid.Voxels[StartIndex].Beta == 0 || Labels[StartIndex] != Geometry)
+        {
+            continue;
+        }
+        
+        const uint32_t Region = NextLabel++;
+        
+        Queue.clear();
+        Queue.push_back(StartIndex);
+        Labels[StartIndex] = Region;
+        
+        // Flood fill the region
+        for (size_t Head = 0; Head < Queue.size(); ++Head)
+        {
+            int X, Y, Z;
+            IndexToThreeDim(Queue[Head], XSize, YSize, X, Y, Z);
+            
+            const int Neighbours[6][3] = { {X-1,Y,Z}, {X+1,Y,Z}, {X,Y-1,Z}, {X,Y+1,Z}, {X,Y,Z-1}, {X,Y,Z+1} };
+            
+            for (const auto& Neighbour : Neighbours)
+            {
+                if (Neighbour[0] < 0 || Neighbour[0] >= XSize || Neighbour[1] < 0 || Neighbour[1] >= YSize || Neighbour[2] < 0 || Neighbour[2] >= ZSize)
+                {
+                    continue;
+                }
+                
+                const int NeighbourIndex = ThreeDimToOneDim(Neighbour[0], Neighbour[1], Neighbour[2], XSize, YSize);
+                
+                if (Labels[NeighbourIndex] == Geometry && Grid.Voxels[NeighbourIndex].Beta != 0)
+                {
+                    Labels[NeighbourIndex] = Region;
+                    Queue.push_back(NeighbourIndex);
+                }
+            }
+        }
+    }
+    
+    ActiveRegions.assign(NextLabel, 0);
+    ActivateAll();
+    
+    PL_LOG(PL_DEBUG_LEVEL_LOG, "Found " << GetRegionCount() << " air regions in " << Timer.elapsed().wall / 1e9 << "s");
+}
+
+void AirRegions::Activate(const std::vector<int>& VoxelIndices)
+{
+    std::fill(ActiveRegions.begin(), ActiveRegions.end(), 0);
+    
+    bool bAnyActive = false;
+    
+    for (int VoxelIndex : VoxelIndices)
+    {
+        if (VoxelIndex < 0 || VoxelIndex >= Labels.size() || Labels[VoxelIndex] == Geometry)
+        {
+            continue;
+        }
+        
+        ActiveRegions[Labels[VoxelIndex]] = 1;
+        bAnyActive = true;
+    }
+    
+    if (!bAnyActive)
+    {
+        DebugWarn("No listener or source is in open air. Simulating every region");
+        ActivateAll();
+        return;
+    }
+    
+    UpdateActiveVoxels();
+}
+
+uint32_t AirRegions::GetRegion(int VoxelIndex) const
+{
+    return Labels[VoxelIndex];
+}
+
+int AirRegions::GetRegionCount() const
+{
+    return std::max(0, static_cast<int>(ActiveRegions.size()) - 1);
+}
+
+bool AirRegions::IsActive(int VoxelIndex) const
+{
+    return ActiveVoxels[VoxelIndex] != 0;
+}
+
+const std::vector<uint8_t>& AirRegions::GetActiveVoxels() const
+{
+    return ActiveVoxels;
+}
+
+int AirRegions::GetActiveVoxelCount() const
+{
+    return ActiveVoxelCount;
+}
+
+void AirRegions::ActivateAll()
+{
+    std::fill(ActiveRegions.begin(), ActiveRegions.end(), 1);
+    
+    if (ActiveRegions.size() > 0)
+    {
+        ActiveRegions[Geometry] = 0;
+    }
+    
+    UpdateActiveVoxels();
+}
+
+void AirRegions::UpdateActiveVoxels()
+{
+    ActiveVoxels.resize(Labels.size());
+    
+    ParallelFor(0, static_cast<int>(Labels.size()), [this](int Begin, int End)
+    {
+        for (int i = Begin; i < End; ++i)
+        {
+            ActiveVoxels[i] = ActiveRegions[Labels[i]];
+        }
+    });
+    
+    ActiveVoxelCount = static_cast<int>(std::count(ActiveVoxels.begin(), ActiveVoxels.end(), 1));
+}
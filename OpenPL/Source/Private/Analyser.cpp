@@ -13,7 +13,26 @@
 #include "PL_SYSTEM.h"
 #include "PL_SCENE.h"
 #include "FreeGrid.h"
-#include <sstream>
+#include "TriangleBVH.h"
+#include "ImageSourceModel.h"
+
+namespace
+{
+    /**
+     * Runs a filter forwards then backwards over the samples. The phase cancels out and the magnitude response is squared.
+     */
+    void FilterZeroPhase(const juce::IIRCoefficients& Coefficients, float* Samples, int NumSamples)
+    {
+        juce::IIRFilter Filter;
+        Filter.setCoefficients(Coefficients);
+        Filter.processSamples(Samples, NumSamples);
+        
+        std::reverse(Samples, Samples + NumSamples);
+        Filter.reset();
+        Filter.processSamples(Samples, NumSamples);
+        std::reverse(Samples, Samples + NumSamples);
+    }
+}
 
 void Analyser::Encode(Simulator* Simulator, PLVector EncodingPosition, int* OutVoxelIndex)
 {
@@ -76,33 +95,30 @@ void Analyser::Encode(Simulator* Simulator, PLVector EncodingPosition, int* OutV
 
 void Analyser::GetOcclusion(Simulator* Simulator, PLVector EncodingPosition, float* OutOcclusion)
 {
-    const int NumSamples = Simulator->GetTimeSteps();
-    const float SamplingRate = Simulator->GetSamplingRate();
-    
     const PL_SCENE* Scene = Simulator->GetScene();
     
     // It can be assumed the encoding position in the emitter location
     int EmitterIndex;   // The array index
-    int EmitterX, EmitterY, EmitterZ;   // The 3D world indexes of the emitter
     Scene->GetVoxelIndexOfPosition(EncodingPosition, &EmitterIndex);
-    Scene->GetThreeDimensionalIndexOfIndex(EmitterIndex, EmitterX, EmitterY, EmitterZ);
     
     const std::vector<std::vector<PLVoxel>>& SimulatedLattice = Simulator->GetSimulatedLattice();
     
-    if (EmitterIndex < 0 || EmitterIndex >= SimulatedLattice.size())
+    const PL_VOXEL_GRID* Grid;
+    Scene->GetVoxels(&Grid);
+    const bool bEmitterInLattice = Grid->Bounds.contains(Eigen::Vector3d(EncodingPosition.X, EncodingPosition.Y, EncodingPosition.Z));
+    
+    // Nothing was simulated out there, so fall back to the geometry in the way
+    if (!bEmitterInLattice || EmitterIndex < 0 || EmitterIndex >= SimulatedLattice.size())
     {
-        *OutOcclusion = 1;
+        Scene->TraceOcclusion(&EncodingPosition, 1, OutOcclusion);
         return;
     }
     
-    const std::vector<PLVoxel> Response = SimulatedLattice[EmitterIndex];   // Response at the emitter location
-    
     PLVector ListenerLocation;
     PL_SYSTEM* System;
     Scene->GetSystem(&System);
     System->GetListenerPosition(ListenerLocation);
     int ListenerIndex;
-    int ListenerX, ListenerY, ListenerZ;
     Scene->GetVoxelIndexOfPosition(ListenerLocation, &ListenerIndex);
     
     if (ListenerIndex < 0 || ListenerIndex >= SimulatedLattice.size())
@@ -111,7 +127,28 @@ void Analyser::GetOcclusion(Simulator* Simulator, PLVector EncodingPosition, flo
         return;
     }
     
+    const float ObstructionGain = CalculateOcclusion(Simulator, ListenerIndex, EmitterIndex);
+    
+    PL_LOG_VERBOSE("Occlusion: " << ObstructionGain);
+    
+//    double r = 1.0f / std::max(0.001f, ObstructionGain);
+     
+    *OutOcclusion = ObstructionGain;
+}
+
+float Analyser::CalculateOcclusion(Simulator* Simulator, int ListenerIndex, int EmitterIndex)
+{
+    const int NumSamples = Simulator->GetTimeSteps();
+    const float SamplingRate = Simulator->GetSamplingRate();
+    
+    const PL_SCENE* Scene = Simulator->GetScene();
+    
+    int EmitterX, EmitterY, EmitterZ;   // The 3D world indexes of the emitter
+    int ListenerX, ListenerY, ListenerZ;
+    Scene->GetThreeDimensionalIndexOfIndex(EmitterIndex, EmitterX, EmitterY, EmitterZ);
     Scene->GetThreeDimensionalIndexOfIndex(ListenerIndex, ListenerX, ListenerY, ListenerZ);
+    
+    const std::vector<PLVoxel>& Response = Simulator->GetSimulatedLattice()[EmitterIndex];   // Response at the emitter location
 
     //
     // ONSET DELAY
@@ -127,7 +164,7 @@ void Analyser::GetOcclusion(Simulator* Simulator, PLVector EncodingPosition, flo
     }
     
      const int DirectGainSamples = static_cast<int>(0.01f * SamplingRate);    // go forward 10ms
-     const int DirectEnd = OnsetSample + DirectGainSamples;
+     const int DirectEnd = std::min(OnsetSample + DirectGainSamples, NumSamples);
 
      float ObstructionGain = 0.0f;
      {
@@ -151,13 +188,130 @@ void Analyser::GetOcclusion(Simulator* Simulator, PLVector EncodingPosition, flo
 
          float E = (Edry / EfreePr);
          ObstructionGain = std::sqrt(E);
-         
-         std::ostringstream StringStream;
-         StringStream << "Occlusion: " << ObstructionGain << ". Final Energy: " << E << ". Energy From Geometry: " << Edry << ". Energy From Grid: " << EfreePr;
-//         DebugLog(StringStream.str().c_str());
      }
     
-//    double r = 1.0f / std::max(0.001f, ObstructionGain);
-     
-    *OutOcclusion = ObstructionGain;
+    return ObstructionGain;
+}
+
+void Analyser::GetImpulseResponse(Simulator* Simulator, PLVector EmitterLocation, int MaxReflectionOrder, int SampleRate, float* OutResponse, int ResponseLength)
+{
+    if (!Simulator || !OutResponse || ResponseLength <= 0 || SampleRate <= 0)
+    {
+        return;
+    }
+    
+    std::fill(OutResponse, OutResponse + ResponseLength, 0.0f);
+    
+    const PL_SCENE* Scene = Simulator->GetScene();
+    const float SpeedOfSound = 343.21f;
+    const float MinDistance = 0.1f;
+    
+    PLVector ListenerLocation;
+    Scene->GetListenerLocation(&ListenerLocation);
+    
+    // Keep the crossover below Nyquist so the filters stay stable
+    const float Crossover = std::min(Simulator->GetMaxFrequency(), 0.45f * SampleRate);
+    
+    int EmitterIndex;
+    Scene->GetVoxelIndexOfPosition(EmitterLocation, &EmitterIndex);
+    
+    const std::vector<std::vector<PLVoxel>>& SimulatedLattice = Simulator->GetSimulatedLattice();
+    
+    const PL_VOXEL_GRID* Grid;
+    Scene->GetVoxels(&Grid);
+    const bool bEmitterInLattice = Grid->Bounds.contains(Eigen::Vector3d(EmitterLocation.X, EmitterLocation.Y, EmitterLocation.Z)) && EmitterIndex >= 0 && EmitterIndex < SimulatedLattice.size();
+    
+    FreeGrid* FreeGrid;
+    Scene->GetFreeGrid(&FreeGrid);
+    const double FreeEnergy = FreeGrid ? FreeGrid->GetEnergyAtOneMeter() : 0.0;
+    
+    // Outside the lattice the image sources cover the whole band on their own
+    const bool bHasLowBand = bEmitterInLattice && FreeEnergy > 0.0;
+    
+    //
+    // LOW BAND
+    //
+    if (bHasLowBand)
+    {
+        const std::vector<PLVoxel>& Response = SimulatedLattice[EmitterIndex];
+        const double SimulatorRate = Simulator->GetSamplingRate();
+        
+        // Time the Gaussian pulse takes to peak after it starts. Removing it lines the simulation up with the image sources
+        const double Pi = std::acos(-1);
+        const double PulseDelay = 2.0 / (0.5 * Pi * Simulator->GetMaxFrequency());
+        
+        // The free field energy is summed over the simulator's samples. Upsampling spreads the pulse over more samples,
+        // and a unit impulse only has this fraction of its energy below the crossover
+        const double UpsampleRatio = SampleRate / SimulatorRate;
+        const double Scale = std::sqrt((2.0 * Crossover / SampleRate) / (FreeEnergy * UpsampleRatio));
+        
+        for (int i = 0; i < ResponseLength; ++i)
+        {
+            const double Time = static_cast<double>(i) / SampleRate;
+            const double SimulatorSample = (Time + PulseDelay) * SimulatorRate;
+            const int Before = static_cast<int>(SimulatorSample);
+            
+            if (Before + 1 >= Response.size())
+            {
+                break;
+            }
+            
+            const double Fraction = SimulatorSample - Before;
+            const double Pressure = Response[Before].AirPressure * (1.0 - Fraction) + Response[Before + 1].AirPressure * Fraction;
+            
+            // The lattice is 2D, where pressure falls off with 1/sqrt(r) instead of 1/r. Correct by the distance travelled so far
+            const double Distance = std::max(Time * SpeedOfSound, static_cast<double>(MinDistance));
+            
+            OutResponse[i] = static_cast<float>(Pressure * Scale / std::sqrt(Distance));
+        }
+        
+        FilterZeroPhase(juce::IIRCoefficients::makeLowPass(SampleRate, Crossover), OutResponse, ResponseLength);
+    }
+    
+    //
+    // HIGH BAND
+    //
+    const TriangleBVH* Triangles;
+    Scene->GetTriangleBVH(&Triangles);
+    
+    if (!Triangles)
+    {
+        return;
+    }
+    
+    std::vector<ImageSourceModel::Reflection> Reflections;
+    ImageSourceModel ImageSources (*Triangles);
+    ImageSources.Calculate(EmitterLocation, ListenerLocation, MaxReflectionOrder, SpeedOfSound * ResponseLength / SampleRate, Reflections);
+    
+    std::vector<float> HighBand (ResponseLength, 0.0f);
+    
+    for (const ImageSourceModel::Reflection& Reflection : Reflections)
+    {
+        // Split each arrival between the two nearest samples so the delay isn't rounded
+        const float Position = Reflection.Delay * SampleRate;
+        const int Before = static_cast<int>(Position);
+        const float Fraction = Position - Before;
+        
+        if (Before < ResponseLength)
+        {
+            HighBand[Before] += Reflection.Gain * (1.0f - Fraction);
+        }
+        
+        if (Before + 1 < ResponseLength)
+        {
+            HighBand[Before + 1] += Reflection.Gain * Fraction;
+        }
+    }
+    
+    if (bHasLowBand)
+    {
+        FilterZeroPhase(juce::IIRCoefficients::makeHighPass(SampleRate, Crossover), HighBand.data(), ResponseLength);
+    }
+    
+    for (int i = 0; i < ResponseLength; ++i)
+    {
+        OutResponse[i] += HighBand[i];
+    }
+    
+    PL_LOG_VERBOSE("Impulse response: " << Reflections.size() << " image source paths above " << Crossover << "Hz");
 }
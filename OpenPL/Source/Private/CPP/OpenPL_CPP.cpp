@@ -35,6 +35,16 @@ namespace OpenPL
         return Result;
     }
 
+    PL_RESULT PLSystem::BenchmarkThreadScaling(int VoxelsInSide, float* OutFirstTouchSpeedup, float* OutSerialTouchSpeedup)
+    {
+        return PL_System_BenchmarkThreadScaling(reinterpret_cast<PL_SYSTEM*>(this), VoxelsInSide, OutFirstTouchSpeedup, OutSerialTouchSpeedup);
+    }
+
+    PL_RESULT PLSystem::SetParallelThreads(int MaxThreads, bool PinThreads)
+    {
+        return PL_System_SetParallelThreads(reinterpret_cast<PL_SYSTEM*>(this), MaxThreads, PinThreads);
+    }
+
     PL_RESULT PLScene::Release()
     {
         return PL_Scene_Release(reinterpret_cast<PL_SCENE*>(this));
@@ -55,6 +65,41 @@ namespace OpenPL
         return PL_Scene_RemoveMesh(reinterpret_cast<PL_SCENE*>(this), IndexToRemove);
     }
 
+    PL_RESULT PLScene::AddHeightfield(PLVector Origin, float Spacing, int Rows, int Columns, const float* Heights, float Absorptivity, int* OutIndex)
+    {
+        return PL_Scene_AddHeightfield(reinterpret_cast<PL_SCENE*>(this), Origin, Spacing, Rows, Columns, Heights, Absorptivity, OutIndex);
+    }
+
+    PL_RESULT PLScene::RemoveHeightfield(int IndexToRemove)
+    {
+        return PL_Scene_RemoveHeightfield(reinterpret_cast<PL_SCENE*>(this), IndexToRemove);
+    }
+
+    PL_RESULT PLScene::AddBox(PLVector Position, PLQuaternion Rotation, PLVector HalfExtents, float Absorptivity, int* OutIndex)
+    {
+        return PL_Scene_AddBox(reinterpret_cast<PL_SCENE*>(this), Position, Rotation, HalfExtents, Absorptivity, OutIndex);
+    }
+
+    PL_RESULT PLScene::AddSphere(PLVector Position, float Radius, float Absorptivity, int* OutIndex)
+    {
+        return PL_Scene_AddSphere(reinterpret_cast<PL_SCENE*>(this), Position, Radius, Absorptivity, OutIndex);
+    }
+
+    PL_RESULT PLScene::AddCapsule(PLVector Position, PLQuaternion Rotation, float Radius, float HalfHeight, float Absorptivity, int* OutIndex)
+    {
+        return PL_Scene_AddCapsule(reinterpret_cast<PL_SCENE*>(this), Position, Rotation, Radius, HalfHeight, Absorptivity, OutIndex);
+    }
+
+    PL_RESULT PLScene::AddConvexHull(PLVector Position, PLQuaternion Rotation, PLVector Scale, PLVector* Vertices, int VerticesLength, int* Indices, int IndicesLength, float Absorptivity, int* OutIndex)
+    {
+        return PL_Scene_AddConvexHull(reinterpret_cast<PL_SCENE*>(this), Position, Rotation, Scale, Vertices, VerticesLength, Indices, IndicesLength, Absorptivity, OutIndex);
+    }
+
+    PL_RESULT PLScene::RemovePrimitive(int IndexToRemove)
+    {
+        return PL_Scene_RemovePrimitive(reinterpret_cast<PL_SCENE*>(this), IndexToRemove);
+    }
+
     PL_RESULT PLScene::FillVoxelsWithGeometry()
     {
         return PL_Scene_FillVoxelsWithGeometry(reinterpret_cast<PL_SCENE*>(this));
@@ -85,11 +130,76 @@ namespace OpenPL
         return PL_Scene_Simulate(reinterpret_cast<PL_SCENE*>(this), SimulationLocation);
     }
 
+    PL_RESULT PLScene::GetSimulationRate(float* OutSamplingRate, float* OutMaxFrequency)
+    {
+        return PL_Scene_GetSimulationRate(reinterpret_cast<PL_SCENE*>(this), OutSamplingRate, OutMaxFrequency);
+    }
+
+    PL_RESULT PLScene::SetSimulationScheme(PL_SIMULATION_SCHEME Scheme)
+    {
+        return PL_Scene_SetSimulationScheme(reinterpret_cast<PL_SCENE*>(this), Scheme);
+    }
+
+    PL_RESULT PLScene::SetSimulationPrecision(PL_SIMULATION_PRECISION Precision)
+    {
+        return PL_Scene_SetSimulationPrecision(reinterpret_cast<PL_SCENE*>(this), Precision);
+    }
+
+    PL_RESULT PLScene::SetWarmStartDistance(float MaxDistance)
+    {
+        return PL_Scene_SetWarmStartDistance(reinterpret_cast<PL_SCENE*>(this), MaxDistance);
+    }
+
+    PL_RESULT PLScene::SetMeshSimplification(bool bEnabled, float MaxErrorInVoxels)
+    {
+        return PL_Scene_SetMeshSimplification(reinterpret_cast<PL_SCENE*>(this), bEnabled, MaxErrorInVoxels);
+    }
+
+    PL_RESULT PLScene::SetVoxelisationMode(PL_VOXELISATION_MODE Mode)
+    {
+        return PL_Scene_SetVoxelisationMode(reinterpret_cast<PL_SCENE*>(this), Mode);
+    }
+
+    PL_RESULT PLScene::BenchmarkWarmStart(PLVector FromLocation, PLVector ToLocation, float* OutRelativeError, float* OutSpeedup)
+    {
+        return PL_Scene_BenchmarkWarmStart(reinterpret_cast<PL_SCENE*>(this), FromLocation, ToLocation, OutRelativeError, OutSpeedup);
+    }
+
+    PL_RESULT PLScene::StartSnapshotRecording(const char* FilePrefix, int Interval, int Stride, PL_SNAPSHOT_REGION Region, int PlaneIndex, PL_SNAPSHOT_PRECISION Precision)
+    {
+        return PL_Scene_StartSnapshotRecording(reinterpret_cast<PL_SCENE*>(this), FilePrefix, Interval, Stride, Region, PlaneIndex, Precision);
+    }
+
+    PL_RESULT PLScene::StopSnapshotRecording()
+    {
+        return PL_Scene_StopSnapshotRecording(reinterpret_cast<PL_SCENE*>(this));
+    }
+
     PL_RESULT PLScene::Debug()
     {
         return PL_Scene_Debug(reinterpret_cast<PL_SCENE*>(this));
     }
 
+    PL_RESULT PLScene::DebugUpdate()
+    {
+        return PL_Scene_DebugUpdate(reinterpret_cast<PL_SCENE*>(this));
+    }
+
+    PL_RESULT PLScene::GenerateProbes(PL_PROBE_PLACEMENT Placement, float Spacing, PLVector* Seeds, int SeedsLength, int MaxProbes, int* OutProbeCount)
+    {
+        return PL_Scene_GenerateProbes(reinterpret_cast<PL_SCENE*>(this), Placement, Spacing, Seeds, SeedsLength, MaxProbes, OutProbeCount);
+    }
+
+    PL_RESULT PLScene::BakeProbes()
+    {
+        return PL_Scene_BakeProbes(reinterpret_cast<PL_SCENE*>(this));
+    }
+
+    PL_RESULT PLScene::GetBakedOcclusion(PLVector EmitterLocation, float* OutOcclusion)
+    {
+        return PL_Scene_GetBakedOcclusion(reinterpret_cast<PL_SCENE*>(this), EmitterLocation, OutOcclusion);
+    }
+
     PL_RESULT PLScene::GetVoxelsCount(int* OutVoxelCount)
     {
         return PL_Scene_GetVoxelsCount(reinterpret_cast<PL_SCENE*>(this), OutVoxelCount);
@@ -105,6 +215,16 @@ namespace OpenPL
         return PL_Scene_GetVoxelAbsorpivity(reinterpret_cast<PL_SCENE*>(this), OutAbsorpivity, Index);
     }
 
+    PL_RESULT PLScene::GetDistanceToGeometry(PLVector Location, float* OutDistance)
+    {
+        return PL_Scene_GetDistanceToGeometry(reinterpret_cast<PL_SCENE*>(this), Location, OutDistance);
+    }
+
+    PL_RESULT PLScene::GetVoxelRegion(int* OutRegion, bool* OutActive, int Index)
+    {
+        return PL_Scene_GetVoxelRegion(reinterpret_cast<PL_SCENE*>(this), OutRegion, OutActive, Index);
+    }
+
     PL_RESULT PLScene::DrawGraph(PLVector GraphPosition)
     {
         return PL_Scene_DrawGraph(reinterpret_cast<PL_SCENE*>(this), GraphPosition);
@@ -119,4 +239,59 @@ namespace OpenPL
     {
         return PL_Scene_GetOcclusion(reinterpret_cast<PL_SCENE*>(this), EmitterLocation, OutOcclusion);
     }
+
+    PL_RESULT PLScene::TraceOcclusion(PLVector* EmitterLocations, int EmitterLocationsLength, float* OutOcclusions)
+    {
+        return PL_Scene_TraceOcclusion(reinterpret_cast<PL_SCENE*>(this), EmitterLocations, EmitterLocationsLength, OutOcclusions);
+    }
+
+    PL_RESULT PLScene::SolveFrequencyResponse(PLVector SourceLocation, float* Frequencies, int FrequenciesLength, float* OutReal, float* OutImaginary, int OutLength)
+    {
+        return PL_Scene_SolveFrequencyResponse(reinterpret_cast<PL_SCENE*>(this), SourceLocation, Frequencies, FrequenciesLength, OutReal, OutImaginary, OutLength);
+    }
+
+    PL_RESULT PLScene::GetImpulseResponse(PLVector EmitterLocation, int MaxReflectionOrder, int SampleRate, float* OutResponse, int ResponseLength)
+    {
+        return PL_Scene_GetImpulseResponse(reinterpret_cast<PL_SCENE*>(this), EmitterLocation, MaxReflectionOrder, SampleRate, OutResponse, ResponseLength);
+    }
+
+    PL_RESULT PLScene::UpdateGeodesicField()
+    {
+        return PL_Scene_UpdateGeodesicField(reinterpret_cast<PL_SCENE*>(this));
+    }
+
+    PL_RESULT PLScene::GetGeodesicPath(PLVector EmitterLocation, float* OutDistance, PLVector* OutDirection)
+    {
+        return PL_Scene_GetGeodesicPath(reinterpret_cast<PL_SCENE*>(this), EmitterLocation, OutDistance, OutDirection);
+    }
+
+    PL_RESULT PLScene::GetRoomGraphSize(int* OutRoomCount, int* OutPortalCount)
+    {
+        return PL_Scene_GetRoomGraphSize(reinterpret_cast<PL_SCENE*>(this), OutRoomCount, OutPortalCount);
+    }
+
+    PL_RESULT PLScene::GetRoom(PLVector Location, int* OutRoom)
+    {
+        return PL_Scene_GetRoom(reinterpret_cast<PL_SCENE*>(this), Location, OutRoom);
+    }
+
+    PL_RESULT PLScene::GetPortal(int PortalIndex, int* OutRoomA, int* OutRoomB, PLVector* OutPosition, float* OutArea)
+    {
+        return PL_Scene_GetPortal(reinterpret_cast<PL_SCENE*>(this), PortalIndex, OutRoomA, OutRoomB, OutPosition, OutArea);
+    }
+
+    PL_RESULT PLScene::FindRoomPath(PLVector From, PLVector To, int* OutPortals, int MaxPortals, int* OutPortalCount, float* OutDistance)
+    {
+        return PL_Scene_FindRoomPath(reinterpret_cast<PL_SCENE*>(this), From, To, OutPortals, MaxPortals, OutPortalCount, OutDistance);
+    }
+
+    PL_RESULT PLScene::ExecuteCommands(void* Commands, int CommandsLength, PL_COMMAND_RESULT* OutResults, int ResultsLength, int* OutCommandCount)
+    {
+        return PL_Scene_ExecuteCommands(reinterpret_cast<PL_SCENE*>(this), Commands, CommandsLength, OutResults, ResultsLength, OutCommandCount);
+    }
+
+    PL_RESULT PLScene::ExecuteCommands(PLCommandBuffer& Commands, PL_COMMAND_RESULT* OutResults, int ResultsLength, int* OutCommandCount)
+    {
+        return ExecuteCommands(Commands.GetData(), Commands.GetSize(), OutResults, ResultsLength, OutCommandCount);
+    }
 }
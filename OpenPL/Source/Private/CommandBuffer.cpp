@@ -0,0 +1,250 @@
+/*
+  ==============================================================================
+  
+    CommandBuffer.cpp
+    Created: 19 Oct 2026 5:12:09am
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#include "CommandBuffer.h"
+#include "PL_SCENE.h"
+#include "Analyser.h"
+#include <cstring>
+#include <type_traits>
+
+namespace
+{
+    template <typename T>
+    T ReadArguments(const char* Arguments)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Command arguments are copied out of the buffer byte by byte");
+        
+        T Value;
+        std::memcpy(&Value, Arguments, sizeof(T));
+        return Value;
+    }
+}
+
+PL_RESULT CommandBuffer::Execute(PL_SCENE& Scene, void* Commands, int CommandsLength, PL_COMMAND_RESULT* OutResults, int ResultsLength, int& OutCommandCount)
+{
+    OutCommandCount = 0;
+    
+    if (!Commands || CommandsLength < 0 || reinterpret_cast<uintptr_t>(Commands) % 4 != 0)
+    {
+        DebugError("Command buffer must be 4 byte aligned");
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    char* Buffer = static_cast<char*>(Commands);
+    
+    if (!Validate(Buffer, CommandsLength, OutCommandCount))
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    if (OutCommandCount > 0 && (!OutResults || ResultsLength < OutCommandCount))
+    {
+        DebugError("Not enough results for every command in the buffer");
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    int Offset = 0;
+    
+    for (int Command = 0; Command < OutCommandCount; ++Command)
+    {
+        const PL_COMMAND_HEADER Header = ReadArguments<PL_COMMAND_HEADER>(Buffer + Offset);
+        char* Arguments = Buffer + Offset + sizeof(PL_COMMAND_HEADER);
+        
+        OutResults[Command] = ExecuteOne(Scene, Header, Arguments);
+        Offset += sizeof(PL_COMMAND_HEADER) + Header.Size;
+    }
+    
+    return PL_OK;
+}
+
+bool CommandBuffer::Validate(const char* Commands, int CommandsLength, int& OutCommandCount)
+{
+    OutCommandCount = 0;
+    int Offset = 0;
+    
+    while (Offset < CommandsLength)
+    {
+        if (CommandsLength - Offset < static_cast<int>(sizeof(PL_COMMAND_HEADER)))
+        {
+            DebugError("Command buffer ends part way through a header");
+            return false;
+        }
+        
+        const PL_COMMAND_HEADER Header = ReadArguments<PL_COMMAND_HEADER>(Commands + Offset);
+        const int Remaining = CommandsLength - Offset - static_cast<int>(sizeof(PL_COMMAND_HEADER));
+        
+        if (Header.Size < 0 || Header.Size % 4 != 0 || Header.Size > Remaining)
+        {
+            DebugError("Command buffer has a command whose size isn't a multiple of 4 or runs past the end");
+            return false;
+        }
+        
+        const int Needed = GetArgumentsSize(Header, Commands + Offset + sizeof(PL_COMMAND_HEADER));
+        
+        if (Needed < 0 || Needed > Header.Size)
+        {
+            DebugError("Command buffer has an unknown command or one without enough arguments");
+            return false;
+        }
+        
+        Offset += sizeof(PL_COMMAND_HEADER) + Header.Size;
+        ++OutCommandCount;
+    }
+    
+    return true;
+}
+
+int CommandBuffer::GetArgumentsSize(const PL_COMMAND_HEADER& Header, const char* Arguments)
+{
+    switch (Header.Type)
+    {
+        case PL_COMMAND_ADD_MESH:
+        {
+            if (Header.Size < static_cast<int>(sizeof(PL_COMMAND_ADD_MESH_ARGS)))
+            {
+                return sizeof(PL_COMMAND_ADD_MESH_ARGS);
+            }
+            
+            const PL_COMMAND_ADD_MESH_ARGS Mesh = ReadArguments<PL_COMMAND_ADD_MESH_ARGS>(Arguments);
+            
+            if (Mesh.VerticesLength < 0 || Mesh.IndicesLength < 0)
+            {
+                return -1;
+            }
+            
+            // 64 bit so a huge length can't wrap around to something that fits
+            const int64_t Size = static_cast<int64_t>(sizeof(PL_COMMAND_ADD_MESH_ARGS)) + static_cast<int64_t>(Mesh.VerticesLength) * sizeof(PLVector) + static_cast<int64_t>(Mesh.IndicesLength) * sizeof(int);
+            return Size > Header.Size ? -1 : static_cast<int>(Size);
+        }
+        case PL_COMMAND_ADD_LISTENER_LOCATION:
+        case PL_COMMAND_ADD_SOURCE_LOCATION:
+        case PL_COMMAND_GET_OCCLUSION:
+            return sizeof(PLVector);
+        case PL_COMMAND_SET_LISTENER_LOCATION:
+        case PL_COMMAND_SET_SOURCE_LOCATION:
+            return sizeof(PL_COMMAND_LOCATION_ARGS);
+        case PL_COMMAND_REMOVE_MESH:
+        case PL_COMMAND_REMOVE_LISTENER_LOCATION:
+        case PL_COMMAND_REMOVE_SOURCE_LOCATION:
+        case PL_COMMAND_GET_VOXEL:
+            return sizeof(int);
+        default:
+            return -1;
+    }
+}
+
+PL_COMMAND_RESULT CommandBuffer::ExecuteOne(PL_SCENE& Scene, const PL_COMMAND_HEADER& Header, char* Arguments)
+{
+    PL_COMMAND_RESULT Result;
+    Result.Result = PL_OK;
+    Result.Index = 0;
+    Result.Flag = 0;
+    Result.Value = 0.0f;
+    Result.Vector = PLVector();
+    
+    switch (Header.Type)
+    {
+        case PL_COMMAND_ADD_MESH:
+        {
+            const PL_COMMAND_ADD_MESH_ARGS Mesh = ReadArguments<PL_COMMAND_ADD_MESH_ARGS>(Arguments);
+            
+            // The buffer is 4 byte aligned, so the vertices and indices can be used where they are
+            PLVector* Vertices = reinterpret_cast<PLVector*>(Arguments + sizeof(PL_COMMAND_ADD_MESH_ARGS));
+            int* Indices = reinterpret_cast<int*>(Arguments + sizeof(PL_COMMAND_ADD_MESH_ARGS) + Mesh.VerticesLength * sizeof(PLVector));
+            
+            Result.Result = Scene.AddAndConvertGameMesh(Mesh.WorldPosition, Mesh.WorldRotation, Mesh.WorldScale, Vertices, Mesh.VerticesLength, Indices, Mesh.IndicesLength, &Result.Index);
+            break;
+        }
+        case PL_COMMAND_REMOVE_MESH:
+        {
+            const int Index = ReadArguments<int>(Arguments);
+            Result.Result = Index < 0 ? PL_ERR_INVALID_PARAM : Scene.RemoveMesh(Index);
+            break;
+        }
+        case PL_COMMAND_ADD_LISTENER_LOCATION:
+        {
+            PLVector Location = ReadArguments<PLVector>(Arguments);
+            Result.Result = Scene.AddListenerLocation(Location, Result.Index);
+            break;
+        }
+        case PL_COMMAND_SET_LISTENER_LOCATION:
+        {
+            const PL_COMMAND_LOCATION_ARGS Move = ReadArguments<PL_COMMAND_LOCATION_ARGS>(Arguments);
+            Result.Result = Scene.SetListenerLocation(Move.Index, Move.Location);
+            break;
+        }
+        case PL_COMMAND_REMOVE_LISTENER_LOCATION:
+        {
+            const int Index = ReadArguments<int>(Arguments);
+            Result.Result = Index < 0 ? PL_ERR_INVALID_PARAM : Scene.RemoveListenerLocation(Index);
+            break;
+        }
+        case PL_COMMAND_ADD_SOURCE_LOCATION:
+        {
+            PLVector Location = ReadArguments<PLVector>(Arguments);
+            Result.Result = Scene.AddSourceLocation(Location, Result.Index);
+            break;
+        }
+        case PL_COMMAND_SET_SOURCE_LOCATION:
+        {
+            const PL_COMMAND_LOCATION_ARGS Move = ReadArguments<PL_COMMAND_LOCATION_ARGS>(Arguments);
+            Result.Result = Scene.SetSourceLocation(Move.Index, Move.Location);
+            break;
+        }
+        case PL_COMMAND_REMOVE_SOURCE_LOCATION:
+        {
+            const int Index = ReadArguments<int>(Arguments);
+            Result.Result = Index < 0 ? PL_ERR_INVALID_PARAM : Scene.RemoveSourceLocation(Index);
+            break;
+        }
+        case PL_COMMAND_GET_VOXEL:
+        {
+            const int Index = ReadArguments<int>(Arguments);
+            float Absorptivity = 0.0f;
+            bool bActive = false;
+            
+            Result.Result = Scene.GetVoxelLocation(&Result.Vector, Index);
+            
+            if (Result.Result == PL_OK)
+            {
+                Result.Result = Scene.GetVoxelAbsorpivity(&Absorptivity, Index);
+            }
+            
+            if (Result.Result == PL_OK)
+            {
+                Result.Result = Scene.GetVoxelRegion(&Result.Index, &bActive, Index);
+            }
+            
+            Result.Value = Absorptivity;
+            Result.Flag = bActive ? 1 : 0;
+            break;
+        }
+        case PL_COMMAND_GET_OCCLUSION:
+        {
+            Simulator* Simulator = nullptr;
+            Scene.GetSimulator(&Simulator);
+            
+            if (!Simulator)
+            {
+                Result.Result = PL_ERR;
+                break;
+            }
+            
+            Analyser Analyser;
+            Analyser.GetOcclusion(Simulator, ReadArguments<PLVector>(Arguments), &Result.Value);
+            break;
+        }
+        default:
+            Result.Result = PL_ERR_INVALID_PARAM;
+            break;
+    }
+    
+    return Result;
+}
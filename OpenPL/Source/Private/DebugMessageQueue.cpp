@@ -0,0 +1,102 @@
+/*
+  ==============================================================================
+  
+    DebugMessageQueue.cpp
+    Created: 18 Oct 2026 8:41:17pm
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#include "DebugMessageQueue.h"
+#include <cstring>
+
+DebugMessageQueue::DebugMessageQueue()
+: PushPosition(0), PopPosition(0), DroppedCount(0)
+{
+    for (size_t i = 0; i < Capacity; ++i)
+    {
+        Slots[i].Sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool DebugMessageQueue::Push(const char* Message, PL_DEBUG_LEVEL Level)
+{
+    size_t Position = PushPosition.load(std::memory_order_relaxed);
+    Slot* Target;
+    
+    while (true)
+    {
+        Target = &Slots[Position & (Capacity - 1)];
+        const size_t Sequence = Target->Sequence.load(std::memory_order_acquire);
+        const std::ptrdiff_t Difference = static_cast<std::ptrdiff_t>(Sequence) - static_cast<std::ptrdiff_t>(Position);
+        
+        if (Difference == 0)
+        {
+            // Slot is free. Claim it unless another thread got there first, in which case Position is reloaded
+            if (PushPosition.compare_exchange_weak(Position, Position + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (Difference < 0)
+        {
+            // Still holds a message from a lap ago, so the queue is full
+            DroppedCount.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        else
+        {
+            Position = PushPosition.load(std::memory_order_relaxed);
+        }
+    }
+    
+    std::strncpy(Target->Message, Message, MaxMessageLength - 1);
+    Target->Message[MaxMessageLength - 1] = '\0';
+    Target->Level = Level;
+    Target->Sequence.store(Position + 1, std::memory_order_release);
+    
+    return true;
+}
+
+bool DebugMessageQueue::Pop(char* OutMessage, PL_DEBUG_LEVEL& OutLevel)
+{
+    size_t Position = PopPosition.load(std::memory_order_relaxed);
+    Slot* Source;
+    
+    while (true)
+    {
+        Source = &Slots[Position & (Capacity - 1)];
+        const size_t Sequence = Source->Sequence.load(std::memory_order_acquire);
+        const std::ptrdiff_t Difference = static_cast<std::ptrdiff_t>(Sequence) - static_cast<std::ptrdiff_t>(Position + 1);
+        
+        if (Difference == 0)
+        {
+            if (PopPosition.compare_exchange_weak(Position, Position + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (Difference < 0)
+        {
+            return false;
+        }
+        else
+        {
+            Position = PopPosition.load(std::memory_order_relaxed);
+        }
+    }
+    
+    std::memcpy(OutMessage, Source->Message, MaxMessageLength);
+    OutLevel = Source->Level;
+    
+    // Free the slot for the push one lap from now
+    Source->Sequence.store(Position + Capacity, std::memory_order_release);
+    
+    return true;
+}
+
+size_t DebugMessageQueue::TakeDroppedCount()
+{
+    return DroppedCount.exchange(0, std::memory_order_relaxed);
+}
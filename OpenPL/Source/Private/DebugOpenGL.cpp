@@ -1,91 +1,449 @@
 /*
   ==============================================================================
-
+  
     DebugOpenGL.cpp
     Created: 8 Apr 2021 1:50:11pm
     Author:  James Kelly
-
+  
   ==============================================================================
 */
 
 #include "DebugOpenGL.h"
 #include <igl/opengl/glfw/Viewer.h>
+#include <igl/opengl/create_shader_program.h>
+#include <GLFW/glfw3.h>
 #include "PL_SCENE.h"
+#include "AirRegions.h"
 
-PL_RESULT OpenOpenGLDebugWindow(PL_SCENE* Scene)
+namespace
 {
-    igl::opengl::glfw::Viewer viewer;
-    const std::vector<PL_MESH>* Meshes = nullptr;
-    PL_RESULT GetMeshesResult = Scene->GetMeshes(&Meshes);
+    /**
+     * Draws a cube at each voxel center with one instanced draw call, instead of uploading 12 triangles per voxel through the viewer.
+     * Must be used on the thread that owns the OpenGL context.
+     */
+    class InstancedCubes
+    {
+    public:
+    
+        void Init()
+        {
+            const std::string VertexShader = R"(#version 150
+                uniform mat4 view;
+                uniform mat4 proj;
+                uniform float size;
+                in vec3 corner;
+                in vec3 normal;
+                in vec3 center;
+                out float shade;
+                void main()
+                {
+                    gl_Position = proj * view * vec4(center + corner * size, 1.0);
+                    shade = 0.45 + 0.55 * abs(dot(normal, normalize(vec3(0.3, 0.8, 0.5))));
+                }
+            )";
+            
+            const std::string FragmentShader = R"(#version 150
+                in float shade;
+                out vec4 outColor;
+                void main()
+                {
+                    outColor = vec4(vec3(0.8, 0.55, 0.3) * shade, 1.0);
+                }
+            )";
+            
+            igl::opengl::create_shader_program(VertexShader, FragmentShader, { { "corner", 0 }, { "normal", 1 }, { "center", 2 } }, Program);
+            
+            // Four corners per face so each face gets its own normal
+            std::vector<float> Vertices;
+            std::vector<GLuint> Indices;
+            
+            for (int Axis = 0; Axis < 3; ++Axis)
+            {
+                for (int Side = -1; Side <= 1; Side += 2)
+                {
+                    const GLuint First = static_cast<GLuint>(Vertices.size() / 6);
+                    const int U = (Axis + 1) % 3;
+                    const int V = (Axis + 2) % 3;
+                    
+                    for (int Corner = 0; Corner < 4; ++Corner)
+                    {
+                        float Position[3];
+                        float Normal[3] = { 0.0f, 0.0f, 0.0f };
+                        Position[Axis] = 0.5f * Side;
+                        Position[U] = (Corner == 1 || Corner == 2) ? 0.5f : -0.5f;
+                        Position[V] = (Corner >= 2) ? 0.5f : -0.5f;
+                        Normal[Axis] = static_cast<float>(Side);
+                        Vertices.insert(Vertices.end(), Position, Position + 3);
+                        Vertices.insert(Vertices.end(), Normal, Normal + 3);
+                    }
+                    
+                    const GLuint Face[6] = { First, First + 1, First + 2, First, First + 2, First + 3 };
+                    Indices.insert(Indices.end(), Face, Face + 6);
+                }
+            }
+            
+            glGenVertexArrays(1, &VertexArray);
+            glBindVertexArray(VertexArray);
+            
+            glGenBuffers(1, &CubeBuffer);
+            glBindBuffer(GL_ARRAY_BUFFER, CubeBuffer);
+            glBufferData(GL_ARRAY_BUFFER, Vertices.size() * sizeof(float), Vertices.data(), GL_STATIC_DRAW);
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), reinterpret_cast<void*>(0));
+            glEnableVertexAttribArray(1);
+            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), reinterpret_cast<void*>(3 * sizeof(float)));
+            
+            glGenBuffers(1, &IndexBuffer);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IndexBuffer);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, Indices.size() * sizeof(GLuint), Indices.data(), GL_STATIC_DRAW);
+            IndexCount = static_cast<GLsizei>(Indices.size());
+            
+            glGenBuffers(1, &InstanceBuffer);
+            glBindBuffer(GL_ARRAY_BUFFER, InstanceBuffer);
+            glEnableVertexAttribArray(2);
+            glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), reinterpret_cast<void*>(0));
+            glVertexAttribDivisor(2, 1);
+            
+            glBindVertexArray(0);
+        }
+        
+        void Upload(const std::vector<float>& Centers)
+        {
+            glBindBuffer(GL_ARRAY_BUFFER, InstanceBuffer);
+            glBufferData(GL_ARRAY_BUFFER, Centers.size() * sizeof(float), Centers.data(), GL_DYNAMIC_DRAW);
+            InstanceCount = static_cast<GLsizei>(Centers.size() / 3);
+        }
+        
+        void Draw(const Eigen::Matrix4f& View, const Eigen::Matrix4f& Projection, float Size) const
+        {
+            if (InstanceCount == 0)
+            {
+                return;
+            }
+            
+            glUseProgram(Program);
+            glUniformMatrix4fv(glGetUniformLocation(Program, "view"), 1, GL_FALSE, View.data());
+            glUniformMatrix4fv(glGetUniformLocation(Program, "proj"), 1, GL_FALSE, Projection.data());
+            glUniform1f(glGetUniformLocation(Program, "size"), Size);
+            
+            glBindVertexArray(VertexArray);
+            glDrawElementsInstanced(GL_TRIANGLES, IndexCount, GL_UNSIGNED_INT, reinterpret_cast<void*>(0), InstanceCount);
+            glBindVertexArray(0);
+        }
+    
+    private:
+    
+        GLuint Program = 0;
+        GLuint VertexArray = 0;
+        GLuint CubeBuffer = 0;
+        GLuint IndexBuffer = 0;
+        GLuint InstanceBuffer = 0;
+        GLsizei IndexCount = 0;
+        GLsizei InstanceCount = 0;
+    };
+    
+    Eigen::RowVector3d HueToColour(double Hue)
+    {
+        Eigen::RowVector3d Colour (std::abs(Hue * 6.0 - 3.0) - 1.0, 2.0 - std::abs(Hue * 6.0 - 2.0), 2.0 - std::abs(Hue * 6.0 - 4.0));
+        return Colour.cwiseMax(0.0).cwiseMin(1.0);
+    }
+}
+
+struct DebugViewer::Window
+{
+    igl::opengl::glfw::Viewer Viewer;
+    InstancedCubes Cubes;
+    
+    std::shared_ptr<const DebugSnapshot> Current;
+    std::shared_ptr<const DebugSnapshot::Geometry> CurrentGeometry;
+    uint64_t SeenVersion = 0;
+    
+    double LastFrameTime = 0.0;
+};
+
+DebugViewer::DebugViewer()
+{
+}
+
+DebugViewer::~DebugViewer()
+{
+    Close();
+}
+
+PL_RESULT DebugViewer::Open()
+{
+    if (OpenWindow)
+    {
+        return PL_OK;
+    }
+    
+    std::unique_ptr<Window> NewWindow (new Window());
+    igl::opengl::glfw::Viewer& Viewer = NewWindow->Viewer;
+    Window& State = *NewWindow;
+    
+    // One slot for the meshes and one for the air points, so either can be replaced without touching the other
+    Viewer.append_mesh(true);
+    
+    // Draw every frame even without input so new snapshots show up. Update paces the frames, so the viewer must never sleep itself
+    Viewer.core().is_animating = true;
+    Viewer.core().animation_max_fps = 1e6;
+    
+    Viewer.callback_init = [&State](igl::opengl::glfw::Viewer&)
+    {
+        State.Cubes.Init();
+        return false;
+    };
+    
+    Viewer.callback_pre_draw = [this, &State](igl::opengl::glfw::Viewer& CurrentViewer)
+    {
+        {
+            boost::mutex::scoped_lock Lock (SnapshotMutex);
+            
+            if (Version == State.SeenVersion)
+            {
+                return false;
+            }
+            
+            State.Current = Latest;
+            State.SeenVersion = Version;
+        }
+        
+        if (State.Current->Meshes != State.CurrentGeometry)
+        {
+            State.CurrentGeometry = State.Current->Meshes;
+            igl::opengl::ViewerData& MeshData = CurrentViewer.data_list[0];
+            MeshData.clear();
+            
+            if (State.CurrentGeometry->Vertices.rows() > 0)
+            {
+                MeshData.set_mesh(State.CurrentGeometry->Vertices, State.CurrentGeometry->Indices);
+                MeshData.add_edges(State.CurrentGeometry->BoundsFrom, State.CurrentGeometry->BoundsTo, Eigen::RowVector3d(1,0,0));
+            }
+        }
+        
+        igl::opengl::ViewerData& PointData = CurrentViewer.data_list[1];
+        PointData.clear();
+        PointData.add_points(State.Current->AirPoints, State.Current->AirColours);
+        
+        State.Cubes.Upload(State.Current->OccupiedCenters);
+        return false;
+    };
+    
+    Viewer.callback_post_draw = [&State](igl::opengl::glfw::Viewer& CurrentViewer)
+    {
+        State.Cubes.Draw(CurrentViewer.core().view, CurrentViewer.core().proj, State.Current ? State.Current->VoxelSize : 0.0f);
+        return false;
+    };
+    
+    Viewer.launch_init(true, false, "OpenPL Debug");
     
-    if (GetMeshesResult != PL_OK || Meshes == nullptr)
+    if (!Viewer.window)
     {
-        DebugWarn("Could not get meshes to render");
+        DebugError("Could not open the debug window");
         return PL_ERR;
     }
     
-    for (auto& Mesh : *Meshes)
+    OpenWindow = std::move(NewWindow);
+    Running.store(true);
+    
+    return PL_OK;
+}
+
+void DebugViewer::Update()
+{
+    if (!OpenWindow)
+    {
+        return;
+    }
+    
+    // Input is handled every update so the window stays responsive, but frames are only drawn as often as they're needed
+    const double Now = glfwGetTime();
+    if (Now - OpenWindow->LastFrameTime >= 1.0 / MaxFramesPerSecond)
+    {
+        OpenWindow->LastFrameTime = Now;
+        OpenWindow->Viewer.launch_rendering(false);
+    }
+    else
+    {
+        glfwPollEvents();
+    }
+    
+    if (glfwWindowShouldClose(OpenWindow->Viewer.window))
+    {
+        Close();
+    }
+}
+
+void DebugViewer::Close()
+{
+    if (!OpenWindow)
+    {
+        return;
+    }
+    
+    Running.store(false);
+    OpenWindow->Viewer.launch_shut();
+    OpenWindow.reset();
+}
+
+bool DebugViewer::IsOpen() const
+{
+    return Running.load();
+}
+
+std::shared_ptr<const DebugSnapshot::Geometry> DebugViewer::MakeGeometry(const PL_SCENE& Scene) const
+{
+    std::shared_ptr<DebugSnapshot::Geometry> Result (new DebugSnapshot::Geometry());
+    
+    const std::vector<PL_MESH>* Meshes = nullptr;
+    Scene.GetMeshes(&Meshes);
+    
+    int VertexCount = 0;
+    int TriangleCount = 0;
+    
+    for (const PL_MESH& Mesh : *Meshes)
+    {
+        VertexCount += Mesh.Vertices.cols();
+        TriangleCount += Mesh.Indices.cols();
+    }
+    
+    // Edges of a box, as pairs of corners. Corner bits are X, Y and Z being at the max
+    const int BoxEdges[12][2] = { {0,1}, {1,3}, {3,2}, {2,0}, {4,5}, {5,7}, {7,6}, {6,4}, {0,4}, {1,5}, {2,6}, {3,7} };
+    
+    Result->Vertices.resize(VertexCount, 3);
+    Result->Indices.resize(TriangleCount, 3);
+    Result->BoundsFrom.resize(Meshes->size() * 12, 3);
+    Result->BoundsTo.resize(Meshes->size() * 12, 3);
+    
+    int FirstVertex = 0;
+    int FirstTriangle = 0;
+    
+    for (int MeshIndex = 0; MeshIndex < Meshes->size(); ++MeshIndex)
     {
-        // Transpose the matrices because we store vectors as:
-        // {x1, x2, x3}
-        // {y1, y2, y3}
-        // {z1, z2, z3}
-        // However, OpenGL expects:
-        // {x1, y1, z1}
-        // {x2, y2, z2}
-        // {x3, y3, z3}
-        viewer.data().set_mesh(Mesh.Vertices.transpose(), Mesh.Indices.transpose());
-        viewer.append_mesh(true);
+        const PL_MESH& Mesh = (*Meshes)[MeshIndex];
         
-        Eigen::Vector3d MeshMin = Mesh.Vertices.rowwise().minCoeff();
-        Eigen::Vector3d MeshMax = Mesh.Vertices.rowwise().maxCoeff();
-        Eigen::AlignedBox<double, 3> MeshBounds (MeshMin, MeshMax);
+        // Meshes store one vertex per column, but the viewer wants one per row
+        Result->Vertices.middleRows(FirstVertex, Mesh.Vertices.cols()) = Mesh.Vertices.transpose();
+        Result->Indices.middleRows(FirstTriangle, Mesh.Indices.cols()) = Mesh.Indices.transpose().array() + FirstVertex;
         
-        VertexMatrix BoundingBoxPoints(8,3);
-        BoundingBoxPoints <<
-        MeshMin(0), MeshMin(1), MeshMin(2),
-        MeshMax(0), MeshMin(1), MeshMin(2),
-        MeshMax(0), MeshMax(1), MeshMin(2),
-        MeshMin(0), MeshMax(1), MeshMin(2),
-        MeshMin(0), MeshMin(1), MeshMax(2),
-        MeshMax(0), MeshMin(1), MeshMax(2),
-        MeshMax(0), MeshMax(1), MeshMax(2),
-        MeshMin(0), MeshMax(1), MeshMax(2);
+        const Eigen::Vector3d MeshMin = Mesh.Vertices.rowwise().minCoeff();
+        const Eigen::Vector3d MeshMax = Mesh.Vertices.rowwise().maxCoeff();
         
-        // Edges of the bounding box
-        IndiceMatrix E_box(12,2);
-        E_box <<
-        0, 1,
-        1, 2,
-        2, 3,
-        3, 0,
-        4, 5,
-        5, 6,
-        6, 7,
-        7, 4,
-        0, 4,
-        1, 5,
-        2, 6,
-        7 ,3;
+        for (int Edge = 0; Edge < 12; ++Edge)
+        {
+            const int From = BoxEdges[Edge][0];
+            const int To = BoxEdges[Edge][1];
+            Result->BoundsFrom.row(MeshIndex * 12 + Edge) << (From & 1 ? MeshMax : MeshMin).x(), (From & 2 ? MeshMax : MeshMin).y(), (From & 4 ? MeshMax : MeshMin).z();
+            Result->BoundsTo.row(MeshIndex * 12 + Edge) << (To & 1 ? MeshMax : MeshMin).x(), (To & 2 ? MeshMax : MeshMin).y(), (To & 4 ? MeshMax : MeshMin).z();
+        }
         
-        viewer.data().add_points(BoundingBoxPoints,Eigen::RowVector3d(1,0,0));
+        FirstVertex += Mesh.Vertices.cols();
+        FirstTriangle += Mesh.Indices.cols();
+    }
+    
+    return Result;
+}
 
-        // Plot the edges of the bounding box
-        for (unsigned i=0;i<E_box.rows(); ++i)
-          viewer.data().add_edges
-          (
-           BoundingBoxPoints.row(E_box(i,0)),
-           BoundingBoxPoints.row(E_box(i,1)),
-            Eigen::RowVector3d(1,0,0)
-          );
+void DebugViewer::Publish(const PL_SCENE& Scene, Colouring AirColouring)
+{
+    if (!Running.load())
+    {
+        return;
     }
     
-    int Success = viewer.launch();
+    std::shared_ptr<DebugSnapshot> Snapshot (new DebugSnapshot());
     
-    if (Success == EXIT_SUCCESS)
+    // The meshes can't change during a simulation, so reuse the ones in the last snapshot rather than copying them for every step.
+    // Snapshots are never changed once published, so sharing them with whichever thread published last is safe
+    if (AirColouring == Colouring_Pressure)
     {
-        return PL_OK;
+        boost::mutex::scoped_lock Lock (SnapshotMutex);
+        Snapshot->Meshes = Latest ? Latest->Meshes : nullptr;
+    }
+    
+    if (!Snapshot->Meshes)
+    {
+        Snapshot->Meshes = MakeGeometry(Scene);
+    }
+    
+    const PL_VOXEL_GRID* Grid = nullptr;
+    Scene.GetVoxels(&Grid);
+    Snapshot->VoxelSize = Grid->VoxelSize;
+    
+    const AirRegions* Regions = nullptr;
+    
+    if (AirColouring == Colouring_Regions)
+    {
+        Scene.GetAirRegions(&Regions);
+    }
+    
+    const int XSize = Grid->Size(0,0);
+    const int YSize = Grid->Size(0,1);
+    const int ZSize = Grid->Size(0,2);
+    const int NumVoxels = static_cast<int>(Grid->Voxels.size());
+    
+    std::vector<int> AirVoxels;
+    double MaxPressure = 0.0;
+    
+    for (int VoxelIndex = 0; VoxelIndex < NumVoxels; ++VoxelIndex)
+    {
+        if (Grid->Voxels[VoxelIndex].Beta != 0)
+        {
+            AirVoxels.push_back(VoxelIndex);
+            MaxPressure = std::max(MaxPressure, std::abs(Grid->Voxels[VoxelIndex].AirPressure));
+            continue;
+        }
+        
+        int X, Y, Z;
+        IndexToThreeDim(VoxelIndex, XSize, YSize, X, Y, Z);
+        
+        // Only the shell of the geometry can be seen, so skip voxels buried inside it
+        const bool TouchesAir =
+            (X > 0 && Grid->Voxels[VoxelIndex - 1].Beta != 0) || (X + 1 < XSize && Grid->Voxels[VoxelIndex + 1].Beta != 0) ||
+            (Y > 0 && Grid->Voxels[VoxelIndex - XSize].Beta != 0) || (Y + 1 < YSize && Grid->Voxels[VoxelIndex + XSize].Beta != 0) ||
+            (Z > 0 && Grid->Voxels[VoxelIndex - XSize * YSize].Beta != 0) || (Z + 1 < ZSize && Grid->Voxels[VoxelIndex + XSize * YSize].Beta != 0);
+        
+        if (TouchesAir)
+        {
+            PLVector Location;
+            Scene.GetVoxelPosition(VoxelIndex, &Location);
+            Snapshot->OccupiedCenters.push_back(Location.X);
+            Snapshot->OccupiedCenters.push_back(Location.Y);
+            Snapshot->OccupiedCenters.push_back(Location.Z);
+        }
+    }
+    
+    Snapshot->AirPoints.resize(AirVoxels.size(), 3);
+    Snapshot->AirColours.resize(AirVoxels.size(), 3);
+    
+    for (int i = 0; i < AirVoxels.size(); ++i)
+    {
+        PLVector Location;
+        Scene.GetVoxelPosition(AirVoxels[i], &Location);
+        Snapshot->AirPoints.row(i) << Location.X, Location.Y, Location.Z;
+        
+        if (AirColouring == Colouring_Pressure)
+        {
+            // Blue for silence through to red for the loudest voxel
+            const double Level = MaxPressure > 0.0 ? std::abs(Grid->Voxels[AirVoxels[i]].AirPressure) / MaxPressure : 0.0;
+            Snapshot->AirColours.row(i) = HueToColour(0.66 * (1.0 - std::sqrt(Level)));
+        }
+        else if (Regions && Regions->IsActive(AirVoxels[i]))
+        {
+            // Spread the hues out so neighbouring region numbers don't look alike
+            Snapshot->AirColours.row(i) = HueToColour(std::fmod(Regions->GetRegion(AirVoxels[i]) * 0.618033988749895, 1.0));
+        }
+        else if (Regions)
+        {
+            Snapshot->AirColours.row(i) << 0.5, 0.5, 0.5;
+        }
+        else
+        {
+            Snapshot->AirColours.row(i) << 0.6, 0.8, 1.0;
+        }
     }
     
-    return PL_ERR;
+    boost::mutex::scoped_lock Lock (SnapshotMutex);
+    Latest = std::move(Snapshot);
+    ++Version;
 }
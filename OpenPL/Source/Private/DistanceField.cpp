@@ -0,0 +1,200 @@
+/*
+  ==============================================================================
+  
+    DistanceField.cpp
+    Created: 18 Oct 2026 1:34:58pm
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#include "DistanceField.h"
+#include <boost/timer/timer.hpp>
+#include <limits>
+#include <cmath>
+
+namespace
+{
+    const uint32_t Infinite = std::numeric_limits<uint32_t>::max();
+    
+    /**
+     * Scratch space for transforming one line of the lattice. One per thread.
+     */
+    struct LineBuffers
+    {
+        std::vector<uint32_t> Values;
+        std::vector<int> Parabolas;
+        std::vector<double> Boundaries;
+        
+        explicit LineBuffers(int Length)
+        :   Values(Length), Parabolas(Length), Boundaries(Length + 1)
+        { }
+    };
+    
+    /**
+     * 1D squared distance transform of a strided line, in place.
+     * Finds the lower envelope of the parabolas rooted at each finite value, then samples it.
+     */
+    void TransformLine(uint32_t* Line, size_t Stride, int Length, LineBuffers& Buffers)
+    {
+        uint32_t* Values = Buffers.Values.data();
+        int* Parabolas = Buffers.Parabolas.data();
+        double* Boundaries = Buffers.Boundaries.data();
+        
+        for (int q = 0; q < Length; ++q)
+        {
+            Values[q] = Line[q * Stride];
+        }
+        
+        int k = -1;
+        
+        for (int q = 0; q < Length; ++q)
+        {
+            if (Values[q] == Infinite)
+            {
+                continue;
+            }
+            
+            if (k < 0)
+            {
+                k = 0;
+                Parabolas[0] = q;
+                Boundaries[0] = -std::numeric_limits<double>::infinity();
+                Boundaries[1] = std::numeric_limits<double>::infinity();
+                continue;
+            }
+            
+            double Intersection;
+            while (true)
+            {
+                const int p = Parabolas[k];
+                Intersection = ((Values[q] + static_cast<double>(q) * q) - (Values[p] + static_cast<double>(p) * p)) / (2.0 * (q - p));
+                
+                // Boundaries[0] is -infinity so this always stops at the first parabola
+                if (Intersection > Boundaries[k])
+                {
+                    break;
+                }
+                
+                --k;
+            }
+            
+            ++k;
+            Parabolas[k] = q;
+            Boundaries[k] = Intersection;
+            Boundaries[k + 1] = std::numeric_limits<double>::infinity();
+        }
+        
+        // Nothing to measure from along this line
+        if (k < 0)
+        {
+            return;
+        }
+        
+        k = 0;
+        for (int q = 0; q < Length; ++q)
+        {
+            while (Boundaries[k + 1] < q)
+            {
+                ++k;
+            }
+            
+            const uint32_t Offset = static_cast<uint32_t>(q - Parabolas[k]);
+            Line[q * Stride] = Offset * Offset + Values[Parabolas[k]];
+        }
+    }
+}
+
+void DistanceField::Calculate(const PL_VOXEL_GRID& Grid)
+{
+    boost::timer::cpu_timer Timer;
+    
+    const int XSize = Grid.Size(0,0);
+    const int YSize = Grid.Size(0,1);
+    const int ZSize = Grid.Size(0,2);
+    const int NumVoxels = static_cast<int>(Grid.Voxels.size());
+    const size_t PlaneSize = static_cast<size_t>(XSize) * YSize;
+    
+    VoxelSize = Grid.VoxelSize;
+    
+    std::vector<uint32_t> SquaredDistances(NumVoxels);
+    
+    ParallelFor(0, NumVoxels, [&](int Begin, int End)
+    {
+        for (int i = Begin; i < End; ++i)
+        {
+            SquaredDistances[i] = Grid.Voxels[i].Beta == 0 ? 0 : Infinite;
+        }
+    });
+    
+    // Along X. Lines are contiguous
+    ParallelFor(0, YSize * ZSize, [&](int Begin, int End)
+    {
+        LineBuffers Buffers (XSize);
+        for (int Line = Begin; Line < End; ++Line)
+        {
+            TransformLine(&SquaredDistances[static_cast<size_t>(Line) * XSize], 1, XSize, Buffers);
+        }
+    });
+    
+    // Along Y. Neighbouring lines are neighbouring X so each thread walks memory close together
+    ParallelFor(0, XSize * ZSize, [&](int Begin, int End)
+    {
+        LineBuffers Buffers (YSize);
+        for (int Line = Begin; Line < End; ++Line)
+        {
+            const size_t X = Line % XSize;
+            const size_t Z = Line / XSize;
+            TransformLine(&SquaredDistances[X + Z * PlaneSize], XSize, YSize, Buffers);
+        }
+    });
+    
+    // Along Z
+    ParallelFor(0, static_cast<int>(PlaneSize), [&](int Begin, int End)
+    {
+        LineBuffers Buffers (ZSize);
+        for (int Line = Begin; Line < End; ++Line)
+        {
+            TransformLine(&SquaredDistances[Line], PlaneSize, ZSize, Buffers);
+        }
+    });
+    
+    Distances.resize(NumVoxels);
+    
+    ParallelFor(0, NumVoxels, [&](int Begin, int End)
+    {
+        for (int i = Begin; i < End; ++i)
+        {
+            if (SquaredDistances[i] == Infinite)
+            {
+                Distances[i] = Far;
+                continue;
+            }
+            
+            const double Distance = std::sqrt(static_cast<double>(SquaredDistances[i])) * Scale + 0.5;
+            Distances[i] = static_cast<uint16_t>(std::min(Distance, static_cast<double>(Far)));
+        }
+    });
+    
+    PL_LOG(PL_DEBUG_LEVEL_LOG, "Calculated distance field over " << NumVoxels << " voxels in " << Timer.elapsed().wall / 1e9 << "s");
+}
+
+uint16_t DistanceField::GetDistance(int VoxelIndex) const
+{
+    return Distances[VoxelIndex];
+}
+
+float DistanceField::GetDistanceInMeters(int VoxelIndex) const
+{
+    if (Distances[VoxelIndex] == Far)
+    {
+        return std::numeric_limits<float>::max();
+    }
+    
+    return Distances[VoxelIndex] * VoxelSize / Scale;
+}
+
+const std::vector<uint16_t>& DistanceField::GetDistances() const
+{
+    return Distances;
+}
@@ -0,0 +1,284 @@
+/*
+  ==============================================================================
+  
+    FastWindingNumber.cpp
+    Created: 19 Oct 2026 7:34:05am
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#include "FastWindingNumber.h"
+#include <cmath>
+#include <numeric>
+
+FastWindingNumber::FastWindingNumber(const VertexMatrix& Vertices, const IndiceMatrix& Indices)
+{
+    Corners.reserve(Indices.cols() * 3);
+    
+    for (int i = 0; i < Indices.cols(); ++i)
+    {
+        bool bValid = true;
+        
+        for (int Corner = 0; Corner < 3; ++Corner)
+        {
+            bValid = bValid && Indices(Corner, i) >= 0 && Indices(Corner, i) < Vertices.cols();
+        }
+        
+        if (!bValid)
+        {
+            continue;
+        }
+        
+        for (int Corner = 0; Corner < 3; ++Corner)
+        {
+            const Eigen::Vector3f Position = Vertices.col(Indices(Corner, i)).cast<float>();
+            Corners.push_back(Position);
+            Bounds.extend(Position);
+        }
+    }
+    
+    if (!Corners.empty())
+    {
+        Nodes.reserve(2 * (Corners.size() / 3) / MaxLeafTriangles + 1);
+        Nodes.emplace_back();
+        Build(0, 0, static_cast<int>(Corners.size() / 3));
+    }
+}
+
+void FastWindingNumber::Build(int NodeIndex, int FirstTriangle, int TriangleCount)
+{
+    Node Built;
+    Built.Centre = Eigen::Vector3f::Zero();
+    Built.Dipole = Eigen::Vector3f::Zero();
+    Built.Radius = 0.0f;
+    Built.FirstChild = -1;
+    Built.FirstTriangle = FirstTriangle;
+    Built.TriangleCount = TriangleCount;
+    
+    float Area = 0.0f;
+    Eigen::Vector3f Centroids = Eigen::Vector3f::Zero();
+    Eigen::AlignedBox3f CentroidBounds;
+    
+    for (int i = FirstTriangle; i < FirstTriangle + TriangleCount; ++i)
+    {
+        const Eigen::Vector3f* Triangle = &Corners[i * 3];
+        const Eigen::Vector3f AreaNormal = 0.5f * (Triangle[1] - Triangle[0]).cross(Triangle[2] - Triangle[0]);
+        const Eigen::Vector3f Centroid = (Triangle[0] + Triangle[1] + Triangle[2]) / 3.0f;
+        const float TriangleArea = AreaNormal.norm();
+        
+        Built.Dipole += AreaNormal;
+        Built.Centre += TriangleArea * Centroid;
+        Area += TriangleArea;
+        Centroids += Centroid;
+        CentroidBounds.extend(Centroid);
+    }
+    
+    // Slivers with no area still need a centre
+    Built.Centre = Area > 0.0f ? Eigen::Vector3f(Built.Centre / Area) : Eigen::Vector3f(Centroids / static_cast<float>(TriangleCount));
+    
+    for (int i = FirstTriangle * 3; i < (FirstTriangle + TriangleCount) * 3; ++i)
+    {
+        Built.Radius = std::max(Built.Radius, (Corners[i] - Built.Centre).norm());
+    }
+    
+    if (TriangleCount <= MaxLeafTriangles)
+    {
+        Nodes[NodeIndex] = Built;
+        return;
+    }
+    
+    // Split at the median centroid along the longest side
+    int Axis;
+    CentroidBounds.sizes().maxCoeff(&Axis);
+    
+    std::vector<int> Order (TriangleCount);
+    std::iota(Order.begin(), Order.end(), FirstTriangle);
+    
+    auto CentroidAlong = [this, Axis](int Triangle)
+    {
+        return Corners[Triangle * 3][Axis] + Corners[Triangle * 3 + 1][Axis] + Corners[Triangle * 3 + 2][Axis];
+    };
+    
+    const int Half = TriangleCount / 2;
+    std::nth_element(Order.begin(), Order.begin() + Half, Order.end(), [&](int First, int Second)
+    {
+        return CentroidAlong(First) < CentroidAlong(Second);
+    });
+    
+    std::vector<Eigen::Vector3f> Sorted (TriangleCount * 3);
+    
+    for (int i = 0; i < TriangleCount; ++i)
+    {
+        std::copy(&Corners[Order[i] * 3], &Corners[Order[i] * 3] + 3, &Sorted[i * 3]);
+    }
+    
+    std::copy(Sorted.begin(), Sorted.end(), &Corners[FirstTriangle * 3]);
+    
+    // Children are built depth first, so both slots are taken before either is filled to keep them next to each other
+    Built.FirstChild = static_cast<int>(Nodes.size());
+    Built.TriangleCount = 0;
+    Nodes[NodeIndex] = Built;
+    Nodes.resize(Nodes.size() + 2);
+    
+    Build(Built.FirstChild, FirstTriangle, Half);
+    Build(Built.FirstChild + 1, FirstTriangle + Half, TriangleCount - Half);
+}
+
+void FastWindingNumber::Evaluate(const float* X, const float* Y, const float* Z, int Count, float* OutWinding) const
+{
+    float SolidAngle[PacketSize] = {};
+    
+    if (Nodes.empty())
+    {
+        std::fill(OutWinding, OutWinding + Count, 0.0f);
+        return;
+    }
+    
+    // Halving the triangles at each level keeps the tree far shallower than this
+    int Stack[128];
+    int StackSize = 0;
+    Stack[StackSize++] = 0;
+    
+    while (StackSize > 0)
+    {
+        const Node& Current = Nodes[Stack[--StackSize]];
+        
+        const float CentreX = Current.Centre.x();
+        const float CentreY = Current.Centre.y();
+        const float CentreZ = Current.Centre.z();
+        const float OpenDistanceSquared = Beta * Beta * Current.Radius * Current.Radius;
+        
+        int Near = 0;
+        
+        for (int i = 0; i < Count; ++i)
+        {
+            const float DeltaX = CentreX - X[i];
+            const float DeltaY = CentreY - Y[i];
+            const float DeltaZ = CentreZ - Z[i];
+            Near += DeltaX * DeltaX + DeltaY * DeltaY + DeltaZ * DeltaZ <= OpenDistanceSquared ? 1 : 0;
+        }
+        
+        // Far from every point in the packet, so the whole node is one dipole
+        if (Near == 0)
+        {
+            const float DipoleX = Current.Dipole.x();
+            const float DipoleY = Current.Dipole.y();
+            const float DipoleZ = Current.Dipole.z();
+            
+            for (int i = 0; i < Count; ++i)
+            {
+                const float DeltaX = CentreX - X[i];
+                const float DeltaY = CentreY - Y[i];
+                const float DeltaZ = CentreZ - Z[i];
+                const float DistanceSquared = DeltaX * DeltaX + DeltaY * DeltaY + DeltaZ * DeltaZ;
+                SolidAngle[i] += (DipoleX * DeltaX + DipoleY * DeltaY + DipoleZ * DeltaZ) / (DistanceSquared * std::sqrt(DistanceSquared));
+            }
+            continue;
+        }
+        
+        if (Current.FirstChild >= 0)
+        {
+            Stack[StackSize++] = Current.FirstChild;
+            Stack[StackSize++] = Current.FirstChild + 1;
+            continue;
+        }
+        
+        // Exact solid angle of each triangle, from Van Oosterom and Strackee
+        for (int Triangle = Current.FirstTriangle; Triangle < Current.FirstTriangle + Current.TriangleCount; ++Triangle)
+        {
+            const Eigen::Vector3f* Corner = &Corners[Triangle * 3];
+            
+            for (int i = 0; i < Count; ++i)
+            {
+                const Eigen::Vector3f Point (X[i], Y[i], Z[i]);
+                const Eigen::Vector3f A = Corner[0] - Point;
+                const Eigen::Vector3f B = Corner[1] - Point;
+                const Eigen::Vector3f C = Corner[2] - Point;
+                const float LengthA = A.norm();
+                const float LengthB = B.norm();
+                const float LengthC = C.norm();
+                
+                const float Numerator = A.dot(B.cross(C));
+                const float Denominator = LengthA * LengthB * LengthC + A.dot(B) * LengthC + B.dot(C) * LengthA + C.dot(A) * LengthB;
+                SolidAngle[i] += 2.0f * std::atan2(Numerator, Denominator);
+            }
+        }
+    }
+    
+    for (int i = 0; i < Count; ++i)
+    {
+        OutWinding[i] = SolidAngle[i] / (4.0f * static_cast<float>(M_PI));
+    }
+}
+
+void FastWindingNumber::Fill(PL_VOXEL_GRID& Grid, const PLVector& BottomBackLeft, float Absorptivity) const
+{
+    if (Nodes.empty())
+    {
+        return;
+    }
+    
+    const int XSize = Grid.Size(0, 0);
+    const int YSize = Grid.Size(0, 1);
+    const int ZSize = Grid.Size(0, 2);
+    const float VoxelSize = Grid.VoxelSize;
+    const Eigen::Vector3f Corner (BottomBackLeft.X, BottomBackLeft.Y, BottomBackLeft.Z);
+    const Eigen::Vector3i Sizes (XSize, YSize, ZSize);
+    
+    // Voxels whose centres, at Corner + (i + 0.5) * VoxelSize, are inside the bounds
+    Eigen::Vector3i First;
+    Eigen::Vector3i Last;
+    
+    for (int Axis = 0; Axis < 3; ++Axis)
+    {
+        First[Axis] = std::max(0, static_cast<int>(std::ceil((Bounds.min()[Axis] - Corner[Axis]) / VoxelSize - 0.5f)));
+        Last[Axis] = std::min(Sizes[Axis] - 1, static_cast<int>(std::floor((Bounds.max()[Axis] - Corner[Axis]) / VoxelSize - 0.5f)));
+        
+        if (First[Axis] > Last[Axis])
+        {
+            return;
+        }
+    }
+    
+    ParallelFor(First.z(), Last.z() + 1, [&](int FirstZ, int EndZ)
+    {
+        float X[PacketSize];
+        float Y[PacketSize];
+        float Z[PacketSize];
+        float Winding[PacketSize];
+        
+        for (int z = FirstZ; z < EndZ; ++z)
+        {
+            for (int y = First.y(); y <= Last.y(); ++y)
+            {
+                for (int x = First.x(); x <= Last.x(); x += PacketSize)
+                {
+                    const int Count = std::min(PacketSize, Last.x() + 1 - x);
+                    
+                    for (int i = 0; i < Count; ++i)
+                    {
+                        X[i] = Corner.x() + (x + i + 0.5f) * VoxelSize;
+                        Y[i] = Corner.y() + (y + 0.5f) * VoxelSize;
+                        Z[i] = Corner.z() + (z + 0.5f) * VoxelSize;
+                    }
+                    
+                    Evaluate(X, Y, Z, Count, Winding);
+                    
+                    const int Row = ThreeDimToOneDim(x, y, z, XSize, YSize);
+                    
+                    // Either sign counts, so inside out meshes still fill
+                    for (int i = 0; i < Count; ++i)
+                    {
+                        if (std::abs(Winding[i]) >= 0.5f)
+                        {
+                            PLVoxel& Voxel = Grid.Voxels[Row + i];
+                            Voxel.Beta = 0;
+                            Voxel.Absorptivity = Absorptivity;
+                        }
+                    }
+                }
+            }
+        }
+    });
+}
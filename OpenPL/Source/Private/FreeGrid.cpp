@@ -47,7 +47,11 @@ double FreeGrid::SimulateFreeFieldEnergy(PL_SCENE* Scene)
     PLVector ScenePosition;
     Scene->GetScenePosition(&ScenePosition);
 
-    Scene->Simulate(ScenePosition);
+    if (Scene->Simulate(ScenePosition) != PL_OK)
+    {
+        return 0;
+    }
+    
     // generate a set of IRs in the grid, calculate the free energy
     Simulator* Simulator;
     Scene->GetSimulator(&Simulator);
@@ -0,0 +1,363 @@
+/*
+  ==============================================================================
+  
+    GeodesicField.cpp
+    Created: 18 Oct 2026 7:12:15pm
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#include "GeodesicField.h"
+#include <boost/thread/barrier.hpp>
+#include <boost/timer/timer.hpp>
+#include <limits>
+#include <atomic>
+#include <cmath>
+
+namespace
+{
+    const float Infinite = std::numeric_limits<float>::infinity();
+    
+    /** Smaller improvements than this, in voxels, don't count as the sweeps still changing the field*/
+    const float Tolerance = 1e-4f;
+    
+    float SignNotZero(float Value)
+    {
+        return Value < 0.0f ? -1.0f : 1.0f;
+    }
+}
+
+void GeodesicField::Calculate(const PL_VOXEL_GRID& Grid, int SourceIndex)
+{
+    boost::timer::cpu_timer Timer;
+    
+    const int XSize = Grid.Size(0,0);
+    const int YSize = Grid.Size(0,1);
+    const int ZSize = Grid.Size(0,2);
+    const int NumVoxels = static_cast<int>(Grid.Voxels.size());
+    const int Strides[3] = { 1, XSize, XSize * YSize };
+    
+    VoxelSize = Grid.VoxelSize;
+    this->SourceIndex = SourceIndex;
+    
+    Distances.assign(NumVoxels, Unreachable);
+    Directions.assign(NumVoxels, NoDirection);
+    
+    if (SourceIndex < 0 || SourceIndex >= NumVoxels || Grid.Voxels[SourceIndex].Beta == 0)
+    {
+        DebugWarn("Geodesic source isn't in open air. Nothing can be reached");
+        return;
+    }
+    
+    // Arrival time in voxels, and the unnormalised direction the path left the source in
+    std::vector<float> Times (NumVoxels, Infinite);
+    std::vector<Eigen::Vector3f> Paths (NumVoxels, Eigen::Vector3f::Zero());
+    
+    Times[SourceIndex] = 0.0f;
+    
+    int SourceX, SourceY, SourceZ;
+    IndexToThreeDim(SourceIndex, XSize, YSize, SourceX, SourceY, SourceZ);
+    const Eigen::Vector3f SourcePosition (SourceX, SourceY, SourceZ);
+    
+    // The upwind scheme is least accurate near a point source, where the wavefront curves the most.
+    // Start the voxels the source can see nearby at their exact distance instead
+    for (int z = std::max(0, SourceZ - ExactRadius); z <= std::min(ZSize - 1, SourceZ + ExactRadius); ++z)
+    {
+        for (int y = std::max(0, SourceY - ExactRadius); y <= std::min(YSize - 1, SourceY + ExactRadius); ++y)
+        {
+            for (int x = std::max(0, SourceX - ExactRadius); x <= std::min(XSize - 1, SourceX + ExactRadius); ++x)
+            {
+                const Eigen::Vector3f Offset = Eigen::Vector3f(x, y, z) - SourcePosition;
+                const float Distance = Offset.norm();
+                
+                if (Distance > ExactRadius || Distance == 0.0f)
+                {
+                    continue;
+                }
+                
+                // Sample the straight line at quarter voxel steps to check it stays in the air
+                bool bVisible = true;
+                const int Steps = static_cast<int>(std::ceil(Distance * 4.0f));
+                
+                for (int Step = 1; Step <= Steps && bVisible; ++Step)
+                {
+                    const Eigen::Vector3f Point = SourcePosition + Offset * (static_cast<float>(Step) / Steps);
+                    const int PointIndex = ThreeDimToOneDim(static_cast<int>(std::lround(Point.x())), static_cast<int>(std::lround(Point.y())), static_cast<int>(std::lround(Point.z())), XSize, YSize);
+                    bVisible = Grid.Voxels[PointIndex].Beta != 0;
+                }
+                
+                if (bVisible)
+                {
+                    const int Index = ThreeDimToOneDim(x, y, z, XSize, YSize);
+                    Times[Index] = Distance;
+                    Paths[Index] = Offset / Distance;
+                }
+            }
+        }
+    }
+    
+    // Godunov upwind update of one voxel from its lowest neighbour on each axis. Returns whether the time improved
+    auto Update = [&](int X, int Y, int Z)
+    {
+        const int Index = ThreeDimToOneDim(X, Y, Z, XSize, YSize);
+        
+        if (Index == SourceIndex || Grid.Voxels[Index].Beta == 0)
+        {
+            return false;
+        }
+        
+        const int Coordinates[3] = { X, Y, Z };
+        const int Sizes[3] = { XSize, YSize, ZSize };
+        
+        float Neighbours[3];
+        int NeighbourIndices[3];
+        
+        for (int Axis = 0; Axis < 3; ++Axis)
+        {
+            Neighbours[Axis] = Infinite;
+            NeighbourIndices[Axis] = -1;
+            
+            if (Coordinates[Axis] > 0 && Times[Index - Strides[Axis]] < Neighbours[Axis])
+            {
+                Neighbours[Axis] = Times[Index - Strides[Axis]];
+                NeighbourIndices[Axis] = Index - Strides[Axis];
+            }
+            
+            if (Coordinates[Axis] < Sizes[Axis] - 1 && Times[Index + Strides[Axis]] < Neighbours[Axis])
+            {
+                Neighbours[Axis] = Times[Index + Strides[Axis]];
+                NeighbourIndices[Axis] = Index + Strides[Axis];
+            }
+        }
+        
+        // Sort the axes so the lowest neighbour comes first
+        int Order[3] = { 0, 1, 2 };
+        
+        if (Neighbours[Order[1]] < Neighbours[Order[0]])
+        {
+            std::swap(Order[0], Order[1]);
+        }
+        
+        if (Neighbours[Order[2]] < Neighbours[Order[1]])
+        {
+            std::swap(Order[1], Order[2]);
+        }
+        
+        if (Neighbours[Order[1]] < Neighbours[Order[0]])
+        {
+            std::swap(Order[0], Order[1]);
+        }
+        
+        const float A = Neighbours[Order[0]];
+        const float B = Neighbours[Order[1]];
+        const float C = Neighbours[Order[2]];
+        
+        if (A == Infinite)
+        {
+            return false;
+        }
+        
+        float Time = A + 1.0f;
+        int UsedAxes = 1;
+        
+        if (Time > B)
+        {
+            Time = 0.5f * (A + B + std::sqrt(2.0f - (A - B) * (A - B)));
+            UsedAxes = 2;
+            
+            if (Time > C)
+            {
+                const float Sum = A + B + C;
+                Time = (Sum + std::sqrt(Sum * Sum - 3.0f * (A * A + B * B + C * C - 1.0f))) / 3.0f;
+                UsedAxes = 3;
+            }
+        }
+        
+        if (Time >= Times[Index] - Tolerance)
+        {
+            return false;
+        }
+        
+        Times[Index] = Time;
+        
+        // Blend the upwind neighbours' directions by how much each contributes to the gradient
+        Eigen::Vector3f Path = Eigen::Vector3f::Zero();
+        
+        for (int i = 0; i < UsedAxes; ++i)
+        {
+            const int NeighbourIndex = NeighbourIndices[Order[i]];
+            const float Weight = Time - Neighbours[Order[i]];
+            
+            Path += Weight * Paths[NeighbourIndex];
+        }
+        
+        // Only the source itself has no direction, and paths straight out of it leave towards this voxel
+        Paths[Index] = Path.isZero() ? (Eigen::Vector3f(X, Y, Z) - SourcePosition).normalized() : Path.normalized();
+        
+        return true;
+    };
+    
+    const int NumPlanes = XSize + YSize + ZSize - 2;
+    
+    // Whether anything changed, for alternate iterations, so one can be cleared while the other is still being read
+    std::atomic<bool> bChanged[2] = { { false }, { false } };
+    int Iteration = 0;
+    
+    // Eight sweeps an iteration, each with a barrier per plane, are too short to start threads for each, so the workers live for every iteration
+    ParallelWorkers(ZSize, [&](int Worker, int WorkerCount, boost::barrier& Barrier)
+    {
+        int FirstWorkerZ, EndWorkerZ;
+        GetParallelChunk(Worker, WorkerCount, 0, ZSize, FirstWorkerZ, EndWorkerZ);
+        
+        int WorkerIteration = 0;
+        
+        for (; WorkerIteration < MaxIterations; ++WorkerIteration)
+        {
+            std::atomic<bool>& bIterationChanged = bChanged[WorkerIteration & 1];
+            bool bWorkerChanged = false;
+            
+            for (int Sweep = 0; Sweep < 8; ++Sweep)
+            {
+                const bool bFlipX = Sweep & 1;
+                const bool bFlipY = Sweep & 2;
+                const bool bFlipZ = Sweep & 4;
+                
+                // Every cell on plane x + y + z = Plane only depends on cells of the plane before it in this sweep order
+                for (int Plane = 0; Plane < NumPlanes; ++Plane)
+                {
+                    const int FirstZ = std::max(FirstWorkerZ, Plane - (XSize - 1) - (YSize - 1));
+                    const int LastZ = std::min(EndWorkerZ - 1, Plane);
+                    
+                    for (int z = FirstZ; z <= LastZ; ++z)
+                    {
+                        const int FirstY = std::max(0, Plane - z - (XSize - 1));
+                        const int LastY = std::min(YSize - 1, Plane - z);
+                        
+                        for (int y = FirstY; y <= LastY; ++y)
+                        {
+                            const int x = Plane - z - y;
+                            bWorkerChanged |= Update(bFlipX ? XSize - 1 - x : x, bFlipY ? YSize - 1 - y : y, bFlipZ ? ZSize - 1 - z : z);
+                        }
+                    }
+                    
+                    Barrier.wait();
+                }
+            }
+            
+            if (bWorkerChanged)
+            {
+                bIterationChanged.store(true);
+            }
+            
+            // The next iteration's flag was last read an iteration ago, before this iteration's barriers
+            if (Worker == 0)
+            {
+                bChanged[(WorkerIteration + 1) & 1].store(false);
+            }
+            
+            Barrier.wait();
+            
+            if (!bIterationChanged.load())
+            {
+                break;
+            }
+        }
+        
+        if (Worker == 0)
+        {
+            Iteration = WorkerIteration;
+        }
+    });
+    
+    ParallelFor(0, NumVoxels, [&](int Begin, int End)
+    {
+        for (int i = Begin; i < End; ++i)
+        {
+            if (Times[i] == Infinite)
+            {
+                continue;
+            }
+            
+            Distances[i] = static_cast<uint16_t>(std::min(std::lround(Times[i] * Scale), static_cast<long>(Unreachable - 1)));
+            Directions[i] = i == SourceIndex ? NoDirection : EncodeDirection(Paths[i]);
+        }
+    });
+    
+    PL_LOG(PL_DEBUG_LEVEL_LOG, "Geodesic field swept " << std::min(Iteration + 1, MaxIterations) << " times in " << Timer.elapsed().wall / 1e9 << "s");
+}
+
+uint16_t GeodesicField::GetDistance(int VoxelIndex) const
+{
+    return Distances[VoxelIndex];
+}
+
+float GeodesicField::GetDistanceInMeters(int VoxelIndex) const
+{
+    const uint16_t Distance = Distances[VoxelIndex];
+    
+    if (Distance == Unreachable)
+    {
+        return std::numeric_limits<float>::max();
+    }
+    
+    return Distance * VoxelSize / Scale;
+}
+
+Eigen::Vector3f GeodesicField::GetDirection(int VoxelIndex) const
+{
+    return DecodeDirection(Directions[VoxelIndex]);
+}
+
+int GeodesicField::GetSourceIndex() const
+{
+    return SourceIndex;
+}
+
+uint16_t GeodesicField::EncodeDirection(const Eigen::Vector3f& Direction)
+{
+    const float Length = Direction.cwiseAbs().sum();
+    
+    if (!(Length > 0.0f))
+    {
+        return NoDirection;
+    }
+    
+    // Project onto the octahedron, then fold the bottom half out over the top
+    const Eigen::Vector3f Projected = Direction / Length;
+    float U = Projected.x();
+    float V = Projected.y();
+    
+    if (Projected.z() < 0.0f)
+    {
+        U = (1.0f - std::abs(Projected.y())) * SignNotZero(Projected.x());
+        V = (1.0f - std::abs(Projected.x())) * SignNotZero(Projected.y());
+    }
+    
+    const uint8_t EncodedU = static_cast<uint8_t>(static_cast<int8_t>(std::lround(U * 127.0f)));
+    const uint8_t EncodedV = static_cast<uint8_t>(static_cast<int8_t>(std::lround(V * 127.0f)));
+    
+    return static_cast<uint16_t>(EncodedU | (EncodedV << 8));
+}
+
+Eigen::Vector3f GeodesicField::DecodeDirection(uint16_t Encoded)
+{
+    if (Encoded == NoDirection)
+    {
+        return Eigen::Vector3f::Zero();
+    }
+    
+    const float U = static_cast<int8_t>(Encoded & 0xFF) / 127.0f;
+    const float V = static_cast<int8_t>(Encoded >> 8) / 127.0f;
+    
+    Eigen::Vector3f Direction (U, V, 1.0f - std::abs(U) - std::abs(V));
+    
+    if (Direction.z() < 0.0f)
+    {
+        const float X = Direction.x();
+        Direction.x() = (1.0f - std::abs(Direction.y())) * SignNotZero(X);
+        Direction.y() = (1.0f - std::abs(X)) * SignNotZero(Direction.y());
+    }
+    
+    return Direction.normalized();
+}
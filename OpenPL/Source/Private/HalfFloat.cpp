@@ -0,0 +1,127 @@
+/*
+  ==============================================================================
+  
+    HalfFloat.cpp
+    Created: 19 Oct 2026 1:21:40am
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#include "HalfFloat.h"
+#include <cstring>
+#include <cmath>
+
+#if defined(__F16C__) || defined(__AVX2__)
+    #include <immintrin.h>
+    #define PL_HAS_F16C 1
+#else
+    #define PL_HAS_F16C 0
+#endif
+
+uint16_t FloatToHalf(float Value)
+{
+    uint32_t Bits;
+    std::memcpy(&Bits, &Value, sizeof(Bits));
+    
+    const uint16_t Sign = static_cast<uint16_t>((Bits >> 16) & 0x8000);
+    const uint32_t Magnitude = Bits & 0x7FFFFFFF;
+    
+    // NaN stays NaN and anything too big for a half becomes infinity
+    if (Magnitude > 0x7F800000)
+    {
+        return Sign | 0x7E00;
+    }
+    
+    if (Magnitude >= 0x477FF000)
+    {
+        return Sign | 0x7C00;
+    }
+    
+    // Too small for a normal half. Shift the mantissa down into a subnormal, rounding to nearest even
+    if (Magnitude < 0x38800000)
+    {
+        const int Shift = 113 - static_cast<int>(Magnitude >> 23);
+        
+        // Under half the smallest subnormal, so it rounds to zero
+        if (Shift > 11)
+        {
+            return Sign;
+        }
+        
+        const uint32_t Mantissa = (Magnitude & 0x007FFFFF) | 0x00800000;
+        const uint32_t Halfway = 1u << (Shift + 12);
+        const uint32_t Remainder = Mantissa & ((Halfway << 1) - 1);
+        uint32_t Result = Mantissa >> (Shift + 13);
+        
+        if (Remainder > Halfway || (Remainder == Halfway && (Result & 1)))
+        {
+            ++Result;
+        }
+        
+        return Sign | static_cast<uint16_t>(Result);
+    }
+    
+    // Rebias the exponent from 127 to 15 and round the mantissa from 23 to 10 bits, to nearest even
+    const uint32_t Rebiased = Magnitude - 0x38000000;
+    const uint32_t Result = (Rebiased + 0x0FFF + ((Rebiased >> 13) & 1)) >> 13;
+    
+    return Sign | static_cast<uint16_t>(Result);
+}
+
+float HalfToFloat(uint16_t Half)
+{
+    const uint32_t Sign = static_cast<uint32_t>(Half & 0x8000) << 16;
+    const uint32_t Exponent = (Half >> 10) & 0x1F;
+    const uint32_t Mantissa = Half & 0x03FF;
+    
+    // Subnormals are just the mantissa in units of the smallest one, 2^-24
+    if (Exponent == 0)
+    {
+        const float Magnitude = std::ldexp(static_cast<float>(Mantissa), -24);
+        return Sign ? -Magnitude : Magnitude;
+    }
+    
+    // Infinity and NaN keep their mantissa
+    const uint32_t Bits = Exponent == 0x1F ? Sign | 0x7F800000 | (Mantissa << 13) : Sign | ((Exponent + 112) << 23) | (Mantissa << 13);
+    
+    float Value;
+    std::memcpy(&Value, &Bits, sizeof(Value));
+    return Value;
+}
+
+void FloatsToHalves(const float* Values, uint16_t* OutHalves, int Count)
+{
+    int i = 0;
+
+#if PL_HAS_F16C
+    for (; i + 8 <= Count; i += 8)
+    {
+        const __m128i Halves = _mm256_cvtps_ph(_mm256_loadu_ps(Values + i), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(OutHalves + i), Halves);
+    }
+#endif
+
+    for (; i < Count; ++i)
+    {
+        OutHalves[i] = FloatToHalf(Values[i]);
+    }
+}
+
+void HalvesToFloats(const uint16_t* Halves, float* OutValues, int Count)
+{
+    int i = 0;
+
+#if PL_HAS_F16C
+    for (; i + 8 <= Count; i += 8)
+    {
+        const __m128i Loaded = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Halves + i));
+        _mm256_storeu_ps(OutValues + i, _mm256_cvtph_ps(Loaded));
+    }
+#endif
+
+    for (; i < Count; ++i)
+    {
+        OutValues[i] = HalfToFloat(Halves[i]);
+    }
+}
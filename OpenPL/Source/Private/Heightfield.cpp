@@ -0,0 +1,84 @@
+/*
+  ==============================================================================
+  
+    Heightfield.cpp
+    Created: 19 Oct 2026 5:48:31am
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#include "Heightfield.h"
+#include <cmath>
+
+Heightfield::Heightfield(const PLVector& Origin, float Spacing, int Rows, int Columns, const float* Heights, float Absorptivity)
+:   Origin(Origin),
+    Spacing(Spacing),
+    Rows(Rows),
+    Columns(Columns),
+    Heights(Heights, Heights + static_cast<size_t>(Rows) * Columns),
+    Absorptivity(Absorptivity)
+{ }
+
+bool Heightfield::GetHeight(float X, float Z, float& OutHeight) const
+{
+    const float Column = (X - Origin.X) / Spacing;
+    const float Row = (Z - Origin.Z) / Spacing;
+    
+    if (Column < 0.0f || Row < 0.0f || Column > Columns - 1 || Row > Rows - 1)
+    {
+        return false;
+    }
+    
+    // The last row and column interpolate from the one before, so the far edge is still inside
+    const int Column0 = std::min(static_cast<int>(Column), Columns - 2);
+    const int Row0 = std::min(static_cast<int>(Row), Rows - 2);
+    const float FractionX = Column - Column0;
+    const float FractionZ = Row - Row0;
+    
+    const float* Near = &Heights[static_cast<size_t>(Row0) * Columns + Column0];
+    const float* Far = Near + Columns;
+    
+    const float NearHeight = Near[0] + (Near[1] - Near[0]) * FractionX;
+    const float FarHeight = Far[0] + (Far[1] - Far[0]) * FractionX;
+    
+    OutHeight = Origin.Y + NearHeight + (FarHeight - NearHeight) * FractionZ;
+    return true;
+}
+
+void Heightfield::Fill(PL_VOXEL_GRID& Grid, const PLVector& BottomBackLeft) const
+{
+    const int XSize = Grid.Size(0, 0);
+    const int YSize = Grid.Size(0, 1);
+    const int ZSize = Grid.Size(0, 2);
+    const float VoxelSize = Grid.VoxelSize;
+    
+    ParallelFor(0, ZSize, [&](int FirstZ, int EndZ)
+    {
+        for (int z = FirstZ; z < EndZ; ++z)
+        {
+            const float CentreZ = BottomBackLeft.Z + (z + 0.5f) * VoxelSize;
+            
+            for (int x = 0; x < XSize; ++x)
+            {
+                const float CentreX = BottomBackLeft.X + (x + 0.5f) * VoxelSize;
+                float Height;
+                
+                if (!GetHeight(CentreX, CentreZ, Height))
+                {
+                    continue;
+                }
+                
+                // Voxels whose centre is at or below the height
+                const int Filled = std::max(0, std::min(YSize, static_cast<int>(std::floor((Height - BottomBackLeft.Y) / VoxelSize + 0.5f))));
+                
+                for (int y = 0; y < Filled; ++y)
+                {
+                    PLVoxel& Voxel = Grid.Voxels[ThreeDimToOneDim(x, y, z, XSize, YSize)];
+                    Voxel.Beta = 0;
+                    Voxel.Absorptivity = Absorptivity;
+                }
+            }
+        }
+    });
+}
@@ -0,0 +1,566 @@
+/*
+  ==============================================================================
+  
+    HelmholtzSolver.cpp
+    Created: 19 Oct 2026 1:42:10am
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#include "HelmholtzSolver.h"
+#include <boost/timer/timer.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    typedef HelmholtzSolver::Complex Complex;
+    
+    /** Levels smaller than this many cells are swept on one thread. Starting the threads would take longer than the sweep*/
+    const int MinParallelCells = 32768;
+    
+    /** Cells summed into each partial of a dot product*/
+    const int DotBlockCells = 4096;
+    
+    constexpr double Pi = 3.14159265358979323846;
+    
+    /**
+     * Calls Function(FirstZ, EndZ) over every Z slab of a level, on several threads if the level is big enough.
+     */
+    template <typename FunctionType>
+    void ForEachSlab(int ZSize, int CellCount, const FunctionType& Function)
+    {
+        if (CellCount < MinParallelCells)
+        {
+            Function(0, ZSize);
+        }
+        else
+        {
+            ParallelFor(0, ZSize, Function);
+        }
+    }
+    
+    /**
+     * Complex product without the checks for infinite parts that the standard operator makes, which stop it being inlined.
+     */
+    inline Complex Multiply(const Complex& A, const Complex& B)
+    {
+        return Complex(A.real() * B.real() - A.imag() * B.imag(), A.real() * B.imag() + A.imag() * B.real());
+    }
+    
+    /**
+     * Out = A + Scale * B.
+     */
+    void AddScaled(const std::vector<Complex>& A, Complex Scale, const std::vector<Complex>& B, std::vector<Complex>& Out)
+    {
+        for (size_t i = 0; i < Out.size(); ++i)
+        {
+            Out[i] = A[i] + Multiply(Scale, B[i]);
+        }
+    }
+    
+    double Norm(const std::vector<Complex>& Vector)
+    {
+        double Sum = 0.0;
+        
+        for (const Complex& Value : Vector)
+        {
+            Sum += std::norm(Value);
+        }
+        
+        return std::sqrt(Sum);
+    }
+}
+
+void HelmholtzSolver::Build(const PL_VOXEL_GRID& Grid)
+{
+    VoxelSize = Grid.VoxelSize;
+    Levels.clear();
+    
+    Level Fine;
+    Fine.XSize = Grid.Size(0,0);
+    Fine.YSize = Grid.Size(0,1);
+    Fine.ZSize = Grid.Size(0,2);
+    
+    const int CellCount = Fine.GetCellCount();
+    Fine.Volume.assign(CellCount, 0.0f);
+    Fine.Admittance.assign(CellCount, 0.0f);
+    Fine.EdgeFaces.assign(CellCount, 0.0f);
+    Fine.ConductanceX.assign(CellCount, 0.0f);
+    Fine.ConductanceY.assign(CellCount, 0.0f);
+    Fine.ConductanceZ.assign(CellCount, 0.0f);
+    
+    const int Sizes[3] = { Fine.XSize, Fine.YSize, Fine.ZSize };
+    const int Strides[3] = { 1, Fine.XSize, Fine.XSize * Fine.YSize };
+    std::vector<float>* Conductances[3] = { &Fine.ConductanceX, &Fine.ConductanceY, &Fine.ConductanceZ };
+    
+    for (int z = 0; z < Fine.ZSize; ++z)
+    {
+        for (int y = 0; y < Fine.YSize; ++y)
+        {
+            for (int x = 0; x < Fine.XSize; ++x)
+            {
+                const int Index = Fine.GetIndex(x, y, z);
+                
+                if (Grid.Voxels[Index].Beta == 0)
+                {
+                    continue;
+                }
+                
+                Fine.Volume[Index] = 1.0f;
+                
+                const int Position[3] = { x, y, z };
+                
+                for (int Axis = 0; Axis < 3; ++Axis)
+                {
+                    for (int Direction = -1; Direction <= 1; Direction += 2)
+                    {
+                        const int NeighbourPosition = Position[Axis] + Direction;
+                        
+                        // Matched edge, so sound leaving the lattice carries on outwards
+                        if (NeighbourPosition < 0 || NeighbourPosition >= Sizes[Axis])
+                        {
+                            Fine.EdgeFaces[Index] += 1.0f;
+                            continue;
+                        }
+                        
+                        const PLVoxel& Neighbour = Grid.Voxels[Index + Direction * Strides[Axis]];
+                        
+                        if (Neighbour.Beta != 0)
+                        {
+                            if (Direction > 0)
+                            {
+                                (*Conductances[Axis])[Index] = 1.0f;
+                            }
+                            
+                            continue;
+                        }
+                        
+                        Fine.Admittance[Index] += static_cast<float>((1.0 - Neighbour.Absorptivity) / (1.0 + Neighbour.Absorptivity));
+                    }
+                }
+            }
+        }
+    }
+    
+    Levels.push_back(std::move(Fine));
+    
+    while (std::max(Levels.back().XSize, std::max(Levels.back().YSize, Levels.back().ZSize)) > CoarsestSize)
+    {
+        Levels.push_back(Coarsen(Levels.back()));
+    }
+    
+    for (Level& Grid : Levels)
+    {
+        Grid.Solution.assign(Grid.GetCellCount(), Complex());
+        Grid.RightHandSide.assign(Grid.GetCellCount(), Complex());
+        Grid.Residual.assign(Grid.GetCellCount(), Complex());
+    }
+    
+    PL_LOG_VERBOSE("Helmholtz solver has " << Levels.size() << " multigrid levels");
+}
+
+HelmholtzSolver::Level HelmholtzSolver::Coarsen(const Level& Fine)
+{
+    Level Coarse;
+    Coarse.XSize = (Fine.XSize + 1) / 2;
+    Coarse.YSize = (Fine.YSize + 1) / 2;
+    Coarse.ZSize = (Fine.ZSize + 1) / 2;
+    
+    const int CellCount = Coarse.GetCellCount();
+    Coarse.Volume.assign(CellCount, 0.0f);
+    Coarse.Admittance.assign(CellCount, 0.0f);
+    Coarse.EdgeFaces.assign(CellCount, 0.0f);
+    Coarse.ConductanceX.assign(CellCount, 0.0f);
+    Coarse.ConductanceY.assign(CellCount, 0.0f);
+    Coarse.ConductanceZ.assign(CellCount, 0.0f);
+    
+    // Conductance is face area over the distance between cell centers. Axes that are already 1 cell across don't shrink, so their distances don't grow
+    const float StepX = Fine.XSize > 1 ? 2.0f : 1.0f;
+    const float StepY = Fine.YSize > 1 ? 2.0f : 1.0f;
+    const float StepZ = Fine.ZSize > 1 ? 2.0f : 1.0f;
+    
+    for (int z = 0; z < Fine.ZSize; ++z)
+    {
+        for (int y = 0; y < Fine.YSize; ++y)
+        {
+            for (int x = 0; x < Fine.XSize; ++x)
+            {
+                const int FineIndex = Fine.GetIndex(x, y, z);
+                const int CoarseIndex = Coarse.GetIndex(x / 2, y / 2, z / 2);
+                
+                Coarse.Volume[CoarseIndex] += Fine.Volume[FineIndex];
+                Coarse.Admittance[CoarseIndex] += Fine.Admittance[FineIndex];
+                Coarse.EdgeFaces[CoarseIndex] += Fine.EdgeFaces[FineIndex];
+                
+                // Faces inside the coarse cell disappear. Faces on its boundary add up
+                if (x % 2 == 1 || Fine.XSize == 1)
+                {
+                    Coarse.ConductanceX[CoarseIndex] += Fine.ConductanceX[FineIndex] / StepX;
+                }
+                
+                if (y % 2 == 1 || Fine.YSize == 1)
+                {
+                    Coarse.ConductanceY[CoarseIndex] += Fine.ConductanceY[FineIndex] / StepY;
+                }
+                
+                if (z % 2 == 1 || Fine.ZSize == 1)
+                {
+                    Coarse.ConductanceZ[CoarseIndex] += Fine.ConductanceZ[FineIndex] / StepZ;
+                }
+            }
+        }
+    }
+    
+    return Coarse;
+}
+
+void HelmholtzSolver::Apply(const Level& Grid, Complex Shift, const std::vector<Complex>& In, std::vector<Complex>& Out) const
+{
+    const Complex MassScale = -Shift * Wavenumber * Wavenumber;
+    const Complex LossScale (0.0, Wavenumber);
+    const int StrideY = Grid.XSize;
+    const int StrideZ = Grid.XSize * Grid.YSize;
+    
+    ForEachSlab(Grid.ZSize, Grid.GetCellCount(), [&](int FirstZ, int EndZ)
+    {
+        for (int z = FirstZ; z < EndZ; ++z)
+        {
+            for (int y = 0; y < Grid.YSize; ++y)
+            {
+                for (int x = 0; x < Grid.XSize; ++x)
+                {
+                    const int Index = Grid.GetIndex(x, y, z);
+                    const Complex Pressure = In[Index];
+                    
+                    // Geometry rows are the identity, so the pressure there stays at whatever it's set to, which is 0
+                    if (Grid.Volume[Index] == 0.0f)
+                    {
+                        Out[Index] = Pressure;
+                        continue;
+                    }
+                    
+                    Complex Sum = Multiply(MassScale * static_cast<double>(Grid.Volume[Index]) + LossScale * static_cast<double>(Grid.Admittance[Index]) + EdgeLoss * static_cast<double>(Grid.EdgeFaces[Index]), Pressure);
+                    
+                    Sum += static_cast<double>(Grid.ConductanceX[Index]) * (Pressure - (x + 1 < Grid.XSize ? In[Index + 1] : Complex()));
+                    Sum += static_cast<double>(Grid.ConductanceY[Index]) * (Pressure - (y + 1 < Grid.YSize ? In[Index + StrideY] : Complex()));
+                    Sum += static_cast<double>(Grid.ConductanceZ[Index]) * (Pressure - (z + 1 < Grid.ZSize ? In[Index + StrideZ] : Complex()));
+                    
+                    if (x > 0)
+                    {
+                        Sum += static_cast<double>(Grid.ConductanceX[Index - 1]) * (Pressure - In[Index - 1]);
+                    }
+                    
+                    if (y > 0)
+                    {
+                        Sum += static_cast<double>(Grid.ConductanceY[Index - StrideY]) * (Pressure - In[Index - StrideY]);
+                    }
+                    
+                    if (z > 0)
+                    {
+                        Sum += static_cast<double>(Grid.ConductanceZ[Index - StrideZ]) * (Pressure - In[Index - StrideZ]);
+                    }
+                    
+                    Out[Index] = Sum;
+                }
+            }
+        }
+    });
+}
+
+void HelmholtzSolver::Smooth(Level& Grid, int Sweeps)
+{
+    const Complex Shift (1.0, -ShiftDamping);
+    const Complex MassScale = -Shift * Wavenumber * Wavenumber;
+    const Complex LossScale (0.0, Wavenumber);
+    const int StrideY = Grid.XSize;
+    const int StrideZ = Grid.XSize * Grid.YSize;
+    
+    for (int Sweep = 0; Sweep < Sweeps; ++Sweep)
+    {
+        Apply(Grid, Shift, Grid.Solution, Grid.Residual);
+        
+        ForEachSlab(Grid.ZSize, Grid.GetCellCount(), [&](int FirstZ, int EndZ)
+        {
+            for (int z = FirstZ; z < EndZ; ++z)
+            {
+                for (int y = 0; y < Grid.YSize; ++y)
+                {
+                    for (int x = 0; x < Grid.XSize; ++x)
+                    {
+                        const int Index = Grid.GetIndex(x, y, z);
+                        
+                        if (Grid.Volume[Index] == 0.0f)
+                        {
+                            continue;
+                        }
+                        
+                        double Conductance = Grid.ConductanceX[Index] + Grid.ConductanceY[Index] + Grid.ConductanceZ[Index];
+                        Conductance += x > 0 ? Grid.ConductanceX[Index - 1] : 0.0f;
+                        Conductance += y > 0 ? Grid.ConductanceY[Index - StrideY] : 0.0f;
+                        Conductance += z > 0 ? Grid.ConductanceZ[Index - StrideZ] : 0.0f;
+                        
+                        const Complex Diagonal = Conductance + MassScale * static_cast<double>(Grid.Volume[Index]) + LossScale * static_cast<double>(Grid.Admittance[Index]) + EdgeLoss * static_cast<double>(Grid.EdgeFaces[Index]);
+                        const Complex Scale = JacobiWeight * std::conj(Diagonal) / std::norm(Diagonal);
+                        
+                        Grid.Solution[Index] += Multiply(Scale, Grid.RightHandSide[Index] - Grid.Residual[Index]);
+                    }
+                }
+            }
+        });
+    }
+}
+
+void HelmholtzSolver::VCycle(int LevelIndex)
+{
+    Level& Fine = Levels[LevelIndex];
+    std::fill(Fine.Solution.begin(), Fine.Solution.end(), Complex());
+    
+    if (LevelIndex + 1 == static_cast<int>(Levels.size()))
+    {
+        Smooth(Fine, CoarsestSweeps);
+        return;
+    }
+    
+    Smooth(Fine, SmoothingSweeps);
+    
+    Apply(Fine, Complex(1.0, -ShiftDamping), Fine.Solution, Fine.Residual);
+    
+    // Restricting by adding up the children keeps the coarse right hand side in the same finite volume units as its coefficients
+    Level& Coarse = Levels[LevelIndex + 1];
+    std::fill(Coarse.RightHandSide.begin(), Coarse.RightHandSide.end(), Complex());
+    
+    for (int z = 0; z < Fine.ZSize; ++z)
+    {
+        for (int y = 0; y < Fine.YSize; ++y)
+        {
+            for (int x = 0; x < Fine.XSize; ++x)
+            {
+                const int Index = Fine.GetIndex(x, y, z);
+                
+                if (Fine.Volume[Index] != 0.0f)
+                {
+                    Coarse.RightHandSide[Coarse.GetIndex(x / 2, y / 2, z / 2)] += Fine.RightHandSide[Index] - Fine.Residual[Index];
+                }
+            }
+        }
+    }
+    
+    VCycle(LevelIndex + 1);
+    
+    for (int z = 0; z < Fine.ZSize; ++z)
+    {
+        for (int y = 0; y < Fine.YSize; ++y)
+        {
+            for (int x = 0; x < Fine.XSize; ++x)
+            {
+                const int Index = Fine.GetIndex(x, y, z);
+                
+                if (Fine.Volume[Index] == 0.0f)
+                {
+                    continue;
+                }
+                
+                // Trilinear between the centers of the coarse cells around the fine one, weighted 3/4 to the parent and 1/4 to the next cell along each axis.
+                // Geometry cells are left out so walls don't pull the correction towards 0
+                const int Position[3] = { x, y, z };
+                const int CoarseSizes[3] = { Coarse.XSize, Coarse.YSize, Coarse.ZSize };
+                int Parents[3];
+                int Others[3];
+                
+                for (int Axis = 0; Axis < 3; ++Axis)
+                {
+                    Parents[Axis] = Position[Axis] / 2;
+                    Others[Axis] = Parents[Axis] + (Position[Axis] % 2 == 0 ? -1 : 1);
+                    Others[Axis] = Others[Axis] < 0 || Others[Axis] >= CoarseSizes[Axis] ? Parents[Axis] : Others[Axis];
+                }
+                
+                Complex Correction;
+                double TotalWeight = 0.0;
+                
+                for (int Corner = 0; Corner < 8; ++Corner)
+                {
+                    const int CornerX = Corner & 1 ? Others[0] : Parents[0];
+                    const int CornerY = Corner & 2 ? Others[1] : Parents[1];
+                    const int CornerZ = Corner & 4 ? Others[2] : Parents[2];
+                    const int CoarseIndex = Coarse.GetIndex(CornerX, CornerY, CornerZ);
+                    
+                    if (Coarse.Volume[CoarseIndex] == 0.0f)
+                    {
+                        continue;
+                    }
+                    
+                    const double Weight = (Corner & 1 ? 0.25 : 0.75) * (Corner & 2 ? 0.25 : 0.75) * (Corner & 4 ? 0.25 : 0.75);
+                    Correction += Weight * Coarse.Solution[CoarseIndex];
+                    TotalWeight += Weight;
+                }
+                
+                Fine.Solution[Index] += Correction / TotalWeight;
+            }
+        }
+    }
+    
+    Smooth(Fine, SmoothingSweeps);
+}
+
+void HelmholtzSolver::Precondition(const std::vector<Complex>& In, std::vector<Complex>& Out)
+{
+    Levels[0].RightHandSide = In;
+    VCycle(0);
+    Out = Levels[0].Solution;
+}
+
+HelmholtzSolver::Complex HelmholtzSolver::Dot(const std::vector<Complex>& A, const std::vector<Complex>& B)
+{
+    // Blocks are summed into their own partials and added up in order, so the result doesn't change with the thread count or timing
+    const int CellCount = static_cast<int>(A.size());
+    const int BlockCount = (CellCount + DotBlockCells - 1) / DotBlockCells;
+    std::vector<Complex> Partials (BlockCount, Complex());
+    
+    ForEachSlab(BlockCount, CellCount, [&](int FirstBlock, int EndBlock)
+    {
+        for (int Block = FirstBlock; Block < EndBlock; ++Block)
+        {
+            const int End = std::min(CellCount, (Block + 1) * DotBlockCells);
+            Complex BlockSum;
+            
+            for (int i = Block * DotBlockCells; i < End; ++i)
+            {
+                BlockSum += Multiply(std::conj(A[i]), B[i]);
+            }
+            
+            Partials[Block] = BlockSum;
+        }
+    });
+    
+    Complex Sum;
+    
+    for (const Complex& Partial : Partials)
+    {
+        Sum += Partial;
+    }
+    
+    return Sum;
+}
+
+bool HelmholtzSolver::Solve(int SourceIndex, double Frequency, std::vector<Complex>& OutPressure, int* OutIterations)
+{
+    boost::timer::cpu_timer Timer;
+    
+    if (OutIterations)
+    {
+        *OutIterations = 0;
+    }
+    
+    if (Levels.empty() || SourceIndex < 0 || SourceIndex >= Levels[0].GetCellCount() || Levels[0].Volume[SourceIndex] == 0.0f)
+    {
+        DebugWarn("Helmholtz source isn't in the open air of a built lattice");
+        OutPressure.assign(Levels.empty() ? 0 : Levels[0].GetCellCount(), Complex());
+        return false;
+    }
+    
+    if (Frequency > GetMaxFrequency())
+    {
+        PL_LOG(PL_DEBUG_LEVEL_WARN, "Voxels are too big to resolve " << Frequency << "Hz. The phase will drift above " << GetMaxFrequency() << "Hz");
+    }
+    
+    Wavenumber = 2.0 * Pi * Frequency * VoxelSize / SpeedOfSound;
+    
+    // The flux through an edge face if the pressure beyond it were the outgoing wave, p e^(-ik'h). Past the lattice's highest wavenumber, k'h is clamped to pi
+    const double LatticeWavenumber = std::acos(std::max(-1.0, 1.0 - Wavenumber * Wavenumber / 2.0));
+    EdgeLoss = 1.0 - std::polar(1.0, -LatticeWavenumber);
+    
+    const Level& Fine = Levels[0];
+    const int CellCount = Fine.GetCellCount();
+    
+    // A point source of 4 pi / h has the free field e^(-ikr) / r, with r in meters
+    std::vector<Complex> RightHandSide (CellCount, Complex());
+    RightHandSide[SourceIndex] = 4.0 * Pi / VoxelSize;
+    
+    // Right preconditioned BiCGStab (van der Vorst), starting from 0
+    std::vector<Complex>& Solution = OutPressure;
+    Solution.assign(CellCount, Complex());
+    
+    std::vector<Complex> Residual = RightHandSide;
+    const std::vector<Complex> Shadow = RightHandSide;
+    std::vector<Complex> Direction (CellCount, Complex());
+    std::vector<Complex> PreconditionedDirection (CellCount, Complex());
+    std::vector<Complex> AppliedDirection (CellCount, Complex());
+    std::vector<Complex> Intermediate (CellCount, Complex());
+    std::vector<Complex> PreconditionedIntermediate (CellCount, Complex());
+    std::vector<Complex> AppliedIntermediate (CellCount, Complex());
+    
+    const double RightHandSideNorm = Norm(RightHandSide);
+    Complex Rho = 1.0;
+    Complex Alpha = 1.0;
+    Complex Omega = 1.0;
+    bool bConverged = false;
+    int Iteration = 0;
+    
+    while (Iteration < MaxIterations && !bConverged)
+    {
+        ++Iteration;
+        
+        const Complex NextRho = Dot(Shadow, Residual);
+        
+        if (std::abs(NextRho) == 0.0)
+        {
+            DebugWarn("Helmholtz solve broke down");
+            break;
+        }
+        
+        const Complex Beta = (NextRho / Rho) * (Alpha / Omega);
+        Rho = NextRho;
+        
+        for (int i = 0; i < CellCount; ++i)
+        {
+            Direction[i] = Residual[i] + Multiply(Beta, Direction[i] - Multiply(Omega, AppliedDirection[i]));
+        }
+        
+        Precondition(Direction, PreconditionedDirection);
+        Apply(Fine, 1.0, PreconditionedDirection, AppliedDirection);
+        
+        Alpha = Rho / Dot(Shadow, AppliedDirection);
+        AddScaled(Residual, -Alpha, AppliedDirection, Intermediate);
+        
+        if (Norm(Intermediate) <= Tolerance * RightHandSideNorm)
+        {
+            AddScaled(Solution, Alpha, PreconditionedDirection, Solution);
+            bConverged = true;
+            break;
+        }
+        
+        Precondition(Intermediate, PreconditionedIntermediate);
+        Apply(Fine, 1.0, PreconditionedIntermediate, AppliedIntermediate);
+        
+        Omega = Dot(AppliedIntermediate, Intermediate) / Dot(AppliedIntermediate, AppliedIntermediate);
+        
+        for (int i = 0; i < CellCount; ++i)
+        {
+            Solution[i] += Multiply(Alpha, PreconditionedDirection[i]) + Multiply(Omega, PreconditionedIntermediate[i]);
+        }
+        
+        AddScaled(Intermediate, -Omega, AppliedIntermediate, Residual);
+        bConverged = Norm(Residual) <= Tolerance * RightHandSideNorm;
+    }
+    
+    if (OutIterations)
+    {
+        *OutIterations = Iteration;
+    }
+    
+    if (!bConverged)
+    {
+        PL_LOG(PL_DEBUG_LEVEL_WARN, "Helmholtz solve at " << Frequency << "Hz didn't converge in " << Iteration << " iterations");
+    }
+    
+    PL_LOG_VERBOSE("Helmholtz solve at " << Frequency << "Hz took " << Iteration << " iterations: " << Timer.format());
+    
+    return bConverged;
+}
+
+double HelmholtzSolver::GetMaxFrequency() const
+{
+    return VoxelSize > 0.0f ? SpeedOfSound / (VoxelSize * VoxelsPerWavelength) : 0.0;
+}
@@ -0,0 +1,233 @@
+/*
+  ==============================================================================
+  
+    ImageSourceModel.cpp
+    Created: 18 Oct 2026 6:31:55pm
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#include "ImageSourceModel.h"
+#include "TriangleBVH.h"
+#include <boost/thread/mutex.hpp>
+
+namespace
+{
+    const float SpeedOfSound = 343.21f;
+    
+    /** Pressure reflection coefficient of the geometry. Matches the absorptivity given to closed voxels*/
+    const float ReflectionGain = std::sqrt(1.0f - 0.25f);
+    
+    /** Keeps the gain finite when the source and receiver are in the same place*/
+    const float MinPathLength = 0.1f;
+    
+    Eigen::Vector3f Mirror(const Eigen::Vector3f& Point, const TriangleBVH::Triangle& Triangle)
+    {
+        return Point - 2.0f * (Point - Triangle.A).dot(Triangle.Normal) * Triangle.Normal;
+    }
+    
+    bool IsCoplanar(const TriangleBVH::Triangle& A, const TriangleBVH::Triangle& B)
+    {
+        return std::abs(A.Normal.dot(B.Normal)) > 0.9999f && std::abs((B.A - A.A).dot(A.Normal)) < 1e-4f;
+    }
+    
+    ImageSourceModel::Reflection MakeReflection(float PathLength, int Order)
+    {
+        ImageSourceModel::Reflection NewReflection;
+        NewReflection.Delay = PathLength / SpeedOfSound;
+        NewReflection.Gain = std::pow(ReflectionGain, Order) / std::max(PathLength, MinPathLength);
+        NewReflection.Order = Order;
+        return NewReflection;
+    }
+    
+    /**
+     * Planes of the axis aligned box reaching MaxDistance from the receiver. 6 planes.
+     */
+    void MakeRangePlanes(const Eigen::Vector3f& Receiver, float MaxDistance, Eigen::Vector4f* OutPlanes)
+    {
+        for (int Axis = 0; Axis < 3; ++Axis)
+        {
+            const Eigen::Vector3f Normal = Eigen::Vector3f::Unit(Axis);
+            OutPlanes[Axis * 2] << Normal, MaxDistance - Receiver[Axis];
+            OutPlanes[Axis * 2 + 1] << -Normal, MaxDistance + Receiver[Axis];
+        }
+    }
+    
+    /**
+     * Planes of the beam from an image through the triangle it was mirrored in. 4 planes.
+     * The next reflection point of a valid path is inside it, as the leg back towards the image has to cross the triangle.
+     *
+     * @return False if the image is in the plane of the triangle, which has no beam.
+     */
+    bool MakeBeamPlanes(const Eigen::Vector3f& Image, const TriangleBVH::Triangle& Triangle, Eigen::Vector4f* OutPlanes)
+    {
+        const float ImageDistance = (Image - Triangle.A).dot(Triangle.Normal);
+        
+        if (std::abs(ImageDistance) < 1e-6f)
+        {
+            return false;
+        }
+        
+        const Eigen::Vector3f Corners[3] = { Triangle.A, Triangle.B, Triangle.C };
+        
+        for (int i = 0; i < 3; ++i)
+        {
+            Eigen::Vector3f Normal = (Corners[i] - Image).cross(Corners[(i + 1) % 3] - Image).normalized();
+            
+            if (Normal.dot(Corners[(i + 2) % 3] - Image) < 0.0f)
+            {
+                Normal = -Normal;
+            }
+            
+            OutPlanes[i] << Normal, -Normal.dot(Image);
+        }
+        
+        // Only past the triangle, on the side away from the image
+        const Eigen::Vector3f Away = ImageDistance > 0.0f ? Eigen::Vector3f(-Triangle.Normal) : Triangle.Normal;
+        OutPlanes[3] << Away, -Away.dot(Triangle.A);
+        
+        return true;
+    }
+}
+
+ImageSourceModel::ImageSourceModel(const TriangleBVH& Triangles)
+: Triangles(Triangles)
+{
+}
+
+void ImageSourceModel::Calculate(const PLVector& Source, const PLVector& Receiver, int MaxOrder, float MaxDistance, std::vector<Reflection>& OutReflections) const
+{
+    OutReflections.clear();
+    
+    const Eigen::Vector3f SourcePosition (Source.X, Source.Y, Source.Z);
+    const Eigen::Vector3f ReceiverPosition (Receiver.X, Receiver.Y, Receiver.Z);
+    
+    const float DirectLength = (ReceiverPosition - SourcePosition).norm();
+    if (DirectLength <= MaxDistance && !Triangles.IsBlocked(SourcePosition, ReceiverPosition, -1, -1))
+    {
+        OutReflections.push_back(MakeReflection(DirectLength, 0));
+    }
+    
+    MaxOrder = std::min(MaxOrder, MaxSupportedOrder);
+    
+    if (MaxOrder < 1)
+    {
+        return;
+    }
+    
+    Eigen::Vector4f RangePlanes[RangePlaneCount];
+    MakeRangePlanes(ReceiverPosition, MaxDistance, RangePlanes);
+    
+    std::vector<int> FirstOrderTriangles;
+    Triangles.FindInConvex(RangePlanes, RangePlaneCount, FirstOrderTriangles);
+    
+    boost::mutex ReflectionsMutex;
+    
+    // Every first order triangle starts its own tree of images, so split the trees between threads
+    ParallelFor(0, static_cast<int>(FirstOrderTriangles.size()), [&](int Begin, int End)
+    {
+        std::vector<Reflection> ThreadReflections;
+        std::vector<int> Path;
+        std::vector<Eigen::Vector3f> Images;
+        std::vector<std::vector<int>> Candidates (MaxOrder);
+        
+        for (int i = Begin; i < End; ++i)
+        {
+            const int TriangleIndex = FirstOrderTriangles[i];
+            const Eigen::Vector3f Image = Mirror(SourcePosition, Triangles.GetTriangle(TriangleIndex));
+            
+            if ((Image - ReceiverPosition).norm() > MaxDistance)
+            {
+                continue;
+            }
+            
+            Path.assign(1, TriangleIndex);
+            Images.assign(1, Image);
+            Reflect(Path, Images, SourcePosition, ReceiverPosition, MaxOrder, MaxDistance, RangePlanes, Candidates, ThreadReflections);
+        }
+        
+        boost::mutex::scoped_lock Lock (ReflectionsMutex);
+        OutReflections.insert(OutReflections.end(), ThreadReflections.begin(), ThreadReflections.end());
+    });
+}
+
+void ImageSourceModel::Reflect(std::vector<int>& Path, std::vector<Eigen::Vector3f>& Images, const Eigen::Vector3f& Source, const Eigen::Vector3f& Receiver, int MaxOrder, float MaxDistance,
+                               const Eigen::Vector4f* RangePlanes, std::vector<std::vector<int>>& Candidates, std::vector<Reflection>& OutReflections) const
+{
+    if (IsPathValid(Path, Images, Source, Receiver))
+    {
+        OutReflections.push_back(MakeReflection((Images.back() - Receiver).norm(), static_cast<int>(Path.size())));
+    }
+    
+    if (Path.size() >= MaxOrder)
+    {
+        return;
+    }
+    
+    Eigen::Vector4f Planes[RangePlaneCount + BeamPlaneCount];
+    std::copy(RangePlanes, RangePlanes + RangePlaneCount, Planes);
+    
+    if (!MakeBeamPlanes(Images.back(), Triangles.GetTriangle(Path.back()), Planes + RangePlaneCount))
+    {
+        return;
+    }
+    
+    // Deeper orders use the entries after this one, so these stay put while recursing
+    std::vector<int>& NextTriangles = Candidates[Path.size()];
+    Triangles.FindInConvex(Planes, RangePlaneCount + BeamPlaneCount, NextTriangles);
+    
+    for (int TriangleIndex : NextTriangles)
+    {
+        const TriangleBVH::Triangle& Triangle = Triangles.GetTriangle(TriangleIndex);
+        
+        // Reflecting twice in the same plane gives back the previous image
+        if (IsCoplanar(Triangle, Triangles.GetTriangle(Path.back())))
+        {
+            continue;
+        }
+        
+        const Eigen::Vector3f Image = Mirror(Images.back(), Triangle);
+        
+        if ((Image - Receiver).norm() > MaxDistance)
+        {
+            continue;
+        }
+        
+        Path.push_back(TriangleIndex);
+        Images.push_back(Image);
+        
+        Reflect(Path, Images, Source, Receiver, MaxOrder, MaxDistance, RangePlanes, Candidates, OutReflections);
+        
+        Path.pop_back();
+        Images.pop_back();
+    }
+}
+
+bool ImageSourceModel::IsPathValid(const std::vector<int>& Path, const std::vector<Eigen::Vector3f>& Images, const Eigen::Vector3f& Source, const Eigen::Vector3f& Receiver) const
+{
+    Eigen::Vector3f Point = Receiver;
+    int PointTriangle = -1;
+    
+    for (int i = static_cast<int>(Path.size()) - 1; i >= 0; --i)
+    {
+        // The leg towards the image must actually hit the triangle, not just its plane
+        float T;
+        if (!Triangles.IntersectTriangle(Path[i], Point, Images[i], T))
+        {
+            return false;
+        }
+        
+        const Eigen::Vector3f Hit = Point + T * (Images[i] - Point);
+        
+        if (Triangles.IsBlocked(Point, Hit, PointTriangle, Path[i]))
+        {
+            return false;
+        }
+        
+        Point = Hit;
+        PointTriangle = Path[i];
+    }
+    
+    return !Triangles.IsBlocked(Point, Source, PointTriangle, -1);
+}
@@ -0,0 +1,588 @@
+/*
+  ==============================================================================
+  
+    MeshSimplifier.cpp
+    Created: 19 Oct 2026 6:58:12am
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#include "MeshSimplifier.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <map>
+#include <queue>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    /** Triangles covering more cells of the piece clearance hash than this are kept out of it */
+    const int MaxCellsPerTriangle = 64;
+    
+    /**
+     * Sum of squared distances to a set of planes, as Point . A Point + 2 B . Point + C.
+     */
+    struct Quadric
+    {
+        Eigen::Matrix3d A = Eigen::Matrix3d::Zero();
+        Eigen::Vector3d B = Eigen::Vector3d::Zero();
+        double C = 0.0;
+        
+        void AddPlane(const Eigen::Vector3d& Normal, const Eigen::Vector3d& Point)
+        {
+            const double D = -Normal.dot(Point);
+            A += Normal * Normal.transpose();
+            B += D * Normal;
+            C += D * D;
+        }
+        
+        double Error(const Eigen::Vector3d& Point) const
+        {
+            return Point.dot(A * Point) + 2.0 * B.dot(Point) + C;
+        }
+        
+        Quadric operator+(const Quadric& Other) const
+        {
+            Quadric Sum;
+            Sum.A = A + Other.A;
+            Sum.B = B + Other.B;
+            Sum.C = C + Other.C;
+            return Sum;
+        }
+    };
+    
+    /**
+     * Merging From into To at Target. Stale once either vertex has changed since it was worked out.
+     */
+    struct Collapse
+    {
+        double Cost;
+        int From;
+        int To;
+        int FromVersion;
+        int ToVersion;
+        Eigen::Vector3d Target;
+        
+        bool operator>(const Collapse& Other) const
+        {
+            return Cost > Other.Cost;
+        }
+    };
+    
+    typedef std::array<int, 3> Triangle;
+    
+    Eigen::Vector3d TriangleNormal(const std::vector<Eigen::Vector3d>& Positions, const Triangle& Corners)
+    {
+        return (Positions[Corners[1]] - Positions[Corners[0]]).cross(Positions[Corners[2]] - Positions[Corners[0]]);
+    }
+    
+    int FindRoot(std::vector<int>& Parents, int Vertex)
+    {
+        while (Parents[Vertex] != Vertex)
+        {
+            Parents[Vertex] = Parents[Parents[Vertex]];
+            Vertex = Parents[Vertex];
+        }
+        return Vertex;
+    }
+}
+
+MeshSimplifier::MeshSimplifier(double MaxError, double MinPieceSize, double PieceClearance)
+:   MaxError(MaxError),
+    MinPieceSize(MinPieceSize),
+    PieceClearance(PieceClearance)
+{ }
+
+PL_MESH MeshSimplifier::Simplify(const VertexMatrix& Vertices, const IndiceMatrix& Indices) const
+{
+    // Weld vertices that only differ by a rounding error, so seams don't stop collapses or leave cracks
+    const double WeldDistance = std::max(MaxError * 1e-3, 1e-9);
+    
+    std::map<std::tuple<long long, long long, long long>, int> WeldedIndices;
+    std::vector<int> Welded (Vertices.cols());
+    std::vector<Eigen::Vector3d> Positions;
+    
+    for (int i = 0; i < Vertices.cols(); ++i)
+    {
+        const Eigen::Vector3d Position = Vertices.col(i);
+        const std::tuple<long long, long long, long long> Key (std::llround(Position.x() / WeldDistance), std::llround(Position.y() / WeldDistance), std::llround(Position.z() / WeldDistance));
+        auto Found = WeldedIndices.find(Key);
+        
+        if (Found == WeldedIndices.end())
+        {
+            Found = WeldedIndices.emplace(Key, static_cast<int>(Positions.size())).first;
+            Positions.push_back(Position);
+        }
+        
+        Welded[i] = Found->second;
+    }
+    
+    const int VertexCount = static_cast<int>(Positions.size());
+    std::vector<Triangle> Triangles;
+    
+    for (int i = 0; i < Indices.cols(); ++i)
+    {
+        Triangle Corners;
+        bool bValid = true;
+        
+        for (int Corner = 0; Corner < 3; ++Corner)
+        {
+            const int Index = Indices(Corner, i);
+            bValid = bValid && Index >= 0 && Index < Vertices.cols();
+            Corners[Corner] = bValid ? Welded[Index] : 0;
+        }
+        
+        // Triangles with repeated corners or no area are invisible to the inside tests
+        if (!bValid || Corners[0] == Corners[1] || Corners[1] == Corners[2] || Corners[0] == Corners[2] || TriangleNormal(Positions, Corners).norm() < WeldDistance * WeldDistance)
+        {
+            continue;
+        }
+        
+        Triangles.push_back(Corners);
+    }
+    
+    // Drop pieces too small to hold enough of a voxel's sample points, like bolts and trim
+    std::vector<int> Parents (VertexCount);
+    
+    for (int i = 0; i < VertexCount; ++i)
+    {
+        Parents[i] = i;
+    }
+    
+    for (const Triangle& Corners : Triangles)
+    {
+        Parents[FindRoot(Parents, Corners[1])] = FindRoot(Parents, Corners[0]);
+        Parents[FindRoot(Parents, Corners[2])] = FindRoot(Parents, Corners[0]);
+    }
+    
+    std::vector<Eigen::AlignedBox3d> PieceBounds (VertexCount);
+    
+    for (const Triangle& Corners : Triangles)
+    {
+        Eigen::AlignedBox3d& Bounds = PieceBounds[FindRoot(Parents, Corners[0])];
+        
+        for (int Corner : Corners)
+        {
+            Bounds.extend(Positions[Corner]);
+        }
+    }
+    
+    std::vector<int> SmallPieces;
+    
+    for (int Piece = 0; Piece < VertexCount; ++Piece)
+    {
+        if (!PieceBounds[Piece].isEmpty() && PieceBounds[Piece].diagonal().norm() < MinPieceSize)
+        {
+            SmallPieces.push_back(Piece);
+        }
+    }
+    
+    // A small piece touching or beside other geometry is kept, since together they can still fill a voxel
+    std::vector<bool> PieceDropped (VertexCount, false);
+    
+    if (!SmallPieces.empty())
+    {
+        // Triangles are hashed into cells as big as a small piece's reach, so each piece only tests the triangles in the few cells around it
+        const double CellSize = MinPieceSize + 2.0 * PieceClearance;
+        const Eigen::Vector3d Margin = Eigen::Vector3d::Constant(PieceClearance);
+        
+        auto CellOf = [CellSize](const Eigen::Vector3d& Point)
+        {
+            return Eigen::Vector3i(static_cast<int>(std::floor(Point.x() / CellSize)), static_cast<int>(std::floor(Point.y() / CellSize)), static_cast<int>(std::floor(Point.z() / CellSize)));
+        };
+        
+        auto CellKey = [](int X, int Y, int Z)
+        {
+            const uint64_t Mask = (1 << 21) - 1;
+            return (static_cast<uint64_t>(X) & Mask) | (static_cast<uint64_t>(Y) & Mask) << 21 | (static_cast<uint64_t>(Z) & Mask) << 42;
+        };
+        
+        std::vector<Eigen::AlignedBox3d> TriangleBounds (Triangles.size());
+        std::unordered_map<uint64_t, std::vector<int>> Cells;
+        
+        // Triangles spanning lots of cells, like the floor of a room, are tested by every piece instead of filling the hash
+        std::vector<int> LargeTriangles;
+        
+        for (int i = 0; i < Triangles.size(); ++i)
+        {
+            Eigen::AlignedBox3d& Bounds = TriangleBounds[i];
+            Bounds = Eigen::AlignedBox3d(Positions[Triangles[i][0]]);
+            Bounds.extend(Positions[Triangles[i][1]]);
+            Bounds.extend(Positions[Triangles[i][2]]);
+            
+            const Eigen::Vector3i First = CellOf(Bounds.min());
+            const Eigen::Vector3i Last = CellOf(Bounds.max());
+            const Eigen::Vector3i Span = Last - First + Eigen::Vector3i::Ones();
+            
+            if (static_cast<int64_t>(Span.x()) * Span.y() * Span.z() > MaxCellsPerTriangle)
+            {
+                LargeTriangles.push_back(i);
+                continue;
+            }
+            
+            for (int z = First.z(); z <= Last.z(); ++z)
+            {
+                for (int y = First.y(); y <= Last.y(); ++y)
+                {
+                    for (int x = First.x(); x <= Last.x(); ++x)
+                    {
+                        Cells[CellKey(x, y, z)].push_back(i);
+                    }
+                }
+            }
+        }
+        
+        for (int Piece : SmallPieces)
+        {
+            const Eigen::AlignedBox3d Reach (PieceBounds[Piece].min() - Margin, PieceBounds[Piece].max() + Margin);
+            
+            auto IsNearOther = [&](int i)
+            {
+                return FindRoot(Parents, Triangles[i][0]) != Piece && Reach.intersects(TriangleBounds[i]);
+            };
+            
+            bool bNearOther = std::any_of(LargeTriangles.begin(), LargeTriangles.end(), IsNearOther);
+            
+            const Eigen::Vector3i First = CellOf(Reach.min());
+            const Eigen::Vector3i Last = CellOf(Reach.max());
+            
+            for (int z = First.z(); z <= Last.z() && !bNearOther; ++z)
+            {
+                for (int y = First.y(); y <= Last.y() && !bNearOther; ++y)
+                {
+                    for (int x = First.x(); x <= Last.x() && !bNearOther; ++x)
+                    {
+                        const auto Cell = Cells.find(CellKey(x, y, z));
+                        
+                        if (Cell != Cells.end())
+                        {
+                            bNearOther = std::any_of(Cell->second.begin(), Cell->second.end(), IsNearOther);
+                        }
+                    }
+                }
+            }
+            
+            PieceDropped[Piece] = !bNearOther;
+        }
+    }
+    
+    Triangles.erase(std::remove_if(Triangles.begin(), Triangles.end(), [&](const Triangle& Corners)
+    {
+        return PieceDropped[FindRoot(Parents, Corners[0])];
+    }), Triangles.end());
+    
+    const int TriangleCount = static_cast<int>(Triangles.size());
+    std::vector<std::vector<int>> VertexTriangles (VertexCount);
+    std::vector<Quadric> Quadrics (VertexCount);
+    std::map<std::pair<int, int>, int> EdgeTriangles;
+    
+    for (int i = 0; i < TriangleCount; ++i)
+    {
+        const Triangle& Corners = Triangles[i];
+        const Eigen::Vector3d Normal = TriangleNormal(Positions, Corners).normalized();
+        
+        for (int Corner = 0; Corner < 3; ++Corner)
+        {
+            VertexTriangles[Corners[Corner]].push_back(i);
+            Quadrics[Corners[Corner]].AddPlane(Normal, Positions[Corners[0]]);
+            
+            const int Start = Corners[Corner];
+            const int End = Corners[(Corner + 1) % 3];
+            EdgeTriangles[std::make_pair(std::min(Start, End), std::max(Start, End))]++;
+        }
+    }
+    
+    // Open edges are held in place by a plane standing up along them
+    for (int i = 0; i < TriangleCount; ++i)
+    {
+        const Triangle& Corners = Triangles[i];
+        const Eigen::Vector3d Normal = TriangleNormal(Positions, Corners).normalized();
+        
+        for (int Corner = 0; Corner < 3; ++Corner)
+        {
+            const int Start = Corners[Corner];
+            const int End = Corners[(Corner + 1) % 3];
+            
+            if (EdgeTriangles[std::make_pair(std::min(Start, End), std::max(Start, End))] != 1)
+            {
+                continue;
+            }
+            
+            const Eigen::Vector3d Edge = Positions[End] - Positions[Start];
+            const Eigen::Vector3d EdgeNormal = Edge.cross(Normal).normalized();
+            Quadrics[Start].AddPlane(EdgeNormal, Positions[Start]);
+            Quadrics[End].AddPlane(EdgeNormal, Positions[Start]);
+        }
+    }
+    
+    std::vector<int> Versions (VertexCount, 0);
+    std::vector<bool> VertexRemoved (VertexCount, false);
+    std::vector<bool> TriangleRemoved (TriangleCount, false);
+    
+    auto FindCollapse = [&](int From, int To)
+    {
+        const Quadric Combined = Quadrics[From] + Quadrics[To];
+        const Eigen::Vector3d Middle = 0.5 * (Positions[From] + Positions[To]);
+        const double Length = (Positions[From] - Positions[To]).norm();
+        
+        Collapse Best { std::numeric_limits<double>::max(), From, To, Versions[From], Versions[To], Middle };
+        Eigen::Vector3d Candidates[4] = { Positions[To], Positions[From], Middle, Middle };
+        int CandidateCount = 3;
+        
+        // The quadric's minimum, unless it's flat along some direction or runs off away from the edge
+        if (std::abs(Combined.A.determinant()) > 1e-9)
+        {
+            const Eigen::Vector3d Optimal = -Combined.A.inverse() * Combined.B;
+            
+            if ((Optimal - Middle).norm() <= Length)
+            {
+                Candidates[CandidateCount++] = Optimal;
+            }
+        }
+        
+        for (int i = 0; i < CandidateCount; ++i)
+        {
+            const double Cost = std::max(0.0, Combined.Error(Candidates[i]));
+            
+            if (Cost < Best.Cost)
+            {
+                Best.Cost = Cost;
+                Best.Target = Candidates[i];
+            }
+        }
+        
+        return Best;
+    };
+    
+    std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> Queue;
+    
+    for (const auto& Edge : EdgeTriangles)
+    {
+        Queue.push(FindCollapse(Edge.first.first, Edge.first.second));
+    }
+    
+    std::vector<int> FromNeighbours;
+    std::vector<int> ToNeighbours;
+    
+    auto GatherNeighbours = [&](int Vertex, std::vector<int>& OutNeighbours)
+    {
+        OutNeighbours.clear();
+        
+        for (int TriangleIndex : VertexTriangles[Vertex])
+        {
+            for (int Corner : Triangles[TriangleIndex])
+            {
+                if (Corner != Vertex && std::find(OutNeighbours.begin(), OutNeighbours.end(), Corner) == OutNeighbours.end())
+                {
+                    OutNeighbours.push_back(Corner);
+                }
+            }
+        }
+    };
+    
+    auto ContainsBoth = [&](int TriangleIndex, int First, int Second)
+    {
+        const Triangle& Corners = Triangles[TriangleIndex];
+        return std::find(Corners.begin(), Corners.end(), First) != Corners.end() && std::find(Corners.begin(), Corners.end(), Second) != Corners.end();
+    };
+    
+    auto CanCollapse = [&](const Collapse& Candidate)
+    {
+        // Vertices either side of the edge must be the only neighbours the two ends share, or the collapse pinches the surface
+        GatherNeighbours(Candidate.From, FromNeighbours);
+        GatherNeighbours(Candidate.To, ToNeighbours);
+        
+        int SharedNeighbours = 0;
+        int SharedTriangles = 0;
+        
+        for (int Neighbour : FromNeighbours)
+        {
+            SharedNeighbours += std::find(ToNeighbours.begin(), ToNeighbours.end(), Neighbour) != ToNeighbours.end() ? 1 : 0;
+        }
+        
+        for (int TriangleIndex : VertexTriangles[Candidate.From])
+        {
+            SharedTriangles += ContainsBoth(TriangleIndex, Candidate.From, Candidate.To) ? 1 : 0;
+        }
+        
+        if (SharedNeighbours != SharedTriangles)
+        {
+            return false;
+        }
+        
+        // Every triangle that survives must keep facing the same way
+        for (int Moved : { Candidate.From, Candidate.To })
+        {
+            for (int TriangleIndex : VertexTriangles[Moved])
+            {
+                if (ContainsBoth(TriangleIndex, Candidate.From, Candidate.To))
+                {
+                    continue;
+                }
+                
+                const Triangle& Corners = Triangles[TriangleIndex];
+                Eigen::Vector3d CornerPositions[3];
+                
+                for (int Corner = 0; Corner < 3; ++Corner)
+                {
+                    CornerPositions[Corner] = Corners[Corner] == Moved ? Candidate.Target : Positions[Corners[Corner]];
+                }
+                
+                const Eigen::Vector3d Before = TriangleNormal(Positions, Corners);
+                const Eigen::Vector3d After = (CornerPositions[1] - CornerPositions[0]).cross(CornerPositions[2] - CornerPositions[0]);
+                
+                if (After.norm() < WeldDistance * WeldDistance || After.dot(Before) < 0.2 * After.norm() * Before.norm())
+                {
+                    return false;
+                }
+            }
+        }
+        
+        return true;
+    };
+    
+    const double MaxErrorSquared = MaxError * MaxError;
+    
+    while (!Queue.empty())
+    {
+        const Collapse Next = Queue.top();
+        Queue.pop();
+        
+        // Everything left moves the surface too far
+        if (Next.Cost > MaxErrorSquared)
+        {
+            break;
+        }
+        
+        if (VertexRemoved[Next.From] || VertexRemoved[Next.To] || Versions[Next.From] != Next.FromVersion || Versions[Next.To] != Next.ToVersion)
+        {
+            continue;
+        }
+        
+        if (!CanCollapse(Next))
+        {
+            continue;
+        }
+        
+        Positions[Next.To] = Next.Target;
+        Quadrics[Next.To] = Quadrics[Next.To] + Quadrics[Next.From];
+        VertexRemoved[Next.From] = true;
+        Versions[Next.To]++;
+        
+        for (int TriangleIndex : VertexTriangles[Next.From])
+        {
+            if (ContainsBoth(TriangleIndex, Next.From, Next.To))
+            {
+                TriangleRemoved[TriangleIndex] = true;
+                continue;
+            }
+            
+            std::replace(Triangles[TriangleIndex].begin(), Triangles[TriangleIndex].end(), Next.From, Next.To);
+            VertexTriangles[Next.To].push_back(TriangleIndex);
+        }
+        
+        VertexTriangles[Next.From].clear();
+        
+        // Removed triangles are also listed by the vertex on their far side
+        for (int Vertex : FromNeighbours)
+        {
+            std::vector<int>& Around = VertexTriangles[Vertex];
+            Around.erase(std::remove_if(Around.begin(), Around.end(), [&](int TriangleIndex) { return TriangleRemoved[TriangleIndex]; }), Around.end());
+        }
+        
+        std::vector<int>& Around = VertexTriangles[Next.To];
+        Around.erase(std::remove_if(Around.begin(), Around.end(), [&](int TriangleIndex) { return TriangleRemoved[TriangleIndex]; }), Around.end());
+        
+        GatherNeighbours(Next.To, ToNeighbours);
+        
+        for (int Neighbour : ToNeighbours)
+        {
+            Queue.push(FindCollapse(Neighbour, Next.To));
+        }
+    }
+    
+    // Pack what's left
+    std::vector<int> Packed (VertexCount, -1);
+    int PackedVertices = 0;
+    int PackedTriangles = 0;
+    
+    for (int i = 0; i < TriangleCount; ++i)
+    {
+        if (TriangleRemoved[i])
+        {
+            continue;
+        }
+        
+        PackedTriangles++;
+        
+        for (int Corner : Triangles[i])
+        {
+            if (Packed[Corner] < 0)
+            {
+                Packed[Corner] = PackedVertices++;
+            }
+        }
+    }
+    
+    PL_MESH Simplified;
+    Simplified.Vertices.resize(3, PackedVertices);
+    Simplified.Indices.resize(3, PackedTriangles);
+    
+    for (int i = 0; i < VertexCount; ++i)
+    {
+        if (Packed[i] >= 0)
+        {
+            Simplified.Vertices.col(Packed[i]) = Positions[i];
+        }
+    }
+    
+    for (int i = 0, Column = 0; i < TriangleCount; ++i)
+    {
+        if (TriangleRemoved[i])
+        {
+            continue;
+        }
+        
+        for (int Corner = 0; Corner < 3; ++Corner)
+        {
+            Simplified.Indices(Corner, Column) = Packed[Triangles[i][Corner]];
+        }
+        
+        Column++;
+    }
+    
+    return Simplified;
+}
+
+size_t MeshSimplifier::HashAsset(const PLVector* Vertices, int VerticesLength, const int* Indices, int IndicesLength)
+{
+    // FNV-1a over the raw data
+    uint64_t Hash = 14695981039346656037ull;
+    
+    auto AddBytes = [&Hash](const void* Data, size_t Length)
+    {
+        const unsigned char* Bytes = static_cast<const unsigned char*>(Data);
+        
+        for (size_t i = 0; i < Length; ++i)
+        {
+            Hash = (Hash ^ Bytes[i]) * 1099511628211ull;
+        }
+    };
+    
+    for (int i = 0; i < VerticesLength; ++i)
+    {
+        const float Position[3] = { Vertices[i].X, Vertices[i].Y, Vertices[i].Z };
+        AddBytes(Position, sizeof(Position));
+    }
+    
+    AddBytes(Indices, sizeof(int) * static_cast<size_t>(IndicesLength));
+    
+    // 0 is kept for meshes that didn't come from the game
+    return Hash == 0 ? 1 : static_cast<size_t>(Hash);
+}
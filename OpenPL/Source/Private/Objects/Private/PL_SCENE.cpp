@@ -12,13 +12,29 @@
 #include "PL_SYSTEM.h"
 #include <igl/voxel_grid.h>
 #include <igl/copyleft/cgal/points_inside_component.h>
-#include <sstream>
 #include "MatPlotPlotter.h"
 #include "Simulators/SimulatorFDTD.h"
+#include "Simulators/SimulatorFDTD4.h"
+#include "Simulators/SimulatorLeapfrog.h"
+#include "Simulators/SimulatorADI.h"
 #include "Simulators/SimulatorBasic.h"
 #include <boost/timer/timer.hpp>
 #include "Analyser.h"
 #include "FreeGrid.h"
+#include "ProbeGrid.h"
+#include "ProbeGenerator.h"
+#include "DistanceField.h"
+#include "AirRegions.h"
+#include "OccupancyGrid.h"
+#include "TriangleBVH.h"
+#include "GeodesicField.h"
+#include "RoomGraph.h"
+#include "DebugOpenGL.h"
+#include "SnapshotRecorder.h"
+#include "HelmholtzSolver.h"
+#include "MeshSimplifier.h"
+#include "FastWindingNumber.h"
+#include <limits>
 
 Eigen::Vector3d CreateEigenVectorFromPL(const PLVector& Vector)
 {
@@ -27,6 +43,22 @@ Eigen::Vector3d CreateEigenVectorFromPL(const PLVector& Vector)
     return EigenVector;
 }
 
+Simulator* CreateSimulator(PL_SIMULATION_SCHEME Scheme)
+{
+    switch (Scheme)
+    {
+        case PL_SIMULATION_SCHEME_FDTD_4TH_ORDER:
+            return new SimulatorFDTD4();
+        case PL_SIMULATION_SCHEME_LEAPFROG:
+            return new SimulatorLeapfrog();
+        case PL_SIMULATION_SCHEME_ADI:
+            return new SimulatorADI();
+        case PL_SIMULATION_SCHEME_FDTD:
+        default:
+            return new SimulatorFDTD();
+    }
+}
+
 PL_SCENE::PL_SCENE(PL_SYSTEM* System)
 :   OwningSystem(System)
 {
@@ -103,20 +135,30 @@ PL_RESULT PL_SCENE::CreateVoxels(const PLVector& SceneSize, float VoxelSize)
     VoxelGrid.Bounds = Bounds;
     VoxelGrid.Size = Side;
     VoxelGrid.VoxelSize = VoxelSize;
-    VoxelGrid.Voxels = std::vector<PLVoxel>(XSize*YSize*ZSize); // TODO: Actually fill the voxels with values
     
-    Voxels = VoxelGrid;
+    // Zeroed slab by slab on the workers that simulate them, rather than all on this thread and so all on this thread's NUMA node
+    ParallelAssign(VoxelGrid.Voxels, static_cast<size_t>(XSize) * YSize * ZSize, PLVoxel(), ZSize);
     
-    std::ostringstream StringStream;
-    PLVector BottomBackLeft;
-    GetScenePositionBottomBackLeftCorner(&BottomBackLeft);
-    PLVector FirstVoxelPosition;
-    GetVoxelPosition(0, &FirstVoxelPosition);
-    int FirstVoxelIndex;
-    GetVoxelIndexOfPosition(FirstVoxelPosition, &FirstVoxelIndex);
-    StringStream << "Created Voxels. Size: " << Voxels.Voxels.size() << ". Center: " << ScenePosition << ". BottomBackLeft: " << BottomBackLeft << ". First Voxel: " << FirstVoxelPosition << ". First Index: " << FirstVoxelIndex;
+    Voxels = std::move(VoxelGrid);
+    
+    InvalidateWarmStart();
+    DistanceFieldPointer.reset();
+    AirRegionsPointer.reset();
+    OccupancyGridPointer.reset();
+    GeodesicFieldPointer.reset();
+    ProbeGridPointer.reset();
+    RoomGraphPointer.reset();
     
-    DebugLog(StringStream.str().c_str());
+    if (IsDebugLevelEnabled(PL_DEBUG_LEVEL_LOG))
+    {
+        PLVector BottomBackLeft;
+        GetScenePositionBottomBackLeftCorner(&BottomBackLeft);
+        PLVector FirstVoxelPosition;
+        GetVoxelPosition(0, &FirstVoxelPosition);
+        int FirstVoxelIndex;
+        GetVoxelIndexOfPosition(FirstVoxelPosition, &FirstVoxelIndex);
+        PL_LOG(PL_DEBUG_LEVEL_LOG, "Created Voxels. Size: " << Voxels.Voxels.size() << ". Center: " << ScenePosition << ". BottomBackLeft: " << BottomBackLeft << ". First Voxel: " << FirstVoxelPosition << ". First Index: " << FirstVoxelIndex);
+    }
     
     if (!FreeGridPointer)
     {
@@ -131,6 +173,8 @@ PL_RESULT PL_SCENE::CreateVoxels(const PLVector& SceneSize, float VoxelSize)
         FreeGridPointer->Init(this);
     }
     
+    PublishDebugSnapshot(DebugViewer::Colouring_Flat);
+    
     return PL_OK;
 }
 
@@ -200,6 +244,10 @@ PL_RESULT PL_SCENE::AddAndConvertGameMesh(PLVector WorldPosition, PLQuaternion W
     Mesh.Vertices = TransformedVertices;
     Mesh.Indices = EigenIndices;
     
+    // Instances of an asset can share one simplified copy when the voxels are filled
+    Mesh.AssetKey = MeshSimplifier::HashAsset(Vertices, VerticesLength, Indices, IndicesLength);
+    Mesh.LocalToWorld = Transform;
+    
     // Add mesh to scene
     int Index = -1;
     PL_RESULT Result = AddMesh(Mesh, Index);
@@ -220,6 +268,101 @@ PL_RESULT PL_SCENE::RemoveMesh(int Index)
     return PL_OK;
 }
 
+PL_RESULT PL_SCENE::AddHeightfield(const PLVector& Origin, float Spacing, int Rows, int Columns, const float* Heights, float Absorptivity, int& OutIndex)
+{
+    if (!Heights || Spacing <= 0.0f || Rows < 2 || Columns < 2 || Absorptivity < 0.0f || Absorptivity > 1.0f)
+    {
+        DebugError("Can't add heightfield. Needs at least 2 rows and columns, a positive spacing and an absorptivity of 0 to 1");
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    Heightfields.emplace_back(Origin, Spacing, Rows, Columns, Heights, Absorptivity);
+    OutIndex = static_cast<int>(Heightfields.size()) - 1;
+    return PL_OK;
+}
+
+PL_RESULT PL_SCENE::RemoveHeightfield(int Index)
+{
+    if (Index < 0 || Index >= Heightfields.size())
+    {
+        DebugError("Index out of bounds when removing heightfield");
+        return PL_ERR;
+    }
+    Heightfields.erase(Heightfields.begin()+Index);
+    return PL_OK;
+}
+
+PL_RESULT PL_SCENE::AddBox(const PLVector& Position, const PLQuaternion& Rotation, const PLVector& HalfExtents, float Absorptivity, int& OutIndex)
+{
+    if (HalfExtents.X <= 0.0f || HalfExtents.Y <= 0.0f || HalfExtents.Z <= 0.0f || Absorptivity < 0.0f || Absorptivity > 1.0f)
+    {
+        DebugError("Can't add box. Needs positive half extents and an absorptivity of 0 to 1");
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    Primitives.push_back(PrimitiveCollider::Box(Position, Rotation, HalfExtents, Absorptivity));
+    OutIndex = static_cast<int>(Primitives.size()) - 1;
+    return PL_OK;
+}
+
+PL_RESULT PL_SCENE::AddSphere(const PLVector& Position, float Radius, float Absorptivity, int& OutIndex)
+{
+    if (Radius <= 0.0f || Absorptivity < 0.0f || Absorptivity > 1.0f)
+    {
+        DebugError("Can't add sphere. Needs a positive radius and an absorptivity of 0 to 1");
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    Primitives.push_back(PrimitiveCollider::Sphere(Position, Radius, Absorptivity));
+    OutIndex = static_cast<int>(Primitives.size()) - 1;
+    return PL_OK;
+}
+
+PL_RESULT PL_SCENE::AddCapsule(const PLVector& Position, const PLQuaternion& Rotation, float Radius, float HalfHeight, float Absorptivity, int& OutIndex)
+{
+    if (Radius <= 0.0f || HalfHeight < 0.0f || Absorptivity < 0.0f || Absorptivity > 1.0f)
+    {
+        DebugError("Can't add capsule. Needs a positive radius, a half height of at least 0 and an absorptivity of 0 to 1");
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    Primitives.push_back(PrimitiveCollider::Capsule(Position, Rotation, Radius, HalfHeight, Absorptivity));
+    OutIndex = static_cast<int>(Primitives.size()) - 1;
+    return PL_OK;
+}
+
+PL_RESULT PL_SCENE::AddConvexHull(const PLVector& Position, const PLQuaternion& Rotation, const PLVector& Scale, const PLVector* Vertices, int VerticesLength, const int* Indices, int IndicesLength, float Absorptivity, int& OutIndex)
+{
+    if (Absorptivity < 0.0f || Absorptivity > 1.0f)
+    {
+        DebugError("Can't add convex hull. Needs an absorptivity of 0 to 1");
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    PrimitiveCollider Hull = PrimitiveCollider::ConvexHull(Position, Rotation, Scale, Vertices, VerticesLength, Indices, IndicesLength, Absorptivity);
+    
+    if (!Hull.IsValid())
+    {
+        DebugError("Can't add convex hull. Needs at least 4 vertices and triangles that enclose a convex shape");
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    Primitives.push_back(std::move(Hull));
+    OutIndex = static_cast<int>(Primitives.size()) - 1;
+    return PL_OK;
+}
+
+PL_RESULT PL_SCENE::RemovePrimitive(int Index)
+{
+    if (Index < 0 || Index >= Primitives.size())
+    {
+        DebugError("Index out of bounds when removing primitive");
+        return PL_ERR;
+    }
+    Primitives.erase(Primitives.begin()+Index);
+    return PL_OK;
+}
+
 PL_RESULT PL_SCENE::AddListenerLocation(PLVector& Location, int& OutIndex)
 {
     ListenerLocations.push_back(Location);
@@ -238,6 +381,17 @@ PL_RESULT PL_SCENE::RemoveListenerLocation(int Index)
     return PL_OK;
 }
 
+PL_RESULT PL_SCENE::SetListenerLocation(int Index, const PLVector& Location)
+{
+    if (Index < 0 || Index >= ListenerLocations.size())
+    {
+        DebugError("Index out of bounds when moving listener");
+        return PL_ERR;
+    }
+    ListenerLocations[Index] = Location;
+    return PL_OK;
+}
+
 PL_RESULT PL_SCENE::AddSourceLocation(PLVector& Location, int& OutIndex)
 {
     SourceLocations.push_back(Location);
@@ -256,6 +410,17 @@ PL_RESULT PL_SCENE::RemoveSourceLocation(int Index)
     return PL_OK;
 }
 
+PL_RESULT PL_SCENE::SetSourceLocation(int Index, const PLVector& Location)
+{
+    if (Index < 0 || Index >= SourceLocations.size())
+    {
+        DebugError("Index out of bounds when moving emitter");
+        return PL_ERR;
+    }
+    SourceLocations[Index] = Location;
+    return PL_OK;
+}
+
 PL_RESULT PL_SCENE::FillVoxelsWithGeometry()
 {
     if (Voxels.Voxels.size() == 0)
@@ -352,6 +517,108 @@ VertexMatrix GetPointsToCheckForVoxel(Eigen::Vector3d VoxelPosition, Eigen::Vect
     return PointsToCheck;
 }
 
+void PL_SCENE::SimplifyMeshes()
+{
+    const double MaxError = SimplificationError * Voxels.VoxelSize;
+    
+    // A piece this small can only hold one of the 9 points tested per voxel, and a voxel needs 3 inside to be filled.
+    // Unless other geometry within a voxel of it holds the rest
+    const double MinPieceSize = 0.5 * Voxels.VoxelSize;
+    const double PieceClearance = Voxels.VoxelSize;
+    
+    typedef std::tuple<size_t, double, double> AssetKey;
+    
+    struct Job
+    {
+        AssetKey Key;
+        
+        /** First mesh of the asset. Its vertices are moved back into asset space to simplify*/
+        int MeshIndex;
+        
+        std::shared_ptr<const PL_MESH> Result;
+    };
+    
+    std::map<AssetKey, std::shared_ptr<const PL_MESH>> UsedAssets;
+    std::vector<std::pair<int, AssetKey>> Stale;
+    std::vector<Job> Jobs;
+    
+    for (int i = 0; i < Meshes.size(); ++i)
+    {
+        const PL_MESH& Mesh = Meshes[i];
+        
+        // Errors are in asset space, so scaled instances of an asset simplify differently
+        const Eigen::Vector3d Scales = Mesh.LocalToWorld.linear().jacobiSvd().singularValues();
+        
+        if (Scales.minCoeff() < 1e-9)
+        {
+            continue;
+        }
+        
+        // Meshes that didn't come from the game get a key of their own
+        const size_t Asset = Mesh.AssetKey != 0 ? Mesh.AssetKey : static_cast<size_t>(-1) - i;
+        const AssetKey Key (Asset, MaxError / Scales.maxCoeff(), MinPieceSize / Scales.maxCoeff());
+        auto Cached = SimplifiedAssets.find(Key);
+        
+        if (Cached != SimplifiedAssets.end())
+        {
+            UsedAssets[Key] = Cached->second;
+        }
+        else if (UsedAssets.emplace(Key, nullptr).second)
+        {
+            Jobs.push_back({ Key, i, nullptr });
+        }
+        
+        if (!Mesh.Simplified || Mesh.SimplifiedError != MaxError)
+        {
+            Stale.emplace_back(i, Key);
+        }
+    }
+    
+    ParallelFor(0, static_cast<int>(Jobs.size()), [&](int FirstJob, int EndJob)
+    {
+        for (int i = FirstJob; i < EndJob; ++i)
+        {
+            const PL_MESH& Mesh = Meshes[Jobs[i].MeshIndex];
+            const VertexMatrix AssetVertices = Mesh.LocalToWorld.inverse() * Mesh.Vertices.colwise().homogeneous();
+            
+            // Clearance scales with the piece size, so the key covers it
+            MeshSimplifier Simplifier (std::get<1>(Jobs[i].Key), std::get<2>(Jobs[i].Key), std::get<2>(Jobs[i].Key) * PieceClearance / MinPieceSize);
+            Jobs[i].Result = std::make_shared<const PL_MESH>(Simplifier.Simplify(AssetVertices, Mesh.Indices));
+        }
+    });
+    
+    for (const Job& Finished : Jobs)
+    {
+        UsedAssets[Finished.Key] = Finished.Result;
+    }
+    
+    long long TrianglesBefore = 0;
+    long long TrianglesAfter = 0;
+    
+    for (const std::pair<int, AssetKey>& ToPlace : Stale)
+    {
+        PL_MESH& Mesh = Meshes[ToPlace.first];
+        const PL_MESH& Asset = *UsedAssets[ToPlace.second];
+        
+        std::shared_ptr<PL_MESH> Placed = std::make_shared<PL_MESH>();
+        Placed->Vertices = Mesh.LocalToWorld * Asset.Vertices.colwise().homogeneous();
+        Placed->Indices = Asset.Indices;
+        
+        Mesh.Simplified = Placed;
+        Mesh.SimplifiedError = MaxError;
+        
+        TrianglesBefore += Mesh.Indices.cols();
+        TrianglesAfter += Placed->Indices.cols();
+    }
+    
+    SimplifiedAssets = std::move(UsedAssets);
+    
+    if (!Stale.empty())
+    {
+        PL_LOG(PL_DEBUG_LEVEL_LOG, "Simplified " << Stale.size() << " meshes, " << Jobs.size() << " of their assets for the first time. " << TrianglesBefore << " triangles down to " << TrianglesAfter);
+    }
+}
+
 PL_RESULT PL_SCENE::FillVoxels()
 {
     // First, init all Beta fields to 1
@@ -362,8 +629,23 @@ PL_RESULT PL_SCENE::FillVoxels()
         Voxel.Beta = 1;
     }
     
-    for (auto& Mesh : Meshes)
+    if (bSimplifyMeshes)
+    {
+        SimplifyMeshes();
+    }
+    
+    PLVector BottomBackLeft;
+    GetScenePositionBottomBackLeftCorner(&BottomBackLeft);
+    
+    for (auto& SceneMesh : Meshes)
     {
+        const PL_MESH& Mesh = bSimplifyMeshes && SceneMesh.Simplified ? *SceneMesh.Simplified : SceneMesh;
+        
+        if (Mesh.Indices.cols() == 0)
+        {
+            continue;
+        }
+        
         // Full AABB that encloses the mesh
         Eigen::Vector3d MeshMin = Mesh.Vertices.rowwise().minCoeff();
         Eigen::Vector3d MeshMax = Mesh.Vertices.rowwise().maxCoeff();
@@ -375,6 +657,14 @@ PL_RESULT PL_SCENE::FillVoxels()
             continue;
         }
         
+        if (VoxelisationMode == PL_VOXELISATION_MODE_WINDING_NUMBER)
+        {
+            FastWindingNumber Winding (Mesh.Vertices, Mesh.Indices);
+            Winding.Fill(Voxels, BottomBackLeft, 0.25f);
+            PublishDebugSnapshot(DebugViewer::Colouring_Flat);
+            continue;
+        }
+        
         // List of all cells that fit within the mesh
         std::vector<int> MeshCells;
         
@@ -454,10 +744,56 @@ PL_RESULT PL_SCENE::FillVoxels()
                 MeshCell.Beta = 0;
             }
         }
+        
+        PublishDebugSnapshot(DebugViewer::Colouring_Flat);
+    }
+    
+    // Filled column by column instead of with the point in solid tests, which terrain wouldn't pass anyway since it's open underneath
+    for (const Heightfield& Terrain : Heightfields)
+    {
+        Terrain.Fill(Voxels, BottomBackLeft);
+    }
+    
+    for (const PrimitiveCollider& Primitive : Primitives)
+    {
+        Primitive.Fill(Voxels, BottomBackLeft);
+    }
+    
+    if (!Heightfields.empty() || !Primitives.empty())
+    {
+        PublishDebugSnapshot(DebugViewer::Colouring_Flat);
     }
     
+    InvalidateWarmStart();
+    GeodesicFieldPointer.reset();
+    
+    // The bake is of the old geometry, and its cells may not even line up with the new lattice
+    ProbeGridPointer.reset();
+    
+    std::unique_ptr<DistanceField> NewDistanceField (new DistanceField());
+    NewDistanceField->Calculate(Voxels);
+    DistanceFieldPointer = std::move(NewDistanceField);
+    
+    std::unique_ptr<AirRegions> NewAirRegions (new AirRegions());
+    NewAirRegions->Label(Voxels);
+    AirRegionsPointer = std::move(NewAirRegions);
+    
+    std::unique_ptr<OccupancyGrid> NewOccupancyGrid (new OccupancyGrid());
+    NewOccupancyGrid->Build(Voxels, BottomBackLeft);
+    OccupancyGridPointer = std::move(NewOccupancyGrid);
+    
+    std::unique_ptr<TriangleBVH> NewTriangleBVH (new TriangleBVH());
+    NewTriangleBVH->Build(Meshes);
+    TriangleBVHPointer = std::move(NewTriangleBVH);
+    
+    std::unique_ptr<RoomGraph> NewRoomGraph (new RoomGraph());
+    NewRoomGraph->Build(Voxels, *DistanceFieldPointer, BottomBackLeft);
+    RoomGraphPointer = std::move(NewRoomGraph);
+    
     VoxelThreadStatus.store(ThreadStatus_Finished);
     
+    PublishDebugSnapshot(DebugViewer::Colouring_Regions);
+    
     return PL_OK;
 }
 
@@ -476,106 +812,900 @@ PL_RESULT PL_SCENE::Simulate(PLVector SimulationLocation)
         VoxelThread.join();
     }
     
-    SimulatorPointer = std::unique_ptr<class Simulator>(new SimulatorFDTD());
+    int VoxelIndex;
+    if (GetVoxelIndexOfPosition(SimulationLocation, &VoxelIndex) != PL_OK)
+    {
+        DebugError("Could not get the voxel for the listener. Can't apply a pulse to the simulation");
+        return PL_ERR;
+    }
+    
+    if (TryWarmStart(VoxelIndex))
+    {
+        return PL_OK;
+    }
+    
+    SimulatorPointer = std::unique_ptr<class Simulator>(CreateSimulator(SimulationScheme));
     
     PL_SIMULATION_SETTINGS Settings;
     Settings.Resolution = Low;
     Settings.TimeSteps = TimeSteps;
+    Settings.Precision = SimulationPrecision;
     
     SimulatorPointer->Init(this, Voxels, Settings);
     
-    int VoxelIndex;
-    if (GetVoxelIndexOfPosition(SimulationLocation, &VoxelIndex) == PL_OK)
+    if (AirRegionsPointer)
     {
-        std::ostringstream Stream;
-        Stream << "Simulating Over " << Voxels.Voxels.size() << " Voxels\n";
-        {
-            boost::timer::auto_cpu_timer SimulationTimer(Stream);
-            SimulatorPointer->Simulate(VoxelIndex);
-        }
-//        DebugLog(Stream.str().c_str());
+        UpdateActiveRegions(VoxelIndex);
+        SimulatorPointer->SetActiveVoxels(&AirRegionsPointer->GetActiveVoxels());
     }
-    else
+    
+    boost::timer::cpu_timer SimulationTimer;
+    
+    if (!SimulatorPointer->Simulate(VoxelIndex))
     {
-        DebugError("Could not get the voxel for the listener. Can't apply a pulse to the simulation");
+        DebugError("Simulation failed. The previous simulation is gone, so simulate again before reading impulse responses");
+        SimulatorPointer.reset();
+        InvalidateWarmStart();
         return PL_ERR;
     }
+    
+    PL_LOG_VERBOSE("Simulated " << Voxels.Voxels.size() << " voxels in " << SimulationTimer.elapsed().wall / 1e9 << "s");
+    
+    FullSimulationVoxelIndex = VoxelIndex;
+    CurrentSimulationVoxelIndex = VoxelIndex;
+    
+    PublishDebugSnapshot(DebugViewer::Colouring_Pressure);
 
     return PL_OK;
 }
 
-PL_RESULT PL_SCENE::VoxeliseInternal()
+PL_RESULT PL_SCENE::GetSimulationRate(float* OutSamplingRate, float* OutMaxFrequency) const
 {
-    VoxelThreadStatus.store(ThreadStatus_Ongoing);
+    if (!OutSamplingRate || !OutMaxFrequency)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
     
-    return FillVoxels();
+    if (!SimulatorPointer)
+    {
+        DebugError("Simulate the scene before asking for its sampling rate");
+        return PL_ERR;
+    }
+    
+    *OutSamplingRate = SimulatorPointer->GetSamplingRate();
+    *OutMaxFrequency = SimulatorPointer->GetMaxFrequency();
+    
+    return PL_OK;
 }
 
-PL_RESULT PL_SCENE::GetVoxelsCount(int* OutVoxelCount) const
+PL_RESULT PL_SCENE::SetSimulationScheme(PL_SIMULATION_SCHEME Scheme)
 {
-    if (VoxelThreadStatus.load() == ThreadStatus_Ongoing)
+    if (Scheme < PL_SIMULATION_SCHEME_FDTD || Scheme > PL_SIMULATION_SCHEME_ADI)
     {
-        *OutVoxelCount = 0;
-        return PL_OK;
+        return PL_ERR_INVALID_PARAM;
     }
     
-    if (!OutVoxelCount)
+    if (Scheme != SimulationScheme)
     {
-        return PL_ERR_INVALID_PARAM;
+        FullSimulationVoxelIndex = -1;
     }
     
-    *OutVoxelCount = static_cast<int>(Voxels.Voxels.size());
-    
+    SimulationScheme = Scheme;
+    WarnIfPrecisionIgnored();
     return PL_OK;
 }
 
-PL_RESULT PL_SCENE::GetVoxelLocation(PLVector* OutVoxelLocation, int Index) const
+PL_RESULT PL_SCENE::SetVoxelisationMode(PL_VOXELISATION_MODE Mode)
 {
-    if (VoxelThreadStatus.load() == ThreadStatus_Ongoing)
+    if (Mode < PL_VOXELISATION_MODE_EXACT || Mode > PL_VOXELISATION_MODE_WINDING_NUMBER)
     {
-        *OutVoxelLocation = PLVector();
-        return PL_OK;
+        return PL_ERR_INVALID_PARAM;
     }
     
-    if (!OutVoxelLocation || Index < 0)
+    VoxelisationMode = Mode;
+    return PL_OK;
+}
+
+PL_RESULT PL_SCENE::SetSimulationPrecision(PL_SIMULATION_PRECISION Precision)
+{
+    if (Precision < PL_SIMULATION_PRECISION_DOUBLE || Precision > PL_SIMULATION_PRECISION_HALF)
     {
         return PL_ERR_INVALID_PARAM;
     }
     
-    if (Index >= Voxels.Voxels.size())
+    if (Precision != SimulationPrecision)
     {
-        return PL_ERR;  // Should change this to a warning or something similar
+        FullSimulationVoxelIndex = -1;
     }
     
-    return GetVoxelPosition(Index, OutVoxelLocation);
+    SimulationPrecision = Precision;
+    WarnIfPrecisionIgnored();
+    return PL_OK;
 }
 
-PL_RESULT PL_SCENE::GetVoxelAbsorpivity(float* OutAbsorpivity, int Index) const
+void PL_SCENE::WarnIfPrecisionIgnored() const
 {
-    if (!OutAbsorpivity || Index < 0)
+    if (SimulationPrecision != PL_SIMULATION_PRECISION_DOUBLE && SimulationScheme != PL_SIMULATION_SCHEME_LEAPFROG)
+    {
+        DebugWarn("Only the leapfrog scheme stores anything below double precision. The simulation will run in double until the scheme is PL_SIMULATION_SCHEME_LEAPFROG");
+    }
+}
+
+void PL_SCENE::OnSimulationProgress(int TimeStep)
+{
+    if (TimeStep % DebugViewerInterval == 0)
+    {
+        PublishDebugSnapshot(DebugViewer::Colouring_Pressure);
+    }
+    
+    if (SnapshotRecorderPointer)
+    {
+        SnapshotRecorderPointer->Capture(Voxels, TimeStep, TimeStep / SimulatorPointer->GetSamplingRate());
+    }
+}
+
+PL_RESULT PL_SCENE::StartSnapshotRecording(const char* FilePrefix, int Interval, int Stride, PL_SNAPSHOT_REGION Region, int PlaneIndex, PL_SNAPSHOT_PRECISION Precision)
+{
+    if (Voxels.Voxels.size() == 0)
+    {
+        DebugError("No voxels to record. Must call CreateVoxels");
+        return PL_ERR;
+    }
+    
+    if (Interval < 1 || Stride < 1 || Region < PL_SNAPSHOT_REGION_VOLUME || Region > PL_SNAPSHOT_REGION_PLANE_Z)
     {
         return PL_ERR_INVALID_PARAM;
     }
     
-    if (Index >= Voxels.Voxels.size())
+    if (Precision != PL_SNAPSHOT_PRECISION_FLOAT32 && Precision != PL_SNAPSHOT_PRECISION_FLOAT16)
     {
-        return PL_ERR;  // Should change this to a warning or something similar
+        return PL_ERR_INVALID_PARAM;
     }
     
-    if (VoxelThreadStatus.load() == ThreadStatus_Ongoing)
+    if (Region != PL_SNAPSHOT_REGION_VOLUME)
     {
-        *OutAbsorpivity = 0.f;
-        return PL_OK;
+        const int Axis = Region - PL_SNAPSHOT_REGION_PLANE_X;
+        
+        if (PlaneIndex < 0 || PlaneIndex >= Voxels.Size(0, Axis))
+        {
+            DebugError("Snapshot plane is outside the lattice");
+            return PL_ERR_INVALID_PARAM;
+        }
     }
     
-    *OutAbsorpivity = Voxels.Voxels[Index].Absorptivity;
+    PLVector BottomBackLeft;
+    GetScenePositionBottomBackLeftCorner(&BottomBackLeft);
+    
+    if (!SnapshotRecorderPointer)
+    {
+        SnapshotRecorderPointer = std::unique_ptr<SnapshotRecorder>(new SnapshotRecorder());
+    }
+    
+    SnapshotRecorderPointer->Start(FilePrefix, Interval, Stride, Region, PlaneIndex, Precision, Voxels, BottomBackLeft);
     
     return PL_OK;
 }
 
-PL_RESULT PL_SCENE::GetMeshes(const std::vector<PL_MESH>** OutMeshes) const
+PL_RESULT PL_SCENE::StopSnapshotRecording()
 {
-    *OutMeshes = &Meshes;
+    if (SnapshotRecorderPointer)
+    {
+        SnapshotRecorderPointer->Stop();
+        SnapshotRecorderPointer.reset();
+    }
+    
+    return PL_OK;
+}
+
+PL_RESULT PL_SCENE::OpenDebugViewer()
+{
+    if (!DebugViewerPointer)
+    {
+        DebugViewerPointer = std::unique_ptr<DebugViewer>(new DebugViewer());
+    }
+    
+    const PL_RESULT Result = DebugViewerPointer->Open();
+    
+    // While voxelising, the voxel thread sends the first snapshot itself
+    if (Result == PL_OK && VoxelThreadStatus.load() != ThreadStatus_Ongoing)
+    {
+        PublishDebugSnapshot(DebugViewer::Colouring_Regions);
+    }
+    
+    return Result;
+}
+
+PL_RESULT PL_SCENE::UpdateDebugViewer()
+{
+    if (DebugViewerPointer)
+    {
+        DebugViewerPointer->Update();
+    }
+    
+    return PL_OK;
+}
+
+void PL_SCENE::PublishDebugSnapshot(int AirColouring) const
+{
+    if (DebugViewerPointer && DebugViewerPointer->IsOpen())
+    {
+        DebugViewerPointer->Publish(*this, static_cast<DebugViewer::Colouring>(AirColouring));
+    }
+}
+
+PL_RESULT PL_SCENE::SetWarmStartDistance(float MaxDistance)
+{
+    if (MaxDistance < 0.0f)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    WarmStartDistance = MaxDistance;
+    return PL_OK;
+}
+
+PL_RESULT PL_SCENE::SetMeshSimplification(bool bEnabled, float MaxErrorInVoxels)
+{
+    if (MaxErrorInVoxels <= 0.0f || MaxErrorInVoxels > 1.0f)
+    {
+        DebugError("Mesh simplification error must be more than 0 and at most 1 voxel");
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    bSimplifyMeshes = bEnabled;
+    SimplificationError = MaxErrorInVoxels;
+    return PL_OK;
+}
+
+PL_RESULT PL_SCENE::BenchmarkWarmStart(PLVector FromLocation, PLVector ToLocation, float* OutRelativeError, float* OutSpeedup)
+{
+    if (!OutRelativeError || !OutSpeedup)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    int ToIndex;
+    if (GetVoxelIndexOfPosition(ToLocation, &ToIndex) != PL_OK)
+    {
+        DebugError("Benchmark location is outside the lattice");
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    // Cells to compare. Either the sources, or the whole plane the 2D simulation runs over
+    std::vector<int> ProbeIndices;
+    for (const PLVector& SourceLocation : SourceLocations)
+    {
+        int SourceIndex;
+        if (GetVoxelIndexOfPosition(SourceLocation, &SourceIndex) == PL_OK)
+        {
+            ProbeIndices.push_back(SourceIndex);
+        }
+    }
+    
+    if (ProbeIndices.size() == 0)
+    {
+        int ToX, ToY, ToZ;
+        GetThreeDimensionalIndexOfIndex(ToIndex, ToX, ToY, ToZ);
+        for (int z = 0; z < Voxels.Size(0,2); ++z)
+        {
+            for (int x = 0; x < Voxels.Size(0,0); ++x)
+            {
+                ProbeIndices.push_back(ThreeDimToOneDim(x, ToY, z, Voxels.Size(0,0), Voxels.Size(0,1)));
+            }
+        }
+    }
+    
+    const float SavedWarmStartDistance = WarmStartDistance;
+    
+    // Full simulation to start from
+    InvalidateWarmStart();
+    WarmStartDistance = 0.0f;
+    PL_RESULT Result = Simulate(FromLocation);
+    if (Result != PL_OK)
+    {
+        WarmStartDistance = SavedWarmStartDistance;
+        return Result;
+    }
+    
+    // Warm start, however far away the new location is
+    WarmStartDistance = std::numeric_limits<float>::max();
+    boost::timer::cpu_timer WarmTimer;
+    Result = Simulate(ToLocation);
+    WarmTimer.stop();
+    if (Result != PL_OK)
+    {
+        WarmStartDistance = SavedWarmStartDistance;
+        return Result;
+    }
+    
+    std::vector<double> WarmResponses;
+    WarmResponses.reserve(ProbeIndices.size() * TimeSteps);
+    for (int ProbeIndex : ProbeIndices)
+    {
+        for (const PLVoxel& Sample : SimulatorPointer->GetSimulatedLattice()[ProbeIndex])
+        {
+            WarmResponses.push_back(Sample.AirPressure);
+        }
+    }
+    
+    // Reference full simulation
+    InvalidateWarmStart();
+    WarmStartDistance = 0.0f;
+    boost::timer::cpu_timer FullTimer;
+    Result = Simulate(ToLocation);
+    FullTimer.stop();
+    if (Result != PL_OK)
+    {
+        WarmStartDistance = SavedWarmStartDistance;
+        return Result;
+    }
+    
+    double ErrorEnergy = 0.0;
+    double ReferenceEnergy = 0.0;
+    int SampleIndex = 0;
+    for (int ProbeIndex : ProbeIndices)
+    {
+        for (const PLVoxel& Sample : SimulatorPointer->GetSimulatedLattice()[ProbeIndex])
+        {
+            const double Difference = WarmResponses[SampleIndex++] - Sample.AirPressure;
+            ErrorEnergy += Difference * Difference;
+            ReferenceEnergy += Sample.AirPressure * Sample.AirPressure;
+        }
+    }
+    
+    WarmStartDistance = SavedWarmStartDistance;
+    
+    *OutRelativeError = ReferenceEnergy > 0.0 ? static_cast<float>(std::sqrt(ErrorEnergy / ReferenceEnergy)) : 0.0f;
+    
+    const double WarmSeconds = std::max<double>(WarmTimer.elapsed().wall, 1.0);
+    *OutSpeedup = static_cast<float>(FullTimer.elapsed().wall / WarmSeconds);
+    
+    PL_LOG(PL_DEBUG_LEVEL_LOG, "Warm start benchmark. Relative Error: " << *OutRelativeError << ". Warm: " << WarmTimer.elapsed().wall / 1e9 << "s. Full: " << FullTimer.elapsed().wall / 1e9 << "s. Speedup: " << *OutSpeedup);
+    
+    return PL_OK;
+}
+
+bool PL_SCENE::TryWarmStart(int VoxelIndex)
+{
+    if (WarmStartDistance <= 0.0f || !SimulatorPointer || FullSimulationVoxelIndex < 0 || CurrentSimulationVoxelIndex < 0)
+    {
+        return false;
+    }
+    
+    // A pulse inside geometry behaves nothing like a pulse in the air next to it
+    if (Voxels.Voxels[VoxelIndex].Beta == 0)
+    {
+        return false;
+    }
+    
+    // Nor does a pulse on the other side of a wall. The shifted field would leak straight through it
+    if (AirRegionsPointer && AirRegionsPointer->GetRegion(VoxelIndex) != AirRegionsPointer->GetRegion(FullSimulationVoxelIndex))
+    {
+        return false;
+    }
+    
+    int FullX, FullY, FullZ;
+    int CurrentX, CurrentY, CurrentZ;
+    int NewX, NewY, NewZ;
+    GetThreeDimensionalIndexOfIndex(FullSimulationVoxelIndex, FullX, FullY, FullZ);
+    GetThreeDimensionalIndexOfIndex(CurrentSimulationVoxelIndex, CurrentX, CurrentY, CurrentZ);
+    GetThreeDimensionalIndexOfIndex(VoxelIndex, NewX, NewY, NewZ);
+    
+    // Measure from the full simulation so lots of small moves can't drift away from it
+    const float DistanceX = static_cast<float>(NewX - FullX);
+    const float DistanceY = static_cast<float>(NewY - FullY);
+    const float DistanceZ = static_cast<float>(NewZ - FullZ);
+    const float Distance = std::sqrt(DistanceX * DistanceX + DistanceY * DistanceY + DistanceZ * DistanceZ) * VoxelSize;
+    
+    if (Distance > WarmStartDistance)
+    {
+        return false;
+    }
+    
+    SimulatorPointer->ShiftSimulatedLattice(NewX - CurrentX, NewY - CurrentY, NewZ - CurrentZ);
+    CurrentSimulationVoxelIndex = VoxelIndex;
+    return true;
+}
+
+void PL_SCENE::UpdateActiveRegions(int SimulationVoxelIndex)
+{
+    std::vector<int> VoxelIndices { SimulationVoxelIndex };
+    
+    for (const std::vector<PLVector>* Locations : { &ListenerLocations, &SourceLocations })
+    {
+        for (const PLVector& Location : *Locations)
+        {
+            int VoxelIndex;
+            if (GetVoxelIndexOfPosition(Location, &VoxelIndex) == PL_OK)
+            {
+                VoxelIndices.push_back(VoxelIndex);
+            }
+        }
+    }
+    
+    AirRegionsPointer->Activate(VoxelIndices);
+}
+
+void PL_SCENE::InvalidateWarmStart()
+{
+    FullSimulationVoxelIndex = -1;
+    CurrentSimulationVoxelIndex = -1;
+}
+
+PL_RESULT PL_SCENE::VoxeliseInternal()
+{
+    VoxelThreadStatus.store(ThreadStatus_Ongoing);
+    
+    return FillVoxels();
+}
+
+PL_RESULT PL_SCENE::GenerateProbes(PL_PROBE_PLACEMENT Placement, float Spacing, const std::vector<PLVector>& Seeds, int MaxProbes, int* OutProbeCount)
+{
+    if (!OutProbeCount || Placement < PL_PROBE_PLACEMENT_UNIFORM || Placement > PL_PROBE_PLACEMENT_SEEDED)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    *OutProbeCount = 0;
+    
+    if (VoxelThread.joinable())
+    {
+        VoxelThread.join();
+    }
+    
+    if (Placement != PL_PROBE_PLACEMENT_SEEDED)
+    {
+        const size_t PreviousCount = ListenerLocations.size();
+        PL_RESULT Result = ProbeGrid::PlaceProbes(this, Placement, Spacing, MaxProbes, ListenerLocations);
+        *OutProbeCount = static_cast<int>(ListenerLocations.size() - PreviousCount);
+        return Result;
+    }
+    
+    std::vector<PLVector> ActualSeeds = Seeds;
+    if (ActualSeeds.size() == 0)
+    {
+        PLVector ListenerLocation;
+        GetListenerLocation(&ListenerLocation);
+        ActualSeeds.push_back(ListenerLocation);
+    }
+    
+    const size_t PreviousCount = ListenerLocations.size();
+    ProbeGenerator Generator;
+    PL_RESULT Result = Generator.Generate(this, ActualSeeds, Spacing, MaxProbes, ListenerLocations);
+    *OutProbeCount = static_cast<int>(ListenerLocations.size() - PreviousCount);
+    return Result;
+}
+
+PL_RESULT PL_SCENE::BakeProbes()
+{
+    if (ListenerLocations.size() == 0)
+    {
+        DebugError("Can't bake probes. Add listener locations or generate probes first");
+        return PL_ERR;
+    }
+    
+    if (VoxelThread.joinable())
+    {
+        VoxelThread.join();
+    }
+    
+    // Every probe needs its own full simulation
+    const float SavedWarmStartDistance = WarmStartDistance;
+    WarmStartDistance = 0.0f;
+    
+    std::unique_ptr<ProbeGrid> NewProbeGrid (new ProbeGrid());
+    PL_RESULT Result = NewProbeGrid->Bake(this, ListenerLocations);
+    
+    WarmStartDistance = SavedWarmStartDistance;
+    
+    if (Result == PL_OK)
+    {
+        ProbeGridPointer = std::move(NewProbeGrid);
+    }
+    
+    return Result;
+}
+
+PL_RESULT PL_SCENE::GetBakedOcclusion(const PLVector& EmitterLocation, float* OutOcclusion) const
+{
+    if (!OutOcclusion)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    // Filling the voxels throws the bake away on the voxel thread. PL_Scene_BakeProbes joins it before baking again
+    if (VoxelThread.joinable() || !ProbeGridPointer)
+    {
+        return PL_ERR;
+    }
+    
+    int ListenerIndex;
+    int EmitterIndex;
+    GetListenerVoxelIndex(&ListenerIndex);
+    
+    if (ListenerIndex < 0 || GetVoxelIndexOfPosition(EmitterLocation, &EmitterIndex) != PL_OK)
+    {
+        *OutOcclusion = 1;
+        return PL_OK;
+    }
+    
+    return ProbeGridPointer->GetOcclusion(ListenerIndex, EmitterIndex, OutOcclusion);
+}
+
+PL_RESULT PL_SCENE::TraceOcclusion(const PLVector* EmitterLocations, int Count, float* OutOcclusions) const
+{
+    if (!EmitterLocations || !OutOcclusions || Count < 0)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    if (VoxelThreadStatus.load() == ThreadStatus_Ongoing || !OccupancyGridPointer)
+    {
+        std::fill(OutOcclusions, OutOcclusions + Count, 1.0f);
+        return PL_OK;
+    }
+    
+    PLVector ListenerLocation;
+    GetListenerLocation(&ListenerLocation);
+    
+    std::vector<int> SolidVoxels(Count);
+    OccupancyGridPointer->TraceBatch(ListenerLocation, EmitterLocations, Count, OutOcclusions, SolidVoxels.data());
+    
+    for (int i = 0; i < Count; ++i)
+    {
+        OutOcclusions[i] = OccupancyGrid::ThicknessToOcclusion(OutOcclusions[i]);
+    }
+    
+    return PL_OK;
+}
+
+PL_RESULT PL_SCENE::SolveFrequencyResponse(const PLVector& SourceLocation, const float* Frequencies, int FrequenciesLength, float* OutReal, float* OutImaginary, int OutLength) const
+{
+    const int ListenerCount = static_cast<int>(ListenerLocations.size());
+    
+    if (!Frequencies || !OutReal || !OutImaginary || FrequenciesLength < 0 || OutLength < FrequenciesLength * ListenerCount)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    if (VoxelThreadStatus.load() == ThreadStatus_Ongoing || Voxels.Voxels.empty())
+    {
+        DebugWarn("Can't solve the frequency response until the voxels are filled");
+        return PL_ERR;
+    }
+    
+    int SourceIndex;
+    
+    if (!Voxels.Bounds.contains(Eigen::Vector3d(SourceLocation.X, SourceLocation.Y, SourceLocation.Z)) || GetVoxelIndexOfPosition(SourceLocation, &SourceIndex) != PL_OK)
+    {
+        DebugWarn("Frequency response source is outside the voxel lattice");
+        return PL_ERR;
+    }
+    
+    // Listeners outside the lattice hear nothing
+    std::vector<int> ListenerIndices (ListenerCount, -1);
+    
+    for (int Listener = 0; Listener < ListenerCount; ++Listener)
+    {
+        const PLVector& Location = ListenerLocations[Listener];
+        
+        if (Voxels.Bounds.contains(Eigen::Vector3d(Location.X, Location.Y, Location.Z)))
+        {
+            GetVoxelIndexOfPosition(Location, &ListenerIndices[Listener]);
+        }
+    }
+    
+    HelmholtzSolver Solver;
+    Solver.Build(Voxels);
+    
+    std::vector<HelmholtzSolver::Complex> Pressure;
+    PL_RESULT Result = PL_OK;
+    
+    for (int Frequency = 0; Frequency < FrequenciesLength; ++Frequency)
+    {
+        // The best answer found is still written out if the solve doesn't converge
+        if (!Solver.Solve(SourceIndex, Frequencies[Frequency], Pressure))
+        {
+            Result = PL_ERR;
+        }
+        
+        for (int Listener = 0; Listener < ListenerCount; ++Listener)
+        {
+            const int ListenerIndex = ListenerIndices[Listener];
+            const HelmholtzSolver::Complex Value = ListenerIndex >= 0 && ListenerIndex < static_cast<int>(Pressure.size()) ? Pressure[ListenerIndex] : HelmholtzSolver::Complex();
+            
+            OutReal[Frequency * ListenerCount + Listener] = static_cast<float>(Value.real());
+            OutImaginary[Frequency * ListenerCount + Listener] = static_cast<float>(Value.imag());
+        }
+    }
+    
+    return Result;
+}
+
+PL_RESULT PL_SCENE::UpdateGeodesicField()
+{
+    if (VoxelThreadStatus.load() == ThreadStatus_Ongoing)
+    {
+        DebugWarn("Can't find geodesic paths while the voxels are being filled");
+        return PL_ERR;
+    }
+    
+    int ListenerIndex;
+    GetListenerVoxelIndex(&ListenerIndex);
+    
+    std::unique_ptr<GeodesicField> NewGeodesicField (new GeodesicField());
+    NewGeodesicField->Calculate(Voxels, ListenerIndex);
+    GeodesicFieldPointer = std::move(NewGeodesicField);
+    
+    return PL_OK;
+}
+
+PL_RESULT PL_SCENE::GetGeodesicPath(const PLVector& EmitterLocation, float* OutDistance, PLVector* OutDirection) const
+{
+    if (!OutDistance || !OutDirection)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    if (VoxelThreadStatus.load() == ThreadStatus_Ongoing || !GeodesicFieldPointer)
+    {
+        DebugWarn("No geodesic field yet. Must call UpdateGeodesicField");
+        return PL_ERR;
+    }
+    
+    PLVector ListenerLocation;
+    GetListenerLocation(&ListenerLocation);
+    
+    const Eigen::Vector3f Straight (EmitterLocation.X - ListenerLocation.X, EmitterLocation.Y - ListenerLocation.Y, EmitterLocation.Z - ListenerLocation.Z);
+    
+    *OutDistance = Straight.norm();
+    *OutDirection = *OutDistance > 0.0f ? PLVector(Straight.x() / *OutDistance, Straight.y() / *OutDistance, Straight.z() / *OutDistance) : PLVector(0, 0, 0);
+    
+    int EmitterIndex;
+    const bool bEmitterInLattice = Voxels.Bounds.contains(Eigen::Vector3d(EmitterLocation.X, EmitterLocation.Y, EmitterLocation.Z));
+    
+    if (!bEmitterInLattice || GetVoxelIndexOfPosition(EmitterLocation, &EmitterIndex) != PL_OK || GeodesicFieldPointer->GetDistance(EmitterIndex) == GeodesicField::Unreachable)
+    {
+        return PL_OK;
+    }
+    
+    const Eigen::Vector3f Direction = GeodesicFieldPointer->GetDirection(EmitterIndex);
+    
+    // Emitters in the listener's voxel have no path to follow
+    if (Direction.isZero())
+    {
+        return PL_OK;
+    }
+    
+    // The field is measured between voxel centers, so never report less than the straight line
+    *OutDistance = std::max(*OutDistance, GeodesicFieldPointer->GetDistanceInMeters(EmitterIndex));
+    *OutDirection = PLVector(Direction.x(), Direction.y(), Direction.z());
+    
+    return PL_OK;
+}
+
+PL_RESULT PL_SCENE::GetRoomGraphSize(int* OutRoomCount, int* OutPortalCount) const
+{
+    if (!OutRoomCount || !OutPortalCount)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    if (VoxelThreadStatus.load() == ThreadStatus_Ongoing || !RoomGraphPointer)
+    {
+        *OutRoomCount = 0;
+        *OutPortalCount = 0;
+        return PL_OK;
+    }
+    
+    *OutRoomCount = static_cast<int>(RoomGraphPointer->GetRooms().size());
+    *OutPortalCount = static_cast<int>(RoomGraphPointer->GetPortals().size());
+    
+    return PL_OK;
+}
+
+PL_RESULT PL_SCENE::GetRoom(const PLVector& Location, int* OutRoom) const
+{
+    if (!OutRoom)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    *OutRoom = -1;
+    
+    if (VoxelThreadStatus.load() == ThreadStatus_Ongoing || !RoomGraphPointer)
+    {
+        DebugWarn("No room graph yet. Must call FillVoxelsWithGeometry");
+        return PL_ERR;
+    }
+    
+    int VoxelIndex;
+    const bool bInLattice = Voxels.Bounds.contains(Eigen::Vector3d(Location.X, Location.Y, Location.Z));
+    
+    if (bInLattice && GetVoxelIndexOfPosition(Location, &VoxelIndex) == PL_OK && RoomGraphPointer->GetRoom(VoxelIndex) != RoomGraph::NoRoom)
+    {
+        *OutRoom = static_cast<int>(RoomGraphPointer->GetRoom(VoxelIndex));
+    }
+    
+    return PL_OK;
+}
+
+PL_RESULT PL_SCENE::GetPortal(int PortalIndex, int* OutRoomA, int* OutRoomB, PLVector* OutPosition, float* OutArea) const
+{
+    if (!OutRoomA || !OutRoomB || !OutPosition || !OutArea)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    if (VoxelThreadStatus.load() == ThreadStatus_Ongoing || !RoomGraphPointer)
+    {
+        return PL_ERR;
+    }
+    
+    const std::vector<RoomGraph::Portal>& Portals = RoomGraphPointer->GetPortals();
+    
+    if (PortalIndex < 0 || PortalIndex >= Portals.size())
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    const RoomGraph::Portal& Portal = Portals[PortalIndex];
+    *OutRoomA = Portal.RoomA;
+    *OutRoomB = Portal.RoomB;
+    *OutPosition = Portal.Position;
+    *OutArea = Portal.Area;
+    
+    return PL_OK;
+}
+
+PL_RESULT PL_SCENE::FindRoomPath(const PLVector& From, const PLVector& To, int* OutPortals, int MaxPortals, int* OutPortalCount, float* OutDistance) const
+{
+    if ((!OutPortals && MaxPortals > 0) || !OutPortalCount || !OutDistance)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    int FromRoom, ToRoom;
+    
+    if (GetRoom(From, &FromRoom) != PL_OK || GetRoom(To, &ToRoom) != PL_OK)
+    {
+        return PL_ERR;
+    }
+    
+    std::vector<int> Path;
+    
+    if (!RoomGraphPointer->FindPath(From, static_cast<uint32_t>(FromRoom), To, static_cast<uint32_t>(ToRoom), Path, *OutDistance))
+    {
+        DebugWarn("No route between the locations. They may be in geometry or in air that isn't connected");
+        return PL_ERR;
+    }
+    
+    *OutPortalCount = static_cast<int>(Path.size());
+    std::copy(Path.begin(), Path.begin() + std::min(static_cast<int>(Path.size()), std::max(MaxPortals, 0)), OutPortals);
+    
+    return PL_OK;
+}
+
+PL_RESULT PL_SCENE::GetVoxelsCount(int* OutVoxelCount) const
+{
+    if (VoxelThreadStatus.load() == ThreadStatus_Ongoing)
+    {
+        *OutVoxelCount = 0;
+        return PL_OK;
+    }
+    
+    if (!OutVoxelCount)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    *OutVoxelCount = static_cast<int>(Voxels.Voxels.size());
+    
+    return PL_OK;
+}
+
+PL_RESULT PL_SCENE::GetVoxelLocation(PLVector* OutVoxelLocation, int Index) const
+{
+    if (VoxelThreadStatus.load() == ThreadStatus_Ongoing)
+    {
+        *OutVoxelLocation = PLVector();
+        return PL_OK;
+    }
+    
+    if (!OutVoxelLocation || Index < 0)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    if (Index >= Voxels.Voxels.size())
+    {
+        return PL_ERR;  // Should change this to a warning or something similar
+    }
+    
+    return GetVoxelPosition(Index, OutVoxelLocation);
+}
+
+PL_RESULT PL_SCENE::GetVoxelAbsorpivity(float* OutAbsorpivity, int Index) const
+{
+    if (!OutAbsorpivity || Index < 0)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    if (Index >= Voxels.Voxels.size())
+    {
+        return PL_ERR;  // Should change this to a warning or something similar
+    }
+    
+    if (VoxelThreadStatus.load() == ThreadStatus_Ongoing)
+    {
+        *OutAbsorpivity = 0.f;
+        return PL_OK;
+    }
+    
+    *OutAbsorpivity = Voxels.Voxels[Index].Absorptivity;
+    
+    return PL_OK;
+}
+
+PL_RESULT PL_SCENE::GetDistanceToGeometry(const PLVector& Location, float* OutDistance) const
+{
+    if (!OutDistance)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    if (VoxelThreadStatus.load() == ThreadStatus_Ongoing || !DistanceFieldPointer)
+    {
+        DebugWarn("No distance field yet. Must call FillVoxelsWithGeometry");
+        return PL_ERR;
+    }
+    
+    int VoxelIndex;
+    if (GetVoxelIndexOfPosition(Location, &VoxelIndex) != PL_OK)
+    {
+        return PL_ERR;
+    }
+    
+    *OutDistance = DistanceFieldPointer->GetDistanceInMeters(VoxelIndex);
+    
+    return PL_OK;
+}
+
+PL_RESULT PL_SCENE::GetVoxelRegion(int* OutRegion, bool* OutActive, int Index) const
+{
+    if (!OutRegion || !OutActive || Index < 0)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    if (Index >= Voxels.Voxels.size())
+    {
+        return PL_ERR;
+    }
+    
+    if (VoxelThreadStatus.load() == ThreadStatus_Ongoing || !AirRegionsPointer)
+    {
+        *OutRegion = 0;
+        *OutActive = Voxels.Voxels[Index].Beta != 0;
+        return PL_OK;
+    }
+    
+    *OutRegion = static_cast<int>(AirRegionsPointer->GetRegion(Index));
+    *OutActive = AirRegionsPointer->IsActive(Index);
+    
+    return PL_OK;
+}
+
+PL_RESULT PL_SCENE::GetMeshes(const std::vector<PL_MESH>** OutMeshes) const
+{
+    *OutMeshes = &Meshes;
+    return PL_OK;
+}
+
+PL_RESULT PL_SCENE::GetVoxels(const PL_VOXEL_GRID** OutVoxels) const
+{
+    *OutVoxels = &Voxels;
     return PL_OK;
 }
 
@@ -713,6 +1843,54 @@ PL_RESULT PL_SCENE::GetFreeGrid(FreeGrid** OutFreeGrid) const
     return PL_OK;
 }
 
+PL_RESULT PL_SCENE::GetDistanceField(const DistanceField** OutDistanceField) const
+{
+    if (!OutDistanceField)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    *OutDistanceField = VoxelThreadStatus.load() == ThreadStatus_Ongoing ? nullptr : DistanceFieldPointer.get();
+    
+    return PL_OK;
+}
+
+PL_RESULT PL_SCENE::GetAirRegions(const AirRegions** OutAirRegions) const
+{
+    if (!OutAirRegions)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    *OutAirRegions = VoxelThreadStatus.load() == ThreadStatus_Ongoing ? nullptr : AirRegionsPointer.get();
+    
+    return PL_OK;
+}
+
+PL_RESULT PL_SCENE::GetOccupancyGrid(const OccupancyGrid** OutOccupancyGrid) const
+{
+    if (!OutOccupancyGrid)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    *OutOccupancyGrid = VoxelThreadStatus.load() == ThreadStatus_Ongoing ? nullptr : OccupancyGridPointer.get();
+    
+    return PL_OK;
+}
+
+PL_RESULT PL_SCENE::GetTriangleBVH(const TriangleBVH** OutTriangleBVH) const
+{
+    if (!OutTriangleBVH)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    *OutTriangleBVH = VoxelThreadStatus.load() == ThreadStatus_Ongoing ? nullptr : TriangleBVHPointer.get();
+    
+    return PL_OK;
+}
+
 PL_RESULT PL_SCENE::GetVoxelLatticeSize(int& X, int& Y, int& Z) const
 {
     X = Voxels.Size(0,0);
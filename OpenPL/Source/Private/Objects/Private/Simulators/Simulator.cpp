@@ -21,6 +21,7 @@ void Simulator::Init(PL_SCENE* Scene, PL_VOXEL_GRID& Voxels, PL_SIMULATION_SETTI
     this->TimeSteps = Settings.TimeSteps;
     this->Lattice = &Voxels.Voxels;
     this->Settings = Settings;
+    this->VoxelSize = Voxels.VoxelSize;
     
     this->OwningScene = Scene;
     
@@ -31,14 +32,19 @@ void Simulator::Init(PL_SCENE* Scene, PL_VOXEL_GRID& Voxels, PL_SIMULATION_SETTI
         VoxelVector.resize(TimeSteps);
     }
     
-    const double SpeedOfSound = 343.21f;
-    const double MinWaveLength = SpeedOfSound / Settings.Resolution;    // divided by min frequency for simulation. 275 is pretty low and should be fast
-    const double MetersPerGridCell = MinWaveLength / 3.5f;
-    const double SecondsPerSample = MetersPerGridCell / (SpeedOfSound * 1.5f);
-    SamplingRate  = 1.0f / SecondsPerSample;
+    const double MetersPerGridCell = Voxels.VoxelSize;
+    const double ResolvableFrequency = SpeedOfSound / (MetersPerGridCell * GetVoxelsPerWavelength());
+    MaxFrequency = std::min(static_cast<double>(Settings.Resolution), ResolvableFrequency);
     
-    // Need to calculate these coefficents properly
-    UpdateCoefficents = SpeedOfSound * SecondsPerSample / MetersPerGridCell;
+    if (MaxFrequency < Settings.Resolution)
+    {
+        PL_LOG(PL_DEBUG_LEVEL_WARN, "Voxels of " << MetersPerGridCell << "m can only resolve up to " << ResolvableFrequency << "Hz, not the " << static_cast<int>(Settings.Resolution) << "Hz asked for. Use voxels of " << SpeedOfSound / (Settings.Resolution * GetVoxelsPerWavelength()) << "m or less");
+    }
+    
+    // The biggest stable step needs the fewest steps per second of sound
+    UpdateCoefficents = StabilityMargin * GetCourantLimit();
+    const double SecondsPerSample = UpdateCoefficents * MetersPerGridCell / SpeedOfSound;
+    SamplingRate = 1.0 / SecondsPerSample;
     
     GaussianPulse();
 }
@@ -63,11 +69,62 @@ int Simulator::GetTimeSteps() const
     return TimeSteps;
 }
 
+double Simulator::GetCourantNumber() const
+{
+    return UpdateCoefficents;
+}
+
+float Simulator::GetMaxFrequency() const
+{
+    return static_cast<float>(MaxFrequency);
+}
+
+void Simulator::ShiftSimulatedLattice(int OffsetX, int OffsetY, int OffsetZ)
+{
+    if (OffsetX == 0 && OffsetY == 0 && OffsetZ == 0)
+    {
+        return;
+    }
+    
+    // Each cell's response is its own vector, so moving them around is just swapping pointers
+    std::vector<std::vector<PLVoxel>> ShiftedLattice(CubeSize);
+    
+    for (int z = 0; z < ZSize; ++z)
+    {
+        for (int y = 0; y < YSize; ++y)
+        {
+            for (int x = 0; x < XSize; ++x)
+            {
+                const int SourceX = x - OffsetX;
+                const int SourceY = y - OffsetY;
+                const int SourceZ = z - OffsetZ;
+                
+                std::vector<PLVoxel>& ShiftedResponse = ShiftedLattice[ThreeDimToOneDim(x, y, z, XSize, YSize)];
+                
+                if (SourceX < 0 || SourceX >= XSize || SourceY < 0 || SourceY >= YSize || SourceZ < 0 || SourceZ >= ZSize)
+                {
+                    ShiftedResponse.resize(TimeSteps, PLVoxel());
+                    continue;
+                }
+                
+                ShiftedResponse = std::move(SimulatedLattice[ThreeDimToOneDim(SourceX, SourceY, SourceZ, XSize, YSize)]);
+            }
+        }
+    }
+    
+    SimulatedLattice.swap(ShiftedLattice);
+}
+
+void Simulator::SetActiveVoxels(const std::vector<uint8_t>* ActiveVoxels)
+{
+    this->ActiveVoxels = ActiveVoxels;
+}
+
 void Simulator::GaussianPulse()
 {
     Pulse.resize(TimeSteps);
     
-    const float maxFreq = static_cast<float>(Settings.Resolution);
+    const float maxFreq = static_cast<float>(MaxFrequency);
     const float pi = std::acos(-1);
     float sigma = 1.0f / (0.5 * pi * maxFreq);
 
@@ -81,3 +138,61 @@ void Simulator::GaussianPulse()
         Pulse[i] = val;
     }
 }
+
+void Simulator::ResetLattice()
+{
+    for (PLVoxel& Voxel : *Lattice)
+    {
+        Voxel.AirPressure = 0.0f;
+        Voxel.ParticleVelocityX = 0.0f;
+        Voxel.ParticleVelocityY = 0.0f;
+        Voxel.ParticleVelocityZ = 0.0f;
+    }
+}
+
+void Simulator::AbsorbAtEdges(int y)
+{
+    if (XSize > 1)
+    {
+        for (int z = 0; z < ZSize; ++z)
+        {
+            const int Index1 = ThreeDimToOneDim(0, y, z, XSize, YSize);
+            const int Index2 = ThreeDimToOneDim(XSize - 1, y, z, XSize, YSize);
+            
+            (*Lattice)[Index1].ParticleVelocityX = -(*Lattice)[Index1].AirPressure;
+            (*Lattice)[Index2].ParticleVelocityX = (*Lattice)[Index2 - 1].AirPressure;
+        }
+    }
+    
+    if (ZSize > 1)
+    {
+        for (int x = 0; x < XSize; ++x)
+        {
+            const int Index1 = ThreeDimToOneDim(x, y, 0, XSize, YSize);
+            const int Index2 = ThreeDimToOneDim(x, y, ZSize - 1, XSize, YSize);
+            
+            (*Lattice)[Index1].ParticleVelocityZ = -(*Lattice)[Index1].AirPressure;
+            (*Lattice)[Index2].ParticleVelocityZ = (*Lattice)[Index2 - SquareSize].AirPressure;
+        }
+    }
+}
+
+void Simulator::RecordTimeStep(int CurrentTimeStep)
+{
+    for (int i = 0; i < CubeSize; i++)
+    {
+        // Disconnected air is silent and the response starts silent. Walls still hold boundary velocities
+        if (IsActive(i) || (*Lattice)[i].Beta == 0)
+        {
+            SimulatedLattice[i][CurrentTimeStep] = (*Lattice)[i];
+        }
+    }
+}
+
+void Simulator::ReportProgress(int CurrentTimeStep)
+{
+    if (OwningScene)
+    {
+        OwningScene->OnSimulationProgress(CurrentTimeStep);
+    }
+}
@@ -0,0 +1,332 @@
+/*
+  ==============================================================================
+  
+    SimulatorADI.cpp
+    Created: 19 Oct 2026 3:02:51am
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#include "Simulators/SimulatorADI.h"
+#include "OpenPLCommonPrivate.h"
+
+double SimulatorADI::GetCourantLimit() const
+{
+    const double ExplicitLimit = 1.0 / std::sqrt(static_cast<double>(GetDimensions()));
+    
+    if (VoxelSize <= 0.0 || Settings.Resolution <= 0)
+    {
+        return ExplicitLimit;
+    }
+    
+    // Solves ExplicitVoxelsPerWavelength * sqrt(4 C^2 + 2) = voxels per wavelength at the resolution, from the error in GetVoxelsPerWavelength
+    const double Ratio = SpeedOfSound / (Settings.Resolution * VoxelSize * ExplicitVoxelsPerWavelength);
+    return std::max(ExplicitLimit, std::sqrt(std::max(0.0, (Ratio * Ratio - 2.0) / 4.0)));
+}
+
+double SimulatorADI::GetVoxelsPerWavelength() const
+{
+    // At the Courant number that's actually run, so the resolution that picked it is never just out of reach
+    const double Courant = StabilityMargin * GetCourantLimit();
+    
+    // Equal errors need the voxels to shrink by the square root of the ratio of the error terms
+    return ExplicitVoxelsPerWavelength * std::sqrt(4.0 * Courant * Courant + 2.0);
+}
+
+bool SimulatorADI::Simulate(int SimulateVoxelIndex)
+{
+    if (Lattice == nullptr || Lattice->size() == 0)
+    {
+        DebugError("Voxel lattice is either null or has no voxels!");
+        return false;
+    }
+    
+    ResetLattice();
+    
+    int SourceX, y, SourceZ;
+    IndexToThreeDim(SimulateVoxelIndex, XSize, YSize, SourceX, y, SourceZ);
+    
+    BuildFactors(y);
+    
+    // The pressure planes have a silent border so the explicit part needs no edge checks.
+    // Nothing is written yet, so each worker can zero the rows it sweeps and keep them on its NUMA node
+    const int Stride = XSize + 2;
+    std::vector<double, FirstTouchAllocator<double>> Pressure (Stride * (ZSize + 2));
+    std::vector<double, FirstTouchAllocator<double>> PreviousPressure (Pressure.size());
+    
+    // Change in pressure over the step, p(n+1) - 2 p(n) + p(n-1), solved in place from the explicit part
+    std::vector<double, FirstTouchAllocator<double>> Change (XSize * ZSize);
+    
+    const int Source = (SourceX + 1) + (SourceZ + 1) * Stride;
+    const double CourantSquared = UpdateCoefficents * UpdateCoefficents;
+    const int RowBlocks = (ZSize + BatchSize - 1) / BatchSize;
+    PLVoxelLattice& Voxels = *Lattice;
+    
+    // Four sweeps a step are too short to start threads for each, so the workers live for the whole simulation and wait for each other between sweeps
+    ParallelWorkers(ZSize, [&](int Worker, int WorkerCount, boost::barrier& Barrier)
+    {
+        int FirstZ, EndZ, FirstBlock, EndBlock, FirstX, EndX;
+        GetParallelChunk(Worker, WorkerCount, 0, ZSize, FirstZ, EndZ);
+        GetParallelChunk(Worker, WorkerCount, 0, RowBlocks, FirstBlock, EndBlock);
+        GetParallelChunk(Worker, WorkerCount, 0, XSize, FirstX, EndX);
+        
+        std::vector<double> Block (XSize * BatchSize, 0.0);
+        
+        if (FirstZ < EndZ)
+        {
+            // The first and last workers also take the border rows
+            const int FirstRow = FirstZ == 0 ? 0 : FirstZ + 1;
+            const int EndRow = EndZ == ZSize ? ZSize + 2 : EndZ + 1;
+            std::fill(Pressure.begin() + FirstRow * Stride, Pressure.begin() + EndRow * Stride, 0.0);
+            std::fill(PreviousPressure.begin() + FirstRow * Stride, PreviousPressure.begin() + EndRow * Stride, 0.0);
+            std::fill(Change.begin() + FirstZ * XSize, Change.begin() + EndZ * XSize, 0.0);
+        }
+        
+        Barrier.wait();
+        
+        for (int CurrentTimeStep = 0; CurrentTimeStep < TimeSteps; CurrentTimeStep++)
+        {
+            for (int z = FirstZ; z < EndZ; ++z)
+            {
+                const double* Centre = &Pressure[(z + 1) * Stride + 1];
+                const double* Last = &PreviousPressure[(z + 1) * Stride + 1];
+                double* Row = &Change[z * XSize];
+                
+                for (int x = 0; x < XSize; ++x)
+                {
+                    const int Index = x + z * XSize;
+                    const double Neighbours = Centre[x - 1] + Centre[x + 1] + Centre[x - Stride] + Centre[x + Stride];
+                    
+                    Row[x] = Mask[Index] * (CourantSquared * (Neighbours - OpenNeighbours[Index] * Centre[x]) - Loss[Index] * (Centre[x] - Last[x]));
+                }
+            }
+            
+            Barrier.wait();
+            
+            // Rows, a block at a time through an interleaved copy
+            for (int BlockIndex = FirstBlock; BlockIndex < EndBlock; ++BlockIndex)
+            {
+                const int FirstRow = BlockIndex * BatchSize;
+                const int Rows = std::min(BatchSize, ZSize - FirstRow);
+                
+                for (int Line = 0; Line < Rows; ++Line)
+                {
+                    const double* Row = &Change[(FirstRow + Line) * XSize];
+                    
+                    for (int x = 0; x < XSize; ++x)
+                    {
+                        Block[x * BatchSize + Line] = Row[x];
+                    }
+                }
+                
+                const int FactorOffset = BlockIndex * XSize * BatchSize;
+                SolveLines(Block.data(), &RowFactors.Lower[FactorOffset], &RowFactors.InverseDiagonal[FactorOffset], &RowFactors.Upper[FactorOffset], XSize, BatchSize, BatchSize);
+                
+                for (int Line = 0; Line < Rows; ++Line)
+                {
+                    double* Row = &Change[(FirstRow + Line) * XSize];
+                    
+                    for (int x = 0; x < XSize; ++x)
+                    {
+                        Row[x] = Block[x * BatchSize + Line];
+                    }
+                }
+            }
+            
+            Barrier.wait();
+            
+            // Columns are already side by side
+            if (FirstX < EndX)
+            {
+                SolveLines(&Change[FirstX], &ColumnFactors.Lower[FirstX], &ColumnFactors.InverseDiagonal[FirstX], &ColumnFactors.Upper[FirstX], ZSize, EndX - FirstX, XSize);
+            }
+            
+            Barrier.wait();
+            
+            for (int z = FirstZ; z < EndZ; ++z)
+            {
+                const double* Centre = &Pressure[(z + 1) * Stride + 1];
+                double* Next = &PreviousPressure[(z + 1) * Stride + 1];
+                const double* Row = &Change[z * XSize];
+                const int LatticeRow = ThreeDimToOneDim(0, y, z, XSize, YSize);
+                
+                for (int x = 0; x < XSize; ++x)
+                {
+                    // Keep the lattice live for the response, the debug window and snapshots
+                    Voxels[LatticeRow + x].AirPressure = Centre[x];
+                    Next[x] = 2.0 * Centre[x] - Next[x] + Row[x];
+                }
+            }
+            
+            Barrier.wait();
+            
+            if (Worker == 0)
+            {
+                RecordTimeStep(CurrentTimeStep);
+                
+                // Adding the pulse to both time levels adds it to the pressure without a kick to the velocity, like SimulatorLeapfrog
+                PreviousPressure[Source] += Pulse[CurrentTimeStep];
+                Pressure[Source] += Pulse[CurrentTimeStep];
+                Pressure.swap(PreviousPressure);
+                
+                ReportProgress(CurrentTimeStep);
+            }
+            
+            Barrier.wait();
+        }
+    });
+    
+    return true;
+}
+
+void SimulatorADI::BuildFactors(int y)
+{
+    const int PlaneSize = XSize * ZSize;
+    const double Implicit = Theta * UpdateCoefficents * UpdateCoefficents;
+    
+    Mask.assign(PlaneSize, 0.0);
+    OpenNeighbours.assign(PlaneSize, 0.0);
+    Loss.assign(PlaneSize, 0.0);
+    
+    // Diagonal and neighbour coefficients of each voxel's row and column equations
+    std::vector<double> RowDiagonal (PlaneSize, 1.0);
+    std::vector<double> RowLower (PlaneSize, 0.0);
+    std::vector<double> RowUpper (PlaneSize, 0.0);
+    std::vector<double> ColumnDiagonal (PlaneSize, 1.0);
+    std::vector<double> ColumnLower (PlaneSize, 0.0);
+    std::vector<double> ColumnUpper (PlaneSize, 0.0);
+    
+    const int OffsetsX[4] = { -1, 1, 0, 0 };
+    const int OffsetsZ[4] = { 0, 0, -1, 1 };
+    
+    for (int z = 0; z < ZSize; z++)
+    {
+        for (int x = 0; x < XSize; x++)
+        {
+            const int Index = x + z * XSize;
+            const int LatticeIndex = ThreeDimToOneDim(x, y, z, XSize, YSize);
+            
+            if ((*Lattice)[LatticeIndex].Beta == 0 || !IsActive(LatticeIndex))
+            {
+                continue;
+            }
+            
+            Mask[Index] = 1.0;
+            
+            for (int Neighbour = 0; Neighbour < 4; ++Neighbour)
+            {
+                const int NeighbourX = x + OffsetsX[Neighbour];
+                const int NeighbourZ = z + OffsetsZ[Neighbour];
+                const bool bAlongX = Neighbour < 2;
+                double FaceLoss;
+                
+                if (NeighbourX < 0 || NeighbourX >= XSize || NeighbourZ < 0 || NeighbourZ >= ZSize)
+                {
+                    // Matched edge
+                    FaceLoss = UpdateCoefficents;
+                }
+                else
+                {
+                    const PLVoxel& NeighbourVoxel = (*Lattice)[ThreeDimToOneDim(NeighbourX, y, NeighbourZ, XSize, YSize)];
+                    
+                    // Air that isn't simulated still counts, like in the leapfrog. Its row is empty, so its pressure stays 0
+                    if (NeighbourVoxel.Beta != 0)
+                    {
+                        OpenNeighbours[Index] += 1.0;
+                        
+                        double& Diagonal = bAlongX ? RowDiagonal[Index] : ColumnDiagonal[Index];
+                        double& OffDiagonal = bAlongX ? (Neighbour == 0 ? RowLower[Index] : RowUpper[Index]) : (Neighbour == 2 ? ColumnLower[Index] : ColumnUpper[Index]);
+                        Diagonal += Implicit;
+                        OffDiagonal = -Implicit;
+                        continue;
+                    }
+                    
+                    FaceLoss = UpdateCoefficents * (1.0 - NeighbourVoxel.Absorptivity) / (1.0 + NeighbourVoxel.Absorptivity);
+                }
+                
+                // The loss is split between the axes, centred in time so it's stable at any step
+                Loss[Index] += FaceLoss;
+                (bAlongX ? RowDiagonal[Index] : ColumnDiagonal[Index]) += 0.5 * FaceLoss;
+            }
+        }
+    }
+    
+    // Rows of voxels that aren't simulated are just 1, which keeps their change at the 0 the explicit part gives them
+    for (int Index = 0; Index < PlaneSize; ++Index)
+    {
+        if (Mask[Index] == 0.0)
+        {
+            RowLower[Index] = RowUpper[Index] = ColumnLower[Index] = ColumnUpper[Index] = 0.0;
+        }
+    }
+    
+    // Forward elimination of the Thomas algorithm, which only depends on the matrix
+    const auto Factor = [](const double* Lower, const double* Diagonal, const double* Upper, int Length, int Step, double* OutLower, double* OutInverseDiagonal, double* OutUpper, int OutStep)
+    {
+        double PreviousUpper = 0.0;
+        
+        for (int i = 0; i < Length; ++i)
+        {
+            const double InverseDiagonal = 1.0 / (Diagonal[i * Step] - Lower[i * Step] * PreviousUpper);
+            OutLower[i * OutStep] = Lower[i * Step];
+            OutInverseDiagonal[i * OutStep] = InverseDiagonal;
+            OutUpper[i * OutStep] = Upper[i * Step] * InverseDiagonal;
+            PreviousUpper = OutUpper[i * OutStep];
+        }
+    };
+    
+    ColumnFactors.Lower.assign(PlaneSize, 0.0);
+    ColumnFactors.InverseDiagonal.assign(PlaneSize, 1.0);
+    ColumnFactors.Upper.assign(PlaneSize, 0.0);
+    
+    for (int x = 0; x < XSize; ++x)
+    {
+        Factor(&ColumnLower[x], &ColumnDiagonal[x], &ColumnUpper[x], ZSize, XSize, &ColumnFactors.Lower[x], &ColumnFactors.InverseDiagonal[x], &ColumnFactors.Upper[x], XSize);
+    }
+    
+    // Padding rows of the last block stay as identity lines
+    const int RowBlocks = (ZSize + BatchSize - 1) / BatchSize;
+    RowFactors.Lower.assign(RowBlocks * XSize * BatchSize, 0.0);
+    RowFactors.InverseDiagonal.assign(RowFactors.Lower.size(), 1.0);
+    RowFactors.Upper.assign(RowFactors.Lower.size(), 0.0);
+    
+    for (int z = 0; z < ZSize; ++z)
+    {
+        const int Offset = (z / BatchSize) * XSize * BatchSize + z % BatchSize;
+        Factor(&RowLower[z * XSize], &RowDiagonal[z * XSize], &RowUpper[z * XSize], XSize, 1, &RowFactors.Lower[Offset], &RowFactors.InverseDiagonal[Offset], &RowFactors.Upper[Offset], BatchSize);
+    }
+}
+
+void SimulatorADI::SolveLines(double* Values, const double* Lower, const double* InverseDiagonal, const double* Upper, int Length, int Batch, int Stride)
+{
+    for (int b = 0; b < Batch; ++b)
+    {
+        Values[b] *= InverseDiagonal[b];
+    }
+    
+    for (int i = 1; i < Length; ++i)
+    {
+        double* Current = Values + i * Stride;
+        const double* Previous = Current - Stride;
+        const double* CurrentLower = Lower + i * Stride;
+        const double* CurrentInverse = InverseDiagonal + i * Stride;
+        
+        for (int b = 0; b < Batch; ++b)
+        {
+            Current[b] = (Current[b] - CurrentLower[b] * Previous[b]) * CurrentInverse[b];
+        }
+    }
+    
+    for (int i = Length - 2; i >= 0; --i)
+    {
+        double* Current = Values + i * Stride;
+        const double* Next = Current + Stride;
+        const double* CurrentUpper = Upper + i * Stride;
+        
+        for (int b = 0; b < Batch; ++b)
+        {
+            Current[b] -= CurrentUpper[b] * Next[b];
+        }
+    }
+}
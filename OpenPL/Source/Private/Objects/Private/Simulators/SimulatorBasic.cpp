@@ -10,7 +10,7 @@
 
 #include "Simulators/SimulatorBasic.h"
 
-void SimulatorBasic::Simulate(int SimulateVoxelIndex)
+bool SimulatorBasic::Simulate(int SimulateVoxelIndex)
 {
     // Courant number contains the ratio of the temporal step to the spatial step
     // So if we are simulating 1 sec per 1 meter, the courant is 1 (or Unity)
@@ -96,4 +96,6 @@ void SimulatorBasic::Simulate(int SimulateVoxelIndex)
         // Add pulse
         (*Lattice)[4].AirPressure += Pulse[CurrentTimeStep];
     }
+    
+    return true;
 }
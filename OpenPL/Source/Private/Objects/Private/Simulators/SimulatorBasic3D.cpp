@@ -10,7 +10,7 @@
 
 #include "Simulators/SimulatorBasic3D.h"
 
-void SimulatorBasic3D::Simulate(int SimulateVoxelIndex)
+bool SimulatorBasic3D::Simulate(int SimulateVoxelIndex)
 {
     // Courant number contains the ratio of the temporal step to the spatial step
     // So if we are simulating 1 sec per 1 meter, the courant is 1 (or Unity)
@@ -72,5 +72,7 @@ void SimulatorBasic3D::Simulate(int SimulateVoxelIndex)
         // Add pulse
         (*Lattice)[4].AirPressure += Pulse[CurrentTimeStep];
     }
+    
+    return true;
 }
 
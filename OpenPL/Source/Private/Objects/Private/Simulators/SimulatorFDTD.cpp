@@ -13,27 +13,18 @@
 #include "PL_SCENE.h"
 #include "PL_SYSTEM.h"
 
-void SimulatorFDTD::Simulate(int SimulateVoxelIndex)
+bool SimulatorFDTD::Simulate(int SimulateVoxelIndex)
 {
     if (Lattice == nullptr || Lattice->size() == 0)
     {
         DebugError("Voxel lattice is either null or has no voxels!");
-        return;
+        return false;
     }
     
-    // Reset all pressure and velocity
-    {
-        for(auto& Voxel : *Lattice)
-        {
-            Voxel.AirPressure = 0.0f;
-            Voxel.ParticleVelocityX = 0.0f;
-            Voxel.ParticleVelocityY = 0.0f;
-            Voxel.ParticleVelocityZ = 0.0f;
-        }
-    }
+    ResetLattice();
     
     int X,Y,Z;
-    OwningScene->GetThreeDimensionalIndexOfIndex(SimulateVoxelIndex,X,Y,Z);
+    IndexToThreeDim(SimulateVoxelIndex, XSize, YSize, X, Y, Z);
     
     int y = Y;
     
@@ -46,7 +37,15 @@ void SimulatorFDTD::Simulate(int SimulateVoxelIndex)
             {
                 for (int z = 0; z < ZSize; z++)
                 {
-                    PLVoxel& CurrentVoxel = (*Lattice)[ThreeDimToOneDim(x, y, z, XSize, YSize)];
+                    const int Index = ThreeDimToOneDim(x, y, z, XSize, YSize);
+                    
+                    // Closed and disconnected voxels never hold any pressure
+                    if (!IsActive(Index))
+                    {
+                        continue;
+                    }
+                    
+                    PLVoxel& CurrentVoxel = (*Lattice)[Index];
                     PLVoxel NextVoxelX = x + 1 >= XSize ? PLVoxel() : (*Lattice)[ThreeDimToOneDim(x + 1, y, z, XSize, YSize)];
                     PLVoxel NextVoxelY = y + 1 >= YSize ? PLVoxel() : (*Lattice)[ThreeDimToOneDim(x, y + 1, z, XSize, YSize)];
                     PLVoxel NextVoxelZ = z + 1 >= ZSize ? PLVoxel() : (*Lattice)[ThreeDimToOneDim(x, y, z + 1, XSize, YSize)];
@@ -67,13 +66,22 @@ void SimulatorFDTD::Simulate(int SimulateVoxelIndex)
                 {
                     // Basically don't understand any of this!!!
                     
-                    const PLVoxel& PreviousVoxel = (*Lattice)[ThreeDimToOneDim(x-1, y, z, XSize, YSize)];
+                    const int Index = ThreeDimToOneDim(x, y, z, XSize, YSize);
+                    const int PreviousIndex = ThreeDimToOneDim(x-1, y, z, XSize, YSize);
+                    
+                    // Velocity is stored on the face between the voxels, so it only matters if one side is live air
+                    if (!IsActive(Index) && !IsActive(PreviousIndex))
+                    {
+                        continue;
+                    }
+                    
+                    const PLVoxel& PreviousVoxel = (*Lattice)[PreviousIndex];
                     
                     const double BetaNext = static_cast<double>(PreviousVoxel.Beta);
                     const double AbsorptionNext = PreviousVoxel.Absorptivity;
                     const double YNext = (1.f - AbsorptionNext) / (1.f + AbsorptionNext);  // What is Y? Yee?
                     
-                    PLVoxel& CurrentVoxel = (*Lattice)[ThreeDimToOneDim(x, y, z, XSize, YSize)];
+                    PLVoxel& CurrentVoxel = (*Lattice)[Index];
                     
                     const double BetaThis = static_cast<double>(CurrentVoxel.Beta);
                     const double AbsorptionThis = CurrentVoxel.Absorptivity;
@@ -132,13 +140,21 @@ void SimulatorFDTD::Simulate(int SimulateVoxelIndex)
                 {
                     // Basically don't understand any of this!!!
 
-                    const PLVoxel& PreviousVoxel = (*Lattice)[ThreeDimToOneDim(x, y, z-1, XSize, YSize)];
+                    const int Index = ThreeDimToOneDim(x, y, z, XSize, YSize);
+                    const int PreviousIndex = ThreeDimToOneDim(x, y, z-1, XSize, YSize);
+
+                    if (!IsActive(Index) && !IsActive(PreviousIndex))
+                    {
+                        continue;
+                    }
+
+                    const PLVoxel& PreviousVoxel = (*Lattice)[PreviousIndex];
 
                     const double BetaNext = static_cast<double>(PreviousVoxel.Beta);
                     const double AbsorptionNext = PreviousVoxel.Absorptivity;
                     const double YNext = (1.f - AbsorptionNext) / (1.f + AbsorptionNext);  // What is Y?
 
-                    PLVoxel& CurrentVoxel = (*Lattice)[ThreeDimToOneDim(x, y, z, XSize, YSize)];
+                    PLVoxel& CurrentVoxel = (*Lattice)[Index];
 
                     const double BetaThis = static_cast<double>(CurrentVoxel.Beta);
                     const double AbsorptionThis = CurrentVoxel.Absorptivity;
@@ -155,38 +171,14 @@ void SimulatorFDTD::Simulate(int SimulateVoxelIndex)
             }
         }
         
-        // Absorption top/bottom
-        {
-            for (int i = 0; i < ZSize; ++i)
-            {
-                const int Index1 = i;
-                const int Index2 = XSize * (ZSize + 1) + i;
-                
-                (*Lattice)[Index1].ParticleVelocityX = -(*Lattice)[Index1].AirPressure;
-                (*Lattice)[Index2].ParticleVelocityX = (*Lattice)[Index2 - YSize - 1].AirPressure;
-            }
-        }
-        
-        // Absorption left/right
-        {
-            for (int i = 0; i < XSize; ++i)
-            {
-                const int Index1 = i * (ZSize + 1);
-                const int Index2 = i * (ZSize + 1) + ZSize;
-                
-                (*Lattice)[Index1].ParticleVelocityZ = -(*Lattice)[Index1].AirPressure;
-                (*Lattice)[Index2].ParticleVelocityZ = (*Lattice)[Index2 - 1].AirPressure;
-            }
-        }
+        AbsorbAtEdges(y);
         
-        // Add response
-        {
-            for (int i = 0; i < CubeSize; i++)
-            {
-                SimulatedLattice[i][CurrentTimeStep] = (*Lattice)[i];
-            }
-        }
+        RecordTimeStep(CurrentTimeStep);
         
         (*Lattice)[SimulateVoxelIndex].AirPressure += Pulse[CurrentTimeStep];
+        
+        ReportProgress(CurrentTimeStep);
     }
+    
+    return true;
 }
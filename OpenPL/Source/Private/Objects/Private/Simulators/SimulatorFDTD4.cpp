@@ -0,0 +1,219 @@
+/*
+  ==============================================================================
+  
+    SimulatorFDTD4.cpp
+    Created: 18 Oct 2026 11:14:52pm
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#include "Simulators/SimulatorFDTD4.h"
+#include "OpenPLCommonPrivate.h"
+
+namespace
+{
+    /** Weights of the near and far differences of the staggered fourth order derivative*/
+    const double Inner = 9.0 / 8.0;
+    const double Outer = 1.0 / 24.0;
+    
+    /** Same wall update as SimulatorFDTD. Both sides open reduces to the plain air update*/
+    double UpdateVelocity(const PLVoxel& PreviousVoxel, const PLVoxel& CurrentVoxel, double Velocity, double Gradient, double UpdateCoefficents)
+    {
+        const double BetaNext = static_cast<double>(PreviousVoxel.Beta);
+        const double YNext = (1.0 - PreviousVoxel.Absorptivity) / (1.0 + PreviousVoxel.Absorptivity);
+        
+        const double BetaThis = static_cast<double>(CurrentVoxel.Beta);
+        const double YThis = (1.0 - CurrentVoxel.Absorptivity) / (1.0 + CurrentVoxel.Absorptivity);
+        
+        const double AirCellUpdate = Velocity - UpdateCoefficents * Gradient;
+        
+        const double YBoundary = BetaThis * YNext + BetaNext * YThis;
+        const double WallCellUpdate = YBoundary * (PreviousVoxel.AirPressure * BetaNext + CurrentVoxel.AirPressure * BetaThis);
+        
+        return BetaThis * BetaNext * AirCellUpdate + (BetaNext - BetaThis) * WallCellUpdate;
+    }
+}
+
+bool SimulatorFDTD4::Simulate(int SimulateVoxelIndex)
+{
+    if (Lattice == nullptr || Lattice->size() == 0)
+    {
+        DebugError("Voxel lattice is either null or has no voxels!");
+        return false;
+    }
+    
+    ResetLattice();
+    
+    int X,Y,Z;
+    IndexToThreeDim(SimulateVoxelIndex, XSize, YSize, X, Y, Z);
+    
+    const int y = Y;
+    BuildStencils(y);
+    
+    PLVoxelLattice& Voxels = *Lattice;
+    
+    for (int CurrentTimeStep = 0; CurrentTimeStep < TimeSteps; CurrentTimeStep++)
+    {
+        // Pressure grid
+        for (int z = 0; z < ZSize; z++)
+        {
+            for (int x = 0; x < XSize; x++)
+            {
+                const int Index = ThreeDimToOneDim(x, y, z, XSize, YSize);
+                
+                if (!IsActive(Index))
+                {
+                    continue;
+                }
+                
+                const uint16_t Flags = Stencils[x + z * XSize];
+                PLVoxel& CurrentVoxel = Voxels[Index];
+                
+                const double VelocityX = CurrentVoxel.ParticleVelocityX;
+                const double NextVelocityX = x + 1 >= XSize ? 0.0 : Voxels[Index + 1].ParticleVelocityX;
+                double DivergenceX = NextVelocityX - VelocityX;
+                
+                if (Flags & Stencil_PressureFourthX)
+                {
+                    // A face behind a wall mirrors the face the same distance in front, around the wall's own velocity
+                    const double Before = Flags & Stencil_PressureBeforeX ? 2.0 * VelocityX - NextVelocityX : Voxels[Index - 1].ParticleVelocityX;
+                    const double After = Flags & Stencil_PressureAfterX ? 2.0 * NextVelocityX - VelocityX : Voxels[Index + 2].ParticleVelocityX;
+                    DivergenceX = Inner * DivergenceX - Outer * (After - Before);
+                }
+                
+                const double VelocityZ = CurrentVoxel.ParticleVelocityZ;
+                const double NextVelocityZ = z + 1 >= ZSize ? 0.0 : Voxels[Index + SquareSize].ParticleVelocityZ;
+                double DivergenceZ = NextVelocityZ - VelocityZ;
+                
+                if (Flags & Stencil_PressureFourthZ)
+                {
+                    const double Before = Flags & Stencil_PressureBeforeZ ? 2.0 * VelocityZ - NextVelocityZ : Voxels[Index - SquareSize].ParticleVelocityZ;
+                    const double After = Flags & Stencil_PressureAfterZ ? 2.0 * NextVelocityZ - VelocityZ : Voxels[Index + 2 * SquareSize].ParticleVelocityZ;
+                    DivergenceZ = Inner * DivergenceZ - Outer * (After - Before);
+                }
+                
+                CurrentVoxel.AirPressure = static_cast<double>(CurrentVoxel.Beta) * (CurrentVoxel.AirPressure - UpdateCoefficents * (DivergenceX + DivergenceZ));
+            }
+        }
+        
+        // X velocity, stored on the face between a voxel and the one before it
+        for (int z = 0; z < ZSize; z++)
+        {
+            for (int x = 1; x < XSize; x++)
+            {
+                const int Index = ThreeDimToOneDim(x, y, z, XSize, YSize);
+                const int PreviousIndex = Index - 1;
+                
+                if (!IsActive(Index) && !IsActive(PreviousIndex))
+                {
+                    continue;
+                }
+                
+                const uint16_t Flags = Stencils[x + z * XSize];
+                PLVoxel& CurrentVoxel = Voxels[Index];
+                const PLVoxel& PreviousVoxel = Voxels[PreviousIndex];
+                
+                double GradientX = CurrentVoxel.AirPressure - PreviousVoxel.AirPressure;
+                
+                if (Flags & Stencil_VelocityFourthX)
+                {
+                    // Pressure behind a rigid wall mirrors the pressure in front of it
+                    const double Before = Flags & Stencil_VelocityBeforeX ? PreviousVoxel.AirPressure : Voxels[Index - 2].AirPressure;
+                    const double After = Flags & Stencil_VelocityAfterX ? CurrentVoxel.AirPressure : Voxels[Index + 1].AirPressure;
+                    GradientX = Inner * GradientX - Outer * (After - Before);
+                }
+                
+                CurrentVoxel.ParticleVelocityX = UpdateVelocity(PreviousVoxel, CurrentVoxel, CurrentVoxel.ParticleVelocityX, GradientX, UpdateCoefficents);
+            }
+        }
+        
+        // Z velocity
+        for (int z = 1; z < ZSize; z++)
+        {
+            for (int x = 0; x < XSize; x++)
+            {
+                const int Index = ThreeDimToOneDim(x, y, z, XSize, YSize);
+                const int PreviousIndex = Index - SquareSize;
+                
+                if (!IsActive(Index) && !IsActive(PreviousIndex))
+                {
+                    continue;
+                }
+                
+                const uint16_t Flags = Stencils[x + z * XSize];
+                PLVoxel& CurrentVoxel = Voxels[Index];
+                const PLVoxel& PreviousVoxel = Voxels[PreviousIndex];
+                
+                double GradientZ = CurrentVoxel.AirPressure - PreviousVoxel.AirPressure;
+                
+                if (Flags & Stencil_VelocityFourthZ)
+                {
+                    const double Before = Flags & Stencil_VelocityBeforeZ ? PreviousVoxel.AirPressure : Voxels[Index - 2 * SquareSize].AirPressure;
+                    const double After = Flags & Stencil_VelocityAfterZ ? CurrentVoxel.AirPressure : Voxels[Index + SquareSize].AirPressure;
+                    GradientZ = Inner * GradientZ - Outer * (After - Before);
+                }
+                
+                CurrentVoxel.ParticleVelocityZ = UpdateVelocity(PreviousVoxel, CurrentVoxel, CurrentVoxel.ParticleVelocityZ, GradientZ, UpdateCoefficents);
+            }
+        }
+        
+        AbsorbAtEdges(y);
+        
+        RecordTimeStep(CurrentTimeStep);
+        
+        Voxels[SimulateVoxelIndex].AirPressure += Pulse[CurrentTimeStep];
+        
+        ReportProgress(CurrentTimeStep);
+    }
+    
+    return true;
+}
+
+void SimulatorFDTD4::BuildStencils(int y)
+{
+    Stencils.assign(XSize * ZSize, 0);
+    
+    for (int z = 0; z < ZSize; z++)
+    {
+        for (int x = 0; x < XSize; x++)
+        {
+            uint16_t& Flags = Stencils[x + z * XSize];
+            
+            // Pressure reads the faces either side of the two next to it, velocity the voxels either side of the two next to it
+            if (x >= 2 && x + 2 < XSize && IsOpen(x, y, z))
+            {
+                Flags |= Stencil_PressureFourthX;
+                Flags |= IsOpen(x - 1, y, z) ? 0 : Stencil_PressureBeforeX;
+                Flags |= IsOpen(x + 1, y, z) ? 0 : Stencil_PressureAfterX;
+            }
+            
+            if (x >= 2 && x + 1 < XSize && IsOpen(x - 1, y, z) && IsOpen(x, y, z))
+            {
+                Flags |= Stencil_VelocityFourthX;
+                Flags |= IsOpen(x - 2, y, z) ? 0 : Stencil_VelocityBeforeX;
+                Flags |= IsOpen(x + 1, y, z) ? 0 : Stencil_VelocityAfterX;
+            }
+            
+            if (z >= 2 && z + 2 < ZSize && IsOpen(x, y, z))
+            {
+                Flags |= Stencil_PressureFourthZ;
+                Flags |= IsOpen(x, y, z - 1) ? 0 : Stencil_PressureBeforeZ;
+                Flags |= IsOpen(x, y, z + 1) ? 0 : Stencil_PressureAfterZ;
+            }
+            
+            if (z >= 2 && z + 1 < ZSize && IsOpen(x, y, z - 1) && IsOpen(x, y, z))
+            {
+                Flags |= Stencil_VelocityFourthZ;
+                Flags |= IsOpen(x, y, z - 2) ? 0 : Stencil_VelocityBeforeZ;
+                Flags |= IsOpen(x, y, z + 1) ? 0 : Stencil_VelocityAfterZ;
+            }
+        }
+    }
+}
+
+bool SimulatorFDTD4::IsOpen(int x, int y, int z) const
+{
+    const int Index = ThreeDimToOneDim(x, y, z, XSize, YSize);
+    return (*Lattice)[Index].Beta != 0 && IsActive(Index);
+}
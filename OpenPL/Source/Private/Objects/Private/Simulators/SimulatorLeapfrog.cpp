@@ -0,0 +1,291 @@
+/*
+  ==============================================================================
+  
+    SimulatorLeapfrog.cpp
+    Created: 19 Oct 2026 12:06:17am
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#include "Simulators/SimulatorLeapfrog.h"
+#include "OpenPLCommonPrivate.h"
+#include "HalfFloat.h"
+#include <map>
+#include <tuple>
+#include <type_traits>
+
+namespace
+{
+    void LoadRow(const uint16_t* Stored, float* OutRow, int Count)
+    {
+        HalvesToFloats(Stored, OutRow, Count);
+    }
+    
+    void StoreRow(const float* Row, uint16_t* OutStored, int Count)
+    {
+        FloatsToHalves(Row, OutStored, Count);
+    }
+    
+    // Rows stored in the type they're worked on in are read in place, so these only need to exist
+    template <typename Type>
+    void LoadRow(const Type* Stored, Type* OutRow, int Count)
+    {
+        std::copy(Stored, Stored + Count, OutRow);
+    }
+    
+    template <typename Type>
+    void StoreRow(const Type* Row, Type* OutStored, int Count)
+    {
+        std::copy(Row, Row + Count, OutStored);
+    }
+    
+    void Add(uint16_t& Stored, double Amount)
+    {
+        Stored = FloatToHalf(HalfToFloat(Stored) + static_cast<float>(Amount));
+    }
+    
+    template <typename Type>
+    void Add(Type& Stored, double Amount)
+    {
+        Stored += static_cast<Type>(Amount);
+    }
+    
+    typedef std::map<std::tuple<float, float, float>, uint16_t> KindMap;
+    
+    /**
+     * Finds the kind with the same mask and open neighbours as Key and the loss closest to it.
+     *
+     * @return KindIndices.end() if no kind has the same mask and open neighbours.
+     */
+    KindMap::const_iterator FindClosestLoss(const KindMap& KindIndices, const std::tuple<float, float, float>& Key)
+    {
+        const auto SameNeighbours = [&Key](KindMap::const_iterator Candidate)
+        {
+            return std::get<0>(Candidate->first) == std::get<0>(Key) && std::get<1>(Candidate->first) == std::get<1>(Key);
+        };
+        
+        // Kinds are ordered by mask, then open neighbours, then loss, so the closest losses sit either side of Key
+        const KindMap::const_iterator Above = KindIndices.lower_bound(Key);
+        KindMap::const_iterator Closest = KindIndices.end();
+        
+        if (Above != KindIndices.end() && SameNeighbours(Above))
+        {
+            Closest = Above;
+        }
+        
+        if (Above != KindIndices.begin() && SameNeighbours(std::prev(Above)))
+        {
+            const KindMap::const_iterator Below = std::prev(Above);
+            
+            if (Closest == KindIndices.end() || std::get<2>(Key) - std::get<2>(Below->first) < std::get<2>(Closest->first) - std::get<2>(Key))
+            {
+                Closest = Below;
+            }
+        }
+        
+        return Closest;
+    }
+}
+
+bool SimulatorLeapfrog::Simulate(int SimulateVoxelIndex)
+{
+    if (Lattice == nullptr || Lattice->size() == 0)
+    {
+        DebugError("Voxel lattice is either null or has no voxels!");
+        return false;
+    }
+    
+    ResetLattice();
+    
+    int X,Y,Z;
+    IndexToThreeDim(SimulateVoxelIndex, XSize, YSize, X, Y, Z);
+    
+    if (!BuildCells(Y))
+    {
+        return false;
+    }
+    
+    switch (Settings.Precision)
+    {
+        case PL_SIMULATION_PRECISION_HALF:
+            Run<uint16_t, float>(Y, X, Z);
+            break;
+        case PL_SIMULATION_PRECISION_FLOAT:
+            Run<float, float>(Y, X, Z);
+            break;
+        case PL_SIMULATION_PRECISION_DOUBLE:
+        default:
+            Run<double, double>(Y, X, Z);
+            break;
+    }
+    
+    return true;
+}
+
+template <typename Storage, typename Compute>
+void SimulatorLeapfrog::Run(int y, int SourceX, int SourceZ)
+{
+    constexpr bool Converted = !std::is_same<Storage, Compute>::value;
+    
+    const int Stride = XSize + 2;
+    std::vector<Storage> Pressure (Stride * (ZSize + 2), Storage());
+    std::vector<Storage> PreviousPressure (Pressure.size(), Storage());
+    
+    // Converted rows of the current pressure, three at a time since each row needs the one either side. Plus the last and next pressure of the row
+    std::vector<Compute> RowBuffers (Converted ? Stride * 5 : 0, Compute());
+    
+    const int Source = (SourceX + 1) + (SourceZ + 1) * Stride;
+    const Compute CourantSquared = static_cast<Compute>(UpdateCoefficents * UpdateCoefficents);
+    PLVoxelLattice& Voxels = *Lattice;
+    
+    for (int CurrentTimeStep = 0; CurrentTimeStep < TimeSteps; CurrentTimeStep++)
+    {
+        if constexpr (Converted)
+        {
+            LoadRow(&Pressure[0], &RowBuffers[0], Stride);
+            LoadRow(&Pressure[Stride], &RowBuffers[Stride], Stride);
+        }
+        
+        // One sweep writes the next pressure over the last, since each voxel only reads its own last pressure
+        for (int z = 0; z < ZSize; z++)
+        {
+            const int Row = (z + 1) * Stride;
+            const Compute* Above;
+            const Compute* Centre;
+            const Compute* Below;
+            const Compute* Last;
+            Compute* Next;
+            
+            if constexpr (Converted)
+            {
+                Compute* Buffers = RowBuffers.data();
+                LoadRow(&Pressure[Row + Stride], Buffers + ((z + 2) % 3) * Stride, Stride);
+                LoadRow(&PreviousPressure[Row], Buffers + 3 * Stride, Stride);
+                
+                Above = Buffers + (z % 3) * Stride;
+                Centre = Buffers + ((z + 1) % 3) * Stride;
+                Below = Buffers + ((z + 2) % 3) * Stride;
+                Last = Buffers + 3 * Stride;
+                Next = Buffers + 4 * Stride;
+            }
+            else
+            {
+                Above = reinterpret_cast<const Compute*>(&Pressure[Row - Stride]);
+                Centre = reinterpret_cast<const Compute*>(&Pressure[Row]);
+                Below = reinterpret_cast<const Compute*>(&Pressure[Row + Stride]);
+                Last = reinterpret_cast<const Compute*>(&PreviousPressure[Row]);
+                Next = reinterpret_cast<Compute*>(&PreviousPressure[Row]);
+            }
+            
+            const uint16_t* RowCells = &Cells[z * XSize];
+            
+            for (int x = 1; x <= XSize; x++)
+            {
+                const CellKind& Kind = Kinds[RowCells[x - 1]];
+                const Compute Now = Centre[x];
+                const Compute Before = Last[x];
+                const Compute Neighbours = Centre[x - 1] + Centre[x + 1] + Above[x] + Below[x];
+                
+                Next[x] = Kind.Mask * (2 * Now - Before + CourantSquared * (Neighbours - Kind.OpenNeighbours * Now) - Kind.Loss * (Now - Before));
+            }
+            
+            if constexpr (Converted)
+            {
+                StoreRow(Next + 1, reinterpret_cast<Storage*>(&PreviousPressure[Row + 1]), XSize);
+            }
+            
+            // Keep the lattice live for the response, the debug window and snapshots
+            const int LatticeRow = ThreeDimToOneDim(0, y, z, XSize, YSize);
+            
+            for (int x = 0; x < XSize; x++)
+            {
+                Voxels[LatticeRow + x].AirPressure = Centre[x + 1];
+            }
+        }
+        
+        RecordTimeStep(CurrentTimeStep);
+        
+        // Adding the pulse to both time levels adds it to the pressure without a kick to the velocity, like SimulatorFDTD
+        Add(PreviousPressure[Source], Pulse[CurrentTimeStep]);
+        Add(Pressure[Source], Pulse[CurrentTimeStep]);
+        Pressure.swap(PreviousPressure);
+        
+        ReportProgress(CurrentTimeStep);
+    }
+}
+
+bool SimulatorLeapfrog::BuildCells(int y)
+{
+    Kinds.clear();
+    Cells.assign(XSize * ZSize, 0);
+    
+    KindMap KindIndices;
+    
+    const int OffsetsX[4] = { -1, 1, 0, 0 };
+    const int OffsetsZ[4] = { 0, 0, -1, 1 };
+    
+    for (int z = 0; z < ZSize; z++)
+    {
+        for (int x = 0; x < XSize; x++)
+        {
+            const int Index = ThreeDimToOneDim(x, y, z, XSize, YSize);
+            
+            CellKind Kind;
+            Kind.Mask = (*Lattice)[Index].Beta != 0 && IsActive(Index) ? 1.0f : 0.0f;
+            Kind.OpenNeighbours = 0.0f;
+            Kind.Loss = 0.0f;
+            
+            for (int Neighbour = 0; Neighbour < 4 && Kind.Mask != 0.0f; ++Neighbour)
+            {
+                const int NeighbourX = x + OffsetsX[Neighbour];
+                const int NeighbourZ = z + OffsetsZ[Neighbour];
+                
+                if (NeighbourX < 0 || NeighbourX >= XSize || NeighbourZ < 0 || NeighbourZ >= ZSize)
+                {
+                    Kind.Loss += static_cast<float>(UpdateCoefficents);
+                    continue;
+                }
+                
+                const PLVoxel& NeighbourVoxel = (*Lattice)[ThreeDimToOneDim(NeighbourX, y, NeighbourZ, XSize, YSize)];
+                
+                // Air that isn't simulated still counts. Its pressure stays 0, like in the staggered scheme
+                if (NeighbourVoxel.Beta != 0)
+                {
+                    Kind.OpenNeighbours += 1.0f;
+                    continue;
+                }
+                
+                const double Admittance = (1.0 - NeighbourVoxel.Absorptivity) / (1.0 + NeighbourVoxel.Absorptivity);
+                Kind.Loss += static_cast<float>(UpdateCoefficents * Admittance);
+            }
+            
+            const std::tuple<float, float, float> Key (Kind.Mask, Kind.OpenNeighbours, Kind.Loss);
+            KindMap::const_iterator Found = KindIndices.find(Key);
+            
+            if (Found == KindIndices.end())
+            {
+                // Every wall can have its own absorptivity. Past what an index holds, share the kind with the same neighbours and the closest loss
+                if (Kinds.size() > 0xFFFF)
+                {
+                    Found = FindClosestLoss(KindIndices, Key);
+                    
+                    if (Found == KindIndices.end())
+                    {
+                        PL_LOG(PL_DEBUG_LEVEL_ERR, "Leapfrog simulator: the plane through y = " << y << " needs more than " << Kinds.size() << " kinds of voxel and none of them has " << Kind.OpenNeighbours << " open neighbours to share, so it can't be simulated");
+                        return false;
+                    }
+                }
+                else
+                {
+                    Found = KindIndices.emplace(Key, static_cast<uint16_t>(Kinds.size())).first;
+                    Kinds.push_back(Kind);
+                }
+            }
+            
+            Cells[x + z * XSize] = Found->second;
+        }
+    }
+    
+    return true;
+}
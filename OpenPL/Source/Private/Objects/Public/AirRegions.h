@@ -0,0 +1,76 @@
+/*
+  ==============================================================================
+  
+    AirRegions.h
+    Created: 18 Oct 2026 3:20:07pm
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "OpenPLCommonPrivate.h"
+#include <cstdint>
+
+/**
+ * Splits the open voxels of a lattice into regions of connected air.
+ *
+ * Sound can't travel between regions, so a region without a listener or source in it (a sealed void inside a wall, the air outside a building)
+ * has no effect on the simulation. Those voxels are marked inactive and the simulators skip them.
+ */
+class AirRegions
+{
+public:
+
+    /** Region of closed voxels*/
+    static constexpr uint32_t Geometry = 0;
+    
+    /**
+     * Labels every open voxel with its region. Open voxels are connected through their 6 face neighbours.
+     * Every region starts active.
+     */
+    void Label(const PL_VOXEL_GRID& Grid);
+    
+    /**
+     * Activates only the regions containing at least one of the voxels.
+     * If none of the voxels are in air, every region is activated so nothing is culled by mistake.
+     *
+     * @param VoxelIndices Voxels of the listeners and sources that will be simulated.
+     */
+    void Activate(const std::vector<int>& VoxelIndices);
+    
+    /**
+     * @return Region of the voxel, starting at 1. Geometry for closed voxels.
+     */
+    uint32_t GetRegion(int VoxelIndex) const;
+    
+    int GetRegionCount() const;
+    
+    bool IsActive(int VoxelIndex) const;
+    
+    /** 1 for open voxels in an active region, 0 for everything else. Indexed the same as the lattice*/
+    const std::vector<uint8_t>& GetActiveVoxels() const;
+    
+    int GetActiveVoxelCount() const;
+
+private:
+
+    void ActivateAll();
+    
+    void UpdateActiveVoxels();
+    
+    /** Region of each voxel*/
+    std::vector<uint32_t> Labels;
+    
+    /** Whether each region is active, indexed by region*/
+    std::vector<uint8_t> ActiveRegions;
+    
+    std::vector<uint8_t> ActiveVoxels;
+    
+    int XSize = 0;
+    int YSize = 0;
+    int ZSize = 0;
+    
+    int ActiveVoxelCount = 0;
+};
@@ -32,4 +32,28 @@ public:
     void Encode(Simulator* Simulator, PLVector EncodingPosition, int* OutVoxelIndex);
     
     void GetOcclusion(Simulator* Simulator, PLVector EncodingPosition, float* OutOcclusion);
+    
+    /**
+     * Calculates the obstruction gain between two voxels of the last simulation. 1 = unoccluded, 0 = fully occluded.
+     * The simulation must have been pulsed from the listener voxel.
+     *
+     * @param Simulator Simulator to take data from
+     * @param ListenerIndex Voxel the simulation was pulsed from
+     * @param EmitterIndex Voxel to measure the response at
+     */
+    float CalculateOcclusion(Simulator* Simulator, int ListenerIndex, int EmitterIndex);
+    
+    /**
+     * Builds a full band impulse response from the listener to an emitter.
+     * The simulation gives everything below its max frequency and image sources add the early reflections above it.
+     * The two bands are split with zero phase Butterworth filters, so they sum back to a flat response.
+     *
+     * @param Simulator Simulator to take data from. The simulation must have been pulsed from the listener voxel.
+     * @param EmitterLocation Position to make the impulse response from.
+     * @param MaxReflectionOrder Number of bounces to find for the high band.
+     * @param SampleRate Sampling rate of the output.
+     * @param OutResponse Array to write the response to. A unit impulse at 1 meter has a gain of 1.
+     * @param ResponseLength Length of OutResponse.
+     */
+    void GetImpulseResponse(Simulator* Simulator, PLVector EmitterLocation, int MaxReflectionOrder, int SampleRate, float* OutResponse, int ResponseLength);
 };
@@ -0,0 +1,53 @@
+/*
+  ==============================================================================
+  
+    CommandBuffer.h
+    Created: 19 Oct 2026 5:12:09am
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "OpenPLCommonPrivate.h"
+
+class PL_SCENE;
+
+/**
+ * Runs a buffer of PL_COMMANDs recorded by the host against a scene, so a whole frame of changes and queries crosses the ABI in one call.
+ * Arguments are read straight out of the host's buffer and results written straight into its output array, so each command costs a copy of its arguments
+ * and the scene call it stands in for, without the marshalling and checks of a separate exported call.
+ *
+ * The buffer is walked once before anything runs, so a malformed buffer changes nothing.
+ */
+class CommandBuffer
+{
+public:
+
+    /**
+     * @param Scene Scene to run the commands against.
+     * @param Commands Start of the buffer. Must be 4 byte aligned.
+     * @param CommandsLength Bytes in the buffer.
+     * @param OutResults One result per command, in the order they were recorded.
+     * @param ResultsLength Length of OutResults.
+     * @param OutCommandCount Commands in the buffer.
+     * @return PL_ERR_INVALID_PARAM if the buffer is malformed or OutResults is too short, in which case nothing ran.
+     * Otherwise PL_OK, even if single commands failed. Their results say how.
+     */
+    static PL_RESULT Execute(PL_SCENE& Scene, void* Commands, int CommandsLength, PL_COMMAND_RESULT* OutResults, int ResultsLength, int& OutCommandCount);
+
+private:
+
+    /**
+     * Checks every header fits in the buffer and holds the arguments its type needs, and counts the commands.
+     */
+    static bool Validate(const char* Commands, int CommandsLength, int& OutCommandCount);
+    
+    /**
+     * Bytes of arguments the command needs, or -1 if the type isn't a PL_COMMAND.
+     */
+    static int GetArgumentsSize(const PL_COMMAND_HEADER& Header, const char* Arguments);
+    
+    static PL_COMMAND_RESULT ExecuteOne(PL_SCENE& Scene, const PL_COMMAND_HEADER& Header, char* Arguments);
+};
@@ -0,0 +1,70 @@
+/*
+  ==============================================================================
+  
+    DebugMessageQueue.h
+    Created: 18 Oct 2026 8:41:17pm
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "OpenPLCommon.h"
+#include <atomic>
+#include <cstddef>
+
+/**
+ * Fixed size queue of debug messages, so logging never calls back into the host on a simulation thread.
+ *
+ * Any thread can push without locking or allocating. The host pops them on its own thread with PL_Debug_Flush.
+ * Bounded MPMC queue after Vyukov. Each slot has a sequence number saying whether it's free to write or ready to read.
+ */
+class DebugMessageQueue
+{
+public:
+
+    /** Messages longer than this, including the terminator, are cut short*/
+    static constexpr int MaxMessageLength = 256;
+    
+    /** Must be a power of 2*/
+    static constexpr size_t Capacity = 256;
+    
+    DebugMessageQueue();
+    
+    /**
+     * Copies a message into the queue.
+     *
+     * @return False if the queue was full and the message was dropped.
+     */
+    bool Push(const char* Message, PL_DEBUG_LEVEL Level);
+    
+    /**
+     * Takes the oldest message out of the queue.
+     *
+     * @param OutMessage Buffer of at least MaxMessageLength chars.
+     * @return False if the queue was empty.
+     */
+    bool Pop(char* OutMessage, PL_DEBUG_LEVEL& OutLevel);
+    
+    /**
+     * @return Number of messages dropped since the last call.
+     */
+    size_t TakeDroppedCount();
+
+private:
+
+    struct Slot
+    {
+        std::atomic<size_t> Sequence;
+        PL_DEBUG_LEVEL Level;
+        char Message[MaxMessageLength];
+    };
+    
+    Slot Slots[Capacity];
+    
+    // Kept on their own cache lines so producers and the consumer don't fight over them
+    alignas(64) std::atomic<size_t> PushPosition;
+    alignas(64) std::atomic<size_t> PopPosition;
+    alignas(64) std::atomic<size_t> DroppedCount;
+};
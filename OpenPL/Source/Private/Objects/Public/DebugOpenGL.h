@@ -1,18 +1,112 @@
 /*
   ==============================================================================
-
+  
     DebugOpenGL.h
     Created: 8 Apr 2021 1:49:58pm
     Author:  James Kelly
-
+  
   ==============================================================================
 */
 
 #pragma once
 
 #include "OpenPLCommonPrivate.h"
+#include <boost/thread/mutex.hpp>
+#include <memory>
+
+/**
+ * Everything the debug window draws, copied out of the scene so the window never touches the scene itself.
+ * Snapshots are never changed once published, so the window can hold on to one while the scene moves on.
+ */
+struct DebugSnapshot
+{
+    /** Every scene mesh merged into one, one vertex per row. Shared between snapshots while the meshes haven't changed*/
+    struct Geometry
+    {
+        VertexMatrix Vertices;
+        IndiceMatrix Indices;
+        
+        /** Ends of the edges of each mesh's bounding box, one edge per row*/
+        VertexMatrix BoundsFrom;
+        VertexMatrix BoundsTo;
+    };
+    
+    std::shared_ptr<const Geometry> Meshes;
+    
+    /** X,Y,Z of every geometry voxel that touches air, ready to upload as cube instances*/
+    std::vector<float> OccupiedCenters;
+    
+    VertexMatrix AirPoints;
+    VertexMatrix AirColours;
+    
+    float VoxelSize = 0.0f;
+};
 
 /**
- * Opens an OpenGL window that renders the meshes of a scene
+ * OpenGL window that renders the meshes and voxels of a scene.
+ *
+ * GLFW has to be initialised and polled on the main thread on every platform, so the window never runs by itself.
+ * The host opens it and then calls Update once a frame from the main thread, which draws a frame and handles input without blocking.
+ *
+ * The scene publishes a new snapshot whenever it changes, like while voxelising or simulating, and the window picks up the latest one when it next draws.
+ * Geometry voxels are drawn as instanced cubes in one draw call.
  */
-PL_RESULT OpenOpenGLDebugWindow(PL_SCENE* Scene);
+class DebugViewer
+{
+public:
+
+    enum Colouring
+    {
+        /** Air is one colour. Used while the voxels are being filled and the regions aren't known yet*/
+        Colouring_Flat,
+        /** Each region of air is a different colour and skipped regions are grey*/
+        Colouring_Regions,
+        /** Air is coloured by its current pressure*/
+        Colouring_Pressure
+    };
+    
+    DebugViewer();
+    
+    /** Closes the window if it's open. Main thread only in that case*/
+    ~DebugViewer();
+    
+    /**
+     * Opens the window if it isn't already open. Main thread only.
+     */
+    PL_RESULT Open();
+    
+    /**
+     * Draws a frame if one is due and handles input, then returns. Does nothing while the window is closed. Main thread only.
+     */
+    void Update();
+    
+    bool IsOpen() const;
+    
+    /**
+     * Copies the scene into a new snapshot for the window. Does nothing if the window is closed.
+     * Safe to call from any thread that owns the scene at the time, like the voxel thread.
+     */
+    void Publish(const PL_SCENE& Scene, Colouring AirColouring);
+
+private:
+
+    /** The GLFW window and what it last drew. Only touched on the main thread*/
+    struct Window;
+    
+    void Close();
+    
+    std::shared_ptr<const DebugSnapshot::Geometry> MakeGeometry(const PL_SCENE& Scene) const;
+    
+    /** Frames drawn per second at most, however often the host updates*/
+    static constexpr double MaxFramesPerSecond = 30.0;
+    
+    std::unique_ptr<Window> OpenWindow;
+    
+    /** Whether the window is open. Read by the threads publishing snapshots*/
+    std::atomic<bool> Running { false };
+    
+    /** Guards Latest and Version. Only held long enough to swap the pointer*/
+    boost::mutex SnapshotMutex;
+    std::shared_ptr<const DebugSnapshot> Latest;
+    uint64_t Version = 0;
+};
@@ -0,0 +1,51 @@
+/*
+  ==============================================================================
+  
+    DistanceField.h
+    Created: 18 Oct 2026 1:34:51pm
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "OpenPLCommonPrivate.h"
+#include <cstdint>
+
+/**
+ * Exact Euclidean distance from every voxel to the nearest closed voxel (Beta == 0).
+ *
+ * Calculated with separable passes along X, Y then Z (Felzenszwalb & Huttenlocher), each pass running the lines of the lattice in parallel.
+ * The whole transform is linear in the number of voxels.
+ */
+class DistanceField
+{
+public:
+
+    /** Distances are stored in fixed point, in 1/Scale of a voxel*/
+    static constexpr int Scale = 8;
+    
+    /** Stored for voxels that have no geometry within range, or when the lattice has no geometry at all*/
+    static constexpr uint16_t Far = 0xFFFF;
+    
+    void Calculate(const PL_VOXEL_GRID& Grid);
+    
+    /**
+     * @return Fixed point distance of the voxel to the nearest geometry. Divide by Scale to get voxels.
+     */
+    uint16_t GetDistance(int VoxelIndex) const;
+    
+    /**
+     * @return Distance in meters, or the largest float if there is no geometry in range.
+     */
+    float GetDistanceInMeters(int VoxelIndex) const;
+    
+    const std::vector<uint16_t>& GetDistances() const;
+
+private:
+
+    std::vector<uint16_t> Distances;
+    
+    float VoxelSize = 0.0f;
+};
@@ -0,0 +1,89 @@
+/*
+  ==============================================================================
+  
+    FastWindingNumber.h
+    Created: 19 Oct 2026 7:34:05am
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "OpenPLCommonPrivate.h"
+#include <vector>
+
+/**
+ * Generalised winding number of a triangle mesh, which is 1 inside a closed mesh, 0 outside, and degrades smoothly when the mesh has holes,
+ * overlaps or flipped pieces. Thresholding it at 0.5 gives occupancy for meshes the exact inside tests throw on or get wrong.
+ *
+ * Triangles are kept in a tree. Each node sums the area weighted normals of its triangles into one dipole at their centre,
+ * and a node far enough from a point (Beta times its radius) is evaluated as that dipole instead of triangle by triangle, like Barnes-Hut.
+ * Points are evaluated in packets that walk the tree together, so the dipole and triangle terms are loops over the packet's points.
+ */
+class FastWindingNumber
+{
+public:
+
+    /** Points evaluated together. One row of voxels is split into packets of this many*/
+    static constexpr int PacketSize = 8;
+    
+    /**
+     * @param Vertices 3 x N vertices.
+     * @param Indices 3 x M triangles.
+     */
+    FastWindingNumber(const VertexMatrix& Vertices, const IndiceMatrix& Indices);
+    
+    /**
+     * @param Count Number of points, up to PacketSize.
+     * @param OutWinding Winding number at each point.
+     */
+    void Evaluate(const float* X, const float* Y, const float* Z, int Count, float* OutWinding) const;
+    
+    /**
+     * Fills every voxel whose centre has a winding number of at least 0.5. Only voxels inside the mesh's bounds are evaluated,
+     * since the surface covers less than half of the sphere around any point outside them. Split between threads by Z slab.
+     *
+     * @param BottomBackLeft World position of the lattice's corner.
+     * @param Absorptivity Absorptivity of the filled voxels.
+     */
+    void Fill(PL_VOXEL_GRID& Grid, const PLVector& BottomBackLeft, float Absorptivity) const;
+
+private:
+
+    struct Node
+    {
+        /** Area weighted centre of the node's triangles*/
+        Eigen::Vector3f Centre;
+        
+        /** Sum of the area weighted normals of the node's triangles*/
+        Eigen::Vector3f Dipole;
+        
+        /** Furthest any corner of the node's triangles is from Centre*/
+        float Radius;
+        
+        /** First child, with the second straight after. -1 for a leaf*/
+        int FirstChild;
+        
+        /** Range of Corners a leaf owns, 3 per triangle*/
+        int FirstTriangle;
+        int TriangleCount;
+    };
+    
+    /**
+     * Fills in the node at NodeIndex for a range of triangles, splitting it in two until the ranges are small enough for leaves.
+     */
+    void Build(int NodeIndex, int FirstTriangle, int TriangleCount);
+    
+    /** Triangle corners, 3 at a time, reordered so every node's triangles are together*/
+    std::vector<Eigen::Vector3f> Corners;
+    
+    std::vector<Node> Nodes;
+    
+    Eigen::AlignedBox3f Bounds;
+    
+    /** Nodes closer than Beta times their radius are opened up. 2 keeps the error well below the 0.5 threshold*/
+    static constexpr float Beta = 2.0f;
+    
+    static constexpr int MaxLeafTriangles = 8;
+};
@@ -0,0 +1,82 @@
+/*
+  ==============================================================================
+  
+    GeodesicField.h
+    Created: 18 Oct 2026 7:12:08pm
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "OpenPLCommonPrivate.h"
+#include <cstdint>
+
+/**
+ * Shortest path length through the air from one voxel, usually the listener's, to every other voxel.
+ * Also stores the direction each path leaves the source in, which is where the sound appears to come from, like a doorway instead of through a wall.
+ *
+ * Solved as the eikonal equation |grad T| = 1 with fast sweeping (Zhao). Each of the 8 sweep orders is run in diagonal hyperplanes,
+ * where every cell only depends on the previous plane, so each plane is split between threads (Detrixhe et al).
+ * The path direction is carried along with the arrival time using the same upwind neighbours.
+ */
+class GeodesicField
+{
+public:
+
+    /** Distances are stored in fixed point, in 1/Scale of a voxel*/
+    static constexpr int Scale = 8;
+    
+    /** Stored for voxels that can't be reached from the source, including geometry*/
+    static constexpr uint16_t Unreachable = 0xFFFF;
+    
+    /**
+     * @param Grid Voxel lattice to solve through. Only open voxels (Beta != 0) carry sound.
+     * @param SourceIndex Voxel the distances are measured from.
+     */
+    void Calculate(const PL_VOXEL_GRID& Grid, int SourceIndex);
+    
+    /**
+     * @return Fixed point path length from the source. Divide by Scale to get voxels.
+     */
+    uint16_t GetDistance(int VoxelIndex) const;
+    
+    /**
+     * @return Path length in meters, or the largest float if the voxel can't be reached.
+     */
+    float GetDistanceInMeters(int VoxelIndex) const;
+    
+    /**
+     * @return Unit direction the shortest path leaves the source in. Zero for the source itself and voxels that can't be reached.
+     */
+    Eigen::Vector3f GetDirection(int VoxelIndex) const;
+    
+    int GetSourceIndex() const;
+
+private:
+
+    /**
+     * Octahedral mapping of a unit vector into two signed bytes. Accurate to about a degree.
+     */
+    static uint16_t EncodeDirection(const Eigen::Vector3f& Direction);
+    
+    static Eigen::Vector3f DecodeDirection(uint16_t Encoded);
+    
+    /** Encoded in place of a direction when there isn't one. Never made by EncodeDirection*/
+    static constexpr uint16_t NoDirection = 0x8080;
+    
+    /** Voxels within this many voxels of the source that it can see start at their exact distance*/
+    static constexpr int ExactRadius = 4;
+    
+    /** Sweeps of all 8 orders to run before giving up on convergence*/
+    static constexpr int MaxIterations = 32;
+    
+    std::vector<uint16_t> Distances;
+    
+    std::vector<uint16_t> Directions;
+    
+    float VoxelSize = 0.0f;
+    
+    int SourceIndex = -1;
+};
@@ -0,0 +1,27 @@
+/*
+  ==============================================================================
+  
+    HalfFloat.h
+    Created: 19 Oct 2026 1:21:40am
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Rounds to the nearest IEEE 754 half precision float, ties to even.
+ */
+uint16_t FloatToHalf(float Value);
+
+float HalfToFloat(uint16_t Half);
+
+/**
+ * Converts a whole array at once. Builds with F16C (-mf16c, -march=native or /arch:AVX2) convert eight values per instruction.
+ */
+void FloatsToHalves(const float* Values, uint16_t* OutHalves, int Count);
+
+void HalvesToFloats(const uint16_t* Halves, float* OutValues, int Count);
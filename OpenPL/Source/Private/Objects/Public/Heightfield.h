@@ -0,0 +1,63 @@
+/*
+  ==============================================================================
+  
+    Heightfield.h
+    Created: 19 Oct 2026 5:48:31am
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "OpenPLCommonPrivate.h"
+#include <vector>
+
+/**
+ * Terrain given as a grid of heights instead of a triangle mesh.
+ *
+ * Terrain isn't a closed solid, so the point in solid tests meshes are voxelised with don't work on it, and a terrain mesh has millions of triangles to test.
+ * A heightfield is voxelised one (X, Z) column at a time instead: every voxel whose centre is at or below the terrain is filled, all the way down.
+ */
+class Heightfield
+{
+public:
+
+    /**
+     * @param Origin World position of the first sample. Heights are added to its Y.
+     * @param Spacing Distance between samples along X and Z.
+     * @param Rows Samples along Z.
+     * @param Columns Samples along X.
+     * @param Heights Rows * Columns heights, a row of Columns at a time.
+     * @param Absorptivity Absorptivity of the filled voxels.
+     */
+    Heightfield(const PLVector& Origin, float Spacing, int Rows, int Columns, const float* Heights, float Absorptivity);
+    
+    /**
+     * Height of the terrain, interpolated between the 4 samples around the point.
+     *
+     * @return False if the point is outside the samples.
+     */
+    bool GetHeight(float X, float Z, float& OutHeight) const;
+    
+    /**
+     * Fills every voxel of a column up to the terrain. Columns are split between threads by Z slab.
+     *
+     * @param BottomBackLeft World position of the lattice's corner.
+     */
+    void Fill(PL_VOXEL_GRID& Grid, const PLVector& BottomBackLeft) const;
+
+private:
+
+    PLVector Origin;
+    
+    float Spacing;
+    
+    int Rows;
+    
+    int Columns;
+    
+    std::vector<float> Heights;
+    
+    float Absorptivity;
+};
@@ -0,0 +1,146 @@
+/*
+  ==============================================================================
+  
+    HelmholtzSolver.h
+    Created: 19 Oct 2026 1:41:52am
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "OpenPLCommonPrivate.h"
+#include <complex>
+
+/**
+ * Steady state pressure of a point source at one frequency, solved directly in the frequency domain instead of running a pulse through time.
+ * For occlusion at a handful of frequencies this is much cheaper than the time steps a transient needs to settle, and it works on the whole 3D lattice.
+ *
+ * Each voxel is a finite volume. Open faces between air voxels conduct, walls have the same admittance as the leapfrog scheme, (1 - a) / (1 + a),
+ * and the lattice edges are matched so sound leaves instead of reflecting. That gives the Helmholtz system
+ * sum over open faces (p - p neighbour) - (kh)^2 p + i kh (sum of wall admittances) p + (1 - e^(-ik'h)) (edge faces) p = source,
+ * where k' is the wavenumber the lattice actually carries, so a wave leaving straight through an edge face doesn't reflect at all.
+ * which is indefinite, so it's solved with BiCGStab preconditioned by one multigrid V-cycle of the shifted Laplacian, with k^2 replaced by (1 - 0.5i) k^2 (Erlangga et al).
+ * The coarse levels merge 2x2x2 voxels and add up their faces, volumes and wall admittances. Every sweep is split between threads by Z slab.
+ */
+class HelmholtzSolver
+{
+public:
+
+    typedef std::complex<double> Complex;
+    
+    /**
+     * Works out the coefficients of every multigrid level. Call again whenever the voxels change.
+     */
+    void Build(const PL_VOXEL_GRID& Grid);
+    
+    /**
+     * @param SourceIndex Voxel of the point source.
+     * @param Frequency Frequency in Hz.
+     * @param OutPressure Complex pressure at every voxel, scaled so the free field has a magnitude of 1 a meter from the source. 0 in geometry.
+     * @param OutIterations Krylov iterations it took. Can be null.
+     * @return False if the solve didn't converge. OutPressure still has the best answer found.
+     */
+    bool Solve(int SourceIndex, double Frequency, std::vector<Complex>& OutPressure, int* OutIterations = nullptr);
+    
+    /**
+     * Highest frequency the voxels resolve. Phase errors build up with distance, so this needs more voxels per wavelength than the time domain schemes.
+     */
+    double GetMaxFrequency() const;
+    
+    /**
+     * Relative residual the solve stops at.
+     */
+    static constexpr double Tolerance = 1e-6;
+    
+    static constexpr int MaxIterations = 500;
+
+private:
+
+    /**
+     * One level of the multigrid hierarchy. Level 0 is the voxel lattice.
+     */
+    struct Level
+    {
+        int XSize;
+        int YSize;
+        int ZSize;
+        
+        /** Air voxels the cell covers. 0 for cells that are all geometry, which are held at 0*/
+        std::vector<float> Volume;
+        
+        /** Sum of the admittances of the cell's wall faces, in voxel faces*/
+        std::vector<float> Admittance;
+        
+        /** Faces of the cell on the edge of the lattice*/
+        std::vector<float> EdgeFaces;
+        
+        /** Conductance of the face to the next cell along X, Y and Z. 0 if either side is geometry*/
+        std::vector<float> ConductanceX;
+        std::vector<float> ConductanceY;
+        std::vector<float> ConductanceZ;
+        
+        std::vector<Complex> Solution;
+        std::vector<Complex> RightHandSide;
+        std::vector<Complex> Residual;
+        
+        int GetIndex(int x, int y, int z) const { return x + y * XSize + z * XSize * YSize; }
+        
+        int GetCellCount() const { return XSize * YSize * ZSize; }
+    };
+    
+    /**
+     * Merges every 2x2x2 block of the finer level into one cell.
+     */
+    static Level Coarsen(const Level& Fine);
+    
+    /**
+     * Out = A In for the level, with k^2 scaled by Shift. Shift is 1 for the real system.
+     */
+    void Apply(const Level& Grid, Complex Shift, const std::vector<Complex>& In, std::vector<Complex>& Out) const;
+    
+    /**
+     * Damped Jacobi sweeps of the shifted system on the level's Solution.
+     */
+    void Smooth(Level& Grid, int Sweeps);
+    
+    /**
+     * Approximately solves the shifted system at level LevelIndex for its RightHandSide, into its Solution.
+     */
+    void VCycle(int LevelIndex);
+    
+    /**
+     * Out = M^-1 In, one V-cycle from 0.
+     */
+    void Precondition(const std::vector<Complex>& In, std::vector<Complex>& Out);
+    
+    static Complex Dot(const std::vector<Complex>& A, const std::vector<Complex>& B);
+    
+    /** Levels stop shrinking once a side is this many cells or fewer*/
+    static constexpr int CoarsestSize = 4;
+    
+    static constexpr int SmoothingSweeps = 2;
+    
+    static constexpr int CoarsestSweeps = 30;
+    
+    /** Weight of each Jacobi update. Under 1 so the highest frequency error is damped instead of flipped*/
+    static constexpr double JacobiWeight = 0.6;
+    
+    /** Imaginary part of the preconditioner's k^2 scale. Bigger converges the V-cycle faster but makes it a worse fit for the real system*/
+    static constexpr double ShiftDamping = 0.5;
+    
+    static constexpr double VoxelsPerWavelength = 6.0;
+    
+    static constexpr double SpeedOfSound = 343.21;
+    
+    std::vector<Level> Levels;
+    
+    float VoxelSize = 0.0f;
+    
+    /** kh of the current solve, in radians per voxel*/
+    double Wavenumber = 0.0;
+    
+    /** Coefficient of each edge face for the current solve*/
+    Complex EdgeLoss;
+};
@@ -0,0 +1,83 @@
+/*
+  ==============================================================================
+  
+    ImageSourceModel.h
+    Created: 18 Oct 2026 6:31:47pm
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "OpenPLCommonPrivate.h"
+
+class TriangleBVH;
+
+/**
+ * Finds the specular reflection paths between a source and a receiver by mirroring the source in the scene triangles (Allen & Berkley).
+ *
+ * The wave simulation can only resolve low frequencies, so this fills in the early reflections above them.
+ * Every image is checked against the real geometry so only paths that can actually happen are returned.
+ * Images are only mirrored in the triangles inside the beam from the previous image through its triangle, found with the BVH,
+ * so the work grows with how many surfaces each reflection can see rather than with the whole triangle count.
+ */
+class ImageSourceModel
+{
+public:
+
+    struct Reflection
+    {
+        /** Seconds from emission to arrival*/
+        float Delay;
+        
+        /** Pressure gain from wall absorption and spherical spreading*/
+        float Gain;
+        
+        /** Number of bounces. 0 for the direct sound*/
+        int Order;
+    };
+    
+    /**
+     * @param Triangles Geometry to reflect from.
+     */
+    ImageSourceModel(const TriangleBVH& Triangles);
+    
+    /**
+     * Finds every valid path up to MaxOrder bounces, including the direct sound if nothing blocks it.
+     *
+     * @param Source Emitter location.
+     * @param Receiver Listener location.
+     * @param MaxOrder Maximum number of bounces. Clamped to MaxSupportedOrder, as the image count still grows geometrically with the order.
+     * @param MaxDistance Paths longer than this in meters are skipped.
+     * @param OutReflections Found paths, in no particular order.
+     */
+    void Calculate(const PLVector& Source, const PLVector& Receiver, int MaxOrder, float MaxDistance, std::vector<Reflection>& OutReflections) const;
+    
+    static constexpr int MaxSupportedOrder = 3;
+
+private:
+
+    /**
+     * Mirrors the image in every triangle inside its beam and recurses, adding each path that passes validation.
+     *
+     * @param Path Triangles reflected from so far, in order from the source.
+     * @param Images Image position after each reflection in Path.
+     * @param RangePlanes Box around the receiver that every reflection point is within MaxDistance of. RangePlaneCount planes.
+     * @param Candidates Scratch space for the triangles found at each order. Needs MaxOrder entries.
+     */
+    void Reflect(std::vector<int>& Path, std::vector<Eigen::Vector3f>& Images, const Eigen::Vector3f& Source, const Eigen::Vector3f& Receiver, int MaxOrder, float MaxDistance,
+                 const Eigen::Vector4f* RangePlanes, std::vector<std::vector<int>>& Candidates, std::vector<Reflection>& OutReflections) const;
+    
+    /**
+     * Walks back from the receiver through each image's triangle, checking every leg hits its triangle and is unblocked.
+     */
+    bool IsPathValid(const std::vector<int>& Path, const std::vector<Eigen::Vector3f>& Images, const Eigen::Vector3f& Source, const Eigen::Vector3f& Receiver) const;
+    
+    static constexpr int RangePlaneCount = 6;
+    
+    /** 3 sides through the image and the triangle's edges, and the triangle's own plane*/
+    static constexpr int BeamPlaneCount = 4;
+    
+    const TriangleBVH& Triangles;
+};
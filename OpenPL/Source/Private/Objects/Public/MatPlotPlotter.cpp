@@ -13,7 +13,6 @@
 #include <thread>
 #include <chrono>
 #include <cstdlib>
-#include <sstream>
 
 using namespace matplot;
 
@@ -87,6 +86,8 @@ void MatPlotPlotter::PlotOneDimensionWaterfall(int YIndex, int ZIndex)
     std::vector<std::vector<double>> YPoints (XSize, std::vector<double>(TimeSteps, 0));
     std::vector<std::vector<double>> ZPoints (XSize, std::vector<double>(TimeSteps, 0));
     
+    int PointsOutsideLattice = 0;
+    
     for (int x = 0; x < XSize; ++x)
     {
         for (int TimeStep = 0; TimeStep < TimeSteps; ++TimeStep)
@@ -107,17 +108,23 @@ void MatPlotPlotter::PlotOneDimensionWaterfall(int YIndex, int ZIndex)
                 XPoints[x][TimeStep] = x;
                 YPoints[x][TimeStep] = TimeStep;
                 ZPoints[x][TimeStep] = 0;
-                DebugWarn("Tried plotting something outside of the lattice. Defaulting to 0 air pressure");
+                PointsOutsideLattice++;
             }
         }
     }
     
+    // One message for the whole plot, rather than one per point filling the debug queue
+    if (PointsOutsideLattice > 0)
+    {
+        PL_LOG(PL_DEBUG_LEVEL_WARN, "Tried plotting " << PointsOutsideLattice << " points outside of the lattice. Defaulting them to 0 air pressure");
+    }
+    
     PlotFigure->current_axes()->waterfall(XPoints, YPoints, ZPoints);
     
-    std::ostringstream StringStream;
-    StringStream << "Air Pressure Along The X Axis At Y = " << YIndex << ", Z = " << ZIndex;
+    const std::string Title = "Air Pressure Along The X Axis At Y = " + std::to_string(YIndex) + ", Z = " + std::to_string(ZIndex);
+    PL_LOG(PL_DEBUG_LEVEL_LOG, "Plotting " << Title);
     
-    PlotFigure->current_axes()->title(StringStream.str());
+    PlotFigure->current_axes()->title(Title);
     PlotFigure->current_axes()->xlabel(std::string("X Voxel"));
     PlotFigure->current_axes()->ylabel(std::string("Time Step"));
     PlotFigure->current_axes()->zlabel(std::string("Air Pressure"));
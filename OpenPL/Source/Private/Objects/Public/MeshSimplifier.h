@@ -0,0 +1,52 @@
+/*
+  ==============================================================================
+  
+    MeshSimplifier.h
+    Created: 19 Oct 2026 6:58:12am
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "OpenPLCommonPrivate.h"
+
+/**
+ * Throws away detail of a mesh that's too small for the voxels to see, so voxelising it tests far fewer triangles.
+ *
+ * Vertices closer than a tiny fraction of the error are welded, since render meshes split them along UV seams and hard edges.
+ * Degenerate triangles and connected pieces smaller than MinPieceSize with nothing else nearby are dropped, then edges are collapsed with quadric error metrics,
+ * cheapest first, until the next collapse would move a vertex further than MaxError from the planes of the triangles it replaces.
+ * Open edges get planes of their own so holes and the rims of planes stay where they were.
+ * Collapses that would fold a triangle over or pinch the surface into a non manifold are skipped.
+ */
+class MeshSimplifier
+{
+public:
+
+    /**
+     * @param MaxError Furthest the surface can move, in the units of the vertices.
+     * @param MinPieceSize Pieces whose bounds have a shorter diagonal than this are dropped.
+     * @param PieceClearance Small pieces are kept if a triangle of another piece comes within this of their bounds.
+     */
+    MeshSimplifier(double MaxError, double MinPieceSize, double PieceClearance);
+    
+    /**
+     * @param Vertices 3 x N vertices.
+     * @param Indices 3 x M triangles.
+     * @return Simplified mesh. Its vertices are new, so indices don't match the input.
+     */
+    PL_MESH Simplify(const VertexMatrix& Vertices, const IndiceMatrix& Indices) const;
+    
+    /**
+     * Hash of mesh data as the game sent it. Instances of the same asset hash the same, wherever they're placed.
+     */
+    static size_t HashAsset(const PLVector* Vertices, int VerticesLength, const int* Indices, int IndicesLength);
+
+private:
+
+    double MaxError;
+    double MinPieceSize;
+    double PieceClearance;
+};
@@ -0,0 +1,76 @@
+/*
+  ==============================================================================
+  
+    OccupancyGrid.h
+    Created: 18 Oct 2026 4:41:36pm
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "OpenPLCommonPrivate.h"
+#include <cstdint>
+
+/**
+ * One bit per voxel copy of the lattice geometry for fast line of sight queries.
+ *
+ * Rays are marched through the voxels with a 3D DDA (Amanatides & Woo), visiting every voxel the segment touches exactly once.
+ * This needs no simulation, so it works for emitters outside the simulated lattice and between simulations.
+ */
+class OccupancyGrid
+{
+public:
+
+    /**
+     * Packs the closed voxels of the lattice.
+     *
+     * @param Grid Voxel lattice to copy.
+     * @param BottomBackLeft World position of the corner of the first voxel.
+     */
+    void Build(const PL_VOXEL_GRID& Grid, const PLVector& BottomBackLeft);
+    
+    /**
+     * Marches from one point to another and measures the geometry in the way. Only the part of the segment inside the lattice is marched.
+     *
+     * @param From Start of the ray, usually the listener.
+     * @param To End of the ray, usually an emitter.
+     * @param OutThickness Length in meters of the segment that is inside geometry.
+     * @param OutSolidVoxels Number of closed voxels crossed.
+     */
+    void Trace(const PLVector& From, const PLVector& To, float& OutThickness, int& OutSolidVoxels) const;
+    
+    /**
+     * Traces from one point to many. Ray setup is vectorised over the whole batch and large batches are marched on every core.
+     */
+    void TraceBatch(const PLVector& From, const PLVector* To, int Count, float* OutThicknesses, int* OutSolidVoxels) const;
+    
+    /**
+     * Converts a thickness of geometry to an occlusion value. 1 = unoccluded, 0 = fully occluded.
+     */
+    static float ThicknessToOcclusion(float Thickness);
+    
+    bool IsSolid(int X, int Y, int Z) const;
+
+private:
+
+    /**
+     * Marches a ray already in voxel space, between the parametric distances TStart and TEnd.
+     */
+    void March(const Eigen::Vector3f& Start, const Eigen::Vector3f& Direction, float TStart, float TEnd, float& OutT, int& OutSolidVoxels) const;
+    
+    /** Thickness in meters that lets half the direct sound through*/
+    static constexpr float HalfOcclusionThickness = 0.2f;
+    
+    /** 1 bit per voxel, set for closed voxels. Indexed the same as the lattice*/
+    std::vector<uint64_t> Bits;
+    
+    int XSize = 0;
+    int YSize = 0;
+    int ZSize = 0;
+    
+    float VoxelSize = 1.0f;
+    
+    Eigen::Vector3f Origin = Eigen::Vector3f::Zero();
+};
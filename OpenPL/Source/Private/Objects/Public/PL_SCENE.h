@@ -12,13 +12,26 @@
 
 #include "OpenPLCommon.h"
 #include "OpenPLCommonPrivate.h"
+#include "Heightfield.h"
+#include "PrimitiveCollider.h"
 #include <vector>
+#include <map>
+#include <tuple>
 #include <boost/thread/thread.hpp>
 #include <boost/thread/scoped_thread.hpp>
 #include <atomic>
 
 class Simulator;
 class FreeGrid;
+class ProbeGrid;
+class DistanceField;
+class AirRegions;
+class OccupancyGrid;
+class TriangleBVH;
+class GeodesicField;
+class RoomGraph;
+class DebugViewer;
+class SnapshotRecorder;
 
 /**
  * The scene class is the main work horse of the simulation.
@@ -91,6 +104,47 @@ public:
      */
     PL_RESULT RemoveMesh(int Index);
     
+    /**
+     * Adds terrain as a grid of heights. Voxelised a column at a time, so it doesn't need to be closed like a mesh.
+     *
+     * @param Origin World position of the first sample. Heights are added to its Y.
+     * @param Spacing Distance between samples along X and Z.
+     * @param Rows Samples along Z.
+     * @param Columns Samples along X.
+     * @param Heights Rows * Columns heights, a row of Columns at a time. Copied.
+     * @param Absorptivity Absorptivity of the terrain's voxels.
+     * @param OutIndex Index of the heightfield for later removal.
+     */
+    PL_RESULT AddHeightfield(const PLVector& Origin, float Spacing, int Rows, int Columns, const float* Heights, float Absorptivity, int& OutIndex);
+    
+    PL_RESULT RemoveHeightfield(int Index);
+    
+    /**
+     * Adds a box, voxelised from its shape instead of from triangles. Boxes, spheres, capsules and convex hulls share one array of primitives.
+     *
+     * @param Position World position of the centre.
+     * @param Rotation World rotation.
+     * @param HalfExtents Half the size along each local axis.
+     * @param Absorptivity Absorptivity of the box's voxels.
+     * @param OutIndex Index of the primitive for later removal.
+     */
+    PL_RESULT AddBox(const PLVector& Position, const PLQuaternion& Rotation, const PLVector& HalfExtents, float Absorptivity, int& OutIndex);
+    
+    PL_RESULT AddSphere(const PLVector& Position, float Radius, float Absorptivity, int& OutIndex);
+    
+    /**
+     * @param HalfHeight Half the distance between the centres of the end caps, along the local Y axis.
+     */
+    PL_RESULT AddCapsule(const PLVector& Position, const PLQuaternion& Rotation, float Radius, float HalfHeight, float Absorptivity, int& OutIndex);
+    
+    /**
+     * @param Vertices Vertices of the hull in local space. Copied into planes.
+     * @param Indices Triangles of the hull, 3 indices each.
+     */
+    PL_RESULT AddConvexHull(const PLVector& Position, const PLQuaternion& Rotation, const PLVector& Scale, const PLVector* Vertices, int VerticesLength, const int* Indices, int IndicesLength, float Absorptivity, int& OutIndex);
+    
+    PL_RESULT RemovePrimitive(int Index);
+    
     /**
      * Add a listener to the simulation.
      *
@@ -106,6 +160,14 @@ public:
      */
     PL_RESULT RemoveListenerLocation(int Index);
     
+    /**
+     * Move a listener without changing the index of it or any other listener.
+     *
+     * @param Index Index of the listener to move.
+     * @param Location New location of the listener.
+     */
+    PL_RESULT SetListenerLocation(int Index, const PLVector& Location);
+    
     /**
      Add a source/emitter location to the simulation.
      *
@@ -121,6 +183,14 @@ public:
      */
     PL_RESULT RemoveSourceLocation(int Index);
     
+    /**
+     * Move an emitter without changing the index of it or any other emitter.
+     *
+     * @param Index Index of the emitter to move.
+     * @param Location New location of the emitter.
+     */
+    PL_RESULT SetSourceLocation(int Index, const PLVector& Location);
+    
     /**
      * Uses the scene's current geometry to fill all the voxels.
      */
@@ -131,14 +201,200 @@ public:
      */
     PL_RESULT Simulate(PLVector SimulationLocation);
     
+    PL_RESULT GetSimulationRate(float* OutSamplingRate, float* OutMaxFrequency) const;
+    
+    /**
+     * Changing the scheme stops the next simulation warm starting from one run with the old scheme.
+     */
+    PL_RESULT SetSimulationScheme(PL_SIMULATION_SCHEME Scheme);
+    
+    /**
+     * Only the leapfrog scheme uses anything below double. Either order of setting the scheme and precision warns while they don't match.
+     */
+    PL_RESULT SetSimulationPrecision(PL_SIMULATION_PRECISION Precision);
+    
+    /**
+     * Takes effect the next time the voxels are filled.
+     */
+    PL_RESULT SetVoxelisationMode(PL_VOXELISATION_MODE Mode);
+    
+    /**
+     * Called by the simulator after every time step, so the debug window and snapshot recorder can see the pressure as it spreads.
+     */
+    void OnSimulationProgress(int TimeStep);
+    
+    /**
+     * Starts writing the pressure of every simulation to disk every Interval time steps.
+     *
+     * @param FilePrefix Path and start of the file names.
+     * @param Interval Time steps between frames.
+     * @param Stride Keep every Stride-th voxel along each axis.
+     * @param Region Whole lattice or a single plane.
+     * @param PlaneIndex Voxel index along the plane's axis.
+     * @param Precision Float32 or float16.
+     */
+    PL_RESULT StartSnapshotRecording(const char* FilePrefix, int Interval, int Stride, PL_SNAPSHOT_REGION Region, int PlaneIndex, PL_SNAPSHOT_PRECISION Precision);
+    
+    PL_RESULT StopSnapshotRecording();
+    
+    /**
+     * Opens the debug window. It updates as the scene is voxelised and simulated. Main thread only.
+     */
+    PL_RESULT OpenDebugViewer();
+    
+    /**
+     * Draws the debug window if it's open. Main thread only, once a frame.
+     */
+    PL_RESULT UpdateDebugViewer();
+    
+    /**
+     * Set how far the simulation location can move before a full simulation is run again.
+     * Moves within this distance reuse the last simulation by shifting it. 0 disables warm starting.
+     *
+     * @param MaxDistance Distance in meters from the last full simulation.
+     */
+    PL_RESULT SetWarmStartDistance(float MaxDistance);
+    
+    /**
+     * Simplify meshes before voxelising them, so detail too small for the voxels doesn't cost voxelisation time.
+     * Ray tracing still uses the meshes as they were added.
+     *
+     * @param bEnabled Off by default.
+     * @param MaxErrorInVoxels Furthest the surface can move, as a fraction of the voxel size. Greater than 0, up to 1.
+     */
+    PL_RESULT SetMeshSimplification(bool bEnabled, float MaxErrorInVoxels);
+    
+    /**
+     * Compares a warm started simulation against a full simulation after moving from one location to another.
+     * The error is the relative L2 difference of the pressure responses at the source locations.
+     * If there are no sources, every cell in the simulated plane is compared.
+     *
+     * @param FromLocation Location of the initial full simulation.
+     * @param ToLocation Location the simulation moves to.
+     * @param OutRelativeError Relative error of the warm started responses.
+     * @param OutSpeedup How many times faster the warm start was than the full simulation.
+     */
+    PL_RESULT BenchmarkWarmStart(PLVector FromLocation, PLVector ToLocation, float* OutRelativeError, float* OutSpeedup);
+    
+    /**
+     * Automatically places listener probes and adds them as listener locations.
+     * Uniform and adaptive placement cover every walkable voxel. Seeded placement only covers the air reachable from the seeds,
+     * with extra probes in doorways and corridors.
+     *
+     * @param Placement How to spread the probes out.
+     * @param Spacing Distance in meters between probes. Grows if the probes don't fit in MaxProbes.
+     * @param Seeds Locations the player can reach. The system's listener position is used if this is empty. Seeded placement only.
+     * @param MaxProbes Maximum number of probes to add.
+     * @param OutProbeCount Number of probes that were added.
+     */
+    PL_RESULT GenerateProbes(PL_PROBE_PLACEMENT Placement, float Spacing, const std::vector<PLVector>& Seeds, int MaxProbes, int* OutProbeCount);
+    
+    /**
+     * Simulates every listener location as a probe and stores the results for runtime lookup.
+     * Blocks until all probes are simulated. This is meant to be run offline.
+     */
+    PL_RESULT BakeProbes();
+    
+    /**
+     * Get the occlusion of an emitter from the baked probes nearest the listener. Doesn't run any simulation.
+     *
+     * @param EmitterLocation Location of the emitter.
+     * @param OutOcclusion 1 = unoccluded, 0 = fully occluded.
+     */
+    PL_RESULT GetBakedOcclusion(const PLVector& EmitterLocation, float* OutOcclusion) const;
+    
+    /**
+     * Estimates occlusion from the geometry on the straight line between the listener and each emitter. Doesn't need a simulation.
+     *
+     * @param EmitterLocations Emitters to trace to.
+     * @param Count Number of emitters.
+     * @param OutOcclusions One occlusion value per emitter. 1 = unoccluded, 0 = fully occluded.
+     */
+    PL_RESULT TraceOcclusion(const PLVector* EmitterLocations, int Count, float* OutOcclusions) const;
+    
+    /**
+     * Solves the steady state pressure from a source at each frequency over the whole lattice, and reads it at every listener location.
+     *
+     * @param SourceLocation Location of the source.
+     * @param Frequencies Frequencies in Hz to solve at.
+     * @param FrequenciesLength Number of frequencies.
+     * @param OutReal Real part of the pressure, ordered by frequency then listener.
+     * @param OutImaginary Imaginary part of the pressure, in the same order.
+     * @param OutLength Length of OutReal and OutImaginary. At least FrequenciesLength times the number of listeners.
+     */
+    PL_RESULT SolveFrequencyResponse(const PLVector& SourceLocation, const float* Frequencies, int FrequenciesLength, float* OutReal, float* OutImaginary, int OutLength) const;
+    
+    /**
+     * Finds the shortest paths through the air from the listener to every voxel. Call again whenever the listener or geometry moves.
+     */
+    PL_RESULT UpdateGeodesicField();
+    
+    /**
+     * Get the shortest path around geometry from the listener to an emitter, from the last geodesic field.
+     * Emitters that are outside the lattice or can't be reached through the air get the straight line.
+     *
+     * @param EmitterLocation Location of the emitter.
+     * @param OutDistance Length of the path in meters.
+     * @param OutDirection Unit direction the path leaves the listener in, which is where the emitter should be heard from.
+     */
+    PL_RESULT GetGeodesicPath(const PLVector& EmitterLocation, float* OutDistance, PLVector* OutDirection) const;
+    
+    /**
+     * @param OutRoomCount Number of rooms the air was split into.
+     * @param OutPortalCount Number of openings between rooms.
+     */
+    PL_RESULT GetRoomGraphSize(int* OutRoomCount, int* OutPortalCount) const;
+    
+    /**
+     * @param Location World location to look up.
+     * @param OutRoom Room the location is in. -1 if it's in geometry or outside the lattice.
+     */
+    PL_RESULT GetRoom(const PLVector& Location, int* OutRoom) const;
+    
+    /**
+     * @param PortalIndex Portal to look up. (0 =< PortalIndex < Portal Count)
+     * @param OutRoomA One of the rooms the portal joins.
+     * @param OutRoomB The other room the portal joins.
+     * @param OutPosition Center of the opening.
+     * @param OutArea Area of the opening in square meters.
+     */
+    PL_RESULT GetPortal(int PortalIndex, int* OutRoomA, int* OutRoomB, PLVector* OutPosition, float* OutArea) const;
+    
+    /**
+     * Finds the shortest route between two locations through the room graph.
+     *
+     * @param From Start of the route.
+     * @param To End of the route.
+     * @param OutPortals Array to write the portals passed through to, in order from From.
+     * @param MaxPortals Length of OutPortals. Longer routes are cut short.
+     * @param OutPortalCount Number of portals on the route.
+     * @param OutDistance Length of the route in meters.
+     */
+    PL_RESULT FindRoomPath(const PLVector& From, const PLVector& To, int* OutPortals, int MaxPortals, int* OutPortalCount, float* OutDistance) const;
+    
     PL_RESULT GetVoxelsCount(int* OutVoxelCount) const;
     
     PL_RESULT GetVoxelLocation(PLVector* OutVoxelLocation, int Index) const;
     
     PL_RESULT GetVoxelAbsorpivity(float* OutAbsorpivity, int Index) const;
+    
+    /**
+     * @param Location World location to look up.
+     * @param OutDistance Distance in meters from the voxel at Location to the nearest geometry.
+     */
+    PL_RESULT GetDistanceToGeometry(const PLVector& Location, float* OutDistance) const;
+    
+    /**
+     * @param OutRegion Region of connected air the voxel belongs to, starting at 1. 0 for geometry.
+     * @param OutActive Whether the voxel was included in the last simulation.
+     * @param Index Voxel to look up.
+     */
+    PL_RESULT GetVoxelRegion(int* OutRegion, bool* OutActive, int Index) const;
 
     PL_RESULT GetMeshes(const std::vector<PL_MESH>** OutMeshes) const;
     
+    PL_RESULT GetVoxels(const PL_VOXEL_GRID** OutVoxels) const;
+    
     PL_RESULT GetScenePosition(PLVector* OutScenePosition) const;
     
     PL_RESULT GetSceneSize(PLVector* OutSceneSize) const;
@@ -163,6 +419,18 @@ public:
     
     PL_RESULT GetFreeGrid(FreeGrid** OutFreeGrid) const;
     
+    /** Null until the voxels have been filled with geometry*/
+    PL_RESULT GetDistanceField(const DistanceField** OutDistanceField) const;
+    
+    /** Null until the voxels have been filled with geometry*/
+    PL_RESULT GetAirRegions(const AirRegions** OutAirRegions) const;
+    
+    /** Null until the voxels have been filled with geometry*/
+    PL_RESULT GetOccupancyGrid(const OccupancyGrid** OutOccupancyGrid) const;
+    
+    /** Null until the voxels have been filled with geometry*/
+    PL_RESULT GetTriangleBVH(const TriangleBVH** OutTriangleBVH) const;
+    
     PL_RESULT GetVoxelLatticeSize(int& X, int& Y, int& Z) const;
     
     PL_RESULT GetTimeSteps(int& OutTimeSteps);
@@ -177,6 +445,17 @@ private:
     float VoxelSize;
     
     std::vector<PL_MESH> Meshes;
+    
+    /** Simplified meshes in asset space, shared by every instance of an asset. Only keeps what the last fill used*/
+    std::map<std::tuple<size_t, double, double>, std::shared_ptr<const PL_MESH>> SimplifiedAssets;
+    
+    bool bSimplifyMeshes = false;
+    
+    /** Fraction of the voxel size the surface can move when simplifying*/
+    float SimplificationError = 0.1f;
+    
+    std::vector<Heightfield> Heightfields;
+    std::vector<PrimitiveCollider> Primitives;
     std::vector<PLVector> ListenerLocations;
     std::vector<PLVector> SourceLocations;
     
@@ -184,12 +463,57 @@ private:
     
     int TimeSteps = 100;
     
+    PL_SIMULATION_SCHEME SimulationScheme = PL_SIMULATION_SCHEME_FDTD;
+    
+    PL_SIMULATION_PRECISION SimulationPrecision = PL_SIMULATION_PRECISION_DOUBLE;
+    
+    PL_VOXELISATION_MODE VoxelisationMode = PL_VOXELISATION_MODE_EXACT;
+    
+    /** Max distance in meters to warm start from the last full simulation. 0 = always run a full simulation*/
+    float WarmStartDistance = 0.0f;
+    
+    /** Voxel the last full simulation was pulsed from. -1 when there is nothing to warm start from*/
+    int FullSimulationVoxelIndex = -1;
+    
+    /** Voxel the current simulation results are centered on. Differs from FullSimulationVoxelIndex after a warm start*/
+    int CurrentSimulationVoxelIndex = -1;
+    
     /**Pointer to the object that will run our specific simulation. Can be anything from FDTD to rectangular decomposition etc.*/
     std::unique_ptr<Simulator> SimulatorPointer;
     
     /** Does the free energy ready for occlusion*/
     std::unique_ptr<FreeGrid> FreeGridPointer;
     
+    /** Baked listener probes. Null until BakeProbes is called*/
+    std::unique_ptr<ProbeGrid> ProbeGridPointer;
+    
+    /** Distance from every voxel to geometry. Recalculated every time the voxels are filled*/
+    std::unique_ptr<DistanceField> DistanceFieldPointer;
+    
+    /** Connected regions of air. Recalculated every time the voxels are filled*/
+    std::unique_ptr<AirRegions> AirRegionsPointer;
+    
+    /** Bit packed geometry for line of sight queries. Rebuilt every time the voxels are filled*/
+    std::unique_ptr<OccupancyGrid> OccupancyGridPointer;
+    
+    /** Triangles of every mesh for ray tracing. Rebuilt every time the voxels are filled*/
+    std::unique_ptr<TriangleBVH> TriangleBVHPointer;
+    
+    /** Shortest paths from the listener. Null until UpdateGeodesicField is called, and cleared when the voxels change*/
+    std::unique_ptr<GeodesicField> GeodesicFieldPointer;
+    
+    /** Rooms and the portals between them. Rebuilt every time the voxels are filled*/
+    std::unique_ptr<RoomGraph> RoomGraphPointer;
+    
+    /** Debug window. Declared before VoxelThread so it outlives anything the voxel thread publishes to it*/
+    std::unique_ptr<DebugViewer> DebugViewerPointer;
+    
+    /** Time steps between snapshots sent to the debug window while simulating*/
+    static constexpr int DebugViewerInterval = 16;
+    
+    /** Writes pressure frames to disk while simulating. Null when not recording*/
+    std::unique_ptr<SnapshotRecorder> SnapshotRecorderPointer;
+    
     enum ThreadStatus
     {
         ThreadStatus_NotStarted,
@@ -203,10 +527,42 @@ private:
     
     PL_RESULT VoxeliseInternal();
     
+    /**
+     * Shifts the last simulation to a new voxel if it's close enough to where the last full simulation ran.
+     *
+     * @return True if the simulation results are now valid for the voxel and no full simulation is needed.
+     */
+    bool TryWarmStart(int VoxelIndex);
+    
+    /**
+     * Forget the last simulation so the next one runs in full. Call whenever the lattice or geometry changes.
+     */
+    void InvalidateWarmStart();
+    
+    /**
+     * Activates the air regions containing the simulated voxel, listener locations and source locations. Every other region is skipped by the simulator.
+     */
+    void UpdateActiveRegions(int SimulationVoxelIndex);
+    
+    /** Logs a warning if the precision is below double but the scheme can't store it*/
+    void WarnIfPrecisionIgnored() const;
+    
+    /**
+     * Sends the current state of the scene to the debug window, if it's open.
+     *
+     * @param AirColouring One of DebugViewer::Colouring.
+     */
+    void PublishDebugSnapshot(int AirColouring) const;
+    
     /**
      * Adds absorption values to the voxel lattice cells based on the absorptivity of each mesh.
      *
      * If Voxelise creates the voxels, this method gives them meaning.
      */
     PL_RESULT FillVoxels();
+    
+    /**
+     * Makes a simplified copy of every mesh that doesn't have one for the current voxel size. Each asset is simplified once, and assets in parallel.
+     */
+    void SimplifyMeshes();
 };
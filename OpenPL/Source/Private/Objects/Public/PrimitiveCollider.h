@@ -0,0 +1,102 @@
+/*
+  ==============================================================================
+  
+    PrimitiveCollider.h
+    Created: 19 Oct 2026 6:21:40am
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "OpenPLCommonPrivate.h"
+#include <vector>
+
+/**
+ * A box, sphere, capsule or convex hull occluder, voxelised straight from its shape instead of from triangles.
+ *
+ * Every voxel whose centre is inside the shape is filled. The test is a handful of multiplies per voxel, worked out a row of voxels at a time
+ * from the row's local coordinates so the loops vectorise, and a shape is closed by definition so there's nothing to leak through.
+ * Like meshes, shapes thinner than about half a voxel can fall between voxel centres.
+ */
+class PrimitiveCollider
+{
+public:
+
+    /**
+     * @param HalfExtents Half the size of the box along its local axes.
+     */
+    static PrimitiveCollider Box(const PLVector& Position, const PLQuaternion& Rotation, const PLVector& HalfExtents, float Absorptivity);
+    
+    static PrimitiveCollider Sphere(const PLVector& Position, float Radius, float Absorptivity);
+    
+    /**
+     * @param HalfHeight Half the length of the segment between the centres of the two end caps. The segment runs along the local Y axis.
+     */
+    static PrimitiveCollider Capsule(const PLVector& Position, const PLQuaternion& Rotation, float Radius, float HalfHeight, float Absorptivity);
+    
+    /**
+     * The hull is the intersection of the planes of its triangles, so the triangles must already be a convex hull.
+     * Either winding works, since each plane is turned to face away from the middle of the vertices.
+     *
+     * @param Scale Scale of the vertices along their local axes, before rotating.
+     * @return Hull that isn't valid if the triangles don't bound a convex shape.
+     */
+    static PrimitiveCollider ConvexHull(const PLVector& Position, const PLQuaternion& Rotation, const PLVector& Scale, const PLVector* Vertices, int VerticesLength, const int* Indices, int IndicesLength, float Absorptivity);
+    
+    /**
+     * False for a convex hull made from triangles that weren't one. It has no planes and would fill nothing.
+     */
+    bool IsValid() const;
+    
+    /**
+     * Fills every voxel whose centre is inside the shape. Only the voxels inside its bounds are tested, split between threads by Z slab.
+     *
+     * @param BottomBackLeft World position of the lattice's corner.
+     */
+    void Fill(PL_VOXEL_GRID& Grid, const PLVector& BottomBackLeft) const;
+
+private:
+
+    enum Shape
+    {
+        Shape_Box,
+        Shape_Sphere,
+        Shape_Capsule,
+        Shape_ConvexHull
+    };
+    
+    /**
+     * Points inside have Normal . Point <= Distance, in local space.
+     */
+    struct Plane
+    {
+        Eigen::Vector3f Normal;
+        float Distance;
+    };
+    
+    PrimitiveCollider(Shape Type, const PLVector& Position, const PLQuaternion& Rotation, float Absorptivity);
+    
+    /**
+     * Writes 1 for every voxel of a row whose centre is inside, 0 for the rest, from the local positions of the centres.
+     */
+    void TestRow(const float* LocalX, const float* LocalY, const float* LocalZ, int Count, float* Scratch, uint8_t* OutInside) const;
+    
+    Shape Type;
+    
+    Eigen::Vector3f Position;
+    
+    /** Rotates world offsets from Position into local space*/
+    Eigen::Matrix3f WorldToLocal;
+    
+    /** Box half extents, or X as the radius of a sphere or capsule and Y as the half height of a capsule*/
+    Eigen::Vector3f Size;
+    
+    std::vector<Plane> Planes;
+    
+    /** World space bounds. Voxels outside are never tested*/
+    Eigen::AlignedBox3f Bounds;
+    
+    float Absorptivity;
+};
@@ -0,0 +1,65 @@
+/*
+  ==============================================================================
+  
+    ProbeGenerator.h
+    Created: 18 Oct 2026 11:02:15am
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "OpenPLCommonPrivate.h"
+#include <cstdint>
+
+class PL_SCENE;
+
+/**
+ * Generates listener probe locations for the air a player can actually reach.
+ *
+ * 1) Flood fill the open voxels from seed points
+ * 2) Lay probes out on a coarse lattice over the filled air, one per lattice cell, in the most open voxel of each cell
+ * 3) Add probes in narrow passages (doorways, corridors) found from the distance to geometry
+ * 4) Coarsen the lattice until everything fits in the probe budget
+ */
+class ProbeGenerator
+{
+public:
+
+    /**
+     * @param Scene Scene with filled voxels.
+     * @param Seeds Locations the player can reach. Air connected to these is filled.
+     * @param Spacing Distance in meters between lattice probes.
+     * @param MaxProbes Maximum number of probes to generate.
+     * @param OutProbeLocations Probe locations are added to the end of this array.
+     */
+    PL_RESULT Generate(const PL_SCENE* Scene, const std::vector<PLVector>& Seeds, float Spacing, int MaxProbes, std::vector<PLVector>& OutProbeLocations);
+
+private:
+
+    void FloodFill(const std::vector<int>& SeedIndices);
+    
+    /**
+     * One probe per Stride^3 block of reachable voxels.
+     */
+    void PlaceLatticeProbes(int Stride, std::vector<int>& OutProbeIndices) const;
+    
+    /**
+     * Finds saddle points of the distance field. The distance peaks across a doorway and dips going through it.
+     * Sorted narrowest first.
+     */
+    void FindPortals(int MaxRadius, int SuppressionRadius, std::vector<int>& OutPortalIndices) const;
+    
+    const PL_VOXEL_GRID* Grid = nullptr;
+    
+    int XSize = 0;
+    int YSize = 0;
+    int ZSize = 0;
+    
+    /** 1 for open voxels connected to a seed*/
+    std::vector<uint8_t> Reachable;
+    
+    /** Fixed point distance from each voxel to the nearest closed voxel. Only valid during Generate*/
+    const uint16_t* DistanceToGeometry = nullptr;
+};
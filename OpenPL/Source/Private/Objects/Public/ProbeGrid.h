@@ -0,0 +1,105 @@
+/*
+  ==============================================================================
+  
+    ProbeGrid.h
+    Created: 18 Oct 2026 9:12:40am
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "OpenPLCommonPrivate.h"
+#include <cstdint>
+
+class PL_SCENE;
+class Simulator;
+
+/**
+ * Baked listener probes.
+ *
+ * Each probe is simulated offline and the occlusion from the probe to every voxel in its plane is stored.
+ * The simulation runs over the XZ plane of the probe, so emitters are looked up as if they were at the probe's height.
+ * At runtime, occlusion is blended from the probes nearest the listener, which costs a few memory reads per emitter instead of a live simulation.
+ */
+class ProbeGrid
+{
+public:
+
+    /**
+     * Finds probe locations on walkable air voxels of the scene.
+     * A voxel is walkable if it's open and the voxel below it is closed (or it's on the bottom of the lattice).
+     *
+     * @param Scene Scene with filled voxels.
+     * @param Placement How to spread the probes out.
+     * @param Spacing Distance in meters between probes. Grows if the probes don't fit in MaxProbes.
+     * @param MaxProbes Maximum number of probes to add.
+     * @param OutProbeLocations Probe locations are added to the end of this array.
+     */
+    static PL_RESULT PlaceProbes(const PL_SCENE* Scene, PL_PROBE_PLACEMENT Placement, float Spacing, int MaxProbes, std::vector<PLVector>& OutProbeLocations);
+    
+    /**
+     * Simulates each probe location and encodes the occlusion to every voxel.
+     * Blocks until every probe has been simulated.
+     *
+     * @param Scene Scene to simulate.
+     * @param ProbeLocations Locations to simulate from.
+     */
+    PL_RESULT Bake(PL_SCENE* Scene, const std::vector<PLVector>& ProbeLocations);
+    
+    /**
+     * Blends the baked occlusion of the probes nearest the listener.
+     *
+     * @param ListenerIndex Voxel the listener is in.
+     * @param EmitterIndex Voxel the emitter is in.
+     * @param OutOcclusion 1 = unoccluded, 0 = fully occluded.
+     */
+    PL_RESULT GetOcclusion(int ListenerIndex, int EmitterIndex, float* OutOcclusion) const;
+    
+    int GetProbeCount() const;
+
+private:
+
+    /** How many probes are blended together at runtime*/
+    static constexpr int MaxBlendedProbes = 4;
+    
+    /** How many of the nearest probes in a voxel's air region are traced to when looking for visible ones*/
+    static constexpr int MaxCandidateProbes = 16;
+    
+    /** Marks an unused slot in a ProbeBlend*/
+    static constexpr uint16_t NoProbe = 0xFFFF;
+    
+    /**
+     * The nearest probes visible from a voxel and how much each contributes. Weights add up to 1.
+     */
+    struct ProbeBlend
+    {
+        uint16_t Probes[MaxBlendedProbes];
+        float Weights[MaxBlendedProbes];
+    };
+    
+    void EncodeProbe(Simulator* Simulator, int ProbeVoxelIndex, std::vector<uint8_t>& OutEncodedOcclusion) const;
+    
+    int GetPlaneIndex(int VoxelIndex) const;
+    
+    /**
+     * Picks the probes to blend for every voxel. Only probes with a clear line of sight to the voxel are blended,
+     * so a listener next to a wall doesn't hear the probe in the room behind it.
+     * If none of the nearby probes are visible, the nearest probe in the same air region is used on its own.
+     */
+    void BuildBlends(const PL_SCENE* Scene, const std::vector<int>& ProbeVoxelIndices);
+    
+    /** Voxel index of each baked probe*/
+    std::vector<int> ProbeVoxels;
+    
+    /** For each probe, the occlusion to every voxel of its XZ plane quantised to 0-255. Indexed by X + Z * XSize*/
+    std::vector<std::vector<uint8_t>> EncodedOcclusion;
+    
+    int XSize = 0;
+    int YSize = 0;
+    int ZSize = 0;
+    
+    /** For each voxel, the probes to blend when the listener is inside it*/
+    std::vector<ProbeBlend> Blends;
+};
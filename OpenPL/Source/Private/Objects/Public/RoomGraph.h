@@ -0,0 +1,94 @@
+/*
+  ==============================================================================
+  
+    RoomGraph.h
+    Created: 18 Oct 2026 7:58:31pm
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "OpenPLCommonPrivate.h"
+#include <cstdint>
+
+class DistanceField;
+
+/**
+ * Splits the air of the lattice into rooms joined by portals, like doorways and windows.
+ *
+ * Rooms are found with a watershed of the distance field. Air is flooded from the most open voxels down, so each room grows from its center.
+ * Where two rooms meet, the distance to geometry at the meeting point is the half width of the opening between them.
+ * Openings much narrower than the smaller room become portals. Wider ones are just part of the same room and the two are merged.
+ */
+class RoomGraph
+{
+public:
+
+    struct Room
+    {
+        /** Most open voxel of the room. A good place for a reverb probe*/
+        int CenterVoxel;
+        
+        int VoxelCount;
+        
+        /** Portals leading out of this room*/
+        std::vector<int> Portals;
+    };
+    
+    struct Portal
+    {
+        int RoomA;
+        int RoomB;
+        
+        /** Center of the opening in world space*/
+        PLVector Position;
+        
+        /** Area of the opening in square meters*/
+        float Area;
+    };
+    
+    /** Room of voxels that are geometry*/
+    static constexpr uint32_t NoRoom = 0xFFFFFFFF;
+    
+    /**
+     * @param Grid Voxel lattice to split.
+     * @param Distances Distance field of the same lattice.
+     * @param BottomBackLeft World position of the corner of the first voxel.
+     */
+    void Build(const PL_VOXEL_GRID& Grid, const DistanceField& Distances, const PLVector& BottomBackLeft);
+    
+    uint32_t GetRoom(int VoxelIndex) const;
+    
+    const std::vector<Room>& GetRooms() const;
+    
+    const std::vector<Portal>& GetPortals() const;
+    
+    /**
+     * Finds the shortest route between two points through the portals. Paths inside a room are straight lines.
+     *
+     * @param From Start in world space.
+     * @param FromRoom Room From is in.
+     * @param To End in world space.
+     * @param ToRoom Room To is in.
+     * @param OutPortals Portals passed through, in order from From.
+     * @param OutDistance Length of the route in meters.
+     * @return False if no route connects the rooms.
+     */
+    bool FindPath(const PLVector& From, uint32_t FromRoom, const PLVector& To, uint32_t ToRoom, std::vector<int>& OutPortals, float& OutDistance) const;
+
+private:
+
+    /** Openings up to this fraction of the smaller room's half width are portals*/
+    static constexpr float PortalRatio = 0.7f;
+    
+    /** Rooms with a half width under this many meters are pockets of a bigger room, like the space under a table*/
+    static constexpr float MinRoomHalfWidth = 0.5f;
+    
+    std::vector<uint32_t> RoomOfVoxel;
+    
+    std::vector<Room> Rooms;
+    
+    std::vector<Portal> Portals;
+};
@@ -11,6 +11,7 @@
 #pragma once
 
 #include <vector>
+#include <cmath>
 #include "OpenPLCommonPrivate.h"
 
 class PL_SCENE;
@@ -19,9 +20,35 @@ class Simulator
 {
 public:
     
+    /**
+     * Picks the largest stable time step for the lattice's voxel size and the scheme's dimensions.
+     *
+     * @param Scene Scene to report progress to. Can be null for lattices that don't belong to a scene.
+     * @param Settings Settings.Resolution is the highest frequency wanted. It's lowered if the voxels are too big to resolve it.
+     */
     void Init(PL_SCENE* Scene, PL_VOXEL_GRID& Voxels, PL_SIMULATION_SETTINGS& Settings);
     
-    virtual void Simulate(int SimulateVoxelIndex) { }
+    /**
+     * Runs the pulse from SimulateVoxelIndex for every time step.
+     *
+     * @return False if the lattice couldn't be simulated, like when it's empty. The simulated lattice shouldn't be read.
+     */
+    virtual bool Simulate(int SimulateVoxelIndex) { return false; }
+    
+    /**
+     * Number of dimensions the scheme updates. Sets the stability limit of the time step.
+     */
+    virtual int GetDimensions() const { return 3; }
+    
+    /**
+     * Largest Courant number the scheme is stable at. 1/sqrt(D) for the second order staggered grid.
+     */
+    virtual double GetCourantLimit() const { return 1.0 / std::sqrt(static_cast<double>(GetDimensions())); }
+    
+    /**
+     * Voxels needed per wavelength of the highest simulated frequency before the dispersion error gets bad, about 13% at the Nyquist end.
+     */
+    virtual double GetVoxelsPerWavelength() const { return 3.5; }
     
     const std::vector<std::vector<PLVoxel>>& GetSimulatedLattice() const;
     
@@ -31,12 +58,65 @@ public:
     
     int GetTimeSteps() const;
     
+    /**
+     * Distance sound travels in one time step, in voxels.
+     */
+    double GetCourantNumber() const;
+    
+    /**
+     * Highest frequency in Hz the lattice can resolve. The pulse carries no energy above it.
+     * The lower of the requested resolution and what the voxel size allows.
+     */
+    float GetMaxFrequency() const;
+    
+    /**
+     * Translates the stored simulation by a whole number of voxels instead of simulating again.
+     * Cells shifted in from outside the lattice start silent.
+     *
+     * Propagation is reciprocal, so moving the pulse by a few voxels moves the whole response with it.
+     * The result is exact in open space and an approximation around geometry.
+     */
+    void ShiftSimulatedLattice(int OffsetX, int OffsetY, int OffsetZ);
+    
+    /**
+     * Limits the simulation to the active voxels. Inactive voxels stay silent and aren't updated.
+     *
+     * @param ActiveVoxels 1 for each voxel to simulate. Null to simulate everything.
+     */
+    void SetActiveVoxels(const std::vector<uint8_t>* ActiveVoxels);
+    
     virtual ~Simulator() { }
     
 protected:
     
     void GaussianPulse();
     
+    static constexpr double SpeedOfSound = 343.21;
+    
+    /** Fraction of the Courant limit to run at. Exactly on the limit rounding errors can still grow*/
+    static constexpr double StabilityMargin = 0.995;
+    
+    /** Clears the pressure and velocity of every voxel before a new pulse*/
+    void ResetLattice();
+    
+    /**
+     * Sound leaving through the first and last X and Z faces of the plane carries on outwards instead of reflecting.
+     */
+    void AbsorbAtEdges(int y);
+    
+    /** Stores the lattice as this time step of the response*/
+    void RecordTimeStep(int CurrentTimeStep);
+    
+    /**
+     * Tells the scene how far the simulation has got. Call at the end of every time step.
+     */
+    void ReportProgress(int CurrentTimeStep);
+    
+    bool IsActive(int VoxelIndex) const
+    {
+        return ActiveVoxels == nullptr || (*ActiveVoxels)[VoxelIndex] != 0;
+    }
+    
 protected:
     
     int XSize;
@@ -46,11 +126,15 @@ protected:
     int CubeSize;
     int TimeSteps;
     double SamplingRate;
+    double MaxFrequency;
+    
+    /** Width of a voxel in meters*/
+    double VoxelSize;
     double UpdateCoefficents;
     PL_SIMULATION_SETTINGS Settings;
     
     /**The 3D cube of voxels. Attached to the scene/geometry*/
-    std::vector<PLVoxel>* Lattice;
+    PLVoxelLattice* Lattice;
     
     /**The 3D cube of voxels with values at each time step*/
     std::vector<std::vector<PLVoxel>> SimulatedLattice;
@@ -58,5 +142,8 @@ protected:
     /**Gaussian pulse*/
     std::vector<double> Pulse;
     
+    /**Voxels connected to a listener or source. Null when every voxel is simulated*/
+    const std::vector<uint8_t>* ActiveVoxels = nullptr;
+    
     PL_SCENE* OwningScene;
 };
@@ -0,0 +1,101 @@
+/*
+  ==============================================================================
+  
+    SimulatorADI.h
+    Created: 19 Oct 2026 3:02:44am
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "Simulator.h"
+
+/**
+ * Alternating direction implicit form of SimulatorLeapfrog. The wave equation is stable at any time step (Lees, theta = 1/4):
+ * (1 + Lx/2 - C^2/4 dxx) (1 + Lz/2 - C^2/4 dzz) (p(n+1) - 2 p(n) + p(n-1)) = C^2 (dxx + dzz) p(n) - (Lx + Lz) (p(n) - p(n-1)),
+ * where Lx and Lz are the losses of the voxel's wall and edge faces along each axis, like the leapfrog's Loss.
+ *
+ * Each time step is one tridiagonal solve along every row and then one along every column.
+ * The matrices never change, so they're factored once and each step is only the Thomas algorithm's two substitution sweeps.
+ * Columns are solved side by side, X fastest, so the inner loop runs across neighbouring lines and vectorises.
+ * Rows are gathered into blocks of BatchSize lines and interleaved the same way. Both are split between threads.
+ *
+ * Bigger steps cost phase accuracy, so the step is only as big as Settings.Resolution allows.
+ * On voxels much finer than the resolution needs, that's several times the explicit limit.
+ */
+class SimulatorADI : public Simulator
+{
+public:
+
+    virtual bool Simulate(int SimulateVoxelIndex) override;
+    
+    /** Only the plane through the source is simulated*/
+    virtual int GetDimensions() const override { return 2; }
+    
+    /**
+     * Not a stability limit, since any step is stable. The largest Courant number whose phase error at Settings.Resolution is no worse
+     * than the explicit schemes' at their 3.5 voxels per wavelength. Never below the explicit limit, so coarse voxels run at the leapfrog's step.
+     */
+    virtual double GetCourantLimit() const override;
+    
+    /**
+     * Along an axis the phase error is about (kh)^2 (2 C^2 + 1) / 24, against (kh)^2 / 48 for the leapfrog at its limit.
+     * Even at the explicit step that needs twice the leapfrog's voxels per wavelength, and bigger steps need more.
+     */
+    virtual double GetVoxelsPerWavelength() const override;
+    
+    ~SimulatorADI() { }
+
+private:
+
+    /**
+     * Thomas algorithm factors of a set of tridiagonal lines, laid out like the values they solve.
+     */
+    struct LineFactors
+    {
+        /** Coefficient of the previous value on the line*/
+        std::vector<double> Lower;
+        
+        /** 1 / the diagonal left after eliminating the previous value*/
+        std::vector<double> InverseDiagonal;
+        
+        /** Coefficient of the next value on the line, after elimination*/
+        std::vector<double> Upper;
+    };
+    
+    /**
+     * Works out the loss of every voxel in the plane through y and factors the row and column matrices.
+     */
+    void BuildFactors(int y);
+    
+    /**
+     * Solves Batch tridiagonal lines of Length values in place. Value i of line b is at i * Stride + b, and so are its factors.
+     */
+    static void SolveLines(double* Values, const double* Lower, const double* InverseDiagonal, const double* Upper, int Length, int Batch, int Stride);
+    
+    /** Weight of the implicit part. 1/4 is the smallest that's stable at any step*/
+    static constexpr double Theta = 0.25;
+    
+    /** Rows solved together. Enough for a vector register of doubles or two*/
+    static constexpr int BatchSize = 8;
+    
+    /** Voxels per wavelength the explicit schemes need*/
+    static constexpr double ExplicitVoxelsPerWavelength = 3.5;
+    
+    /** 1 for voxels that are simulated, 0 for geometry and air that isn't. X fastest*/
+    std::vector<double> Mask;
+    
+    /** Neighbours in the plane that are air*/
+    std::vector<double> OpenNeighbours;
+    
+    /** C times the admittance of the voxel's wall and edge faces, along both axes*/
+    std::vector<double> Loss;
+    
+    /** Rows, in blocks of BatchSize rows with the rows of a block interleaved. Padded with empty rows up to a whole block*/
+    LineFactors RowFactors;
+    
+    /** Columns, in the plane's own layout*/
+    LineFactors ColumnFactors;
+};
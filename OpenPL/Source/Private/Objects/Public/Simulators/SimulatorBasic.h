@@ -14,7 +14,7 @@
 
 class SimulatorBasic : public Simulator
 {
-    virtual void Simulate(int SimulateVoxelIndex) override;
+    virtual bool Simulate(int SimulateVoxelIndex) override;
     
     ~SimulatorBasic() { }
 };
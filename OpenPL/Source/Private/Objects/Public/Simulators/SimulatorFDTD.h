@@ -14,7 +14,10 @@
 
 class SimulatorFDTD : public Simulator
 {
-    virtual void Simulate(int SimulateVoxelIndex) override;
+    virtual bool Simulate(int SimulateVoxelIndex) override;
+    
+    /** Only the plane through the source is simulated*/
+    virtual int GetDimensions() const override { return 2; }
     
     ~SimulatorFDTD() { }
 };
@@ -0,0 +1,68 @@
+/*
+  ==============================================================================
+  
+    SimulatorFDTD4.h
+    Created: 18 Oct 2026 11:14:52pm
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "Simulator.h"
+
+/**
+ * Staggered FDTD like SimulatorFDTD, but with fourth order spatial differences, (27 (b - a) - (d - c)) / 24 over the four samples c a b d.
+ *
+ * Phase error at 2.5 voxels per wavelength is about what the second order scheme has at 3.5, so the same resolution runs on voxels 1.4 times bigger.
+ * That's half the cells in the simulated plane and a third in a volume, for a slightly smaller time step.
+ * The wider stencil can't reach across geometry. Next to a wall it reads the mirror image of the voxels on its own side instead,
+ * which is exact for rigid walls. Within two voxels of the lattice edges it falls back to second order so the edges still absorb.
+ */
+class SimulatorFDTD4 : public Simulator
+{
+public:
+
+    virtual bool Simulate(int SimulateVoxelIndex) override;
+    
+    /** Only the plane through the source is simulated*/
+    virtual int GetDimensions() const override { return 2; }
+    
+    /** The stencil's gain at the Nyquist frequency is 7/6, so the limit is that much lower than second order*/
+    virtual double GetCourantLimit() const override { return 6.0 / 7.0 / std::sqrt(static_cast<double>(GetDimensions())); }
+    
+    virtual double GetVoxelsPerWavelength() const override { return 2.5; }
+    
+    ~SimulatorFDTD4() { }
+
+private:
+
+    /**
+     * Per axis, for the pressure of a voxel and the velocity on the face before it.
+     * Fourth marks updates far enough from the lattice edges for the wide stencil. Before and After mark outer samples that are behind a wall and mirrored.
+     */
+    enum StencilFlags : uint16_t
+    {
+        Stencil_PressureFourthX = 1 << 0,
+        Stencil_PressureBeforeX = 1 << 1,
+        Stencil_PressureAfterX = 1 << 2,
+        Stencil_VelocityFourthX = 1 << 3,
+        Stencil_VelocityBeforeX = 1 << 4,
+        Stencil_VelocityAfterX = 1 << 5,
+        Stencil_PressureFourthZ = 1 << 6,
+        Stencil_PressureBeforeZ = 1 << 7,
+        Stencil_PressureAfterZ = 1 << 8,
+        Stencil_VelocityFourthZ = 1 << 9,
+        Stencil_VelocityBeforeZ = 1 << 10,
+        Stencil_VelocityAfterZ = 1 << 11
+    };
+    
+    void BuildStencils(int y);
+    
+    /** Open air that is being simulated*/
+    bool IsOpen(int x, int y, int z) const;
+    
+    /** One set of StencilFlags per voxel of the simulated plane, X fastest*/
+    std::vector<uint16_t> Stencils;
+};
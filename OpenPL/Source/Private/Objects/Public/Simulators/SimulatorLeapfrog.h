@@ -0,0 +1,69 @@
+/*
+  ==============================================================================
+  
+    SimulatorLeapfrog.h
+    Created: 19 Oct 2026 12:06:17am
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "Simulator.h"
+
+/**
+ * Pressure only form of SimulatorFDTD. Taking the velocity out of the staggered updates leaves the standard leapfrog wave equation,
+ * p(n+1) = 2 p(n) - p(n-1) + C^2 (sum of open neighbours - count * p(n)) - Loss (p(n) - p(n-1)),
+ * where Loss is C times the admittance of every wall face of the voxel. In the air it gives the same pressures as SimulatorFDTD.
+ *
+ * Every time step is one sweep over two planes of pressure and a small index per voxel, instead of three sweeps over whole voxels.
+ * The planes can be stored as double, float or half floats (Settings.Precision). Float and half are worked on as float.
+ * The plane arrays have a silent border so the sweep needs no edge checks.
+ */
+class SimulatorLeapfrog : public Simulator
+{
+public:
+
+    virtual bool Simulate(int SimulateVoxelIndex) override;
+    
+    /** Only the plane through the source is simulated*/
+    virtual int GetDimensions() const override { return 2; }
+    
+    ~SimulatorLeapfrog() { }
+
+private:
+
+    /**
+     * Constants shared by every voxel with the same surroundings. Most voxels are plain air, so there are only a handful.
+     */
+    struct CellKind
+    {
+        /** 1 for voxels that are simulated. 0 for geometry and air that isn't, so their pressure stays 0*/
+        float Mask;
+        
+        /** Neighbours in the plane that are air*/
+        float OpenNeighbours;
+        
+        /** C times the admittance of the voxel's wall faces. The lattice edges are matched, with an admittance of 1*/
+        float Loss;
+    };
+    
+    /**
+     * Works out every voxel's kind for the plane through y.
+     *
+     * @return False if the plane needs more kinds than a cell index holds and a voxel has no kind with the same neighbours to share.
+     */
+    bool BuildCells(int y);
+    
+    /**
+     * Runs every time step with the pressure stored as Storage and worked on a row at a time as Compute.
+     */
+    template <typename Storage, typename Compute>
+    void Run(int y, int SourceX, int SourceZ);
+    
+    std::vector<CellKind> Kinds;
+    
+    /** Index into Kinds for every voxel of the simulated plane, X fastest*/
+    std::vector<uint16_t> Cells;
+};
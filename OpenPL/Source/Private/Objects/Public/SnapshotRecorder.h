@@ -0,0 +1,117 @@
+/*
+  ==============================================================================
+  
+    SnapshotRecorder.h
+    Created: 18 Oct 2026 9:24:45pm
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "OpenPLCommonPrivate.h"
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <cstdint>
+#include <deque>
+#include <string>
+
+/**
+ * Writes the air pressure of the live lattice to disk every few time steps while it simulates, so the field can be viewed in ParaView afterwards.
+ *
+ * Each frame is a VTK XML image (.vti) of the whole lattice or one plane of it, optionally keeping only every Stride-th voxel.
+ * A .pvd collection listing every frame with its time is written when recording stops, so the frames load as one animation.
+ * Frames are numbered in the order they're captured and their times carry on from one simulation to the next, so recording several simulations gives one continuous animation.
+ * The simulation thread only copies the voxels into a buffer. Files are written on a background thread.
+ */
+class SnapshotRecorder
+{
+public:
+
+    ~SnapshotRecorder();
+    
+    /**
+     * @param FilePrefix Path and start of the file names. Frames are FilePrefix_<frame>.vti and the collection is FilePrefix.pvd.
+     * @param Interval Time steps between frames.
+     * @param Stride Keep every Stride-th voxel along each axis.
+     * @param Region Whole lattice or one plane of it.
+     * @param PlaneIndex Voxel index along the plane's axis. Ignored for volumes.
+     * @param Precision Float32 frames load straight into VTK. Float16 frames are half the size, but VTK has no half type so they're stored as UInt16 bits.
+     */
+    void Start(const std::string& FilePrefix, int Interval, int Stride, PL_SNAPSHOT_REGION Region, int PlaneIndex, PL_SNAPSHOT_PRECISION Precision, const PL_VOXEL_GRID& Grid, const PLVector& BottomBackLeft);
+    
+    /**
+     * Copies the lattice into a frame if TimeStep is on the interval. Waits if the writer thread has fallen too far behind.
+     * A time step no later than the last one starts a new simulation, which is placed on the timeline straight after the previous one.
+     *
+     * @param Time Time of the step in seconds, from the start of its simulation.
+     */
+    void Capture(const PL_VOXEL_GRID& Grid, int TimeStep, double Time);
+    
+    /**
+     * Waits for every frame to be written, then writes the collection file.
+     */
+    void Stop();
+
+private:
+
+    struct Frame
+    {
+        /** Position in the recording*/
+        int Index;
+        
+        /** Seconds since the first simulation recorded started*/
+        double Time;
+        std::vector<uint8_t> Data;
+    };
+    
+    void WriteFrames();
+    
+    void WriteFrame(const Frame& ToWrite) const;
+    
+    void WriteCollection() const;
+    
+    /** Frames waiting to be written before Capture starts waiting. Bounds how much memory the recorder holds*/
+    static constexpr size_t MaxQueuedFrames = 4;
+    
+    std::string FilePrefix;
+    int Interval = 1;
+    PL_SNAPSHOT_PRECISION Precision = PL_SNAPSHOT_PRECISION_FLOAT32;
+    
+    /** First and one past the last voxel recorded along each axis*/
+    int Begin[3];
+    int End[3];
+    int Stride = 1;
+    
+    /** Samples per frame along each axis*/
+    int Counts[3];
+    
+    PLVector Origin;
+    float Spacing = 0.0f;
+    
+    boost::thread WriterThread;
+    boost::mutex QueueMutex;
+    boost::condition_variable QueueChanged;
+    bool Stopping = false;
+    
+    /** Filled frames waiting to be written*/
+    std::deque<Frame> Queued;
+    
+    /** Written frames whose buffers can be filled again, so frames don't allocate once recording is going*/
+    std::vector<Frame> Spare;
+    
+    /** Index and time of every frame written, for the collection*/
+    std::vector<std::pair<int, double>> Written;
+    
+    /** Frames captured so far. Only touched by the simulation thread, like the members below*/
+    int FrameCount = 0;
+    
+    /** Last time step seen, to spot a new simulation starting*/
+    int LastTimeStep = -1;
+    double LastTime = 0.0;
+    double StepDuration = 0.0;
+    
+    /** Start of the current simulation on the recording's timeline*/
+    double TimeOffset = 0.0;
+};
@@ -0,0 +1,55 @@
+/*
+  ==============================================================================
+  
+    ThreadScalingBenchmark.h
+    Created: 19 Oct 2026 4:37:18am
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "OpenPLCommonPrivate.h"
+#include <vector>
+
+/**
+ * Times a memory bound sweep over a cube of voxels at 1, 2, 4... threads, up to one per hardware thread.
+ * Each sweep averages every air voxel's pressure with its 6 neighbours, split between threads by Z slab like the simulators.
+ *
+ * Every thread count is run twice: on a lattice zeroed by the calling thread, which puts every page on its NUMA node,
+ * and on one zeroed with ParallelAssign, where each worker first touches the slabs it sweeps.
+ * On one socket both scale the same. Across sockets the first stops scaling once the workers spill onto the second socket,
+ * since they all read across the interconnect. Pinning threads with SetParallelThreads keeps each worker on its own slabs' node.
+ */
+class ThreadScalingBenchmark
+{
+public:
+
+    struct Timing
+    {
+        int Threads;
+        
+        /** Wall time of the sweeps on the lattice one thread zeroed*/
+        double SerialTouchSeconds;
+        
+        /** Wall time of the sweeps on the lattice every worker zeroed its own slabs of*/
+        double FirstTouchSeconds;
+    };
+    
+    /**
+     * Runs every thread count on a VoxelsInSide^3 lattice and logs each timing. Leaves the thread count as it found it.
+     */
+    std::vector<Timing> Run(int VoxelsInSide);
+    
+    static constexpr int Sweeps = 10;
+    
+    static constexpr int MinVoxelsInSide = 8;
+
+private:
+
+    /**
+     * Sweeps Lattice with the current thread count and returns the wall time.
+     */
+    static double TimeSweeps(PLVoxelLattice& Lattice, int Size);
+};
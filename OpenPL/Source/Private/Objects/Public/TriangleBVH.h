@@ -0,0 +1,88 @@
+/*
+  ==============================================================================
+  
+    TriangleBVH.h
+    Created: 18 Oct 2026 6:05:12pm
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "OpenPLCommonPrivate.h"
+
+/**
+ * Bounding volume hierarchy over every triangle of the scene meshes, for ray queries against the real geometry instead of the voxels.
+ */
+class TriangleBVH
+{
+public:
+
+    struct Triangle
+    {
+        Eigen::Vector3f A;
+        Eigen::Vector3f B;
+        Eigen::Vector3f C;
+        
+        /** Unit normal. Triangles are two sided so the direction doesn't matter*/
+        Eigen::Vector3f Normal;
+    };
+    
+    /**
+     * Copies the triangles of the meshes and builds the tree. Meshes must already be in world space.
+     */
+    void Build(const std::vector<PL_MESH>& Meshes);
+    
+    /**
+     * Finds where a segment crosses one particular triangle.
+     *
+     * @param OutT Distance along the segment, 0 at From and 1 at To.
+     * @return True if the segment crosses the triangle.
+     */
+    bool IntersectTriangle(int TriangleIndex, const Eigen::Vector3f& From, const Eigen::Vector3f& To, float& OutT) const;
+    
+    /**
+     * Checks whether any triangle blocks the segment between two points.
+     *
+     * @param IgnoreA Triangle to skip, like the one From lies on. -1 for none.
+     * @param IgnoreB Another triangle to skip, like the one To lies on. -1 for none.
+     */
+    bool IsBlocked(const Eigen::Vector3f& From, const Eigen::Vector3f& To, int IgnoreA, int IgnoreB) const;
+    
+    /**
+     * Finds the triangles that might touch a convex region. Conservative, so a triangle is only left out if all its corners are outside one of the planes.
+     *
+     * @param Planes Planes bounding the region, as (Normal, Offset) with Normal.dot(Point) + Offset >= 0 inside. Normals must be unit length.
+     * @param PlaneCount Number of planes.
+     * @param OutTriangles Indices of the triangles found. Cleared first.
+     */
+    void FindInConvex(const Eigen::Vector4f* Planes, int PlaneCount, std::vector<int>& OutTriangles) const;
+    
+    const Triangle& GetTriangle(int TriangleIndex) const;
+    
+    int GetTriangleCount() const;
+
+private:
+
+    /**
+     * Leaves have a Count above 0 and point into TriangleOrder. Inner nodes have their first child right after them and the second at FirstOrSecondChild.
+     */
+    struct Node
+    {
+        Eigen::AlignedBox3f Bounds;
+        int FirstOrSecondChild;
+        int Count;
+    };
+    
+    int BuildNode(int First, int Count);
+    
+    static constexpr int MaxTrianglesPerLeaf = 4;
+    
+    std::vector<Triangle> Triangles;
+    
+    /** Triangle indices, reordered so every leaf's triangles sit next to each other*/
+    std::vector<int> TriangleOrder;
+    
+    std::vector<Node> Nodes;
+};
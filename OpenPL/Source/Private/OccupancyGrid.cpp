@@ -0,0 +1,188 @@
+/*
+  ==============================================================================
+  
+    OccupancyGrid.cpp
+    Created: 18 Oct 2026 4:41:44pm
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#include "OccupancyGrid.h"
+#include <limits>
+#include <cmath>
+
+namespace
+{
+    /** Batches smaller than this aren't worth starting threads for*/
+    const int MinRaysPerThread = 1024;
+}
+
+void OccupancyGrid::Build(const PL_VOXEL_GRID& Grid, const PLVector& BottomBackLeft)
+{
+    XSize = Grid.Size(0,0);
+    YSize = Grid.Size(0,1);
+    ZSize = Grid.Size(0,2);
+    VoxelSize = Grid.VoxelSize;
+    Origin = Eigen::Vector3f(BottomBackLeft.X, BottomBackLeft.Y, BottomBackLeft.Z);
+    
+    const int NumVoxels = static_cast<int>(Grid.Voxels.size());
+    const int NumWords = (NumVoxels + 63) / 64;
+    
+    Bits.assign(NumWords, 0);
+    
+    // Each thread owns whole words so no two threads write the same one
+    ParallelFor(0, NumWords, [&](int Begin, int End)
+    {
+        for (int Word = Begin; Word < End; ++Word)
+        {
+            const int FirstVoxel = Word * 64;
+            const int LastVoxel = std::min(FirstVoxel + 64, NumVoxels);
+            
+            uint64_t Packed = 0;
+            for (int i = FirstVoxel; i < LastVoxel; ++i)
+            {
+                if (Grid.Voxels[i].Beta == 0)
+                {
+                    Packed |= uint64_t(1) << (i - FirstVoxel);
+                }
+            }
+            Bits[Word] = Packed;
+        }
+    });
+}
+
+void OccupancyGrid::Trace(const PLVector& From, const PLVector& To, float& OutThickness, int& OutSolidVoxels) const
+{
+    TraceBatch(From, &To, 1, &OutThickness, &OutSolidVoxels);
+}
+
+void OccupancyGrid::TraceBatch(const PLVector& From, const PLVector* To, int Count, float* OutThicknesses, int* OutSolidVoxels) const
+{
+    if (Count <= 0)
+    {
+        return;
+    }
+    
+    if (Bits.size() == 0)
+    {
+        std::fill(OutThicknesses, OutThicknesses + Count, 0.0f);
+        std::fill(OutSolidVoxels, OutSolidVoxels + Count, 0);
+        return;
+    }
+    
+    // Everything below is in voxel space, where each voxel is 1 unit wide and the lattice starts at 0
+    const Eigen::Array3f Start = (Eigen::Vector3f(From.X, From.Y, From.Z) - Origin).array() / VoxelSize;
+    const Eigen::Array3f Size (XSize, YSize, ZSize);
+    
+    Eigen::Array3Xf Directions (3, Count);
+    Eigen::ArrayXf Lengths (Count);
+    
+    for (int i = 0; i < Count; ++i)
+    {
+        Directions.col(i) << To[i].X - From.X, To[i].Y - From.Y, To[i].Z - From.Z;
+    }
+    
+    Lengths = Directions.matrix().colwise().norm().transpose().array();
+    Directions /= VoxelSize;
+    
+    // Keep the sign of axis aligned rays so the slab test below never divides 0 by 0
+    const float Tiny = 1e-12f;
+    Directions = (Directions.abs() < Tiny).select((Directions < 0.0f).select(-Tiny, Eigen::Array3Xf::Constant(3, Count, Tiny)), Directions);
+    
+    // Clip every ray to the lattice box at once
+    const Eigen::Array3Xf InverseDirections = Directions.inverse();
+    const Eigen::Array3Xf TLow = InverseDirections.colwise() * (-Start);
+    const Eigen::Array3Xf THigh = InverseDirections.colwise() * (Size - Start);
+    const Eigen::ArrayXf TStart = TLow.min(THigh).colwise().maxCoeff().transpose().max(0.0f);
+    const Eigen::ArrayXf TEnd = TLow.max(THigh).colwise().minCoeff().transpose().min(1.0f);
+    
+    auto MarchRays = [&](int Begin, int End)
+    {
+        for (int i = Begin; i < End; ++i)
+        {
+            float SolidT = 0.0f;
+            int SolidVoxels = 0;
+            
+            if (TStart(i) < TEnd(i))
+            {
+                March(Start.matrix(), Directions.col(i).matrix(), TStart(i), TEnd(i), SolidT, SolidVoxels);
+            }
+            
+            OutThicknesses[i] = SolidT * Lengths(i);
+            OutSolidVoxels[i] = SolidVoxels;
+        }
+    };
+    
+    if (Count < MinRaysPerThread * 2)
+    {
+        MarchRays(0, Count);
+        return;
+    }
+    
+    ParallelFor(0, Count, MarchRays);
+}
+
+float OccupancyGrid::ThicknessToOcclusion(float Thickness)
+{
+    return std::pow(0.5f, Thickness / HalfOcclusionThickness);
+}
+
+bool OccupancyGrid::IsSolid(int X, int Y, int Z) const
+{
+    const int Index = ThreeDimToOneDim(X, Y, Z, XSize, YSize);
+    return (Bits[Index >> 6] >> (Index & 63)) & 1;
+}
+
+void OccupancyGrid::March(const Eigen::Vector3f& Start, const Eigen::Vector3f& Direction, float TStart, float TEnd, float& OutT, int& OutSolidVoxels) const
+{
+    const int Sizes[3] = { XSize, YSize, ZSize };
+    const int IndexSteps[3] = { 1, XSize, XSize * YSize };
+    
+    int Voxel[3];
+    int Step[3];
+    float TMax[3];
+    float TDelta[3];
+    
+    int Index = 0;
+    
+    for (int Axis = 0; Axis < 3; ++Axis)
+    {
+        const float Entry = Start[Axis] + Direction[Axis] * TStart;
+        Voxel[Axis] = std::min(std::max(static_cast<int>(std::floor(Entry)), 0), Sizes[Axis] - 1);
+        Index += Voxel[Axis] * IndexSteps[Axis];
+        
+        Step[Axis] = Direction[Axis] > 0.0f ? 1 : -1;
+        TDelta[Axis] = std::abs(1.0f / Direction[Axis]);
+        
+        // Parametric distance to the first voxel boundary along this axis
+        const float Boundary = static_cast<float>(Voxel[Axis] + (Step[Axis] > 0 ? 1 : 0));
+        TMax[Axis] = (Boundary - Start[Axis]) / Direction[Axis];
+    }
+    
+    float T = TStart;
+    
+    while (T < TEnd)
+    {
+        const int Axis = TMax[0] < TMax[1] ? (TMax[0] < TMax[2] ? 0 : 2) : (TMax[1] < TMax[2] ? 1 : 2);
+        const float TNext = std::min(TMax[Axis], TEnd);
+        
+        // Rays that only clip a corner don't count as crossing the voxel
+        if (TNext > T && ((Bits[Index >> 6] >> (Index & 63)) & 1))
+        {
+            OutT += TNext - T;
+            ++OutSolidVoxels;
+        }
+        
+        T = TNext;
+        
+        Voxel[Axis] += Step[Axis];
+        if (Voxel[Axis] < 0 || Voxel[Axis] >= Sizes[Axis])
+        {
+            break;
+        }
+        
+        Index += Step[Axis] * IndexSteps[Axis];
+        TMax[Axis] += TDelta[Axis];
+    }
+}
@@ -15,6 +15,8 @@
 #include "MatPlotPlotter.h"
 #include "Simulators/Simulator.h"
 #include "Analyser.h"
+#include "ThreadScalingBenchmark.h"
+#include "CommandBuffer.h"
 
 PL_RESULT PL_Debug_Initialize (PL_Debug_Callback Callback)
 {
@@ -22,6 +24,23 @@ PL_RESULT PL_Debug_Initialize (PL_Debug_Callback Callback)
     return PL_OK;
 }
 
+PL_RESULT PL_Debug_SetLevel (PL_DEBUG_LEVEL MinimumLevel)
+{
+    if (MinimumLevel < PL_DEBUG_LEVEL_VERBOSE || MinimumLevel > PL_DEBUG_LEVEL_OFF)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    SetDebugLevel(MinimumLevel);
+    return PL_OK;
+}
+
+PL_RESULT PL_Debug_Flush ()
+{
+    FlushDebugMessages();
+    return PL_OK;
+}
+
 PL_RESULT PL_System_Create (PL_SYSTEM** OutSystem)
 {
     if (!OutSystem)
@@ -68,6 +87,35 @@ PL_RESULT PL_System_GetListenerPosition(PL_SYSTEM* System, PLVector* OutListener
     return System->GetListenerPosition(*OutListenerPosition);
 }
 
+PL_RESULT PL_System_SetParallelThreads(PL_SYSTEM* System, int MaxThreads, bool PinThreads)
+{
+    if (!System || MaxThreads < 0)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    SetParallelThreads(MaxThreads, PinThreads);
+    return PL_OK;
+}
+
+PL_RESULT PL_System_BenchmarkThreadScaling(PL_SYSTEM* System, int VoxelsInSide, float* OutFirstTouchSpeedup, float* OutSerialTouchSpeedup)
+{
+    if (!System || !OutFirstTouchSpeedup || !OutSerialTouchSpeedup || VoxelsInSide < ThreadScalingBenchmark::MinVoxelsInSide)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    ThreadScalingBenchmark Benchmark;
+    const std::vector<ThreadScalingBenchmark::Timing> Timings = Benchmark.Run(VoxelsInSide);
+    
+    const ThreadScalingBenchmark::Timing& Single = Timings.front();
+    const ThreadScalingBenchmark::Timing& All = Timings.back();
+    *OutFirstTouchSpeedup = static_cast<float>(Single.FirstTouchSeconds / All.FirstTouchSeconds);
+    *OutSerialTouchSpeedup = static_cast<float>(Single.SerialTouchSeconds / All.SerialTouchSeconds);
+    
+    return PL_OK;
+}
+
 PL_RESULT PL_System_CreateScene(PL_SYSTEM* System, PL_SCENE** OutScene)
 {
     if (!System)
@@ -127,6 +175,76 @@ PL_RESULT PL_Scene_RemoveMesh(PL_SCENE* Scene, int IndexToRemove)
     return Scene->RemoveMesh(IndexToRemove);
 }
 
+PL_RESULT PL_Scene_AddHeightfield(PL_SCENE* Scene, PLVector Origin, float Spacing, int Rows, int Columns, const float* Heights, float Absorptivity, int* OutIndex)
+{
+    if (!Scene || !OutIndex)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    return Scene->AddHeightfield(Origin, Spacing, Rows, Columns, Heights, Absorptivity, *OutIndex);
+}
+
+PL_RESULT PL_Scene_RemoveHeightfield(PL_SCENE* Scene, int IndexToRemove)
+{
+    if (!Scene || IndexToRemove < 0)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    return Scene->RemoveHeightfield(IndexToRemove);
+}
+
+PL_RESULT PL_Scene_AddBox(PL_SCENE* Scene, PLVector Position, PLQuaternion Rotation, PLVector HalfExtents, float Absorptivity, int* OutIndex)
+{
+    if (!Scene || !OutIndex)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    return Scene->AddBox(Position, Rotation, HalfExtents, Absorptivity, *OutIndex);
+}
+
+PL_RESULT PL_Scene_AddSphere(PL_SCENE* Scene, PLVector Position, float Radius, float Absorptivity, int* OutIndex)
+{
+    if (!Scene || !OutIndex)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    return Scene->AddSphere(Position, Radius, Absorptivity, *OutIndex);
+}
+
+PL_RESULT PL_Scene_AddCapsule(PL_SCENE* Scene, PLVector Position, PLQuaternion Rotation, float Radius, float HalfHeight, float Absorptivity, int* OutIndex)
+{
+    if (!Scene || !OutIndex)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    return Scene->AddCapsule(Position, Rotation, Radius, HalfHeight, Absorptivity, *OutIndex);
+}
+
+PL_RESULT PL_Scene_AddConvexHull(PL_SCENE* Scene, PLVector Position, PLQuaternion Rotation, PLVector Scale, PLVector* Vertices, int VerticesLength, int* Indices, int IndicesLength, float Absorptivity, int* OutIndex)
+{
+    if (!Scene || !Vertices || !Indices || !OutIndex)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    return Scene->AddConvexHull(Position, Rotation, Scale, Vertices, VerticesLength, Indices, IndicesLength, Absorptivity, *OutIndex);
+}
+
+PL_RESULT PL_Scene_RemovePrimitive(PL_SCENE* Scene, int IndexToRemove)
+{
+    if (!Scene || IndexToRemove < 0)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    return Scene->RemovePrimitive(IndexToRemove);
+}
+
 PL_RESULT PL_Scene_FillVoxelsWithGeometry(PL_SCENE* Scene)
 {
     if (!Scene)
@@ -187,6 +305,96 @@ PL_RESULT PL_Scene_Simulate(PL_SCENE* Scene, PLVector SimulationLocation)
     return Scene->Simulate(SimulationLocation);
 }
 
+PL_RESULT PL_Scene_GetSimulationRate(PL_SCENE* Scene, float* OutSamplingRate, float* OutMaxFrequency)
+{
+    if (!Scene)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    return Scene->GetSimulationRate(OutSamplingRate, OutMaxFrequency);
+}
+
+PL_RESULT PL_Scene_SetSimulationScheme(PL_SCENE* Scene, PL_SIMULATION_SCHEME Scheme)
+{
+    if (!Scene)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    return Scene->SetSimulationScheme(Scheme);
+}
+
+PL_RESULT PL_Scene_SetSimulationPrecision(PL_SCENE* Scene, PL_SIMULATION_PRECISION Precision)
+{
+    if (!Scene)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    return Scene->SetSimulationPrecision(Precision);
+}
+
+PL_RESULT PL_Scene_SetWarmStartDistance(PL_SCENE* Scene, float MaxDistance)
+{
+    if (!Scene)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    return Scene->SetWarmStartDistance(MaxDistance);
+}
+
+PL_RESULT PL_Scene_SetMeshSimplification(PL_SCENE* Scene, bool bEnabled, float MaxErrorInVoxels)
+{
+    if (!Scene)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    return Scene->SetMeshSimplification(bEnabled, MaxErrorInVoxels);
+}
+
+PL_RESULT PL_Scene_SetVoxelisationMode(PL_SCENE* Scene, PL_VOXELISATION_MODE Mode)
+{
+    if (!Scene)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    return Scene->SetVoxelisationMode(Mode);
+}
+
+PL_RESULT PL_Scene_StartSnapshotRecording(PL_SCENE* Scene, const char* FilePrefix, int Interval, int Stride, PL_SNAPSHOT_REGION Region, int PlaneIndex, PL_SNAPSHOT_PRECISION Precision)
+{
+    if (!Scene || !FilePrefix)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    return Scene->StartSnapshotRecording(FilePrefix, Interval, Stride, Region, PlaneIndex, Precision);
+}
+
+PL_RESULT PL_Scene_StopSnapshotRecording(PL_SCENE* Scene)
+{
+    if (!Scene)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    return Scene->StopSnapshotRecording();
+}
+
+PL_RESULT PL_Scene_BenchmarkWarmStart(PL_SCENE* Scene, PLVector FromLocation, PLVector ToLocation, float* OutRelativeError, float* OutSpeedup)
+{
+    if (!Scene)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    return Scene->BenchmarkWarmStart(FromLocation, ToLocation, OutRelativeError, OutSpeedup);
+}
+
 PL_RESULT PL_Scene_Debug(PL_SCENE* Scene)
 {
     if (!Scene)
@@ -194,7 +402,53 @@ PL_RESULT PL_Scene_Debug(PL_SCENE* Scene)
         return PL_ERR_INVALID_PARAM;
     }
     
-    return OpenOpenGLDebugWindow(Scene);
+    return Scene->OpenDebugViewer();
+}
+
+PL_RESULT PL_Scene_DebugUpdate(PL_SCENE* Scene)
+{
+    if (!Scene)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    return Scene->UpdateDebugViewer();
+}
+
+PL_RESULT PL_Scene_GenerateProbes(PL_SCENE* Scene, PL_PROBE_PLACEMENT Placement, float Spacing, PLVector* Seeds, int SeedsLength, int MaxProbes, int* OutProbeCount)
+{
+    if (!Scene || SeedsLength < 0 || (!Seeds && SeedsLength > 0))
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    std::vector<PLVector> SeedsVector;
+    if (Seeds)
+    {
+        SeedsVector.assign(Seeds, Seeds + SeedsLength);
+    }
+    
+    return Scene->GenerateProbes(Placement, Spacing, SeedsVector, MaxProbes, OutProbeCount);
+}
+
+PL_RESULT PL_Scene_BakeProbes(PL_SCENE* Scene)
+{
+    if (!Scene)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    return Scene->BakeProbes();
+}
+
+PL_RESULT PL_Scene_GetBakedOcclusion(PL_SCENE* Scene, PLVector EmitterLocation, float* OutOcclusion)
+{
+    if (!Scene)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    return Scene->GetBakedOcclusion(EmitterLocation, OutOcclusion);
 }
 
 PL_RESULT PL_Scene_GetVoxelsCount(PL_SCENE* Scene, int* OutVoxelCount)
@@ -227,6 +481,26 @@ PL_RESULT PL_Scene_GetVoxelAbsorpivity(PL_SCENE* Scene, float* OutAbsorpivity, i
     return Scene->GetVoxelAbsorpivity(OutAbsorpivity, Index);
 }
 
+PL_RESULT PL_Scene_GetDistanceToGeometry(PL_SCENE* Scene, PLVector Location, float* OutDistance)
+{
+    if (!Scene)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    return Scene->GetDistanceToGeometry(Location, OutDistance);
+}
+
+PL_RESULT PL_Scene_GetVoxelRegion(PL_SCENE* Scene, int* OutRegion, bool* OutActive, int Index)
+{
+    if (!Scene)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    return Scene->GetVoxelRegion(OutRegion, OutActive, Index);
+}
+
 PL_RESULT PL_Scene_DrawGraph(PL_SCENE* Scene, PLVector GraphPosition)
 {
     if (!Scene)
@@ -302,3 +576,114 @@ PL_RESULT PL_Scene_GetOcclusion(PL_SCENE* Scene, PLVector EmitterLocation, float
     
     return PL_OK;
 }
+
+PL_RESULT PL_Scene_TraceOcclusion(PL_SCENE* Scene, PLVector* EmitterLocations, int EmitterLocationsLength, float* OutOcclusions)
+{
+    if (!Scene)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    return Scene->TraceOcclusion(EmitterLocations, EmitterLocationsLength, OutOcclusions);
+}
+
+PL_RESULT PL_Scene_SolveFrequencyResponse(PL_SCENE* Scene, PLVector SourceLocation, float* Frequencies, int FrequenciesLength, float* OutReal, float* OutImaginary, int OutLength)
+{
+    if (!Scene)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    return Scene->SolveFrequencyResponse(SourceLocation, Frequencies, FrequenciesLength, OutReal, OutImaginary, OutLength);
+}
+
+PL_RESULT PL_Scene_GetImpulseResponse(PL_SCENE* Scene, PLVector EmitterLocation, int MaxReflectionOrder, int SampleRate, float* OutResponse, int ResponseLength)
+{
+    if (!Scene || !OutResponse || ResponseLength <= 0 || SampleRate <= 0)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    Simulator* Simulator;
+    Scene->GetSimulator(&Simulator);
+    
+    if (!Simulator)
+    {
+        return PL_ERR;
+    }
+    
+    Analyser Analyser;
+    Analyser.GetImpulseResponse(Simulator, EmitterLocation, MaxReflectionOrder, SampleRate, OutResponse, ResponseLength);
+    
+    return PL_OK;
+}
+
+PL_RESULT PL_Scene_UpdateGeodesicField(PL_SCENE* Scene)
+{
+    if (!Scene)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    return Scene->UpdateGeodesicField();
+}
+
+PL_RESULT PL_Scene_GetGeodesicPath(PL_SCENE* Scene, PLVector EmitterLocation, float* OutDistance, PLVector* OutDirection)
+{
+    if (!Scene)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    return Scene->GetGeodesicPath(EmitterLocation, OutDistance, OutDirection);
+}
+
+PL_RESULT PL_Scene_GetRoomGraphSize(PL_SCENE* Scene, int* OutRoomCount, int* OutPortalCount)
+{
+    if (!Scene)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    return Scene->GetRoomGraphSize(OutRoomCount, OutPortalCount);
+}
+
+PL_RESULT PL_Scene_GetRoom(PL_SCENE* Scene, PLVector Location, int* OutRoom)
+{
+    if (!Scene)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    return Scene->GetRoom(Location, OutRoom);
+}
+
+PL_RESULT PL_Scene_GetPortal(PL_SCENE* Scene, int PortalIndex, int* OutRoomA, int* OutRoomB, PLVector* OutPosition, float* OutArea)
+{
+    if (!Scene)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    return Scene->GetPortal(PortalIndex, OutRoomA, OutRoomB, OutPosition, OutArea);
+}
+
+PL_RESULT PL_Scene_FindRoomPath(PL_SCENE* Scene, PLVector From, PLVector To, int* OutPortals, int MaxPortals, int* OutPortalCount, float* OutDistance)
+{
+    if (!Scene)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    return Scene->FindRoomPath(From, To, OutPortals, MaxPortals, OutPortalCount, OutDistance);
+}
+
+PL_RESULT PL_Scene_ExecuteCommands(PL_SCENE* Scene, void* Commands, int CommandsLength, PL_COMMAND_RESULT* OutResults, int ResultsLength, int* OutCommandCount)
+{
+    if (!Scene || !OutCommandCount)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    return CommandBuffer::Execute(*Scene, Commands, CommandsLength, OutResults, ResultsLength, *OutCommandCount);
+}
@@ -9,22 +9,144 @@
 */
 
 #include "OpenPLCommonPrivate.h"
+#include "DebugMessageQueue.h"
 
-PL_Debug_Callback DebugCallback = nullptr;
+#include <cstdio>
+#include <fstream>
+
+#if JUCE_LINUX
+ #include <dirent.h>
+ #include <pthread.h>
+ #include <sched.h>
+#elif JUCE_WINDOWS
+ #define NOMINMAX
+ #include <windows.h>
+#endif
+
+std::atomic<PL_Debug_Callback> DebugCallback (nullptr);
+
+std::atomic<int> MinimumDebugLevel (PL_DEBUG_LEVEL_LOG);
+
+DebugMessageQueue DebugMessages;
+
+std::atomic<int> MaxParallelThreads (0);
+
+std::atomic<bool> bPinParallelThreads (false);
+
+namespace
+{
+    /**
+     * Reads the cores of each NUMA node from /sys/devices/system/node, in node order. Nodes with only memory are left out.
+     * Without NUMA information, every core is one node.
+     */
+    std::vector<std::vector<int>> ReadNodeCores()
+    {
+        std::vector<std::pair<int, std::vector<int>>> Nodes;
+        
+#if JUCE_LINUX
+        if (DIR* NodeDirectory = opendir("/sys/devices/system/node"))
+        {
+            while (dirent* Entry = readdir(NodeDirectory))
+            {
+                int Node;
+                char Rest;
+                
+                if (std::sscanf(Entry->d_name, "node%d%c", &Node, &Rest) != 1)
+                {
+                    continue;
+                }
+                
+                // Lists look like "0-15,32-47"
+                std::ifstream CoreList ("/sys/devices/system/node/" + std::string(Entry->d_name) + "/cpulist");
+                std::string Range;
+                std::vector<int> Cores;
+                
+                while (std::getline(CoreList, Range, ','))
+                {
+                    int First, Last;
+                    const int Read = std::sscanf(Range.c_str(), "%d-%d", &First, &Last);
+                    
+                    for (int Core = First; Read > 0 && Core <= (Read == 2 ? Last : First); ++Core)
+                    {
+                        Cores.push_back(Core);
+                    }
+                }
+                
+                if (!Cores.empty())
+                {
+                    Nodes.emplace_back(Node, Cores);
+                }
+            }
+            
+            closedir(NodeDirectory);
+        }
+#endif
+        
+        std::sort(Nodes.begin(), Nodes.end());
+        std::vector<std::vector<int>> NodeCores;
+        
+        for (const auto& Node : Nodes)
+        {
+            NodeCores.push_back(Node.second);
+        }
+        
+        if (NodeCores.empty())
+        {
+            NodeCores.emplace_back();
+            
+            for (int Core = 0; Core < std::max(1, static_cast<int>(boost::thread::hardware_concurrency())); ++Core)
+            {
+                NodeCores.back().push_back(Core);
+            }
+        }
+        
+        return NodeCores;
+    }
+}
 
 void SetDebugCallback(PL_Debug_Callback Callback)
 {
     DebugCallback = Callback;
 }
 
+void SetDebugLevel(PL_DEBUG_LEVEL MinimumLevel)
+{
+    MinimumDebugLevel.store(MinimumLevel, std::memory_order_relaxed);
+}
+
+void FlushDebugMessages()
+{
+    const PL_Debug_Callback Callback = DebugCallback.load();
+    
+    char Message[DebugMessageQueue::MaxMessageLength];
+    PL_DEBUG_LEVEL Level;
+    
+    while (DebugMessages.Pop(Message, Level))
+    {
+        if (Callback)
+        {
+            Callback(Message, Level);
+        }
+    }
+    
+    const size_t Dropped = DebugMessages.TakeDroppedCount();
+    
+    if (Dropped > 0 && Callback)
+    {
+        LogStream Stream;
+        Stream << "Dropped " << Dropped << " debug messages. Flush more often";
+        Callback(Stream.c_str(), PL_DEBUG_LEVEL_WARN);
+    }
+}
+
 /**
  * Log a message to the external debug method.
  */
 void Debug(const char* Message, PL_DEBUG_LEVEL Level)
 {
-    if (DebugCallback)
+    if (IsDebugLevelEnabled(Level))
     {
-        DebugCallback(Message, Level);
+        DebugMessages.Push(Message, Level);
     }
 }
 
@@ -52,6 +174,70 @@ void DebugError(const char* Message)
     Debug(Message, PL_DEBUG_LEVEL_ERR);
 }
 
+void SetParallelThreads(int MaxThreads, bool bPinThreads)
+{
+    MaxParallelThreads.store(std::max(0, MaxThreads));
+    bPinParallelThreads.store(bPinThreads);
+}
+
+int GetParallelThreadCount()
+{
+    const int HardwareThreads = std::max(1, static_cast<int>(boost::thread::hardware_concurrency()));
+    const int MaxThreads = MaxParallelThreads.load(std::memory_order_relaxed);
+    return MaxThreads > 0 ? MaxThreads : HardwareThreads;
+}
+
+int GetParallelThreadSetting()
+{
+    return MaxParallelThreads.load(std::memory_order_relaxed);
+}
+
+bool IsPinningThreads()
+{
+    return bPinParallelThreads.load(std::memory_order_relaxed);
+}
+
+void PinWorkerThread(int Worker, int WorkerCount)
+{
+    if (!IsPinningThreads())
+    {
+        return;
+    }
+    
+    static const std::vector<std::vector<int>> NodeCores = ReadNodeCores();
+    
+    const int NodeCount = static_cast<int>(NodeCores.size());
+    const int Workers = std::max(1, WorkerCount);
+    const int Index = Worker % Workers;
+    const int Node = std::min(NodeCount - 1, Index * NodeCount / Workers);
+    
+    // First worker whose share falls on this node
+    const int FirstWorkerOnNode = (Node * Workers + NodeCount - 1) / NodeCount;
+    const std::vector<int>& CoresOnNode = NodeCores[Node];
+    const int Core = CoresOnNode[(Index - FirstWorkerOnNode) % CoresOnNode.size()];
+    
+#if JUCE_LINUX
+    cpu_set_t Cores;
+    CPU_ZERO(&Cores);
+    CPU_SET(Core, &Cores);
+    pthread_setaffinity_np(pthread_self(), sizeof(Cores), &Cores);
+#elif JUCE_WINDOWS
+    // Only the first processor group of 64 cores can be reached through a thread mask
+    SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << (Core % 64));
+#else
+    // macOS only takes affinity hints, so threads are left where the scheduler puts them
+    juce::ignoreUnused(Core);
+#endif
+}
+
+void GetParallelChunk(int Worker, int WorkerCount, int Begin, int End, int& OutBegin, int& OutEnd)
+{
+    const int Count = std::max(0, End - Begin);
+    const int ChunkSize = (Count + WorkerCount - 1) / std::max(1, WorkerCount);
+    OutBegin = std::min(End, Begin + Worker * ChunkSize);
+    OutEnd = std::min(End, OutBegin + ChunkSize);
+}
+
 /**
  * Converts a 3D array index to a 1D index.
  */
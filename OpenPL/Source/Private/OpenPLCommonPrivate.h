@@ -13,6 +13,13 @@
 #include "OpenPLCommon.h"
 #include <Eigen/Core>
 #include <Eigen/Geometry>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/barrier.hpp>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <ostream>
+#include <streambuf>
 
 typedef Eigen::MatrixXd     VertexMatrix;
 typedef Eigen::MatrixXi     IndiceMatrix;
@@ -20,7 +27,24 @@ typedef Eigen::MatrixXi     IndiceMatrix;
 void SetDebugCallback(PL_Debug_Callback Callback);
 
 /**
- * Log a message to the external debug method.
+ * Messages below this level are thrown away before they're formatted.
+ */
+void SetDebugLevel(PL_DEBUG_LEVEL MinimumLevel);
+
+extern std::atomic<int> MinimumDebugLevel;
+
+inline bool IsDebugLevelEnabled(PL_DEBUG_LEVEL Level)
+{
+    return Level >= MinimumDebugLevel.load(std::memory_order_relaxed);
+}
+
+/**
+ * Passes every queued message to the external debug method, on the calling thread.
+ */
+void FlushDebugMessages();
+
+/**
+ * Queue a message for the external debug method. Safe to call from any thread and never allocates.
  */
 void Debug(const char* Message, PL_DEBUG_LEVEL Level);
 
@@ -39,6 +63,57 @@ void DebugWarn(const char* Message);
  */
 void DebugError(const char* Message);
 
+/**
+ * Stream that formats into a fixed buffer on the stack instead of allocating. Anything past the end of the buffer is cut off.
+ */
+class LogStream : private std::streambuf, public std::ostream
+{
+public:
+    
+    static constexpr int MaxLength = 256;
+    
+    LogStream() : std::ostream(this)
+    {
+        setp(Buffer, Buffer + MaxLength - 1);
+    }
+    
+    const char* c_str()
+    {
+        *pptr() = '\0';
+        return Buffer;
+    }
+    
+private:
+    
+    char Buffer[MaxLength];
+};
+
+/**
+ * Logs a streamed message, like PL_LOG(PL_DEBUG_LEVEL_LOG, "Found " << Count << " rooms").
+ * The level is checked first, so nothing is formatted when the message would be thrown away.
+ */
+#define PL_LOG(Level, Message) \
+    do \
+    { \
+        if (IsDebugLevelEnabled(Level)) \
+        { \
+            LogStream PLLogStream; \
+            PLLogStream << Message; \
+            Debug(PLLogStream.c_str(), Level); \
+        } \
+    } while (false)
+
+// Verbose messages are compiled out of release builds. Define PL_VERBOSE_LOGS to 1 to keep them
+#ifndef PL_VERBOSE_LOGS
+ #define PL_VERBOSE_LOGS JUCE_DEBUG
+#endif
+
+#if PL_VERBOSE_LOGS
+ #define PL_LOG_VERBOSE(Message) PL_LOG(PL_DEBUG_LEVEL_VERBOSE, Message)
+#else
+ #define PL_LOG_VERBOSE(Message) do {} while (false)
+#endif
+
 /**
  * Converts a 3D array index to a 1D index.
  */
@@ -46,6 +121,160 @@ int ThreeDimToOneDim(int X, int Y, int Z, int XSize, int YSize);
 
 void IndexToThreeDim(int Index, int XSize, int YSize, int& OutX, int& OutY, int& OutZ);
 
+/**
+ * Sets how many threads ParallelFor splits work between. 0 uses one per hardware thread.
+ * With bPinThreads, each worker only runs on one core. Chunk N of every ParallelFor over the same range then runs on the same core,
+ * so it stays on the NUMA node that first touched its memory. Affects every scene.
+ */
+void SetParallelThreads(int MaxThreads, bool bPinThreads);
+
+/**
+ * Threads ParallelFor starts for a range at least this long.
+ */
+int GetParallelThreadCount();
+
+/**
+ * The MaxThreads last passed to SetParallelThreads, so it can be put back. 0 if the count follows the hardware.
+ */
+int GetParallelThreadSetting();
+
+bool IsPinningThreads();
+
+/**
+ * Pins the calling thread to one core if threads are being pinned. Does nothing on platforms without hard affinity.
+ * Workers are split between the NUMA nodes in contiguous runs, in the order the chunks of a range are handed out,
+ * so neighbouring chunks share a node and every node gets the same share. Within a node, worker N goes to its Nth core.
+ *
+ * @param WorkerCount Workers splitting the range, including this one.
+ */
+void PinWorkerThread(int Worker, int WorkerCount);
+
+/**
+ * Splits the range [Begin, End) into one contiguous chunk per thread from GetParallelThreadCount and calls Function(ChunkBegin, ChunkEnd) for each chunk on its own thread.
+ * Chunk N always runs on worker N. Blocks until every chunk has finished.
+ */
+template <typename FunctionType>
+void ParallelFor(int Begin, int End, const FunctionType& Function)
+{
+    const int Count = End - Begin;
+    
+    if (Count <= 0)
+    {
+        return;
+    }
+    
+    const int NumThreads = std::max(1, std::min(GetParallelThreadCount(), Count));
+    
+    if (NumThreads == 1)
+    {
+        Function(Begin, End);
+        return;
+    }
+    
+    const int ChunkSize = (Count + NumThreads - 1) / NumThreads;
+    
+    boost::thread_group Threads;
+    int Worker = 0;
+    
+    for (int ChunkBegin = Begin; ChunkBegin < End; ChunkBegin += ChunkSize, ++Worker)
+    {
+        const int ChunkEnd = std::min(ChunkBegin + ChunkSize, End);
+        Threads.create_thread([&Function, ChunkBegin, ChunkEnd, Worker, NumThreads]()
+        {
+            PinWorkerThread(Worker, NumThreads);
+            Function(ChunkBegin, ChunkEnd);
+        });
+    }
+    
+    Threads.join_all();
+}
+
+/**
+ * The chunk of [Begin, End) that ParallelFor would give worker Worker of WorkerCount. Empty if there are more workers than chunks.
+ */
+void GetParallelChunk(int Worker, int WorkerCount, int Begin, int End, int& OutBegin, int& OutEnd);
+
+/**
+ * Starts one thread per worker, up to MaxWorkers and GetParallelThreadCount, and calls Function(Worker, WorkerCount, Barrier) on each.
+ * For loops of many short passes: the threads are started and pinned once, and Barrier.wait() separates the passes instead of a ParallelFor each.
+ * Workers should split ranges with GetParallelChunk so they touch the same memory as ParallelFor's chunks. Blocks until every worker has returned.
+ */
+template <typename FunctionType>
+void ParallelWorkers(int MaxWorkers, const FunctionType& Function)
+{
+    const int WorkerCount = std::max(1, std::min(GetParallelThreadCount(), MaxWorkers));
+    boost::barrier Barrier (WorkerCount);
+    
+    if (WorkerCount == 1)
+    {
+        Function(0, 1, Barrier);
+        return;
+    }
+    
+    boost::thread_group Threads;
+    
+    for (int Worker = 0; Worker < WorkerCount; ++Worker)
+    {
+        Threads.create_thread([&Function, &Barrier, Worker, WorkerCount]()
+        {
+            PinWorkerThread(Worker, WorkerCount);
+            Function(Worker, WorkerCount, Barrier);
+        });
+    }
+    
+    Threads.join_all();
+}
+
+/**
+ * Allocator that leaves trivial elements uninitialised, so resizing a vector doesn't write to its memory.
+ * The OS only places a page on a NUMA node when it's first written, so whichever thread fills the element first decides where it lives.
+ */
+template <typename T>
+struct FirstTouchAllocator : std::allocator<T>
+{
+    template <typename U>
+    struct rebind
+    {
+        typedef FirstTouchAllocator<U> other;
+    };
+    
+    FirstTouchAllocator() = default;
+    
+    template <typename U>
+    FirstTouchAllocator(const FirstTouchAllocator<U>&) noexcept { }
+    
+    template <typename U>
+    void construct(U* Pointer) noexcept(std::is_nothrow_default_constructible<U>::value)
+    {
+        ::new (static_cast<void*>(Pointer)) U;
+    }
+    
+    template <typename U, typename... Args>
+    void construct(U* Pointer, Args&&... Arguments)
+    {
+        ::new (static_cast<void*>(Pointer)) U(std::forward<Args>(Arguments)...);
+    }
+};
+
+/**
+ * Resizes Values to Count and fills them with Value, splitting them into Slabs and handing the slabs out like ParallelFor(0, Slabs).
+ * Each worker first touches the slabs it will own in later ParallelFor loops over the same slabs, so the pages end up on its NUMA node.
+ */
+template <typename T>
+void ParallelAssign(std::vector<T, FirstTouchAllocator<T>>& Values, size_t Count, const T& Value, int Slabs)
+{
+    // Frees the old memory instead of reusing pages whoever filled it last touched
+    std::vector<T, FirstTouchAllocator<T>>().swap(Values);
+    Values.resize(Count);
+    
+    ParallelFor(0, std::max(1, Slabs), [&](int FirstSlab, int EndSlab)
+    {
+        const size_t First = Count * FirstSlab / std::max(1, Slabs);
+        const size_t End = Count * EndSlab / std::max(1, Slabs);
+        std::fill(Values.begin() + First, Values.begin() + End, Value);
+    });
+}
+
 /**
  * Defines one voxel cell within the voxel geometry
  */
@@ -80,6 +309,11 @@ struct JUCE_API PLVoxel
     }
 };
 
+/**
+ * Voxels of a lattice. Filled with ParallelAssign so each slab lives on the NUMA node of the worker that simulates it.
+ */
+typedef std::vector<PLVoxel, FirstTouchAllocator<PLVoxel>> PLVoxelLattice;
+
 /**
  * Defines a simple mesh with vertices and indices.
  */
@@ -87,6 +321,18 @@ struct PL_MESH
 {
     VertexMatrix Vertices;
     IndiceMatrix Indices;
+    
+    /** Hash of the mesh as the game sent it, before it was moved into the world. Instances of one asset share it. 0 if it didn't come from the game*/
+    size_t AssetKey = 0;
+    
+    /** Moves the asset's vertices to Vertices*/
+    Eigen::Transform<double, 3, Eigen::Affine, Eigen::DontAlign> LocalToWorld = Eigen::Transform<double, 3, Eigen::Affine, Eigen::DontAlign>::Identity();
+    
+    /** World space copy with detail below the voxel size removed, which is what gets voxelised. Null until voxels are filled with simplification on*/
+    std::shared_ptr<const PL_MESH> Simplified;
+    
+    /** Error Simplified was made with. It's made again once the voxel size or error changes*/
+    double SimplifiedError = 0.0;
 };
 
 /**
@@ -99,7 +345,7 @@ struct PL_VOXEL_GRID
     /** Contains size of each dimension of the lattice. Ie Size(0,0) would return the size of the lattice along the X axis*/
     Eigen::Matrix<int,1,3,1,1,3> Size;
     /** 1D vector containing all voxels. Contains all voxels witin the lattice so must convert 3D indexes to 1D before accessing*/
-    std::vector<PLVoxel> Voxels;
+    PLVoxelLattice Voxels;
     /** Width aka Height aka Depth of each voxel. With CenterPositions and Voxels, can use this to create bounding boxes of each voxel*/
     float VoxelSize;
 };
@@ -116,4 +362,5 @@ struct PL_SIMULATION_SETTINGS
 {
     PL_SIMULATION_RESOLUTION Resolution;
     int TimeSteps;
+    PL_SIMULATION_PRECISION Precision = PL_SIMULATION_PRECISION_DOUBLE;
 };
@@ -0,0 +1,309 @@
+/*
+  ==============================================================================
+  
+    PrimitiveCollider.cpp
+    Created: 19 Oct 2026 6:21:40am
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#include "PrimitiveCollider.h"
+#include <cmath>
+
+namespace
+{
+    Eigen::Vector3f ToEigen(const PLVector& Vector)
+    {
+        return Eigen::Vector3f(Vector.X, Vector.Y, Vector.Z);
+    }
+}
+
+PrimitiveCollider::PrimitiveCollider(Shape Type, const PLVector& Position, const PLQuaternion& Rotation, float Absorptivity)
+:   Type(Type),
+    Position(ToEigen(Position)),
+    Size(Eigen::Vector3f::Zero()),
+    Absorptivity(Absorptivity)
+{
+    Eigen::Quaternionf Orientation (Rotation.W, Rotation.X, Rotation.Y, Rotation.Z);
+    
+    // A zero quaternion from a host that didn't fill it in is treated as no rotation
+    if (Orientation.squaredNorm() < 1e-12f)
+    {
+        Orientation = Eigen::Quaternionf::Identity();
+    }
+    
+    WorldToLocal = Orientation.normalized().toRotationMatrix().transpose();
+}
+
+PrimitiveCollider PrimitiveCollider::Box(const PLVector& Position, const PLQuaternion& Rotation, const PLVector& HalfExtents, float Absorptivity)
+{
+    PrimitiveCollider Collider (Shape_Box, Position, Rotation, Absorptivity);
+    Collider.Size = ToEigen(HalfExtents).cwiseAbs();
+    
+    // Extent of the rotated box along each world axis
+    const Eigen::Vector3f Extent = Collider.WorldToLocal.transpose().cwiseAbs() * Collider.Size;
+    Collider.Bounds = Eigen::AlignedBox3f(Collider.Position - Extent, Collider.Position + Extent);
+    return Collider;
+}
+
+PrimitiveCollider PrimitiveCollider::Sphere(const PLVector& Position, float Radius, float Absorptivity)
+{
+    PLQuaternion Identity { 0.0f, 0.0f, 0.0f, 1.0f };
+    PrimitiveCollider Collider (Shape_Sphere, Position, Identity, Absorptivity);
+    Collider.Size.x() = std::abs(Radius);
+    
+    const Eigen::Vector3f Extent = Eigen::Vector3f::Constant(Collider.Size.x());
+    Collider.Bounds = Eigen::AlignedBox3f(Collider.Position - Extent, Collider.Position + Extent);
+    return Collider;
+}
+
+PrimitiveCollider PrimitiveCollider::Capsule(const PLVector& Position, const PLQuaternion& Rotation, float Radius, float HalfHeight, float Absorptivity)
+{
+    PrimitiveCollider Collider (Shape_Capsule, Position, Rotation, Absorptivity);
+    Collider.Size.x() = std::abs(Radius);
+    Collider.Size.y() = std::abs(HalfHeight);
+    
+    // The segment's end points reach along the local Y axis, and the caps add the radius in every direction
+    const Eigen::Vector3f Axis = Collider.WorldToLocal.row(1).transpose();
+    const Eigen::Vector3f Extent = Axis.cwiseAbs() * Collider.Size.y() + Eigen::Vector3f::Constant(Collider.Size.x());
+    Collider.Bounds = Eigen::AlignedBox3f(Collider.Position - Extent, Collider.Position + Extent);
+    return Collider;
+}
+
+PrimitiveCollider PrimitiveCollider::ConvexHull(const PLVector& Position, const PLQuaternion& Rotation, const PLVector& Scale, const PLVector* Vertices, int VerticesLength, const int* Indices, int IndicesLength, float Absorptivity)
+{
+    PrimitiveCollider Collider (Shape_ConvexHull, Position, Rotation, Absorptivity);
+    
+    if (!Vertices || !Indices || VerticesLength < 4 || IndicesLength < 12 || IndicesLength % 3 != 0)
+    {
+        return Collider;
+    }
+    
+    std::vector<Eigen::Vector3f> Points (VerticesLength);
+    Eigen::Vector3f Centre = Eigen::Vector3f::Zero();
+    Eigen::AlignedBox3f LocalBounds;
+    
+    for (int i = 0; i < VerticesLength; ++i)
+    {
+        Points[i] = ToEigen(Vertices[i]).cwiseProduct(ToEigen(Scale));
+        Centre += Points[i];
+        LocalBounds.extend(Points[i]);
+    }
+    
+    Centre /= static_cast<float>(VerticesLength);
+    
+    // Distances are compared relative to the size of the hull
+    const float Tolerance = 1e-4f * std::max(LocalBounds.diagonal().norm(), 1e-6f);
+    
+    for (int Triangle = 0; Triangle < IndicesLength; Triangle += 3)
+    {
+        const int A = Indices[Triangle];
+        const int B = Indices[Triangle + 1];
+        const int C = Indices[Triangle + 2];
+        
+        if (A < 0 || B < 0 || C < 0 || A >= VerticesLength || B >= VerticesLength || C >= VerticesLength)
+        {
+            return PrimitiveCollider(Shape_ConvexHull, Position, Rotation, Absorptivity);
+        }
+        
+        Eigen::Vector3f Normal = (Points[B] - Points[A]).cross(Points[C] - Points[A]);
+        
+        // Slivers don't have a reliable plane, and their neighbours cover the same face
+        if (Normal.norm() < Tolerance * Tolerance)
+        {
+            continue;
+        }
+        
+        Normal.normalize();
+        
+        if (Normal.dot(Centre - Points[A]) > 0.0f)
+        {
+            Normal = -Normal;
+        }
+        
+        const float Distance = Normal.dot(Points[A]);
+        bool bDuplicate = false;
+        
+        // Faces made of several triangles only need testing once
+        for (const Plane& Existing : Collider.Planes)
+        {
+            if (Existing.Normal.dot(Normal) > 1.0f - 1e-5f && std::abs(Existing.Distance - Distance) < Tolerance)
+            {
+                bDuplicate = true;
+                break;
+            }
+        }
+        
+        if (!bDuplicate)
+        {
+            Collider.Planes.push_back({ Normal, Distance });
+        }
+    }
+    
+    if (Collider.Planes.size() < 4)
+    {
+        return PrimitiveCollider(Shape_ConvexHull, Position, Rotation, Absorptivity);
+    }
+    
+    // Every vertex of a convex hull is on or behind every face
+    for (const Plane& Face : Collider.Planes)
+    {
+        for (const Eigen::Vector3f& Point : Points)
+        {
+            if (Face.Normal.dot(Point) - Face.Distance > Tolerance)
+            {
+                return PrimitiveCollider(Shape_ConvexHull, Position, Rotation, Absorptivity);
+            }
+        }
+    }
+    
+    const Eigen::Matrix3f LocalToWorld = Collider.WorldToLocal.transpose();
+    
+    for (const Eigen::Vector3f& Point : Points)
+    {
+        Collider.Bounds.extend(Collider.Position + LocalToWorld * Point);
+    }
+    
+    return Collider;
+}
+
+bool PrimitiveCollider::IsValid() const
+{
+    return Type != Shape_ConvexHull || !Planes.empty();
+}
+
+void PrimitiveCollider::Fill(PL_VOXEL_GRID& Grid, const PLVector& BottomBackLeft) const
+{
+    const int XSize = Grid.Size(0, 0);
+    const int YSize = Grid.Size(0, 1);
+    const int ZSize = Grid.Size(0, 2);
+    const float VoxelSize = Grid.VoxelSize;
+    const Eigen::Vector3f Corner = ToEigen(BottomBackLeft);
+    const Eigen::Vector3i Sizes (XSize, YSize, ZSize);
+    
+    // Voxels whose centres, at Corner + (i + 0.5) * VoxelSize, are inside the bounds
+    Eigen::Vector3i First;
+    Eigen::Vector3i Last;
+    
+    for (int Axis = 0; Axis < 3; ++Axis)
+    {
+        First[Axis] = std::max(0, static_cast<int>(std::ceil((Bounds.min()[Axis] - Corner[Axis]) / VoxelSize - 0.5f)));
+        Last[Axis] = std::min(Sizes[Axis] - 1, static_cast<int>(std::floor((Bounds.max()[Axis] - Corner[Axis]) / VoxelSize - 0.5f)));
+        
+        if (First[Axis] > Last[Axis])
+        {
+            return;
+        }
+    }
+    
+    const int Count = Last.x() - First.x() + 1;
+    
+    // Moving one voxel along X moves the local position by the first column of WorldToLocal
+    const Eigen::Vector3f Step = WorldToLocal.col(0) * VoxelSize;
+    
+    ParallelFor(First.z(), Last.z() + 1, [&](int FirstZ, int EndZ)
+    {
+        std::vector<float> LocalX (Count);
+        std::vector<float> LocalY (Count);
+        std::vector<float> LocalZ (Count);
+        std::vector<float> Scratch (Count);
+        std::vector<uint8_t> Inside (Count);
+        
+        for (int z = FirstZ; z < EndZ; ++z)
+        {
+            for (int y = First.y(); y <= Last.y(); ++y)
+            {
+                const Eigen::Vector3f Centre = Corner + (Eigen::Vector3f(First.x(), y, z) + Eigen::Vector3f::Constant(0.5f)) * VoxelSize;
+                const Eigen::Vector3f Start = WorldToLocal * (Centre - Position);
+                
+                for (int i = 0; i < Count; ++i)
+                {
+                    LocalX[i] = Start.x() + Step.x() * i;
+                    LocalY[i] = Start.y() + Step.y() * i;
+                    LocalZ[i] = Start.z() + Step.z() * i;
+                }
+                
+                TestRow(LocalX.data(), LocalY.data(), LocalZ.data(), Count, Scratch.data(), Inside.data());
+                
+                const int Row = ThreeDimToOneDim(First.x(), y, z, XSize, YSize);
+                
+                for (int i = 0; i < Count; ++i)
+                {
+                    if (Inside[i])
+                    {
+                        PLVoxel& Voxel = Grid.Voxels[Row + i];
+                        Voxel.Beta = 0;
+                        Voxel.Absorptivity = Absorptivity;
+                    }
+                }
+            }
+        }
+    });
+}
+
+void PrimitiveCollider::TestRow(const float* LocalX, const float* LocalY, const float* LocalZ, int Count, float* Scratch, uint8_t* OutInside) const
+{
+    switch (Type)
+    {
+        case Shape_Box:
+        {
+            const float HalfX = Size.x();
+            const float HalfY = Size.y();
+            const float HalfZ = Size.z();
+            
+            for (int i = 0; i < Count; ++i)
+            {
+                OutInside[i] = (std::abs(LocalX[i]) <= HalfX) & (std::abs(LocalY[i]) <= HalfY) & (std::abs(LocalZ[i]) <= HalfZ);
+            }
+            break;
+        }
+        case Shape_Sphere:
+        {
+            const float RadiusSquared = Size.x() * Size.x();
+            
+            for (int i = 0; i < Count; ++i)
+            {
+                OutInside[i] = LocalX[i] * LocalX[i] + LocalY[i] * LocalY[i] + LocalZ[i] * LocalZ[i] <= RadiusSquared;
+            }
+            break;
+        }
+        case Shape_Capsule:
+        {
+            const float RadiusSquared = Size.x() * Size.x();
+            const float HalfHeight = Size.y();
+            
+            for (int i = 0; i < Count; ++i)
+            {
+                // Distance along the axis past the end of the segment, 0 beside it
+                const float Beyond = std::max(std::abs(LocalY[i]) - HalfHeight, 0.0f);
+                OutInside[i] = LocalX[i] * LocalX[i] + Beyond * Beyond + LocalZ[i] * LocalZ[i] <= RadiusSquared;
+            }
+            break;
+        }
+        case Shape_ConvexHull:
+        {
+            // Furthest distance in front of any face. Planes on the outside so the inner loop runs across the row
+            std::fill(Scratch, Scratch + Count, -std::numeric_limits<float>::max());
+            
+            for (const Plane& Face : Planes)
+            {
+                const float NormalX = Face.Normal.x();
+                const float NormalY = Face.Normal.y();
+                const float NormalZ = Face.Normal.z();
+                const float Distance = Face.Distance;
+                
+                for (int i = 0; i < Count; ++i)
+                {
+                    Scratch[i] = std::max(Scratch[i], NormalX * LocalX[i] + NormalY * LocalY[i] + NormalZ * LocalZ[i] - Distance);
+                }
+            }
+            
+            for (int i = 0; i < Count; ++i)
+            {
+                OutInside[i] = Scratch[i] <= 0.0f;
+            }
+            break;
+        }
+    }
+}
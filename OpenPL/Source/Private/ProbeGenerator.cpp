@@ -0,0 +1,302 @@
+/*
+  ==============================================================================
+  
+    ProbeGenerator.cpp
+    Created: 18 Oct 2026 11:02:22am
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#include "ProbeGenerator.h"
+#include "PL_SCENE.h"
+#include "DistanceField.h"
+#include <limits>
+
+namespace
+{
+    /** Passages up to twice this wide (in meters) get their own probes*/
+    const float MaxPortalRadius = 1.5f;
+}
+
+PL_RESULT ProbeGenerator::Generate(const PL_SCENE* Scene, const std::vector<PLVector>& Seeds, float Spacing, int MaxProbes, std::vector<PLVector>& OutProbeLocations)
+{
+    Scene->GetVoxels(&Grid);
+    
+    if (!Grid || Grid->Voxels.size() == 0)
+    {
+        DebugError("Can't generate probes without voxels. Must call CreateVoxels");
+        return PL_ERR;
+    }
+    
+    if (Spacing <= 0.0f || MaxProbes <= 0)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    XSize = Grid->Size(0,0);
+    YSize = Grid->Size(0,1);
+    ZSize = Grid->Size(0,2);
+    
+    std::vector<int> SeedIndices;
+    for (const PLVector& Seed : Seeds)
+    {
+        int SeedIndex;
+        if (Scene->GetVoxelIndexOfPosition(Seed, &SeedIndex) != PL_OK || Grid->Voxels[SeedIndex].Beta == 0)
+        {
+            DebugWarn("Ignoring a probe seed that is outside the lattice or inside geometry");
+            continue;
+        }
+        
+        // The index wraps around for positions past the edge of the lattice
+        PLVector SeedVoxelLocation;
+        Scene->GetVoxelPosition(SeedIndex, &SeedVoxelLocation);
+        if (std::abs(SeedVoxelLocation.X - Seed.X) > Grid->VoxelSize || std::abs(SeedVoxelLocation.Y - Seed.Y) > Grid->VoxelSize || std::abs(SeedVoxelLocation.Z - Seed.Z) > Grid->VoxelSize)
+        {
+            DebugWarn("Ignoring a probe seed that is outside the lattice or inside geometry");
+            continue;
+        }
+        SeedIndices.push_back(SeedIndex);
+    }
+    
+    if (SeedIndices.size() == 0)
+    {
+        DebugError("No valid seeds to generate probes from");
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    FloodFill(SeedIndices);
+    
+    // The scene only has a distance field once geometry has been filled in
+    const DistanceField* SceneDistanceField;
+    Scene->GetDistanceField(&SceneDistanceField);
+    
+    DistanceField LocalDistanceField;
+    if (!SceneDistanceField)
+    {
+        LocalDistanceField.Calculate(*Grid);
+        SceneDistanceField = &LocalDistanceField;
+    }
+    
+    DistanceToGeometry = SceneDistanceField->GetDistances().data();
+    
+    // Distances are in fixed point
+    const int MaxRadius = std::max(DistanceField::Scale, static_cast<int>(MaxPortalRadius / Grid->VoxelSize * DistanceField::Scale));
+    const int SuppressionRadius = std::max(1, static_cast<int>(MaxPortalRadius / Grid->VoxelSize));
+    int Stride = std::max(1, static_cast<int>(std::round(Spacing / Grid->VoxelSize)));
+    
+    std::vector<int> PortalIndices;
+    FindPortals(MaxRadius, std::max(SuppressionRadius, Stride / 2), PortalIndices);
+    
+    // Portals are the hardest places to interpolate across, so they get the budget first
+    if (PortalIndices.size() > MaxProbes)
+    {
+        PortalIndices.resize(MaxProbes);
+    }
+    
+    const int LatticeBudget = MaxProbes - static_cast<int>(PortalIndices.size());
+    const int LargestSide = std::max(XSize, std::max(YSize, ZSize));
+    
+    std::vector<int> LatticeIndices;
+    while (true)
+    {
+        LatticeIndices.clear();
+        PlaceLatticeProbes(Stride, LatticeIndices);
+        
+        if (LatticeIndices.size() <= LatticeBudget || Stride >= LargestSide)
+        {
+            break;
+        }
+        
+        Stride *= 2;
+    }
+    
+    if (LatticeIndices.size() > LatticeBudget)
+    {
+        LatticeIndices.resize(LatticeBudget);
+    }
+    
+    for (const std::vector<int>* Indices : { &LatticeIndices, &PortalIndices })
+    {
+        for (int Index : *Indices)
+        {
+            PLVector ProbeLocation;
+            Scene->GetVoxelPosition(Index, &ProbeLocation);
+            OutProbeLocations.push_back(ProbeLocation);
+        }
+    }
+    
+    PL_LOG(PL_DEBUG_LEVEL_LOG, "Generated " << LatticeIndices.size() << " lattice probes (" << Stride * Grid->VoxelSize << "m apart) and " << PortalIndices.size() << " portal probes");
+    
+    return PL_OK;
+}
+
+void ProbeGenerator::FloodFill(const std::vector<int>& SeedIndices)
+{
+    Reachable.assign(Grid->Voxels.size(), 0);
+    
+    std::vector<int> Queue;
+    Queue.reserve(Grid->Voxels.size());
+    
+    for (int SeedIndex : SeedIndices)
+    {
+        if (!Reachable[SeedIndex])
+        {
+            Reachable[SeedIndex] = 1;
+            Queue.push_back(SeedIndex);
+        }
+    }
+    
+    for (size_t Head = 0; Head < Queue.size(); ++Head)
+    {
+        int X, Y, Z;
+        IndexToThreeDim(Queue[Head], XSize, YSize, X, Y, Z);
+        
+        const int Neighbours[6][3] = { {X-1,Y,Z}, {X+1,Y,Z}, {X,Y-1,Z}, {X,Y+1,Z}, {X,Y,Z-1}, {X,Y,Z+1} };
+        
+        for (const auto& Neighbour : Neighbours)
+        {
+            if (Neighbour[0] < 0 || Neighbour[0] >= XSize || Neighbour[1] < 0 || Neighbour[1] >= YSize || Neighbour[2] < 0 || Neighbour[2] >= ZSize)
+            {
+                continue;
+            }
+            
+            const int NeighbourIndex = ThreeDimToOneDim(Neighbour[0], Neighbour[1], Neighbour[2], XSize, YSize);
+            
+            if (!Reachable[NeighbourIndex] && Grid->Voxels[NeighbourIndex].Beta != 0)
+            {
+                Reachable[NeighbourIndex] = 1;
+                Queue.push_back(NeighbourIndex);
+            }
+        }
+    }
+}
+
+void ProbeGenerator::PlaceLatticeProbes(int Stride, std::vector<int>& OutProbeIndices) const
+{
+    for (int BlockZ = 0; BlockZ < ZSize; BlockZ += Stride)
+    {
+        for (int BlockY = 0; BlockY < YSize; BlockY += Stride)
+        {
+            for (int BlockX = 0; BlockX < XSize; BlockX += Stride)
+            {
+                const int MaxX = std::min(BlockX + Stride, XSize);
+                const int MaxY = std::min(BlockY + Stride, YSize);
+                const int MaxZ = std::min(BlockZ + Stride, ZSize);
+                const float CentreX = (BlockX + MaxX - 1) * 0.5f;
+                const float CentreY = (BlockY + MaxY - 1) * 0.5f;
+                const float CentreZ = (BlockZ + MaxZ - 1) * 0.5f;
+                
+                // Most open voxel in the block, closest to the centre if there's a tie
+                int BestIndex = -1;
+                int BestDistanceToGeometry = -1;
+                float BestDistanceToCentre = std::numeric_limits<float>::max();
+                
+                for (int z = BlockZ; z < MaxZ; ++z)
+                {
+                    for (int y = BlockY; y < MaxY; ++y)
+                    {
+                        for (int x = BlockX; x < MaxX; ++x)
+                        {
+                            const int Index = ThreeDimToOneDim(x, y, z, XSize, YSize);
+                            
+                            if (!Reachable[Index])
+                            {
+                                continue;
+                            }
+                            
+                            const int Distance = DistanceToGeometry[Index];
+                            const float DistanceToCentre = (x - CentreX) * (x - CentreX) + (y - CentreY) * (y - CentreY) + (z - CentreZ) * (z - CentreZ);
+                            
+                            if (Distance > BestDistanceToGeometry || (Distance == BestDistanceToGeometry && DistanceToCentre < BestDistanceToCentre))
+                            {
+                                BestIndex = Index;
+                                BestDistanceToGeometry = Distance;
+                                BestDistanceToCentre = DistanceToCentre;
+                            }
+                        }
+                    }
+                }
+                
+                if (BestIndex >= 0)
+                {
+                    OutProbeIndices.push_back(BestIndex);
+                }
+            }
+        }
+    }
+}
+
+void ProbeGenerator::FindPortals(int MaxRadius, int SuppressionRadius, std::vector<int>& OutPortalIndices) const
+{
+    std::vector<int> Candidates;
+    
+    // Passages an even number of voxels wide have two centre voxels with the same distance
+    auto IsPeak = [](int Distance, int BeforePrevious, int Previous, int Next, int AfterNext)
+    {
+        return (Previous < Distance && Next < Distance)
+            || (Previous == Distance && BeforePrevious < Distance && Next < Distance)
+            || (Next == Distance && AfterNext < Distance && Previous < Distance);
+    };
+    
+    const int ZStride = XSize * YSize;
+    
+    for (int z = 2; z < ZSize - 2; ++z)
+    {
+        for (int y = 0; y < YSize; ++y)
+        {
+            for (int x = 2; x < XSize - 2; ++x)
+            {
+                const int Index = ThreeDimToOneDim(x, y, z, XSize, YSize);
+                const int Distance = DistanceToGeometry[Index];
+                
+                if (!Reachable[Index] || Distance > MaxRadius)
+                {
+                    continue;
+                }
+                
+                const uint16_t* D = DistanceToGeometry + Index;
+                
+                // Only look at horizontal axes. Floors and ceilings aren't passages
+                const bool bPeakAlongX = IsPeak(Distance, D[-2], D[-1], D[1], D[2]);
+                const bool bPeakAlongZ = IsPeak(Distance, D[-2 * ZStride], D[-ZStride], D[ZStride], D[2 * ZStride]);
+                const bool bDipAlongX = D[-1] >= Distance && D[1] >= Distance;
+                const bool bDipAlongZ = D[-ZStride] >= Distance && D[ZStride] >= Distance;
+                
+                if ((bPeakAlongX && bDipAlongZ) || (bPeakAlongZ && bDipAlongX))
+                {
+                    Candidates.push_back(Index);
+                }
+            }
+        }
+    }
+    
+    // Narrowest passages first, then thin them out so a doorway or corridor doesn't get a probe in every voxel
+    std::stable_sort(Candidates.begin(), Candidates.end(), [this](int A, int B) { return DistanceToGeometry[A] < DistanceToGeometry[B]; });
+    
+    std::vector<uint8_t> Suppressed(Grid->Voxels.size(), 0);
+    
+    for (int Candidate : Candidates)
+    {
+        if (Suppressed[Candidate])
+        {
+            continue;
+        }
+        
+        OutPortalIndices.push_back(Candidate);
+        
+        int X, Y, Z;
+        IndexToThreeDim(Candidate, XSize, YSize, X, Y, Z);
+        
+        for (int z = std::max(0, Z - SuppressionRadius); z <= std::min(ZSize - 1, Z + SuppressionRadius); ++z)
+        {
+            for (int y = std::max(0, Y - SuppressionRadius); y <= std::min(YSize - 1, Y + SuppressionRadius); ++y)
+            {
+                for (int x = std::max(0, X - SuppressionRadius); x <= std::min(XSize - 1, X + SuppressionRadius); ++x)
+                {
+                    Suppressed[ThreeDimToOneDim(x, y, z, XSize, YSize)] = 1;
+                }
+            }
+        }
+    }
+}
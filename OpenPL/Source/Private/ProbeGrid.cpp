@@ -0,0 +1,510 @@
+/*
+  ==============================================================================
+  
+    ProbeGrid.cpp
+    Created: 18 Oct 2026 9:12:48am
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#include "ProbeGrid.h"
+#include "PL_SCENE.h"
+#include "Analyser.h"
+#include "Simulators/Simulator.h"
+#include "AirRegions.h"
+#include "OccupancyGrid.h"
+#include <limits>
+
+namespace
+{
+    /** Probes sit roughly at ear height above the floor they were placed on*/
+    const float ProbeHeightAboveFloor = 1.5f;
+    
+    /** Surface voxels per column above which an adaptive column gets split into four*/
+    const float AdaptiveComplexityThreshold = 1.5f;
+    
+    bool IsOpen(const PL_VOXEL_GRID& Grid, int X, int Y, int Z)
+    {
+        return Grid.Voxels[ThreeDimToOneDim(X, Y, Z, Grid.Size(0,0), Grid.Size(0,1))].Beta != 0;
+    }
+    
+    bool IsWalkable(const PL_VOXEL_GRID& Grid, int X, int Y, int Z)
+    {
+        return IsOpen(Grid, X, Y, Z) && (Y == 0 || !IsOpen(Grid, X, Y - 1, Z));
+    }
+    
+    /**
+     * Counts closed voxels that touch open air in a block of columns, divided by the number of columns.
+     * A flat floor scores 1.
+     */
+    float GetColumnComplexity(const PL_VOXEL_GRID& Grid, int MinX, int MaxX, int MinZ, int MaxZ)
+    {
+        const int XSize = Grid.Size(0,0);
+        const int YSize = Grid.Size(0,1);
+        const int ZSize = Grid.Size(0,2);
+        
+        int SurfaceVoxels = 0;
+        
+        for (int z = MinZ; z < MaxZ; ++z)
+        {
+            for (int y = 0; y < YSize; ++y)
+            {
+                for (int x = MinX; x < MaxX; ++x)
+                {
+                    if (IsOpen(Grid, x, y, z))
+                    {
+                        continue;
+                    }
+                    
+                    const bool TouchesAir = (x > 0 && IsOpen(Grid, x - 1, y, z)) || (x + 1 < XSize && IsOpen(Grid, x + 1, y, z)) ||
+                                            (y > 0 && IsOpen(Grid, x, y - 1, z)) || (y + 1 < YSize && IsOpen(Grid, x, y + 1, z)) ||
+                                            (z > 0 && IsOpen(Grid, x, y, z - 1)) || (z + 1 < ZSize && IsOpen(Grid, x, y, z + 1));
+                    
+                    if (TouchesAir)
+                    {
+                        SurfaceVoxels++;
+                    }
+                }
+            }
+        }
+        
+        return static_cast<float>(SurfaceVoxels) / static_cast<float>((MaxX - MinX) * (MaxZ - MinZ));
+    }
+    
+    /**
+     * Adds one probe per walkable floor in a block of columns, using the walkable voxel closest to the block's centre.
+     */
+    void PlaceProbesInColumns(const PL_SCENE* Scene, const PL_VOXEL_GRID& Grid, int MinX, int MaxX, int MinZ, int MaxZ, std::vector<PLVector>& OutProbeLocations)
+    {
+        const int YSize = Grid.Size(0,1);
+        const int HeightInVoxels = static_cast<int>(ProbeHeightAboveFloor / Grid.VoxelSize);
+        const float CentreX = (MinX + MaxX - 1) * 0.5f;
+        const float CentreZ = (MinZ + MaxZ - 1) * 0.5f;
+        
+        for (int y = 0; y < YSize; ++y)
+        {
+            int BestX = -1;
+            int BestZ = -1;
+            float BestDistance = std::numeric_limits<float>::max();
+            
+            for (int z = MinZ; z < MaxZ; ++z)
+            {
+                for (int x = MinX; x < MaxX; ++x)
+                {
+                    if (!IsWalkable(Grid, x, y, z))
+                    {
+                        continue;
+                    }
+                    
+                    const float Distance = (x - CentreX) * (x - CentreX) + (z - CentreZ) * (z - CentreZ);
+                    
+                    if (Distance < BestDistance)
+                    {
+                        BestDistance = Distance;
+                        BestX = x;
+                        BestZ = z;
+                    }
+                }
+            }
+            
+            if (BestX < 0)
+            {
+                continue;
+            }
+            
+            // Raise the probe to ear height, stopping under any ceiling
+            int ProbeY = y;
+            while (ProbeY - y < HeightInVoxels && ProbeY + 1 < YSize && IsOpen(Grid, BestX, ProbeY + 1, BestZ))
+            {
+                ProbeY++;
+            }
+            
+            PLVector ProbeLocation;
+            Scene->GetVoxelPosition(ThreeDimToOneDim(BestX, ProbeY, BestZ, Grid.Size(0,0), Grid.Size(0,1)), &ProbeLocation);
+            OutProbeLocations.push_back(ProbeLocation);
+        }
+    }
+    
+    void PlaceProbesWithStride(const PL_SCENE* Scene, const PL_VOXEL_GRID& Grid, PL_PROBE_PLACEMENT Placement, int Stride, std::vector<PLVector>& OutProbeLocations)
+    {
+        const int XSize = Grid.Size(0,0);
+        const int ZSize = Grid.Size(0,2);
+        
+        for (int z = 0; z < ZSize; z += Stride)
+        {
+            for (int x = 0; x < XSize; x += Stride)
+            {
+                const int MaxX = std::min(x + Stride, XSize);
+                const int MaxZ = std::min(z + Stride, ZSize);
+                
+                const bool bSplit = Placement == PL_PROBE_PLACEMENT_ADAPTIVE && Stride > 1 && GetColumnComplexity(Grid, x, MaxX, z, MaxZ) > AdaptiveComplexityThreshold;
+                
+                if (!bSplit)
+                {
+                    PlaceProbesInColumns(Scene, Grid, x, MaxX, z, MaxZ, OutProbeLocations);
+                    continue;
+                }
+                
+                const int HalfStride = Stride / 2;
+                const int MidX = std::min(x + HalfStride, MaxX);
+                const int MidZ = std::min(z + HalfStride, MaxZ);
+                
+                PlaceProbesInColumns(Scene, Grid, x, MidX, z, MidZ, OutProbeLocations);
+                
+                if (MidX < MaxX)
+                {
+                    PlaceProbesInColumns(Scene, Grid, MidX, MaxX, z, MidZ, OutProbeLocations);
+                }
+                
+                if (MidZ < MaxZ)
+                {
+                    PlaceProbesInColumns(Scene, Grid, x, MidX, MidZ, MaxZ, OutProbeLocations);
+                }
+                
+                if (MidX < MaxX && MidZ < MaxZ)
+                {
+                    PlaceProbesInColumns(Scene, Grid, MidX, MaxX, MidZ, MaxZ, OutProbeLocations);
+                }
+            }
+        }
+    }
+}
+
+PL_RESULT ProbeGrid::PlaceProbes(const PL_SCENE* Scene, PL_PROBE_PLACEMENT Placement, float Spacing, int MaxProbes, std::vector<PLVector>& OutProbeLocations)
+{
+    const PL_VOXEL_GRID* Grid = nullptr;
+    Scene->GetVoxels(&Grid);
+    
+    if (!Grid || Grid->Voxels.size() == 0)
+    {
+        DebugError("Can't place probes without voxels. Must call CreateVoxels");
+        return PL_ERR;
+    }
+    
+    if (Spacing <= 0.0f || MaxProbes <= 0)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    const int XSize = Grid->Size(0,0);
+    const int ZSize = Grid->Size(0,2);
+    const int LargestSide = std::max(XSize, ZSize);
+    int Stride = std::max(1, static_cast<int>(std::round(Spacing / Grid->VoxelSize)));
+    
+    // Spread the probes further apart until they fit in the budget, like seeded placement does
+    std::vector<PLVector> ProbeLocations;
+    while (true)
+    {
+        ProbeLocations.clear();
+        PlaceProbesWithStride(Scene, *Grid, Placement, Stride, ProbeLocations);
+        
+        if (ProbeLocations.size() <= MaxProbes || Stride >= LargestSide)
+        {
+            break;
+        }
+        
+        Stride *= 2;
+    }
+    
+    if (ProbeLocations.size() > MaxProbes)
+    {
+        ProbeLocations.resize(MaxProbes);
+    }
+    
+    OutProbeLocations.insert(OutProbeLocations.end(), ProbeLocations.begin(), ProbeLocations.end());
+    
+    PL_LOG(PL_DEBUG_LEVEL_LOG, "Placed " << ProbeLocations.size() << " probes (" << Stride * Grid->VoxelSize << "m apart)");
+    
+    return PL_OK;
+}
+
+PL_RESULT ProbeGrid::Bake(PL_SCENE* Scene, const std::vector<PLVector>& ProbeLocations)
+{
+    const PL_VOXEL_GRID* Grid = nullptr;
+    Scene->GetVoxels(&Grid);
+    
+    if (!Grid || Grid->Voxels.size() == 0)
+    {
+        DebugError("Can't bake probes without voxels. Must call CreateVoxels");
+        return PL_ERR;
+    }
+    
+    if (ProbeLocations.size() >= NoProbe)
+    {
+        DebugError("Too many probes to bake");
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    ProbeVoxels.clear();
+    EncodedOcclusion.clear();
+    Blends.clear();
+    
+    XSize = Grid->Size(0,0);
+    YSize = Grid->Size(0,1);
+    ZSize = Grid->Size(0,2);
+    
+    for (const PLVector& ProbeLocation : ProbeLocations)
+    {
+        int ProbeVoxelIndex;
+        if (Scene->GetVoxelIndexOfPosition(ProbeLocation, &ProbeVoxelIndex) != PL_OK || Grid->Voxels[ProbeVoxelIndex].Beta == 0)
+        {
+            DebugWarn("Skipping a probe that is outside the lattice or inside geometry");
+            continue;
+        }
+        
+        if (Scene->Simulate(ProbeLocation) != PL_OK)
+        {
+            DebugWarn("Failed to simulate a probe");
+            continue;
+        }
+        
+        Simulator* ProbeSimulator = nullptr;
+        Scene->GetSimulator(&ProbeSimulator);
+        
+        EncodedOcclusion.emplace_back();
+        EncodeProbe(ProbeSimulator, ProbeVoxelIndex, EncodedOcclusion.back());
+        ProbeVoxels.push_back(ProbeVoxelIndex);
+    }
+    
+    if (ProbeVoxels.size() == 0)
+    {
+        DebugError("No probes could be baked");
+        return PL_ERR;
+    }
+    
+    BuildBlends(Scene, ProbeVoxels);
+    
+    PL_LOG(PL_DEBUG_LEVEL_LOG, "Baked " << ProbeVoxels.size() << " probes over " << Grid->Voxels.size() << " voxels");
+    
+    return PL_OK;
+}
+
+PL_RESULT ProbeGrid::GetOcclusion(int ListenerIndex, int EmitterIndex, float* OutOcclusion) const
+{
+    if (!OutOcclusion)
+    {
+        return PL_ERR_INVALID_PARAM;
+    }
+    
+    if (ListenerIndex < 0 || ListenerIndex >= Blends.size() || EmitterIndex < 0 || EmitterIndex >= Blends.size())
+    {
+        return PL_ERR;
+    }
+    
+    const ProbeBlend& Blend = Blends[ListenerIndex];
+    
+    float Occlusion = 0.0f;
+    
+    for (int i = 0; i < MaxBlendedProbes && Blend.Probes[i] != NoProbe; ++i)
+    {
+        Occlusion += Blend.Weights[i] * EncodedOcclusion[Blend.Probes[i]][GetPlaneIndex(EmitterIndex)];
+    }
+    
+    *OutOcclusion = Occlusion / 255.0f;
+    
+    return PL_OK;
+}
+
+int ProbeGrid::GetProbeCount() const
+{
+    return static_cast<int>(ProbeVoxels.size());
+}
+
+void ProbeGrid::EncodeProbe(Simulator* Simulator, int ProbeVoxelIndex, std::vector<uint8_t>& OutEncodedOcclusion) const
+{
+    int ProbeX, ProbeY, ProbeZ;
+    IndexToThreeDim(ProbeVoxelIndex, XSize, YSize, ProbeX, ProbeY, ProbeZ);
+    
+    OutEncodedOcclusion.resize(XSize * ZSize);
+    
+    ParallelFor(0, ZSize, [&](int Begin, int End)
+    {
+        Analyser Analyser;
+        
+        for (int z = Begin; z < End; ++z)
+        {
+            for (int x = 0; x < XSize; ++x)
+            {
+                const int EmitterIndex = ThreeDimToOneDim(x, ProbeY, z, XSize, YSize);
+                const float Occlusion = Analyser.CalculateOcclusion(Simulator, ProbeVoxelIndex, EmitterIndex);
+                const float Clamped = std::min(std::max(Occlusion, 0.0f), 1.0f);
+                OutEncodedOcclusion[x + z * XSize] = static_cast<uint8_t>(std::round(Clamped * 255.0f));
+            }
+        }
+    });
+}
+
+int ProbeGrid::GetPlaneIndex(int VoxelIndex) const
+{
+    int X, Y, Z;
+    IndexToThreeDim(VoxelIndex, XSize, YSize, X, Y, Z);
+    return X + Z * XSize;
+}
+
+void ProbeGrid::BuildBlends(const PL_SCENE* Scene, const std::vector<int>& ProbeVoxelIndices)
+{
+    const PL_VOXEL_GRID* Grid = nullptr;
+    Scene->GetVoxels(&Grid);
+    
+    const int VoxelCount = static_cast<int>(Grid->Voxels.size());
+    const int ProbeCount = static_cast<int>(ProbeVoxelIndices.size());
+    
+    std::vector<int> ProbeX(ProbeCount), ProbeY(ProbeCount), ProbeZ(ProbeCount);
+    for (int Probe = 0; Probe < ProbeCount; ++Probe)
+    {
+        Scene->GetThreeDimensionalIndexOfIndex(ProbeVoxelIndices[Probe], ProbeX[Probe], ProbeY[Probe], ProbeZ[Probe]);
+    }
+    
+    const AirRegions* Regions = nullptr;
+    Scene->GetAirRegions(&Regions);
+    
+    const OccupancyGrid* Occupancy = nullptr;
+    Scene->GetOccupancyGrid(&Occupancy);
+    
+    std::vector<PLVector> ProbePositions(ProbeCount);
+    std::vector<uint32_t> ProbeRegions(ProbeCount, AirRegions::Geometry);
+    for (int Probe = 0; Probe < ProbeCount; ++Probe)
+    {
+        Scene->GetVoxelPosition(ProbeVoxelIndices[Probe], &ProbePositions[Probe]);
+        
+        if (Regions)
+        {
+            ProbeRegions[Probe] = Regions->GetRegion(ProbeVoxelIndices[Probe]);
+        }
+    }
+    
+    Blends.resize(VoxelCount);
+    
+    ParallelFor(0, VoxelCount, [&](int Begin, int End)
+    {
+        int Candidates[MaxCandidateProbes];
+        int CandidateDistances[MaxCandidateProbes];
+        PLVector CandidatePositions[MaxCandidateProbes];
+        float Thicknesses[MaxCandidateProbes];
+        int SolidVoxels[MaxCandidateProbes];
+        
+        for (int VoxelIndex = Begin; VoxelIndex < End; ++VoxelIndex)
+        {
+            int X, Y, Z;
+            Scene->GetThreeDimensionalIndexOfIndex(VoxelIndex, X, Y, Z);
+            
+            const uint32_t Region = Regions ? Regions->GetRegion(VoxelIndex) : AirRegions::Geometry;
+            
+            // Insertion sort into the closest few probes. Probes in another air region can't be heard from here,
+            // unless the voxel is inside geometry, where anything goes
+            int NumCandidates = 0;
+            
+            for (int Probe = 0; Probe < ProbeCount; ++Probe)
+            {
+                if (Region != AirRegions::Geometry && ProbeRegions[Probe] != Region)
+                {
+                    continue;
+                }
+                
+                const int DistanceSquared = (ProbeX[Probe] - X) * (ProbeX[Probe] - X) + (ProbeY[Probe] - Y) * (ProbeY[Probe] - Y) + (ProbeZ[Probe] - Z) * (ProbeZ[Probe] - Z);
+                
+                if (NumCandidates == MaxCandidateProbes && DistanceSquared >= CandidateDistances[MaxCandidateProbes - 1])
+                {
+                    continue;
+                }
+                
+                int Slot = std::min(NumCandidates, MaxCandidateProbes - 1);
+                while (Slot > 0 && CandidateDistances[Slot - 1] > DistanceSquared)
+                {
+                    Candidates[Slot] = Candidates[Slot - 1];
+                    CandidateDistances[Slot] = CandidateDistances[Slot - 1];
+                    Slot--;
+                }
+                
+                Candidates[Slot] = Probe;
+                CandidateDistances[Slot] = DistanceSquared;
+                NumCandidates = std::min(NumCandidates + 1, MaxCandidateProbes);
+            }
+            
+            // Keep the nearest probes with nothing solid between them and the voxel
+            int Nearest[MaxBlendedProbes];
+            int NearestDistance[MaxBlendedProbes];
+            int NumNearest = 0;
+            
+            if (Occupancy && Region != AirRegions::Geometry && NumCandidates > 0)
+            {
+                PLVector VoxelPosition;
+                Scene->GetVoxelPosition(VoxelIndex, &VoxelPosition);
+                
+                for (int i = 0; i < NumCandidates; ++i)
+                {
+                    CandidatePositions[i] = ProbePositions[Candidates[i]];
+                }
+                
+                Occupancy->TraceBatch(VoxelPosition, CandidatePositions, NumCandidates, Thicknesses, SolidVoxels);
+                
+                for (int i = 0; i < NumCandidates && NumNearest < MaxBlendedProbes; ++i)
+                {
+                    if (SolidVoxels[i] == 0)
+                    {
+                        Nearest[NumNearest] = Candidates[i];
+                        NearestDistance[NumNearest] = CandidateDistances[i];
+                        NumNearest++;
+                    }
+                }
+            }
+            else
+            {
+                for (; NumNearest < std::min(NumCandidates, MaxBlendedProbes); ++NumNearest)
+                {
+                    Nearest[NumNearest] = Candidates[NumNearest];
+                    NearestDistance[NumNearest] = CandidateDistances[NumNearest];
+                }
+            }
+            
+            // Round a corner from every probe. The nearest one in the same region is the best guess
+            if (NumNearest == 0 && NumCandidates > 0)
+            {
+                Nearest[0] = Candidates[0];
+                NearestDistance[0] = CandidateDistances[0];
+                NumNearest = 1;
+            }
+            
+            // A region without any probes in it still needs something to blend
+            if (NumNearest == 0)
+            {
+                int NearestDistanceSquared = std::numeric_limits<int>::max();
+                for (int Probe = 0; Probe < ProbeCount; ++Probe)
+                {
+                    const int DistanceSquared = (ProbeX[Probe] - X) * (ProbeX[Probe] - X) + (ProbeY[Probe] - Y) * (ProbeY[Probe] - Y) + (ProbeZ[Probe] - Z) * (ProbeZ[Probe] - Z);
+                    if (DistanceSquared < NearestDistanceSquared)
+                    {
+                        NearestDistanceSquared = DistanceSquared;
+                        Nearest[0] = Probe;
+                        NearestDistance[0] = DistanceSquared;
+                        NumNearest = 1;
+                    }
+                }
+            }
+            
+            ProbeBlend& Blend = Blends[VoxelIndex];
+            
+            // Inverse distance weighting. Standing on a probe uses only that probe
+            float TotalWeight = 0.0f;
+            for (int i = 0; i < MaxBlendedProbes; ++i)
+            {
+                if (i >= NumNearest || (i > 0 && NearestDistance[0] == 0))
+                {
+                    Blend.Probes[i] = NoProbe;
+                    Blend.Weights[i] = 0.0f;
+                    continue;
+                }
+                
+                Blend.Probes[i] = static_cast<uint16_t>(Nearest[i]);
+                Blend.Weights[i] = NearestDistance[i] == 0 ? 1.0f : 1.0f / std::sqrt(static_cast<float>(NearestDistance[i]));
+                TotalWeight += Blend.Weights[i];
+            }
+            
+            for (int i = 0; i < MaxBlendedProbes; ++i)
+            {
+                Blend.Weights[i] /= TotalWeight;
+            }
+        }
+    });
+}
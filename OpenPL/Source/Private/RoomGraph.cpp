@@ -0,0 +1,437 @@
+/*
+  ==============================================================================
+  
+    RoomGraph.cpp
+    Created: 18 Oct 2026 7:58:39pm
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#include "RoomGraph.h"
+#include "DistanceField.h"
+#include <boost/timer/timer.hpp>
+#include <limits>
+#include <queue>
+#include <map>
+#include <cmath>
+
+namespace
+{
+    float Distance(const PLVector& A, const PLVector& B)
+    {
+        const PLVector Difference = A - B;
+        return std::sqrt(Difference.X * Difference.X + Difference.Y * Difference.Y + Difference.Z * Difference.Z);
+    }
+    
+    /**
+     * Voxel faces shared by two rooms.
+     */
+    struct Opening
+    {
+        Eigen::Vector3d PositionSum = Eigen::Vector3d::Zero();
+        int FacesPerAxis[3] = { 0, 0, 0 };
+        int Faces = 0;
+    };
+}
+
+void RoomGraph::Build(const PL_VOXEL_GRID& Grid, const DistanceField& Distances, const PLVector& BottomBackLeft)
+{
+    boost::timer::cpu_timer Timer;
+    
+    const int XSize = Grid.Size(0,0);
+    const int YSize = Grid.Size(0,1);
+    const int ZSize = Grid.Size(0,2);
+    const int NumVoxels = static_cast<int>(Grid.Voxels.size());
+    const int Strides[3] = { 1, XSize, XSize * YSize };
+    const float VoxelSize = Grid.VoxelSize;
+    
+    const std::vector<uint16_t>& Heights = Distances.GetDistances();
+    
+    RoomOfVoxel.assign(NumVoxels, NoRoom);
+    Rooms.clear();
+    Portals.clear();
+    
+    // Counting sort of the air, most open voxels first
+    std::vector<int> HeightStarts (DistanceField::Far + 2, 0);
+    
+    for (int i = 0; i < NumVoxels; ++i)
+    {
+        if (Grid.Voxels[i].Beta != 0)
+        {
+            ++HeightStarts[DistanceField::Far - Heights[i] + 1];
+        }
+    }
+    
+    for (int i = 1; i < HeightStarts.size(); ++i)
+    {
+        HeightStarts[i] += HeightStarts[i - 1];
+    }
+    
+    std::vector<int> FloodOrder (HeightStarts.back());
+    
+    for (int i = 0; i < NumVoxels; ++i)
+    {
+        if (Grid.Voxels[i].Beta != 0)
+        {
+            FloodOrder[HeightStarts[DistanceField::Far - Heights[i]]++] = i;
+        }
+    }
+    
+    //
+    // FLOOD
+    //
+    // Basins that get merged point to the basin that took them over
+    std::vector<uint32_t> Parents;
+    std::vector<uint16_t> Peaks;
+    std::vector<int> PeakVoxels;
+    
+    auto FindBasin = [&Parents](uint32_t Basin)
+    {
+        while (Parents[Basin] != Basin)
+        {
+            Parents[Basin] = Parents[Parents[Basin]];
+            Basin = Parents[Basin];
+        }
+        return Basin;
+    };
+    
+    const float MinPeak = MinRoomHalfWidth / VoxelSize * DistanceField::Scale;
+    
+    std::vector<uint32_t> Basins (NumVoxels, NoRoom);
+    
+    for (int Index : FloodOrder)
+    {
+        int X, Y, Z;
+        IndexToThreeDim(Index, XSize, YSize, X, Y, Z);
+        const int Coordinates[3] = { X, Y, Z };
+        const int Sizes[3] = { XSize, YSize, ZSize };
+        
+        // Distinct basins already flooded next to this voxel
+        uint32_t Neighbours[6];
+        int NumNeighbours = 0;
+        
+        // The voxel joins the basin of its most open neighbour, so ties at the same height don't creep along walls
+        uint32_t Best = NoRoom;
+        uint16_t BestHeight = 0;
+        
+        for (int Axis = 0; Axis < 3; ++Axis)
+        {
+            for (int Step = -1; Step <= 1; Step += 2)
+            {
+                const int Coordinate = Coordinates[Axis] + Step;
+                
+                if (Coordinate < 0 || Coordinate >= Sizes[Axis])
+                {
+                    continue;
+                }
+                
+                const int NeighbourIndex = Index + Step * Strides[Axis];
+                const uint32_t NeighbourBasin = Basins[NeighbourIndex];
+                
+                if (NeighbourBasin == NoRoom)
+                {
+                    continue;
+                }
+                
+                const uint32_t Root = FindBasin(NeighbourBasin);
+                
+                if (Best == NoRoom || Heights[NeighbourIndex] > BestHeight)
+                {
+                    Best = Root;
+                    BestHeight = Heights[NeighbourIndex];
+                }
+                
+                if (std::find(Neighbours, Neighbours + NumNeighbours, Root) == Neighbours + NumNeighbours)
+                {
+                    Neighbours[NumNeighbours++] = Root;
+                }
+            }
+        }
+        
+        // A new peak starts a new basin
+        if (NumNeighbours == 0)
+        {
+            const uint32_t NewBasin = static_cast<uint32_t>(Parents.size());
+            Parents.push_back(NewBasin);
+            Peaks.push_back(Heights[Index]);
+            PeakVoxels.push_back(Index);
+            Basins[Index] = NewBasin;
+            continue;
+        }
+        
+        // This voxel is where basins meet, and its height is the half width of the opening between them.
+        // Merged basins keep the higher peak as their center
+        for (int i = 0; i < NumNeighbours; ++i)
+        {
+            const uint32_t Other = FindBasin(Neighbours[i]);
+            const uint32_t Current = FindBasin(Best);
+            
+            if (Other == Current)
+            {
+                continue;
+            }
+            
+            const uint16_t LowerPeak = std::min(Peaks[Other], Peaks[Current]);
+            
+            if (LowerPeak < MinPeak || Heights[Index] > PortalRatio * LowerPeak)
+            {
+                if (Peaks[Other] > Peaks[Current])
+                {
+                    Parents[Current] = Other;
+                }
+                else
+                {
+                    Parents[Other] = Current;
+                }
+            }
+        }
+        
+        Basins[Index] = FindBasin(Best);
+    }
+    
+    std::vector<uint32_t> RoomOfBasin (Parents.size(), NoRoom);
+    
+    for (uint32_t Basin = 0; Basin < Parents.size(); ++Basin)
+    {
+        if (FindBasin(Basin) == Basin)
+        {
+            RoomOfBasin[Basin] = static_cast<uint32_t>(Rooms.size());
+            
+            Room NewRoom;
+            NewRoom.CenterVoxel = PeakVoxels[Basin];
+            NewRoom.VoxelCount = 0;
+            Rooms.push_back(NewRoom);
+        }
+    }
+    
+    // The flood above decides which basins are rooms, but labels voxels in whatever order ties come in, which can creep along corners.
+    // Label them again by flooding out from every peak, first come first served at each height, so each voxel goes to the room whose core is closest
+    std::vector<std::vector<int>> Levels (DistanceField::Far + 1);
+    
+    for (uint32_t Basin = 0; Basin < Parents.size(); ++Basin)
+    {
+        RoomOfVoxel[PeakVoxels[Basin]] = RoomOfBasin[FindBasin(Basin)];
+        Levels[Peaks[Basin]].push_back(PeakVoxels[Basin]);
+    }
+    
+    for (int Level = DistanceField::Far; Level >= 0; --Level)
+    {
+        std::vector<int>& Queue = Levels[Level];
+        
+        // The queue can grow while it's being processed
+        for (size_t Head = 0; Head < Queue.size(); ++Head)
+        {
+            const int Index = Queue[Head];
+            
+            int X, Y, Z;
+            IndexToThreeDim(Index, XSize, YSize, X, Y, Z);
+            const int Coordinates[3] = { X, Y, Z };
+            const int Sizes[3] = { XSize, YSize, ZSize };
+            
+            for (int Axis = 0; Axis < 3; ++Axis)
+            {
+                for (int Step = -1; Step <= 1; Step += 2)
+                {
+                    const int Coordinate = Coordinates[Axis] + Step;
+                    
+                    if (Coordinate < 0 || Coordinate >= Sizes[Axis])
+                    {
+                        continue;
+                    }
+                    
+                    const int NeighbourIndex = Index + Step * Strides[Axis];
+                    
+                    if (Grid.Voxels[NeighbourIndex].Beta == 0 || RoomOfVoxel[NeighbourIndex] != NoRoom)
+                    {
+                        continue;
+                    }
+                    
+                    RoomOfVoxel[NeighbourIndex] = RoomOfVoxel[Index];
+                    Levels[std::min(static_cast<int>(Heights[NeighbourIndex]), Level)].push_back(NeighbourIndex);
+                }
+            }
+            
+            ++Rooms[RoomOfVoxel[Index]].VoxelCount;
+        }
+        
+        std::vector<int>().swap(Queue);
+    }
+    
+    //
+    // PORTALS
+    //
+    std::map<uint64_t, Opening> Openings;
+    
+    for (int z = 0; z < ZSize; ++z)
+    {
+        for (int y = 0; y < YSize; ++y)
+        {
+            for (int x = 0; x < XSize; ++x)
+            {
+                const int Index = ThreeDimToOneDim(x, y, z, XSize, YSize);
+                const uint32_t RoomIndex = RoomOfVoxel[Index];
+                
+                if (RoomIndex == NoRoom)
+                {
+                    continue;
+                }
+                
+                const int Coordinates[3] = { x, y, z };
+                const int Sizes[3] = { XSize, YSize, ZSize };
+                
+                for (int Axis = 0; Axis < 3; ++Axis)
+                {
+                    if (Coordinates[Axis] + 1 >= Sizes[Axis])
+                    {
+                        continue;
+                    }
+                    
+                    const uint32_t NeighbourRoom = RoomOfVoxel[Index + Strides[Axis]];
+                    
+                    if (NeighbourRoom == NoRoom || NeighbourRoom == RoomIndex)
+                    {
+                        continue;
+                    }
+                    
+                    const uint64_t Key = (static_cast<uint64_t>(std::min(RoomIndex, NeighbourRoom)) << 32) | std::max(RoomIndex, NeighbourRoom);
+                    Opening& Faces = Openings[Key];
+                    
+                    // Center of the face between the two voxels
+                    Eigen::Vector3d Face (x + 0.5, y + 0.5, z + 0.5);
+                    Face[Axis] += 0.5;
+                    
+                    Faces.PositionSum += Face;
+                    ++Faces.FacesPerAxis[Axis];
+                    ++Faces.Faces;
+                }
+            }
+        }
+    }
+    
+    for (const auto& KeyAndOpening : Openings)
+    {
+        const Opening& Faces = KeyAndOpening.second;
+        const Eigen::Vector3d Center = Faces.PositionSum / Faces.Faces * VoxelSize;
+        
+        Portal NewPortal;
+        NewPortal.RoomA = static_cast<int>(KeyAndOpening.first >> 32);
+        NewPortal.RoomB = static_cast<int>(KeyAndOpening.first & 0xFFFFFFFF);
+        NewPortal.Position = BottomBackLeft + PLVector(Center.x(), Center.y(), Center.z());
+        
+        // A slanted opening is a staircase of faces. The face counts on each axis are its area projected onto that axis
+        const Eigen::Vector3d Projected (Faces.FacesPerAxis[0], Faces.FacesPerAxis[1], Faces.FacesPerAxis[2]);
+        NewPortal.Area = static_cast<float>(Projected.norm()) * VoxelSize * VoxelSize;
+        
+        Rooms[NewPortal.RoomA].Portals.push_back(static_cast<int>(Portals.size()));
+        Rooms[NewPortal.RoomB].Portals.push_back(static_cast<int>(Portals.size()));
+        Portals.push_back(NewPortal);
+    }
+    
+    PL_LOG(PL_DEBUG_LEVEL_LOG, "Found " << Rooms.size() << " rooms and " << Portals.size() << " portals in " << Timer.elapsed().wall / 1e9 << "s");
+}
+
+uint32_t RoomGraph::GetRoom(int VoxelIndex) const
+{
+    return RoomOfVoxel[VoxelIndex];
+}
+
+const std::vector<RoomGraph::Room>& RoomGraph::GetRooms() const
+{
+    return Rooms;
+}
+
+const std::vector<RoomGraph::Portal>& RoomGraph::GetPortals() const
+{
+    return Portals;
+}
+
+bool RoomGraph::FindPath(const PLVector& From, uint32_t FromRoom, const PLVector& To, uint32_t ToRoom, std::vector<int>& OutPortals, float& OutDistance) const
+{
+    OutPortals.clear();
+    
+    if (FromRoom >= Rooms.size() || ToRoom >= Rooms.size())
+    {
+        return false;
+    }
+    
+    if (FromRoom == ToRoom)
+    {
+        OutDistance = Distance(From, To);
+        return true;
+    }
+    
+    // Dijkstra over the portals. The last node is the end point
+    const int EndNode = static_cast<int>(Portals.size());
+    std::vector<float> Costs (Portals.size() + 1, std::numeric_limits<float>::max());
+    std::vector<int> Previous (Portals.size() + 1, -1);
+    
+    typedef std::pair<float, int> CostAndNode;
+    std::priority_queue<CostAndNode, std::vector<CostAndNode>, std::greater<CostAndNode>> Queue;
+    
+    for (int PortalIndex : Rooms[FromRoom].Portals)
+    {
+        Costs[PortalIndex] = Distance(From, Portals[PortalIndex].Position);
+        Queue.push(CostAndNode(Costs[PortalIndex], PortalIndex));
+    }
+    
+    auto Relax = [&](int Node, int FromNode, float Cost)
+    {
+        if (Cost < Costs[Node])
+        {
+            Costs[Node] = Cost;
+            Previous[Node] = FromNode;
+            Queue.push(CostAndNode(Cost, Node));
+        }
+    };
+    
+    while (!Queue.empty())
+    {
+        const CostAndNode Current = Queue.top();
+        Queue.pop();
+        
+        if (Current.first > Costs[Current.second])
+        {
+            continue;
+        }
+        
+        if (Current.second == EndNode)
+        {
+            break;
+        }
+        
+        const Portal& CurrentPortal = Portals[Current.second];
+        
+        // A portal leads into both of its rooms
+        for (int RoomIndex : { CurrentPortal.RoomA, CurrentPortal.RoomB })
+        {
+            if (RoomIndex == ToRoom)
+            {
+                Relax(EndNode, Current.second, Current.first + Distance(CurrentPortal.Position, To));
+            }
+            
+            for (int NextPortal : Rooms[RoomIndex].Portals)
+            {
+                if (NextPortal != Current.second)
+                {
+                    Relax(NextPortal, Current.second, Current.first + Distance(CurrentPortal.Position, Portals[NextPortal].Position));
+                }
+            }
+        }
+    }
+    
+    if (Costs[EndNode] == std::numeric_limits<float>::max())
+    {
+        return false;
+    }
+    
+    for (int Node = Previous[EndNode]; Node >= 0; Node = Previous[Node])
+    {
+        OutPortals.push_back(Node);
+    }
+    
+    std::reverse(OutPortals.begin(), OutPortals.end());
+    OutDistance = Costs[EndNode];
+    
+    return true;
+}
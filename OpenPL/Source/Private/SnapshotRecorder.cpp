@@ -0,0 +1,279 @@
+/*
+  ==============================================================================
+  
+    SnapshotRecorder.cpp
+    Created: 18 Oct 2026 9:24:45pm
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#include "SnapshotRecorder.h"
+#include "HalfFloat.h"
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+
+namespace
+{
+    std::string FrameFileName(const std::string& FilePrefix, int FrameIndex)
+    {
+        std::ostringstream Name;
+        Name << FilePrefix << "_" << std::setw(6) << std::setfill('0') << FrameIndex << ".vti";
+        return Name.str();
+    }
+}
+
+SnapshotRecorder::~SnapshotRecorder()
+{
+    Stop();
+}
+
+void SnapshotRecorder::Start(const std::string& FilePrefix, int Interval, int Stride, PL_SNAPSHOT_REGION Region, int PlaneIndex, PL_SNAPSHOT_PRECISION Precision, const PL_VOXEL_GRID& Grid, const PLVector& BottomBackLeft)
+{
+    Stop();
+    
+    this->FilePrefix = FilePrefix;
+    this->Interval = Interval;
+    this->Stride = Stride;
+    this->Precision = Precision;
+    
+    for (int Axis = 0; Axis < 3; ++Axis)
+    {
+        Begin[Axis] = 0;
+        End[Axis] = Grid.Size(0, Axis);
+    }
+    
+    // Planes are a volume one voxel thick along their axis
+    if (Region != PL_SNAPSHOT_REGION_VOLUME)
+    {
+        const int Axis = Region - PL_SNAPSHOT_REGION_PLANE_X;
+        Begin[Axis] = PlaneIndex;
+        End[Axis] = PlaneIndex + 1;
+    }
+    
+    for (int Axis = 0; Axis < 3; ++Axis)
+    {
+        Counts[Axis] = (End[Axis] - Begin[Axis] + Stride - 1) / Stride;
+    }
+    
+    const float HalfVoxel = Grid.VoxelSize / 2;
+    Origin = PLVector(BottomBackLeft.X + (Begin[0] * Grid.VoxelSize) + HalfVoxel, BottomBackLeft.Y + (Begin[1] * Grid.VoxelSize) + HalfVoxel, BottomBackLeft.Z + (Begin[2] * Grid.VoxelSize) + HalfVoxel);
+    Spacing = Grid.VoxelSize * Stride;
+    
+    Stopping = false;
+    Queued.clear();
+    Written.clear();
+    
+    FrameCount = 0;
+    LastTimeStep = -1;
+    LastTime = 0.0;
+    StepDuration = 0.0;
+    TimeOffset = 0.0;
+    WriterThread = boost::thread(&SnapshotRecorder::WriteFrames, this);
+}
+
+void SnapshotRecorder::Capture(const PL_VOXEL_GRID& Grid, int TimeStep, double Time)
+{
+    if (!WriterThread.joinable())
+    {
+        return;
+    }
+    
+    // Every simulation counts its time steps from 0 again. Carry on one step after the last one so frames never share a time
+    if (TimeStep <= LastTimeStep)
+    {
+        TimeOffset += LastTime + StepDuration;
+    }
+    
+    if (TimeStep > 0)
+    {
+        StepDuration = Time / TimeStep;
+    }
+    
+    LastTimeStep = TimeStep;
+    LastTime = Time;
+    
+    if (TimeStep % Interval != 0)
+    {
+        return;
+    }
+    
+    Frame NewFrame;
+    
+    {
+        boost::mutex::scoped_lock Lock (QueueMutex);
+        
+        while (Queued.size() >= MaxQueuedFrames)
+        {
+            QueueChanged.wait(Lock);
+        }
+        
+        if (!Spare.empty())
+        {
+            NewFrame = std::move(Spare.back());
+            Spare.pop_back();
+        }
+    }
+    
+    const size_t SampleSize = Precision == PL_SNAPSHOT_PRECISION_FLOAT16 ? sizeof(uint16_t) : sizeof(float);
+    NewFrame.Index = FrameCount++;
+    NewFrame.Time = TimeOffset + Time;
+    NewFrame.Data.resize(static_cast<size_t>(Counts[0]) * Counts[1] * Counts[2] * SampleSize);
+    
+    const int XSize = Grid.Size(0,0);
+    const int YSize = Grid.Size(0,1);
+    uint8_t* Output = NewFrame.Data.data();
+    
+    // VTK images are X fastest, then Y, then Z, the same as the lattice
+    for (int Z = Begin[2]; Z < End[2]; Z += Stride)
+    {
+        for (int Y = Begin[1]; Y < End[1]; Y += Stride)
+        {
+            for (int X = Begin[0]; X < End[0]; X += Stride)
+            {
+                const float Pressure = static_cast<float>(Grid.Voxels[ThreeDimToOneDim(X, Y, Z, XSize, YSize)].AirPressure);
+                
+                if (Precision == PL_SNAPSHOT_PRECISION_FLOAT16)
+                {
+                    const uint16_t Half = FloatToHalf(Pressure);
+                    std::memcpy(Output, &Half, sizeof(Half));
+                }
+                else
+                {
+                    std::memcpy(Output, &Pressure, sizeof(Pressure));
+                }
+                
+                Output += SampleSize;
+            }
+        }
+    }
+    
+    {
+        boost::mutex::scoped_lock Lock (QueueMutex);
+        Queued.push_back(std::move(NewFrame));
+    }
+    
+    QueueChanged.notify_all();
+}
+
+void SnapshotRecorder::Stop()
+{
+    if (!WriterThread.joinable())
+    {
+        return;
+    }
+    
+    {
+        boost::mutex::scoped_lock Lock (QueueMutex);
+        Stopping = true;
+    }
+    
+    QueueChanged.notify_all();
+    WriterThread.join();
+    
+    WriteCollection();
+    PL_LOG(PL_DEBUG_LEVEL_LOG, "Recorded " << Written.size() << " pressure snapshots to " << FilePrefix);
+}
+
+void SnapshotRecorder::WriteFrames()
+{
+    while (true)
+    {
+        Frame ToWrite;
+        
+        {
+            boost::mutex::scoped_lock Lock (QueueMutex);
+            
+            while (Queued.empty() && !Stopping)
+            {
+                QueueChanged.wait(Lock);
+            }
+            
+            // Only stop once everything captured has been written
+            if (Queued.empty())
+            {
+                return;
+            }
+            
+            ToWrite = std::move(Queued.front());
+            Queued.pop_front();
+        }
+        
+        WriteFrame(ToWrite);
+        
+        {
+            boost::mutex::scoped_lock Lock (QueueMutex);
+            Written.push_back(std::make_pair(ToWrite.Index, ToWrite.Time));
+            Spare.push_back(std::move(ToWrite));
+        }
+        
+        QueueChanged.notify_all();
+    }
+}
+
+void SnapshotRecorder::WriteFrame(const Frame& ToWrite) const
+{
+    std::ofstream File (FrameFileName(FilePrefix, ToWrite.Index), std::ios::binary);
+    
+    if (!File)
+    {
+        DebugWarn("Couldn't open a pressure snapshot file for writing");
+        return;
+    }
+    
+    const bool IsHalf = Precision == PL_SNAPSHOT_PRECISION_FLOAT16;
+    
+    File << "<?xml version=\"1.0\"?>\n";
+    File << "<VTKFile type=\"ImageData\" version=\"1.0\" byte_order=\"LittleEndian\" header_type=\"UInt64\">\n";
+    File << "  <ImageData WholeExtent=\"0 " << Counts[0] - 1 << " 0 " << Counts[1] - 1 << " 0 " << Counts[2] - 1 << "\"";
+    File << " Origin=\"" << Origin.X << " " << Origin.Y << " " << Origin.Z << "\" Spacing=\"" << Spacing << " " << Spacing << " " << Spacing << "\">\n";
+    File << "    <Piece Extent=\"0 " << Counts[0] - 1 << " 0 " << Counts[1] - 1 << " 0 " << Counts[2] - 1 << "\">\n";
+    File << "      <PointData Scalars=\"Pressure\">\n";
+    File << "        <DataArray type=\"" << (IsHalf ? "UInt16" : "Float32") << "\" Name=\"" << (IsHalf ? "PressureHalfBits" : "Pressure") << "\" format=\"appended\" offset=\"0\"/>\n";
+    File << "      </PointData>\n";
+    File << "    </Piece>\n";
+    File << "  </ImageData>\n";
+    File << "  <AppendedData encoding=\"raw\">\n_";
+    
+    // Raw appended data is a byte count followed by the bytes
+    const uint64_t ByteCount = ToWrite.Data.size();
+    File.write(reinterpret_cast<const char*>(&ByteCount), sizeof(ByteCount));
+    File.write(reinterpret_cast<const char*>(ToWrite.Data.data()), ToWrite.Data.size());
+    
+    File << "\n  </AppendedData>\n";
+    File << "</VTKFile>\n";
+    
+    if (!File)
+    {
+        DebugWarn("Failed writing a pressure snapshot. The disk may be full");
+    }
+}
+
+void SnapshotRecorder::WriteCollection() const
+{
+    std::ofstream File (FilePrefix + ".pvd");
+    
+    if (!File)
+    {
+        DebugWarn("Couldn't open the pressure snapshot collection for writing");
+        return;
+    }
+    
+    // Frames sit next to the collection, so list them without the directory
+    const size_t LastSlash = FilePrefix.find_last_of("/\\");
+    const std::string FileName = LastSlash == std::string::npos ? FilePrefix : FilePrefix.substr(LastSlash + 1);
+    
+    File << "<?xml version=\"1.0\"?>\n";
+    File << "<VTKFile type=\"Collection\" version=\"0.1\">\n";
+    File << "  <Collection>\n";
+    
+    for (const std::pair<int, double>& Entry : Written)
+    {
+        File << "    <DataSet timestep=\"" << Entry.second << "\" file=\"" << FrameFileName(FileName, Entry.first) << "\"/>\n";
+    }
+    
+    File << "  </Collection>\n";
+    File << "</VTKFile>\n";
+}
@@ -0,0 +1,132 @@
+/*
+  ==============================================================================
+  
+    ThreadScalingBenchmark.cpp
+    Created: 19 Oct 2026 4:37:18am
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#include "ThreadScalingBenchmark.h"
+#include <boost/timer/timer.hpp>
+
+std::vector<ThreadScalingBenchmark::Timing> ThreadScalingBenchmark::Run(int VoxelsInSide)
+{
+    const int Size = std::max(VoxelsInSide, MinVoxelsInSide);
+    const size_t Count = static_cast<size_t>(Size) * Size * Size;
+    const int HardwareThreads = std::max(1, static_cast<int>(boost::thread::hardware_concurrency()));
+    
+    const int PreviousThreads = GetParallelThreadSetting();
+    const bool bPinThreads = IsPinningThreads();
+    
+    PLVoxel Air = PLVoxel();
+    Air.Beta = 1;
+    
+    std::vector<int> ThreadCounts;
+    
+    for (int Threads = 1; Threads < HardwareThreads; Threads *= 2)
+    {
+        ThreadCounts.push_back(Threads);
+    }
+    
+    ThreadCounts.push_back(HardwareThreads);
+    
+    std::vector<Timing> Timings;
+    
+    for (int Threads : ThreadCounts)
+    {
+        SetParallelThreads(Threads, bPinThreads);
+        
+        Timing Result;
+        Result.Threads = Threads;
+        
+        {
+            PLVoxelLattice Lattice;
+            Lattice.assign(Count, Air);
+            Result.SerialTouchSeconds = TimeSweeps(Lattice, Size);
+        }
+        
+        {
+            PLVoxelLattice Lattice;
+            ParallelAssign(Lattice, Count, Air, Size);
+            Result.FirstTouchSeconds = TimeSweeps(Lattice, Size);
+        }
+        
+        const Timing& Single = Timings.empty() ? Result : Timings.front();
+        
+        PL_LOG(PL_DEBUG_LEVEL_LOG, Threads << (bPinThreads ? " pinned" : "") << " threads: "
+               << Result.SerialTouchSeconds << "s zeroed by one thread (" << Single.SerialTouchSeconds / Result.SerialTouchSeconds << "x), "
+               << Result.FirstTouchSeconds << "s first touched by each worker (" << Single.FirstTouchSeconds / Result.FirstTouchSeconds << "x)");
+        
+        Timings.push_back(Result);
+    }
+    
+    SetParallelThreads(PreviousThreads, bPinThreads);
+    
+    return Timings;
+}
+
+double ThreadScalingBenchmark::TimeSweeps(PLVoxelLattice& Lattice, int Size)
+{
+    const int OffsetsX[6] = { -1, 1, 0, 0, 0, 0 };
+    const int OffsetsY[6] = { 0, 0, -1, 1, 0, 0 };
+    const int OffsetsZ[6] = { 0, 0, 0, 0, -1, 1 };
+    
+    // Seeds a little pressure so the sweeps aren't averaging zeros
+    Lattice[ThreeDimToOneDim(Size / 2, Size / 2, Size / 2, Size, Size)].AirPressure = 1.0;
+    
+    boost::timer::cpu_timer Timer;
+    
+    for (int Sweep = 0; Sweep < Sweeps; ++Sweep)
+    {
+        // Reads one field and writes the other, then swaps, so no voxel is read after its neighbour wrote it
+        const bool bForward = Sweep % 2 == 0;
+        
+        ParallelFor(0, Size, [&](int FirstZ, int EndZ)
+        {
+            for (int z = FirstZ; z < EndZ; ++z)
+            {
+                for (int y = 0; y < Size; ++y)
+                {
+                    for (int x = 0; x < Size; ++x)
+                    {
+                        PLVoxel& Voxel = Lattice[ThreeDimToOneDim(x, y, z, Size, Size)];
+                        
+                        double Sum = 0.0;
+                        int Neighbours = 0;
+                        
+                        for (int Neighbour = 0; Neighbour < 6; ++Neighbour)
+                        {
+                            const int NeighbourX = x + OffsetsX[Neighbour];
+                            const int NeighbourY = y + OffsetsY[Neighbour];
+                            const int NeighbourZ = z + OffsetsZ[Neighbour];
+                            
+                            if (NeighbourX < 0 || NeighbourX >= Size || NeighbourY < 0 || NeighbourY >= Size || NeighbourZ < 0 || NeighbourZ >= Size)
+                            {
+                                continue;
+                            }
+                            
+                            const PLVoxel& Other = Lattice[ThreeDimToOneDim(NeighbourX, NeighbourY, NeighbourZ, Size, Size)];
+                            Sum += bForward ? Other.AirPressure : Other.ParticleVelocityX;
+                            Neighbours += Other.Beta;
+                        }
+                        
+                        const double Average = Voxel.Beta * Sum / std::max(1, Neighbours);
+                        
+                        if (bForward)
+                        {
+                            Voxel.ParticleVelocityX = Average;
+                        }
+                        else
+                        {
+                            Voxel.AirPressure = Average;
+                        }
+                    }
+                }
+            }
+        });
+    }
+    
+    return Timer.elapsed().wall / 1e9;
+}
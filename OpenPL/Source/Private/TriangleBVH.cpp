@@ -0,0 +1,286 @@
+/*
+  ==============================================================================
+  
+    TriangleBVH.cpp
+    Created: 18 Oct 2026 6:05:20pm
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#include "TriangleBVH.h"
+#include <limits>
+
+namespace
+{
+    /** Keeps points that lie on a triangle from hitting it again*/
+    const float SurfaceEpsilon = 1e-4f;
+    
+    /**
+     * Möller–Trumbore. Two sided.
+     */
+    bool RayTriangle(const TriangleBVH::Triangle& Triangle, const Eigen::Vector3f& Origin, const Eigen::Vector3f& Direction, float& OutT)
+    {
+        const Eigen::Vector3f EdgeA = Triangle.B - Triangle.A;
+        const Eigen::Vector3f EdgeB = Triangle.C - Triangle.A;
+        const Eigen::Vector3f P = Direction.cross(EdgeB);
+        const float Determinant = EdgeA.dot(P);
+        
+        if (std::abs(Determinant) < 1e-12f)
+        {
+            return false;
+        }
+        
+        const float InverseDeterminant = 1.0f / Determinant;
+        const Eigen::Vector3f ToOrigin = Origin - Triangle.A;
+        
+        const float U = ToOrigin.dot(P) * InverseDeterminant;
+        if (U < 0.0f || U > 1.0f)
+        {
+            return false;
+        }
+        
+        const Eigen::Vector3f Q = ToOrigin.cross(EdgeA);
+        const float V = Direction.dot(Q) * InverseDeterminant;
+        if (V < 0.0f || U + V > 1.0f)
+        {
+            return false;
+        }
+        
+        OutT = EdgeB.dot(Q) * InverseDeterminant;
+        return true;
+    }
+    
+    bool RayBox(const Eigen::AlignedBox3f& Box, const Eigen::Vector3f& Origin, const Eigen::Vector3f& InverseDirection, float MaxT)
+    {
+        const Eigen::Array3f TLow = (Box.min() - Origin).array() * InverseDirection.array();
+        const Eigen::Array3f THigh = (Box.max() - Origin).array() * InverseDirection.array();
+        const float TEnter = TLow.min(THigh).maxCoeff();
+        const float TExit = TLow.max(THigh).minCoeff();
+        return TEnter <= TExit && TExit >= 0.0f && TEnter <= MaxT;
+    }
+    
+    /** Whether any corner of the box is on or inside the plane*/
+    bool BoxTouchesPlane(const Eigen::AlignedBox3f& Box, const Eigen::Vector4f& Plane)
+    {
+        const Eigen::Vector3f Normal = Plane.head<3>();
+        const Eigen::Vector3f Furthest = (Normal.array() >= 0.0f).select(Box.max(), Box.min());
+        return Normal.dot(Furthest) + Plane.w() >= -SurfaceEpsilon;
+    }
+    
+    bool TriangleTouchesPlane(const TriangleBVH::Triangle& Triangle, const Eigen::Vector4f& Plane)
+    {
+        const Eigen::Vector3f Normal = Plane.head<3>();
+        return std::max({ Normal.dot(Triangle.A), Normal.dot(Triangle.B), Normal.dot(Triangle.C) }) + Plane.w() >= -SurfaceEpsilon;
+    }
+}
+
+void TriangleBVH::Build(const std::vector<PL_MESH>& Meshes)
+{
+    Triangles.clear();
+    Nodes.clear();
+    
+    for (const PL_MESH& Mesh : Meshes)
+    {
+        for (int Column = 0; Column < Mesh.Indices.cols(); ++Column)
+        {
+            Triangle NewTriangle;
+            NewTriangle.A = Mesh.Vertices.col(Mesh.Indices(0, Column)).cast<float>();
+            NewTriangle.B = Mesh.Vertices.col(Mesh.Indices(1, Column)).cast<float>();
+            NewTriangle.C = Mesh.Vertices.col(Mesh.Indices(2, Column)).cast<float>();
+            
+            const Eigen::Vector3f Normal = (NewTriangle.B - NewTriangle.A).cross(NewTriangle.C - NewTriangle.A);
+            
+            // Degenerate triangles can't reflect or block anything
+            if (Normal.squaredNorm() < 1e-12f)
+            {
+                continue;
+            }
+            
+            NewTriangle.Normal = Normal.normalized();
+            Triangles.push_back(NewTriangle);
+        }
+    }
+    
+    TriangleOrder.resize(Triangles.size());
+    for (int i = 0; i < TriangleOrder.size(); ++i)
+    {
+        TriangleOrder[i] = i;
+    }
+    
+    if (Triangles.size() > 0)
+    {
+        Nodes.reserve(Triangles.size() * 2 / MaxTrianglesPerLeaf + 1);
+        BuildNode(0, static_cast<int>(Triangles.size()));
+    }
+}
+
+int TriangleBVH::BuildNode(int First, int Count)
+{
+    const int NodeIndex = static_cast<int>(Nodes.size());
+    Nodes.push_back(Node());
+    
+    Eigen::AlignedBox3f Bounds;
+    Eigen::AlignedBox3f CentroidBounds;
+    
+    for (int i = First; i < First + Count; ++i)
+    {
+        const Triangle& Current = Triangles[TriangleOrder[i]];
+        Bounds.extend(Current.A).extend(Current.B).extend(Current.C);
+        CentroidBounds.extend(Eigen::Vector3f((Current.A + Current.B + Current.C) / 3.0f));
+    }
+    
+    Nodes[NodeIndex].Bounds = Bounds;
+    
+    if (Count <= MaxTrianglesPerLeaf)
+    {
+        Nodes[NodeIndex].FirstOrSecondChild = First;
+        Nodes[NodeIndex].Count = Count;
+        return NodeIndex;
+    }
+    
+    // Median split along the widest axis of the centroids
+    int Axis;
+    CentroidBounds.sizes().maxCoeff(&Axis);
+    
+    const int Half = Count / 2;
+    std::nth_element(TriangleOrder.begin() + First, TriangleOrder.begin() + First + Half, TriangleOrder.begin() + First + Count, [this, Axis](int A, int B)
+    {
+        const float CentroidA = Triangles[A].A[Axis] + Triangles[A].B[Axis] + Triangles[A].C[Axis];
+        const float CentroidB = Triangles[B].A[Axis] + Triangles[B].B[Axis] + Triangles[B].C[Axis];
+        return CentroidA < CentroidB;
+    });
+    
+    BuildNode(First, Half);
+    const int SecondChild = BuildNode(First + Half, Count - Half);
+    
+    Nodes[NodeIndex].FirstOrSecondChild = SecondChild;
+    Nodes[NodeIndex].Count = 0;
+    
+    return NodeIndex;
+}
+
+bool TriangleBVH::IntersectTriangle(int TriangleIndex, const Eigen::Vector3f& From, const Eigen::Vector3f& To, float& OutT) const
+{
+    return RayTriangle(Triangles[TriangleIndex], From, To - From, OutT) && OutT > 0.0f && OutT < 1.0f;
+}
+
+bool TriangleBVH::IsBlocked(const Eigen::Vector3f& From, const Eigen::Vector3f& To, int IgnoreA, int IgnoreB) const
+{
+    if (Nodes.size() == 0)
+    {
+        return false;
+    }
+    
+    const Eigen::Vector3f Direction = To - From;
+    const float Length = Direction.norm();
+    
+    if (Length < SurfaceEpsilon)
+    {
+        return false;
+    }
+    
+    // Ignore hits right at either end, where the points sit on the surfaces they reflect from
+    const float MinT = SurfaceEpsilon / Length;
+    const float MaxT = 1.0f - MinT;
+    const Eigen::Vector3f InverseDirection = Direction.cwiseInverse();
+    
+    int Stack[64];
+    int StackSize = 0;
+    Stack[StackSize++] = 0;
+    
+    while (StackSize > 0)
+    {
+        const int NodeIndex = Stack[--StackSize];
+        const Node& Current = Nodes[NodeIndex];
+        
+        if (!RayBox(Current.Bounds, From, InverseDirection, MaxT))
+        {
+            continue;
+        }
+        
+        if (Current.Count > 0)
+        {
+            for (int i = Current.FirstOrSecondChild; i < Current.FirstOrSecondChild + Current.Count; ++i)
+            {
+                const int TriangleIndex = TriangleOrder[i];
+                float T;
+                
+                if (TriangleIndex != IgnoreA && TriangleIndex != IgnoreB && RayTriangle(Triangles[TriangleIndex], From, Direction, T) && T > MinT && T < MaxT)
+                {
+                    return true;
+                }
+            }
+            continue;
+        }
+        
+        Stack[StackSize++] = NodeIndex + 1;
+        Stack[StackSize++] = Current.FirstOrSecondChild;
+    }
+    
+    return false;
+}
+
+void TriangleBVH::FindInConvex(const Eigen::Vector4f* Planes, int PlaneCount, std::vector<int>& OutTriangles) const
+{
+    OutTriangles.clear();
+    
+    if (Nodes.size() == 0)
+    {
+        return;
+    }
+    
+    int Stack[64];
+    int StackSize = 0;
+    Stack[StackSize++] = 0;
+    
+    while (StackSize > 0)
+    {
+        const int NodeIndex = Stack[--StackSize];
+        const Node& Current = Nodes[NodeIndex];
+        
+        bool bOutside = false;
+        for (int i = 0; i < PlaneCount && !bOutside; ++i)
+        {
+            bOutside = !BoxTouchesPlane(Current.Bounds, Planes[i]);
+        }
+        
+        if (bOutside)
+        {
+            continue;
+        }
+        
+        if (Current.Count > 0)
+        {
+            for (int i = Current.FirstOrSecondChild; i < Current.FirstOrSecondChild + Current.Count; ++i)
+            {
+                const int TriangleIndex = TriangleOrder[i];
+                
+                bool bTriangleOutside = false;
+                for (int j = 0; j < PlaneCount && !bTriangleOutside; ++j)
+                {
+                    bTriangleOutside = !TriangleTouchesPlane(Triangles[TriangleIndex], Planes[j]);
+                }
+                
+                if (!bTriangleOutside)
+                {
+                    OutTriangles.push_back(TriangleIndex);
+                }
+            }
+            continue;
+        }
+        
+        Stack[StackSize++] = NodeIndex + 1;
+        Stack[StackSize++] = Current.FirstOrSecondChild;
+    }
+}
+
+const TriangleBVH::Triangle& TriangleBVH::GetTriangle(int TriangleIndex) const
+{
+    return Triangles[TriangleIndex];
+}
+
+int TriangleBVH::GetTriangleCount() const
+{
+    return static_cast<int>(Triangles.size());
+}
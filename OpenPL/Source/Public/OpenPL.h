@@ -23,10 +23,28 @@ extern "C"
      *
      * In the example of Unity, you could create a method that takes the message and calls Debug.Log to output the message.
      *
+     * Messages are queued rather than passed straight to the callback, so the callback is only called from PL_Debug_Flush.
+     *
      * @param Callback Pointer to a function with the PL_Debug_Callback signature.
     */
     PL_RESULT JUCE_PUBLIC_FUNCTION PL_Debug_Initialize (PL_Debug_Callback Callback);
 
+    /**
+     * Sets the lowest level of message to log. Anything below it is thrown away before it's formatted, so it costs nearly nothing.
+     *
+     * Defaults to PL_DEBUG_LEVEL_LOG. Verbose messages only exist in debug builds of OpenPL.
+     *
+     * @param MinimumLevel Lowest level to log. PL_DEBUG_LEVEL_OFF turns off every message.
+    */
+    PL_RESULT JUCE_PUBLIC_FUNCTION PL_Debug_SetLevel (PL_DEBUG_LEVEL MinimumLevel);
+
+    /**
+     * Passes every queued debug message to the callback, on the calling thread.
+     *
+     * Should be called regularly, like once a frame from the game thread. The queue holds a few hundred messages, and any logged while it's full are dropped.
+    */
+    PL_RESULT JUCE_PUBLIC_FUNCTION PL_Debug_Flush ();
+
     /**
      * Creates a system object.
      * System objects are management objects for the simulation.
@@ -72,6 +90,29 @@ extern "C"
      * @param OutScene Created scene.
     */
     PL_RESULT JUCE_PUBLIC_FUNCTION PL_System_CreateScene(PL_SYSTEM* System, PL_SCENE** OutScene);
+    
+    /**
+     * Sets the threads voxel and simulation work is split between. Affects every scene in the process, not just this system's.
+     *
+     * @param System System object.
+     * @param MaxThreads Threads to split work between. 0 for one per hardware thread.
+     * @param PinThreads Pins each worker to one core, with the workers split between the NUMA nodes in contiguous runs,
+     * so each worker stays on the NUMA node holding the lattice slabs it first touched.
+     * Worth turning on for multi socket machines that run nothing else. Ignored on macOS.
+     */
+    PL_RESULT JUCE_PUBLIC_FUNCTION PL_System_SetParallelThreads(PL_SYSTEM* System, int MaxThreads, bool PinThreads);
+    
+    /**
+     * Measures how a memory bound sweep over a lattice scales from 1 thread up to every hardware thread, on a lattice zeroed by one thread
+     * and on one each worker zeroed its own slabs of, like PL_Scene_CreateVoxels. Every thread count is logged.
+     * On a multi socket machine the lattice zeroed by one thread stops scaling once the workers spill onto the second socket.
+     *
+     * @param System System object.
+     * @param VoxelsInSide Side of the cube of voxels. Should be big enough to not fit in cache, 200 is 384MB.
+     * @param OutFirstTouchSpeedup How many times faster every hardware thread is than one, on the lattice each worker zeroed.
+     * @param OutSerialTouchSpeedup How many times faster every hardware thread is than one, on the lattice one thread zeroed.
+     */
+    PL_RESULT JUCE_PUBLIC_FUNCTION PL_System_BenchmarkThreadScaling(PL_SYSTEM* System, int VoxelsInSide, float* OutFirstTouchSpeedup, float* OutSerialTouchSpeedup);
 
     /**
      * Releases and destroys a scene object.
@@ -114,6 +155,94 @@ extern "C"
      */
     PL_RESULT JUCE_PUBLIC_FUNCTION PL_Scene_RemoveMesh(PL_SCENE* Scene, int IndexToRemove);
     
+    /**
+     * Adds terrain as a grid of heights instead of a triangle mesh. Heightfields are voxelised by filling each column up to the terrain,
+     * so they cost one interpolation per column and don't need to be closed solids like meshes do.
+     * Only the voxels see heightfields. Ray traced reflections in PL_Scene_GetImpulseResponse only hit meshes.
+     *
+     * @param Scene Scene to add the terrain to.
+     * @param Origin World position of the first height sample. Heights are added to its Y.
+     * @param Spacing Distance between samples along X and Z.
+     * @param Rows Samples along Z. At least 2.
+     * @param Columns Samples along X. At least 2.
+     * @param Heights Rows * Columns heights, one row of Columns after another. Copied, so it can be freed straight after.
+     * @param Absorptivity 0-1 absorptivity of the terrain.
+     * @param OutIndex If successful, the index the heightfield is stored at for later removal.
+     */
+    PL_RESULT JUCE_PUBLIC_FUNCTION PL_Scene_AddHeightfield(PL_SCENE* Scene, PLVector Origin, float Spacing, int Rows, int Columns, const float* Heights, float Absorptivity, int* OutIndex);
+    
+    /**
+     * Removes terrain added with PL_Scene_AddHeightfield. Takes effect the next time the voxels are filled.
+     *
+     * @param Scene Scene to remove the terrain from.
+     * @param IndexToRemove Index from PL_Scene_AddHeightfield.
+     */
+    PL_RESULT JUCE_PUBLIC_FUNCTION PL_Scene_RemoveHeightfield(PL_SCENE* Scene, int IndexToRemove);
+    
+    /**
+     * Adds a box that's voxelised from its shape instead of from triangles. A voxel is filled if its centre is inside, which is a few
+     * multiplies per voxel and can't leak like a mesh with gaps. Use primitives for simple collision like crates, walls and pillars.
+     * Only the voxels see primitives. Ray traced reflections in PL_Scene_GetImpulseResponse only hit meshes.
+     *
+     * @param Scene Scene to add the box to.
+     * @param Position World position of the centre of the box.
+     * @param Rotation World rotation of the box.
+     * @param HalfExtents Half the size of the box along each of its axes.
+     * @param Absorptivity 0-1 absorptivity of the box.
+     * @param OutIndex If successful, the index the primitive is stored at for PL_Scene_RemovePrimitive.
+     */
+    PL_RESULT JUCE_PUBLIC_FUNCTION PL_Scene_AddBox(PL_SCENE* Scene, PLVector Position, PLQuaternion Rotation, PLVector HalfExtents, float Absorptivity, int* OutIndex);
+    
+    /**
+     * Adds a sphere that's voxelised from its shape. See PL_Scene_AddBox.
+     *
+     * @param Scene Scene to add the sphere to.
+     * @param Position World position of the centre of the sphere.
+     * @param Radius Radius of the sphere.
+     * @param Absorptivity 0-1 absorptivity of the sphere.
+     * @param OutIndex If successful, the index the primitive is stored at for PL_Scene_RemovePrimitive.
+     */
+    PL_RESULT JUCE_PUBLIC_FUNCTION PL_Scene_AddSphere(PL_SCENE* Scene, PLVector Position, float Radius, float Absorptivity, int* OutIndex);
+    
+    /**
+     * Adds a capsule that's voxelised from its shape. See PL_Scene_AddBox.
+     *
+     * @param Scene Scene to add the capsule to.
+     * @param Position World position of the centre of the capsule.
+     * @param Rotation World rotation of the capsule. Unrotated, its length runs along Y.
+     * @param Radius Radius of the capsule.
+     * @param HalfHeight Half the distance between the centres of the two end caps. 0 makes a sphere.
+     * @param Absorptivity 0-1 absorptivity of the capsule.
+     * @param OutIndex If successful, the index the primitive is stored at for PL_Scene_RemovePrimitive.
+     */
+    PL_RESULT JUCE_PUBLIC_FUNCTION PL_Scene_AddCapsule(PL_SCENE* Scene, PLVector Position, PLQuaternion Rotation, float Radius, float HalfHeight, float Absorptivity, int* OutIndex);
+    
+    /**
+     * Adds a convex hull that's voxelised from the planes of its faces. See PL_Scene_AddBox.
+     * The triangles must already be a closed convex hull, like a physics engine's convex collision. Either winding works.
+     *
+     * @param Scene Scene to add the hull to.
+     * @param Position World position of the hull.
+     * @param Rotation World rotation of the hull.
+     * @param Scale World scale of the hull.
+     * @param Vertices Pointer to the start of the hull's vertices. Copied, so it can be freed straight after.
+     * @param VerticesLength Length of the vertices array. At least 4.
+     * @param Indices Pointer to the start of the hull's triangle indices. Copied, so it can be freed straight after.
+     * @param IndicesLength Length of the indices array. At least 12.
+     * @param Absorptivity 0-1 absorptivity of the hull.
+     * @param OutIndex If successful, the index the primitive is stored at for PL_Scene_RemovePrimitive.
+     */
+    PL_RESULT JUCE_PUBLIC_FUNCTION PL_Scene_AddConvexHull(PL_SCENE* Scene, PLVector Position, PLQuaternion Rotation, PLVector Scale, PLVector* Vertices, int VerticesLength, int* Indices, int IndicesLength, float Absorptivity, int* OutIndex);
+    
+    /**
+     * Removes a box, sphere, capsule or convex hull from the scene. Takes effect the next time the voxels are filled.
+     * Indices after the removed primitive move down by one.
+     *
+     * @param Scene Scene to remove the primitive from.
+     * @param IndexToRemove Index from adding the primitive.
+     */
+    PL_RESULT JUCE_PUBLIC_FUNCTION PL_Scene_RemovePrimitive(PL_SCENE* Scene, int IndexToRemove);
+    
     /**
      * Takes all the geometry in the scene and fills the voxels with the correct values.
      *
@@ -167,25 +296,189 @@ extern "C"
     /**
      * Using the previously passed geometry, emitter locations and listener locations, simulate over the scene and store the resulting simulation data to disk.
      *
+     * Returns PL_ERR if the simulation fails, like when the leapfrog scheme can't store every kind of wall in the voxels. The last simulation is discarded.
+     *
      * @param Scene Scene to run the simulation over.
      */
     PL_RESULT JUCE_PUBLIC_FUNCTION PL_Scene_Simulate(PL_SCENE* Scene, PLVector SimulationLocation);
     
     /**
-     * Opens a new OpenGL window and displays the meshes contained within the scene.
-     * WARNING: Rendering must happen on the main thread, therefore the game will pause while the debug window is open.
-     * WARNING: Context doesn't properly return to the game. You'll likely need to force quit the engine when exiting.
-     * This method won't be included in release versions for this reason. The method is purely for debugging during development.
+     * The simulation runs at the largest time step that is stable for the voxel size, so bigger voxels give a lower sampling rate.
+     * The highest frequency simulated also drops when the voxels are too big to resolve the requested one.
+     *
+     * @param Scene Scene that has been simulated.
+     * @param OutSamplingRate Time steps per second of the last simulation.
+     * @param OutMaxFrequency Highest frequency in Hz the last simulation carries.
+     */
+    PL_RESULT JUCE_PUBLIC_FUNCTION PL_Scene_GetSimulationRate(PL_SCENE* Scene, float* OutSamplingRate, float* OutMaxFrequency);
+    
+    /**
+     * Picks the scheme the next PL_Scene_Simulate runs with. Higher order schemes reach the same frequency on bigger voxels.
+     *
+     * @param Scene Scene to simulate.
+     * @param Scheme Scheme to use. PL_SIMULATION_SCHEME_FDTD by default.
+     */
+    PL_RESULT JUCE_PUBLIC_FUNCTION PL_Scene_SetSimulationScheme(PL_SCENE* Scene, PL_SIMULATION_SCHEME Scheme);
+    
+    /**
+     * Picks how the next PL_Scene_Simulate stores its state between time steps. Smaller types move less memory on lattices too big for the cache.
+     * Half floats need a build with F16C (-march=native or -mf16c) to be faster than float.
+     *
+     * @param Scene Scene to simulate.
+     * @param Precision Storage type. PL_SIMULATION_PRECISION_DOUBLE by default. Only PL_SIMULATION_SCHEME_LEAPFROG uses anything else,
+     * so a warning is logged while another scheme is picked.
+     */
+    PL_RESULT JUCE_PUBLIC_FUNCTION PL_Scene_SetSimulationPrecision(PL_SCENE* Scene, PL_SIMULATION_PRECISION Precision);
+    
+    /**
+     * Lets PL_Scene_Simulate reuse the last simulation when the simulation location only moves a small distance.
+     * The last simulation is shifted to the new location instead of simulating from scratch.
+     * Once the location is further than MaxDistance from the last full simulation, a full simulation runs again.
+     *
+     * @param Scene Scene to set the warm start distance for.
+     * @param MaxDistance Distance in meters. 0 disables warm starting (the default).
+     */
+    PL_RESULT JUCE_PUBLIC_FUNCTION PL_Scene_SetWarmStartDistance(PL_SCENE* Scene, float MaxDistance);
+    
+    /**
+     * Simplifies meshes before they're voxelised. Render meshes carry detail like bolts, trim and bevels that's far smaller than a voxel,
+     * but every triangle costs time in the inside tests. Edges are collapsed until the surface would move more than MaxErrorInVoxels,
+     * degenerate triangles are dropped, and so are separate pieces smaller than half a voxel.
+     *
+     * Simplification runs when the voxels are filled, one asset per thread. Meshes added with the same vertices and indices are the same asset
+     * and share one simplified copy, until the voxel size or error changes. Ray tracing in PL_Scene_GetImpulseResponse still uses the full meshes.
+     *
+     * @param Scene Scene to simplify the meshes of.
+     * @param bEnabled Off by default.
+     * @param MaxErrorInVoxels Furthest the surface can move as a fraction of the voxel size. Greater than 0 and up to 1. 0.1 by default.
+     */
+    PL_RESULT JUCE_PUBLIC_FUNCTION PL_Scene_SetMeshSimplification(PL_SCENE* Scene, bool bEnabled, float MaxErrorInVoxels);
+    
+    /**
+     * Picks how meshes are voxelised the next time the voxels are filled.
+     * PL_VOXELISATION_MODE_WINDING_NUMBER copes with meshes that aren't closed, which game meshes often aren't, and the exact tests throw on or get wrong.
+     * It works out the generalised winding number at each voxel centre from a tree of the mesh's triangles, a few voxels at a time on every thread.
+     *
+     * @param Scene Scene to voxelise.
+     * @param Mode Mode to use. PL_VOXELISATION_MODE_EXACT by default.
+     */
+    PL_RESULT JUCE_PUBLIC_FUNCTION PL_Scene_SetVoxelisationMode(PL_SCENE* Scene, PL_VOXELISATION_MODE Mode);
+    
+    /**
+     * Measures the error and speed of a warm started simulation against a full simulation.
+     * Runs a full simulation at FromLocation, warm starts to ToLocation, then runs a full simulation at ToLocation to compare against.
+     *
+     * @param Scene Scene to benchmark.
+     * @param FromLocation Location of the first full simulation.
+     * @param ToLocation Location to move the simulation to.
+     * @param OutRelativeError Relative L2 error of the warm started pressure responses.
+     * @param OutSpeedup How many times faster the warm start was.
+     */
+    PL_RESULT JUCE_PUBLIC_FUNCTION PL_Scene_BenchmarkWarmStart(PL_SCENE* Scene, PLVector FromLocation, PLVector ToLocation, float* OutRelativeError, float* OutSpeedup);
+    
+    /**
+     * Starts writing the air pressure to disk every few time steps of each simulation, for viewing in ParaView or other VTK tools.
+     * Frames are VTK images written on a background thread, so the whole simulation history never has to be kept.
+     * Frames are FilePrefix_<time step>.vti. FilePrefix.pvd lists them all once recording stops.
+     *
+     * @param Scene Scene to record. Voxels must already be created.
+     * @param FilePrefix Path and start of the file names.
+     * @param Interval Time steps between frames.
+     * @param Stride Keep every Stride-th voxel along each axis. 1 keeps every voxel.
+     * @param Region Whole lattice or a single plane.
+     * @param PlaneIndex Voxel index along the plane's axis. Ignored for PL_SNAPSHOT_REGION_VOLUME.
+     * @param Precision Float32, or float16 for half the size.
+     */
+    PL_RESULT JUCE_PUBLIC_FUNCTION PL_Scene_StartSnapshotRecording(PL_SCENE* Scene, const char* FilePrefix, int Interval, int Stride, PL_SNAPSHOT_REGION Region, int PlaneIndex, PL_SNAPSHOT_PRECISION Precision);
+    
+    /**
+     * Finishes writing any queued frames and writes the collection file.
+     *
+     * @param Scene Scene to stop recording.
+     */
+    PL_RESULT JUCE_PUBLIC_FUNCTION PL_Scene_StopSnapshotRecording(PL_SCENE* Scene);
+    
+    /**
+     * Opens a new OpenGL window and displays the meshes and voxels contained within the scene. Returns straight away.
+     * It updates as the scene is voxelised and simulated. Calling this again while the window is open does nothing.
+     * GLFW only works on the main thread, so this must be called from the main thread, and PL_Scene_DebugUpdate must be called from it every frame to draw the window.
+     * The method is purely for debugging during development.
      *
      * @param Scene Scene to render.
+     * @see PL_Scene_DebugUpdate
      */
     PL_RESULT JUCE_PUBLIC_FUNCTION PL_Scene_Debug(PL_SCENE* Scene);
     
+    /**
+     * Draws the debug window opened by PL_Scene_Debug and handles its input. Returns straight away, and does nothing if the window isn't open.
+     * Must be called from the main thread, like once a frame. The scene must also be released on the main thread while the window is open.
+     *
+     * @param Scene Scene whose window to draw.
+     */
+    PL_RESULT JUCE_PUBLIC_FUNCTION PL_Scene_DebugUpdate(PL_SCENE* Scene);
+    
+    /**
+     * Automatically places listener probes in the scene and adds them as listener locations.
+     * Voxels must be filled with geometry first.
+     *
+     * @param Scene Scene to place probes in.
+     * @param Placement Whether to place probes uniformly on walkable voxels, add more where there's lots of geometry, or only fill the air reachable from the seeds.
+     * @param Spacing Distance in meters between probes. The spacing grows if the probes don't fit in MaxProbes.
+     * @param Seeds Locations the player can reach, like spawn points. Only used for seeded placement. Can be null to use the system's listener position.
+     * @param SeedsLength Number of seeds.
+     * @param MaxProbes Maximum number of probes to add.
+     * @param OutProbeCount Number of probes added.
+     * @see PL_Scene_BakeProbes
+     */
+    PL_RESULT JUCE_PUBLIC_FUNCTION PL_Scene_GenerateProbes(PL_SCENE* Scene, PL_PROBE_PLACEMENT Placement, float Spacing, PLVector* Seeds, int SeedsLength, int MaxProbes, int* OutProbeCount);
+    
+    /**
+     * Simulates every listener location in the scene and stores the occlusion from each one to every voxel.
+     * WARNING: Runs one full simulation per listener location and blocks until finished. Bake offline, not during gameplay.
+     *
+     * @param Scene Scene to bake.
+     * @see PL_Scene_GetBakedOcclusion
+     */
+    PL_RESULT JUCE_PUBLIC_FUNCTION PL_Scene_BakeProbes(PL_SCENE* Scene);
+    
+    /**
+     * Get the occlusion of an emitter by blending the baked probes nearest to the system's listener position.
+     * Much cheaper than PL_Scene_Simulate and PL_Scene_GetOcclusion, but only as accurate as the probe spacing.
+     * Returns PL_ERR if the probes haven't been baked since the voxels were last created or filled.
+     *
+     * @param Scene Scene with baked probes.
+     * @param EmitterLocation Location of the emitter.
+     * @param OutOcclusion 1 = unoccluded, 0 = fully occluded.
+     */
+    PL_RESULT JUCE_PUBLIC_FUNCTION PL_Scene_GetBakedOcclusion(PL_SCENE* Scene, PLVector EmitterLocation, float* OutOcclusion);
+    
     PL_RESULT JUCE_PUBLIC_FUNCTION PL_Scene_GetVoxelsCount(PL_SCENE* Scene, int* OutVoxelCount);
     
     PL_RESULT JUCE_PUBLIC_FUNCTION PL_Scene_GetVoxelLocation(PL_SCENE* Scene, PLVector* OutVoxelLocation, int Index);
     
     PL_RESULT JUCE_PUBLIC_FUNCTION PL_Scene_GetVoxelAbsorpivity(PL_SCENE* Scene, float* OutAbsorpivity, int Index);
+    
+    /**
+     * Get the distance from a location to the nearest geometry, measured between voxel centers.
+     * The distance field is calculated when the voxels are filled with geometry.
+     *
+     * @param Scene Scene with filled voxels.
+     * @param Location World location to look up.
+     * @param OutDistance Distance in meters. The largest float if there is no geometry in the lattice.
+     * @see PL_Scene_FillVoxelsWithGeometry
+     */
+    PL_RESULT JUCE_PUBLIC_FUNCTION PL_Scene_GetDistanceToGeometry(PL_SCENE* Scene, PLVector Location, float* OutDistance);
+    
+    /**
+     * Get the region of connected air a voxel belongs to.
+     * Regions not connected to the simulated location, a listener location or a source location are inactive and are not simulated.
+     *
+     * @param Scene Scene with filled voxels.
+     * @param OutRegion Region of the voxel, starting at 1. 0 if the voxel is geometry.
+     * @param OutActive Whether the voxel was simulated in the last simulation.
+     * @param Index Index of the voxel.
+     */
+    PL_RESULT JUCE_PUBLIC_FUNCTION PL_Scene_GetVoxelRegion(PL_SCENE* Scene, int* OutRegion, bool* OutActive, int Index);
 
     /**
      * Render a graph with MatPlot++ at a location in the scene.
@@ -208,6 +501,124 @@ extern "C"
      */
     PL_RESULT JUCE_PUBLIC_FUNCTION PL_Scene_GetOcclusion(PL_SCENE* Scene, PLVector EmitterLocation, float* OutOcclusion);
     
+    /**
+     * Estimates occlusion for many emitters by marching a ray from the listener to each one through the voxels and measuring how much geometry is in the way.
+     * Costs well under a microsecond per emitter and doesn't need a simulation, so it can run for every emitter every frame as a first estimate.
+     * Only the part of each ray inside the voxel lattice is checked.
+     *
+     * @param Scene Scene with filled voxels. Every emitter is unoccluded until the voxels are filled.
+     * @param EmitterLocations Locations of the emitters.
+     * @param EmitterLocationsLength Number of emitters.
+     * @param OutOcclusions Array with one value per emitter. 1 = unoccluded, 0 = fully occluded.
+     */
+    PL_RESULT JUCE_PUBLIC_FUNCTION PL_Scene_TraceOcclusion(PL_SCENE* Scene, PLVector* EmitterLocations, int EmitterLocationsLength, float* OutOcclusions);
+    
+    /**
+     * Builds a full band impulse response from the listener to an emitter.
+     * The wave simulation only resolves low frequencies, so early reflections above its max frequency are found with image sources traced against the scene meshes.
+     * The two bands are crossed over at the simulation's max frequency.
+     *
+     * @param Scene Scene that has been simulated from the listener location.
+     * @param EmitterLocation Location of the emitter.
+     * @param MaxReflectionOrder Number of bounces to find for the high frequencies. Clamped to 3.
+     * @param SampleRate Sampling rate of the response, like 48000.
+     * @param OutResponse Array to write the response to. A direct path of 1 meter has a peak of about 1.
+     * @param ResponseLength Length of OutResponse.
+     */
+    PL_RESULT JUCE_PUBLIC_FUNCTION PL_Scene_GetImpulseResponse(PL_SCENE* Scene, PLVector EmitterLocation, int MaxReflectionOrder, int SampleRate, float* OutResponse, int ResponseLength);
+    
+    /**
+     * Solves the steady state pressure of a source at a few frequencies over the whole 3D lattice, instead of running a pulse through time.
+     * Much cheaper than a simulation for static occlusion maps. The pressure is read at every listener location, which includes generated probes.
+     * The phase drifts above c / (6 * VoxelSize), so keep the frequencies below that.
+     *
+     * @param Scene Scene with filled voxels.
+     * @param SourceLocation Location of the source.
+     * @param Frequencies Frequencies in Hz to solve at.
+     * @param FrequenciesLength Number of frequencies.
+     * @param OutReal Array for the real part of the pressure, ordered by frequency then listener. The free field has a magnitude of 1 a meter from the source.
+     * @param OutImaginary Array for the imaginary part of the pressure, in the same order.
+     * @param OutLength Length of OutReal and OutImaginary. At least FrequenciesLength times the number of listener locations.
+     * @return PL_ERR if a solve didn't converge. The best pressure found is still written.
+     */
+    PL_RESULT JUCE_PUBLIC_FUNCTION PL_Scene_SolveFrequencyResponse(PL_SCENE* Scene, PLVector SourceLocation, float* Frequencies, int FrequenciesLength, float* OutReal, float* OutImaginary, int OutLength);
+    
+    /**
+     * Finds the shortest paths around geometry from the listener to every voxel.
+     * Much cheaper than a simulation and covers the whole lattice in 3D. Call again when the listener moves.
+     *
+     * @param Scene Scene with filled voxels.
+     */
+    PL_RESULT JUCE_PUBLIC_FUNCTION PL_Scene_UpdateGeodesicField(PL_SCENE* Scene);
+    
+    /**
+     * Get the shortest path around geometry from the listener to an emitter. Reads the last geodesic field, so is cheap enough to call for every emitter every frame.
+     * Use the direction to pan emitters to the doorway they are heard through, and the extra distance over the straight line for attenuation.
+     *
+     * @param Scene Scene with an updated geodesic field.
+     * @param EmitterLocation Location of the emitter.
+     * @param OutDistance Length of the path in meters. The straight line distance if the emitter can't be reached through the air.
+     * @param OutDirection Unit direction the path leaves the listener in.
+     */
+    PL_RESULT JUCE_PUBLIC_FUNCTION PL_Scene_GetGeodesicPath(PL_SCENE* Scene, PLVector EmitterLocation, float* OutDistance, PLVector* OutDirection);
+    
+    /**
+     * Filling the voxels also splits the air into rooms joined by portals, like doorways and windows.
+     * The graph is small enough to search at runtime, and per room data like reverb can be attached to each room.
+     *
+     * @param Scene Scene with filled voxels.
+     * @param OutRoomCount Number of rooms.
+     * @param OutPortalCount Number of portals.
+     */
+    PL_RESULT JUCE_PUBLIC_FUNCTION PL_Scene_GetRoomGraphSize(PL_SCENE* Scene, int* OutRoomCount, int* OutPortalCount);
+    
+    /**
+     * @param Scene Scene with filled voxels.
+     * @param Location World location to look up.
+     * @param OutRoom Room the location is in. -1 if it's in geometry or outside the voxels.
+     */
+    PL_RESULT JUCE_PUBLIC_FUNCTION PL_Scene_GetRoom(PL_SCENE* Scene, PLVector Location, int* OutRoom);
+    
+    /**
+     * @param Scene Scene with filled voxels.
+     * @param PortalIndex Portal to get. (0 =< PortalIndex < Portal Count)
+     * @param OutRoomA One of the rooms the portal joins.
+     * @param OutRoomB The other room the portal joins.
+     * @param OutPosition Center of the opening.
+     * @param OutArea Area of the opening in square meters.
+     */
+    PL_RESULT JUCE_PUBLIC_FUNCTION PL_Scene_GetPortal(PL_SCENE* Scene, int PortalIndex, int* OutRoomA, int* OutRoomB, PLVector* OutPosition, float* OutArea);
+    
+    /**
+     * Finds the shortest route between two locations through the portals of the room graph.
+     *
+     * @param Scene Scene with filled voxels.
+     * @param From Start of the route.
+     * @param To End of the route.
+     * @param OutPortals Array to write the portals on the route to, in order from From.
+     * @param MaxPortals Length of OutPortals.
+     * @param OutPortalCount Number of portals on the route. Can be more than MaxPortals.
+     * @param OutDistance Length of the route in meters.
+     */
+    PL_RESULT JUCE_PUBLIC_FUNCTION PL_Scene_FindRoomPath(PL_SCENE* Scene, PLVector From, PLVector To, int* OutPortals, int MaxPortals, int* OutPortalCount, float* OutDistance);
+    
+    /**
+     * Runs a whole buffer of commands in one call, instead of one exported call per mesh, listener, emitter or query.
+     * Each command is a PL_COMMAND_HEADER followed by its arguments, laid out back to back. See PL_COMMAND for the arguments of each.
+     * From C++, OpenPL::PLCommandBuffer records them.
+     *
+     * The buffer is checked before anything runs, so a malformed buffer changes nothing.
+     *
+     * @param Scene Scene to run the commands against.
+     * @param Commands Start of the buffer. Must be 4 byte aligned. Owned by the caller.
+     * @param CommandsLength Bytes in the buffer.
+     * @param OutResults One result per command, in the order they were recorded. Owned by the caller.
+     * @param ResultsLength Length of OutResults. Must be at least the number of commands.
+     * @param OutCommandCount Number of commands in the buffer.
+     * @return PL_ERR_INVALID_PARAM if the buffer is malformed or OutResults is too short. PL_OK otherwise, even if single commands failed.
+     */
+    PL_RESULT JUCE_PUBLIC_FUNCTION PL_Scene_ExecuteCommands(PL_SCENE* Scene, void* Commands, int CommandsLength, PL_COMMAND_RESULT* OutResults, int ResultsLength, int* OutCommandCount);
+    
 #ifdef __cplusplus
 }
 #endif
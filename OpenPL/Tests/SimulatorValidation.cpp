@@ -0,0 +1,970 @@
+/*
+  ==============================================================================
+  
+    SimulatorValidation.cpp
+    Created: 18 Oct 2026 10:02:36pm
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#include "SimulatorValidation.h"
+#include "Simulators/SimulatorFDTD.h"
+#include "Simulators/SimulatorFDTD4.h"
+#include "Simulators/SimulatorLeapfrog.h"
+#include "Simulators/SimulatorADI.h"
+#include "HelmholtzSolver.h"
+#include "MeshSimplifier.h"
+#include "FastWindingNumber.h"
+#include <boost/timer/timer.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <memory>
+
+namespace
+{
+    const double Pi = 3.14159265358979323846;
+    
+    /** Absorptivity is the pressure reflection coefficient of a wall, so 1 is rigid*/
+    const double RigidWall = 1.0;
+    
+    struct ValidationGrid
+    {
+        PL_VOXEL_GRID Grid;
+        
+        /**
+         * Lattices are one voxel thick, the plane the simulators run in.
+         * The default voxel size is about 8 voxels per wavelength at the top of the pulse, where every scheme should agree.
+         */
+        ValidationGrid(int XSize, int ZSize, float VoxelSize = 0.15f)
+        {
+            Grid.Size << XSize, 1, ZSize;
+            Grid.VoxelSize = VoxelSize;
+            Grid.Bounds = Eigen::AlignedBox<double, 3>(Eigen::Vector3d::Zero(), Eigen::Vector3d(XSize, 1, ZSize));
+            
+            PLVoxel Air = PLVoxel();
+            Air.Beta = 1;
+            Grid.Voxels.assign(XSize * ZSize, Air);
+        }
+        
+        int Index(int X, int Z) const
+        {
+            return ThreeDimToOneDim(X, 0, Z, Grid.Size(0,0), 1);
+        }
+        
+        void SetWall(int X, int Z, double Absorptivity)
+        {
+            Grid.Voxels[Index(X, Z)].Beta = 0;
+            Grid.Voxels[Index(X, Z)].Absorptivity = Absorptivity;
+        }
+    };
+    
+    std::unique_ptr<Simulator> Simulate(Simulator* (*Create)(), PL_SIMULATION_PRECISION Precision, ValidationGrid& Lattice, int SourceIndex, int TimeSteps)
+    {
+        std::unique_ptr<Simulator> Result (Create());
+        
+        PL_SIMULATION_SETTINGS Settings;
+        Settings.Resolution = Low;
+        Settings.TimeSteps = TimeSteps;
+        Settings.Precision = Precision;
+        
+        Result->Init(nullptr, Lattice.Grid, Settings);
+        Result->Simulate(SourceIndex);
+        return Result;
+    }
+    
+    std::vector<double> GetResponse(const Simulator& Simulated, int VoxelIndex)
+    {
+        const std::vector<PLVoxel>& Voxels = Simulated.GetSimulatedLattice()[VoxelIndex];
+        std::vector<double> Response (Voxels.size());
+        
+        for (int i = 0; i < Voxels.size(); ++i)
+        {
+            Response[i] = Voxels[i].AirPressure;
+        }
+        
+        return Response;
+    }
+    
+    /**
+     * Finds the largest peak within [Begin, End), refined to between samples with a parabola through its neighbours.
+     */
+    void FindPeak(const std::vector<double>& Response, int Begin, int End, double& OutTime, double& OutAmplitude)
+    {
+        int Peak = Begin;
+        
+        for (int i = Begin; i < End; ++i)
+        {
+            if (std::abs(Response[i]) > std::abs(Response[Peak]))
+            {
+                Peak = i;
+            }
+        }
+        
+        OutTime = Peak;
+        OutAmplitude = std::abs(Response[Peak]);
+        
+        if (Peak <= 0 || Peak + 1 >= Response.size())
+        {
+            return;
+        }
+        
+        const double Before = std::abs(Response[Peak - 1]);
+        const double After = std::abs(Response[Peak + 1]);
+        const double Curvature = Before - 2.0 * OutAmplitude + After;
+        
+        if (Curvature < 0.0)
+        {
+            const double Offset = 0.5 * (Before - After) / Curvature;
+            OutTime += Offset;
+            OutAmplitude -= 0.25 * (Before - After) * Offset;
+        }
+    }
+    
+    /**
+     * Finds the strongest frequency between two bounds, in cycles per time step, from a Hann windowed DFT without the mean.
+     */
+    double FindSpectralPeak(const std::vector<double>& Response, double MinFrequency, double MaxFrequency)
+    {
+        const int Length = static_cast<int>(Response.size());
+        double Mean = 0.0;
+        
+        for (double Sample : Response)
+        {
+            Mean += Sample / Length;
+        }
+        
+        // Far finer than the DFT bins, so the peak is found well inside its main lobe
+        const int Steps = 2000;
+        double BestFrequency = MinFrequency;
+        double BestPower = -1.0;
+        
+        for (int Step = 0; Step <= Steps; ++Step)
+        {
+            const double Frequency = MinFrequency + (MaxFrequency - MinFrequency) * Step / Steps;
+            double Real = 0.0;
+            double Imaginary = 0.0;
+            
+            for (int i = 0; i < Length; ++i)
+            {
+                const double Window = 0.5 - 0.5 * std::cos(2.0 * Pi * i / (Length - 1));
+                const double Sample = (Response[i] - Mean) * Window;
+                Real += Sample * std::cos(2.0 * Pi * Frequency * i);
+                Imaginary -= Sample * std::sin(2.0 * Pi * Frequency * i);
+            }
+            
+            const double Power = Real * Real + Imaginary * Imaginary;
+            
+            if (Power > BestPower)
+            {
+                BestPower = Power;
+                BestFrequency = Frequency;
+            }
+        }
+        
+        return BestFrequency;
+    }
+    
+    /**
+     * Cuts every response down to its first Steps time steps.
+     */
+    std::vector<std::vector<double>> EarlyResponses(const std::vector<std::vector<double>>& Full, int Steps)
+    {
+        std::vector<std::vector<double>> Result;
+        
+        for (const std::vector<double>& Response : Full)
+        {
+            Result.emplace_back(Response.begin(), Response.begin() + std::min(Steps, static_cast<int>(Response.size())));
+        }
+        
+        return Result;
+    }
+    
+    /** Schemes disperse differently, so after enough trips around the room their high modes drift out of phase. Compare the first few trips*/
+    const int RoomComparisonSteps = 256;
+    
+    Simulator* CreateFDTD()
+    {
+        return new SimulatorFDTD();
+    }
+    
+    double SecondOrderDispersion(double Courant, double Wavenumber)
+    {
+        return 2.0 * std::asin(Courant * std::sin(Wavenumber / 2.0));
+    }
+    
+    Simulator* CreateFDTD4()
+    {
+        return new SimulatorFDTD4();
+    }
+    
+    Simulator* CreateLeapfrog()
+    {
+        return new SimulatorLeapfrog();
+    }
+    
+    double FourthOrderDispersion(double Courant, double Wavenumber)
+    {
+        return 2.0 * std::asin(Courant * (9.0 / 8.0 * std::sin(Wavenumber / 2.0) - 1.0 / 24.0 * std::sin(3.0 * Wavenumber / 2.0)));
+    }
+    
+    Simulator* CreateADI()
+    {
+        return new SimulatorADI();
+    }
+    
+    /** The implicit half of the step turns the leapfrog's sine into a tangent, so it's defined at any Courant number*/
+    double ADIDispersion(double Courant, double Wavenumber)
+    {
+        return 2.0 * std::atan(Courant * std::sin(Wavenumber / 2.0));
+    }
+    
+    /** Triangle soup built up a shape at a time, converted to matrices once it's done*/
+    struct ValidationMesh
+    {
+        std::vector<Eigen::Vector3d> Vertices;
+        std::vector<std::array<int, 3>> Triangles;
+        
+        /**
+         * Adds a box with each face its own Divisions x Divisions grid, so the seams are split like a render mesh's.
+         */
+        void AddBox(const Eigen::Vector3d& Centre, const Eigen::Vector3d& HalfSize, int Divisions)
+        {
+            for (int Axis = 0; Axis < 3; ++Axis)
+            {
+                for (int Side = -1; Side <= 1; Side += 2)
+                {
+                    const int U = (Axis + 1) % 3;
+                    const int V = (Axis + 2) % 3;
+                    const int First = static_cast<int>(Vertices.size());
+                    
+                    for (int i = 0; i <= Divisions; ++i)
+                    {
+                        for (int j = 0; j <= Divisions; ++j)
+                        {
+                            Eigen::Vector3d Position = Centre;
+                            Position[Axis] += Side * HalfSize[Axis];
+                            Position[U] += HalfSize[U] * (2.0 * i / Divisions - 1.0);
+                            Position[V] += HalfSize[V] * (2.0 * j / Divisions - 1.0);
+                            Vertices.push_back(Position);
+                        }
+                    }
+                    
+                    for (int i = 0; i < Divisions; ++i)
+                    {
+                        for (int j = 0; j < Divisions; ++j)
+                        {
+                            const int A = First + i * (Divisions + 1) + j;
+                            const int B = A + Divisions + 1;
+                            
+                            // Wound so the normals point out on both sides
+                            if (Side > 0)
+                            {
+                                Triangles.push_back({ A, B, B + 1 });
+                                Triangles.push_back({ A, B + 1, A + 1 });
+                            }
+                            else
+                            {
+                                Triangles.push_back({ A, B + 1, B });
+                                Triangles.push_back({ A, A + 1, B + 1 });
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        
+        /**
+         * Adds a UV sphere with Rings bands of latitude and twice as many of longitude. The poles have duplicated vertices, like a render mesh.
+         */
+        void AddSphere(const Eigen::Vector3d& Centre, double Radius, int Rings)
+        {
+            const int Segments = 2 * Rings;
+            const int First = static_cast<int>(Vertices.size());
+            
+            for (int i = 0; i <= Rings; ++i)
+            {
+                for (int j = 0; j < Segments; ++j)
+                {
+                    const double Theta = Pi * i / Rings;
+                    const double Phi = 2.0 * Pi * j / Segments;
+                    Vertices.push_back(Centre + Radius * Eigen::Vector3d(std::sin(Theta) * std::cos(Phi), std::cos(Theta), std::sin(Theta) * std::sin(Phi)));
+                }
+            }
+            
+            for (int i = 0; i < Rings; ++i)
+            {
+                for (int j = 0; j < Segments; ++j)
+                {
+                    const int A = First + i * Segments + j;
+                    const int B = First + i * Segments + (j + 1) % Segments;
+                    Triangles.push_back({ A, A + Segments, B });
+                    Triangles.push_back({ B, A + Segments, B + Segments });
+                }
+            }
+        }
+        
+        VertexMatrix GetVertices() const
+        {
+            VertexMatrix Result (3, Vertices.size());
+            
+            for (int i = 0; i < Vertices.size(); ++i)
+            {
+                Result.col(i) = Vertices[i];
+            }
+            
+            return Result;
+        }
+        
+        IndiceMatrix GetIndices() const
+        {
+            IndiceMatrix Result (3, Triangles.size());
+            
+            for (int i = 0; i < Triangles.size(); ++i)
+            {
+                Result.col(i) << Triangles[i][0], Triangles[i][1], Triangles[i][2];
+            }
+            
+            return Result;
+        }
+    };
+    
+    /**
+     * Generalised winding number at a point, summing the exact solid angle of every triangle from Van Oosterom and Strackee.
+     */
+    double BruteForceWinding(const VertexMatrix& Vertices, const IndiceMatrix& Indices, const Eigen::Vector3d& Point)
+    {
+        double SolidAngle = 0.0;
+        
+        for (int i = 0; i < Indices.cols(); ++i)
+        {
+            const Eigen::Vector3d A = Vertices.col(Indices(0, i)) - Point;
+            const Eigen::Vector3d B = Vertices.col(Indices(1, i)) - Point;
+            const Eigen::Vector3d C = Vertices.col(Indices(2, i)) - Point;
+            const double LengthA = A.norm();
+            const double LengthB = B.norm();
+            const double LengthC = C.norm();
+            
+            SolidAngle += 2.0 * std::atan2(A.dot(B.cross(C)), LengthA * LengthB * LengthC + A.dot(B) * LengthC + B.dot(C) * LengthA + C.dot(A) * LengthB);
+        }
+        
+        return SolidAngle / (4.0 * Pi);
+    }
+    
+    /**
+     * Voxelises a mesh the way PL_VOXELISATION_MODE_EXACT does, filling a voxel if at least 3 of its centre and 8 corners are inside.
+     * The voxels cover the mesh's bounds and one more voxel around them, on a lattice with a corner at the origin.
+     *
+     * @param Bounds Bounds of the mesh the lattice is laid out for. Pass the same bounds to compare two meshes voxel by voxel.
+     */
+    std::vector<bool> VoxeliseMesh(const VertexMatrix& Vertices, const IndiceMatrix& Indices, const Eigen::AlignedBox3d& Bounds, double VoxelSize)
+    {
+        const Eigen::Vector3i First = (Bounds.min() / VoxelSize).array().floor().cast<int>() - 1;
+        const Eigen::Vector3i Last = (Bounds.max() / VoxelSize).array().floor().cast<int>() + 1;
+        std::vector<bool> Filled;
+        
+        for (int z = First.z(); z <= Last.z(); ++z)
+        {
+            for (int y = First.y(); y <= Last.y(); ++y)
+            {
+                for (int x = First.x(); x <= Last.x(); ++x)
+                {
+                    const Eigen::Vector3d Centre = (Eigen::Vector3d(x, y, z) + Eigen::Vector3d::Constant(0.5)) * VoxelSize;
+                    int PointsInside = std::abs(BruteForceWinding(Vertices, Indices, Centre)) >= 0.5 ? 1 : 0;
+                    
+                    for (int Corner = 0; Corner < 8; ++Corner)
+                    {
+                        const Eigen::Vector3d Offset (Corner & 1 ? 0.5 : -0.5, Corner & 2 ? 0.5 : -0.5, Corner & 4 ? 0.5 : -0.5);
+                        PointsInside += std::abs(BruteForceWinding(Vertices, Indices, Centre + Offset * VoxelSize)) >= 0.5 ? 1 : 0;
+                    }
+                    
+                    Filled.push_back(PointsInside > 2);
+                }
+            }
+        }
+        
+        return Filled;
+    }
+    
+    Eigen::AlignedBox3d GetBounds(const VertexMatrix& Vertices)
+    {
+        Eigen::AlignedBox3d Bounds;
+        
+        for (int i = 0; i < Vertices.cols(); ++i)
+        {
+            Bounds.extend(Vertices.col(i));
+        }
+        
+        return Bounds;
+    }
+}
+
+int SimulatorValidation::Run()
+{
+    // SimulatorBasic and SimulatorBasic3D are electromagnetic test beds that ignore the source voxel, so they aren't acoustic backends
+    const Backend Backends[] =
+    {
+        { "FDTD", &CreateFDTD, &SecondOrderDispersion, PL_SIMULATION_PRECISION_DOUBLE, BackendTolerance },
+        { "FDTD 4th order", &CreateFDTD4, &FourthOrderDispersion, PL_SIMULATION_PRECISION_DOUBLE, BackendTolerance },
+        { "Leapfrog", &CreateLeapfrog, &SecondOrderDispersion, PL_SIMULATION_PRECISION_DOUBLE, BackendTolerance },
+        { "Leapfrog float", &CreateLeapfrog, &SecondOrderDispersion, PL_SIMULATION_PRECISION_FLOAT, BackendTolerance },
+        { "Leapfrog half", &CreateLeapfrog, &SecondOrderDispersion, PL_SIMULATION_PRECISION_HALF, BackendTolerance },
+        { "ADI", &CreateADI, &ADIDispersion, PL_SIMULATION_PRECISION_DOUBLE, ADITolerance }
+    };
+    
+    Checks.clear();
+    boost::timer::cpu_timer Timer;
+    
+    Responses ReferenceFreeField;
+    Responses ReferenceRoom;
+    Responses ReferenceRigidWall;
+    Responses ReferenceWall;
+    double ReferenceCourant = 0.0;
+    
+    for (const Backend& ToRun : Backends)
+    {
+        const std::string Name = ToRun.Name;
+        
+        // Room modes
+        double Courant = 0.0;
+        const Responses Room = RunRoomModes(ToRun, Courant);
+        const int Width = 12;
+        const double ContinuousMode = Courant / (2.0 * Width);
+        const double DiscreteMode = ToRun.Dispersion(Courant, Pi / Width) / (2.0 * Pi);
+        const double MeasuredMode = FindSpectralPeak(Room[0], 0.8 * ContinuousMode, 1.15 * ContinuousMode);
+        
+        AddCheck(Name + " rigid room (1,0) mode against the discrete dispersion relation", MeasuredMode, DiscreteMode, 0.01);
+        AddCheck(Name + " rigid room (1,0) mode against c/2L", MeasuredMode, ContinuousMode, 0.03);
+        
+        // Free field. Receivers 8 and 16 voxels from the source along X, read before anything comes back off the edges
+        const Responses FreeField = RunFreeField(ToRun);
+        double NearTime, NearPeak, FarTime, FarPeak;
+        FindPeak(FreeField[0], 0, static_cast<int>(FreeField[0].size()), NearTime, NearPeak);
+        FindPeak(FreeField[1], 0, static_cast<int>(FreeField[1].size()), FarTime, FarPeak);
+        
+        AddCheck(Name + " free field 1/sqrt(r) decay", FarPeak / NearPeak, std::sqrt(8.0 / 16.0), 0.1);
+        AddCheck(Name + " free field speed in voxels per step", 8.0 / (FarTime - NearTime), Courant, 0.05);
+        
+        // Single wall. A rigid wall must reflect exactly like the source's image.
+        // A partly absorbing wall is only close, since the boundary reads the pressure half a voxel from the face
+        const Responses RigidWallResponses = RunSingleWall(ToRun, RigidWall);
+        const Responses Wall = RunSingleWall(ToRun, 0.5);
+        const Responses* WallCases[2] = { &RigidWallResponses, &Wall };
+        const double Reflectivities[2] = { RigidWall, 0.5 };
+        const double Tolerances[2] = { 0.01, 0.1 };
+        const char* WallNames[2] = { "rigid wall", "half absorbing wall" };
+        
+        double ImageTime, ImagePeak;
+        FindPeak(FreeField[2], 0, static_cast<int>(FreeField[2].size()), ImageTime, ImagePeak);
+        
+        for (int Case = 0; Case < 2; ++Case)
+        {
+            const Responses& Current = *WallCases[Case];
+            const std::string CaseName = Name + " " + WallNames[Case];
+            
+            // Take the free field response away to leave just the reflection
+            std::vector<double> Reflection = Current[0];
+            
+            for (int i = 0; i < Reflection.size(); ++i)
+            {
+                Reflection[i] -= FreeField[3][i];
+            }
+            
+            double ReflectionTime, ReflectionPeak;
+            FindPeak(Reflection, 0, static_cast<int>(Reflection.size()), ReflectionTime, ReflectionPeak);
+            
+            double Transmitted = 0.0;
+            
+            for (double Sample : Current[1])
+            {
+                Transmitted = std::max(Transmitted, std::abs(Sample));
+            }
+            
+            AddCheck(CaseName + " reflection coefficient", ReflectionPeak / ImagePeak, Reflectivities[Case], Tolerances[Case]);
+            AddCheck(CaseName + " reflection arrival", ReflectionTime, ImageTime, 0.05);
+            AddCheck(CaseName + " transmission", Transmitted, 0.0, 1e-12);
+        }
+        
+        if (&ToRun == &Backends[0])
+        {
+            ReferenceFreeField = FreeField;
+            ReferenceRoom = Room;
+            ReferenceRigidWall = RigidWallResponses;
+            ReferenceWall = Wall;
+            ReferenceCourant = Courant;
+            continue;
+        }
+        
+        CompareBackends("free field", ToRun, FreeField, Courant, ReferenceFreeField, ReferenceCourant);
+        CompareBackends("rigid room", ToRun, EarlyResponses(Room, RoomComparisonSteps), Courant, EarlyResponses(ReferenceRoom, RoomComparisonSteps), ReferenceCourant);
+        CompareBackends("rigid wall", ToRun, RigidWallResponses, Courant, ReferenceRigidWall, ReferenceCourant);
+        CompareBackends("single wall", ToRun, Wall, Courant, ReferenceWall, ReferenceCourant);
+    }
+    
+    RunHelmholtzFreeField();
+    CompareAtEqualCost();
+    RunMeshSimplifier();
+    RunFastWindingNumber();
+    
+    int Failed = 0;
+    
+    for (const Check& Result : Checks)
+    {
+        Failed += Result.Passed ? 0 : 1;
+    }
+    
+    PL_LOG(Failed > 0 ? PL_DEBUG_LEVEL_ERR : PL_DEBUG_LEVEL_LOG, "Simulator validation: " << Checks.size() - Failed << " of " << Checks.size() << " checks passed in " << Timer.elapsed().wall / 1e9 << "s");
+    
+    return Failed;
+}
+
+const std::vector<SimulatorValidation::Check>& SimulatorValidation::GetChecks() const
+{
+    return Checks;
+}
+
+SimulatorValidation::Responses SimulatorValidation::RunFreeField(const Backend& ToRun)
+{
+    ValidationGrid Lattice (81, 81);
+    const int TimeSteps = 100;
+    std::unique_ptr<Simulator> Simulated = Simulate(ToRun.Create, ToRun.Precision, Lattice, Lattice.Index(40, 40), TimeSteps);
+    
+    // The last receiver is as far from the source as the single wall case's receiver is from the source's image
+    Responses Result;
+    Result.push_back(GetResponse(*Simulated, Lattice.Index(48, 40)));
+    Result.push_back(GetResponse(*Simulated, Lattice.Index(56, 40)));
+    Result.push_back(GetResponse(*Simulated, Lattice.Index(69, 40)));
+    Result.push_back(GetResponse(*Simulated, Lattice.Index(50, 40)));
+    return Result;
+}
+
+SimulatorValidation::Responses SimulatorValidation::RunRoomModes(const Backend& ToRun, double& OutCourant)
+{
+    // 12 by 10 voxels of air inside rigid walls, with a strip of air outside so the lattice edges don't touch the room
+    ValidationGrid Lattice (16, 14);
+    
+    for (int X = 1; X <= 14; ++X)
+    {
+        Lattice.SetWall(X, 1, RigidWall);
+        Lattice.SetWall(X, 12, RigidWall);
+    }
+    
+    for (int Z = 1; Z <= 12; ++Z)
+    {
+        Lattice.SetWall(1, Z, RigidWall);
+        Lattice.SetWall(14, Z, RigidWall);
+    }
+    
+    const int TimeSteps = 2048;
+    std::unique_ptr<Simulator> Simulated = Simulate(ToRun.Create, ToRun.Precision, Lattice, Lattice.Index(3, 4), TimeSteps);
+    OutCourant = Simulated->GetCourantNumber();
+    
+    // Next to a wall the (1,0) mode is near its largest
+    Responses Result;
+    Result.push_back(GetResponse(*Simulated, Lattice.Index(12, 9)));
+    return Result;
+}
+
+SimulatorValidation::Responses SimulatorValidation::RunSingleWall(const Backend& ToRun, double Absorptivity)
+{
+    // The wall's face is half way between X 39 and 40, so the source's image is at 59 and 29 voxels from the receiver
+    ValidationGrid Lattice (61, 81);
+    
+    for (int Z = 0; Z < 81; ++Z)
+    {
+        Lattice.SetWall(40, Z, Absorptivity);
+    }
+    
+    const int TimeSteps = 100;
+    std::unique_ptr<Simulator> Simulated = Simulate(ToRun.Create, ToRun.Precision, Lattice, Lattice.Index(20, 40), TimeSteps);
+    
+    Responses Result;
+    Result.push_back(GetResponse(*Simulated, Lattice.Index(30, 40)));
+    Result.push_back(GetResponse(*Simulated, Lattice.Index(50, 40)));
+    return Result;
+}
+
+void SimulatorValidation::RunHelmholtzFreeField()
+{
+    const int Size = 40;
+    const int Centre = Size / 2;
+    
+    PL_VOXEL_GRID Grid;
+    Grid.Size << Size, Size, Size;
+    Grid.VoxelSize = 0.15f;
+    Grid.Bounds = Eigen::AlignedBox<double, 3>(Eigen::Vector3d::Zero(), Eigen::Vector3d(Size, Size, Size));
+    
+    PLVoxel Air = PLVoxel();
+    Air.Beta = 1;
+    Grid.Voxels.assign(Size * Size * Size, Air);
+    
+    HelmholtzSolver Solver;
+    Solver.Build(Grid);
+    
+    // 8 voxels per wavelength, like the top of the time domain pulse
+    const double Wavenumber = 2.0 * Pi / 8.0;
+    const double Frequency = Wavenumber * 343.21 / (2.0 * Pi * Grid.VoxelSize);
+    
+    std::vector<HelmholtzSolver::Complex> Pressure;
+    const bool bConverged = Solver.Solve(ThreeDimToOneDim(Centre, Centre, Centre, Size, Size), Frequency, Pressure);
+    
+    // Receivers 4 and 8 voxels from the source along X, well clear of the edges
+    const HelmholtzSolver::Complex Near = Pressure[ThreeDimToOneDim(Centre + 4, Centre, Centre, Size, Size)];
+    const HelmholtzSolver::Complex Far = Pressure[ThreeDimToOneDim(Centre + 8, Centre, Centre, Size, Size)];
+    
+    // Unwrapped a voxel at a time, since the phase turns by more than pi between the receivers
+    double PhaseChange = 0.0;
+    
+    for (int x = Centre + 4; x < Centre + 8; ++x)
+    {
+        PhaseChange += std::remainder(std::arg(Pressure[ThreeDimToOneDim(x, Centre, Centre, Size, Size)]) - std::arg(Pressure[ThreeDimToOneDim(x + 1, Centre, Centre, Size, Size)]), 2.0 * Pi);
+    }
+    
+    // Along an axis the 7 point Laplacian carries the wave at acos(1 - (kh)^2 / 2) radians per voxel
+    const double DiscreteWavenumber = std::acos(1.0 - Wavenumber * Wavenumber / 2.0);
+    
+    AddCheck("Helmholtz free field converged", bConverged ? 1.0 : 0.0, 1.0, 0.0);
+    AddCheck("Helmholtz free field 1/r decay", std::abs(Far) / std::abs(Near), 0.5, 0.05);
+    AddCheck("Helmholtz free field magnitude 1 meter from the source", std::abs(Near) * 4.0 * Grid.VoxelSize, 1.0, 0.05);
+    AddCheck("Helmholtz free field wavenumber against the discrete dispersion relation", PhaseChange / 4.0, DiscreteWavenumber, 0.02);
+    AddCheck("Helmholtz free field wavenumber against 2 pi f / c", PhaseChange / 4.0, Wavenumber, 0.05);
+}
+
+void SimulatorValidation::CompareAtEqualCost()
+{
+    struct Run
+    {
+        const char* Name;
+        Simulator* (*Create)();
+        float VoxelSize;
+        
+        Responses Result;
+        double SamplingRate;
+        double Seconds;
+    };
+    
+    // 12 meters of open field, so the pulse passes the far receiver, 2.4 meters from the source, before anything comes back from the edges
+    Run Runs[3] =
+    {
+        { "Leapfrog", &CreateLeapfrog, 0.05f },
+        { "ADI", &CreateADI, 0.05f },
+        { "Leapfrog on voxels twice as big", &CreateLeapfrog, 0.1f }
+    };
+    
+    const double Width = 12.0;
+    const double Duration = 0.02;
+    const double ReceiverDistances[2] = { 1.2, 2.4 };
+    
+    for (Run& Current : Runs)
+    {
+        const int Size = static_cast<int>(std::lround(Width / Current.VoxelSize)) + 1;
+        ValidationGrid Lattice (Size, Size, Current.VoxelSize);
+        
+        // The step depends on the voxels and the scheme. Find it first so every run covers the same time
+        std::unique_ptr<Simulator> Probe (Current.Create());
+        PL_SIMULATION_SETTINGS Settings;
+        Settings.Resolution = Low;
+        Settings.TimeSteps = 1;
+        Probe->Init(nullptr, Lattice.Grid, Settings);
+        Current.SamplingRate = Probe->GetSamplingRate();
+        Probe.reset();
+        
+        boost::timer::cpu_timer Timer;
+        const int TimeSteps = static_cast<int>(std::ceil(Duration * Current.SamplingRate));
+        std::unique_ptr<Simulator> Simulated = Simulate(Current.Create, PL_SIMULATION_PRECISION_DOUBLE, Lattice, Lattice.Index(Size / 2, Size / 2), TimeSteps);
+        Current.Seconds = Timer.elapsed().wall / 1e9;
+        
+        for (double Distance : ReceiverDistances)
+        {
+            Current.Result.push_back(GetResponse(*Simulated, Lattice.Index(Size / 2 + static_cast<int>(std::lround(Distance / Current.VoxelSize)), Size / 2)));
+        }
+    }
+    
+    const Run& Reference = Runs[0];
+    
+    for (int RunIndex = 1; RunIndex < 3; ++RunIndex)
+    {
+        const Run& Compared = Runs[RunIndex];
+        
+        // The strength of the source depends on the voxel's area and the step, so the near receiver's peaks are matched first
+        double ReferenceTime, ReferencePeak, ComparedTime, ComparedPeak;
+        FindPeak(Reference.Result[0], 0, static_cast<int>(Reference.Result[0].size()), ReferenceTime, ReferencePeak);
+        FindPeak(Compared.Result[0], 0, static_cast<int>(Compared.Result[0].size()), ComparedTime, ComparedPeak);
+        const double Gain = ComparedPeak > 0.0 ? ReferencePeak / ComparedPeak : 0.0;
+        
+        for (int Receiver = 0; Receiver < 2; ++Receiver)
+        {
+            double ErrorEnergy = 0.0;
+            double ReferenceEnergy = 0.0;
+            
+            for (int i = 0; i < Reference.Result[Receiver].size(); ++i)
+            {
+                const double Step = i * Compared.SamplingRate / Reference.SamplingRate;
+                const int Before = static_cast<int>(Step);
+                
+                if (Before + 1 >= Compared.Result[Receiver].size())
+                {
+                    break;
+                }
+                
+                const double Fraction = Step - Before;
+                const double Resampled = Gain * (Compared.Result[Receiver][Before] * (1.0 - Fraction) + Compared.Result[Receiver][Before + 1] * Fraction);
+                const double Difference = Resampled - Reference.Result[Receiver][i];
+                ErrorEnergy += Difference * Difference;
+                ReferenceEnergy += Reference.Result[Receiver][i] * Reference.Result[Receiver][i];
+            }
+            
+            const double RelativeError = std::sqrt(ErrorEnergy / ReferenceEnergy);
+            AddCheck(std::string(Compared.Name) + " fine voxel free field receiver " + std::to_string(Receiver) + " against the leapfrog", RelativeError, 0.0, ADITolerance);
+        }
+        
+        PL_LOG(PL_DEBUG_LEVEL_LOG, Compared.Name << " took " << Compared.Seconds / Reference.Seconds << " of the time of the leapfrog on 0.05m voxels, at " << Reference.SamplingRate / Compared.SamplingRate << " times its step");
+    }
+}
+
+void SimulatorValidation::RunMeshSimplifier()
+{
+    // The settings PL_SCENE::SimplifyMeshes uses for the default error of a tenth of a voxel
+    const double VoxelSize = 0.25;
+    const MeshSimplifier Simplifier (0.1 * VoxelSize, 0.5 * VoxelSize, VoxelSize);
+    
+    // Wall 3m x 2m x 0.4m, with its back face at z = -0.2
+    const Eigen::Vector3d WallHalfSize (1.5, 1.0, 0.2);
+    const int WallTriangles = 12;
+    
+    struct SimplifiedCase
+    {
+        int Triangles;
+        int SimplifiedTriangles;
+        int Filled;
+        int Changed;
+    };
+    
+    auto Simplify = [&](const ValidationMesh& Mesh)
+    {
+        const VertexMatrix Vertices = Mesh.GetVertices();
+        const IndiceMatrix Indices = Mesh.GetIndices();
+        const PL_MESH Simplified = Simplifier.Simplify(Vertices, Indices);
+        
+        const Eigen::AlignedBox3d Bounds = GetBounds(Vertices);
+        const std::vector<bool> Before = VoxeliseMesh(Vertices, Indices, Bounds, VoxelSize);
+        const std::vector<bool> After = VoxeliseMesh(Simplified.Vertices, Simplified.Indices, Bounds, VoxelSize);
+        
+        SimplifiedCase Result;
+        Result.Triangles = static_cast<int>(Indices.cols());
+        Result.SimplifiedTriangles = static_cast<int>(Simplified.Indices.cols());
+        Result.Filled = static_cast<int>(std::count(Before.begin(), Before.end(), true));
+        Result.Changed = 0;
+        
+        for (int i = 0; i < Before.size(); ++i)
+        {
+            Result.Changed += Before[i] != After[i] ? 1 : 0;
+        }
+        
+        return Result;
+    };
+    
+    // Flat faces, split far finer than the voxels, collapse to the 12 triangles of a box
+    {
+        ValidationMesh Box;
+        Box.AddBox(Eigen::Vector3d(0.1, 0.0, 0.0), Eigen::Vector3d(1.3, 0.7, 0.9), 20);
+        const SimplifiedCase Result = Simplify(Box);
+        
+        AddCheck("Mesh simplifier tessellated box triangles", Result.SimplifiedTriangles, 12, 0.0);
+        AddCheck("Mesh simplifier tessellated box changed voxels", Result.Changed, 0, 0.0);
+    }
+    
+    // Bolts smaller than the minimum piece size, screwed into the face of a wall, stay since the wall is right next to them
+    {
+        ValidationMesh Wall;
+        Wall.AddBox(Eigen::Vector3d::Zero(), WallHalfSize, 1);
+        
+        for (int i = 0; i < 50; ++i)
+        {
+            Wall.AddSphere(Eigen::Vector3d(-1.4 + 0.056 * i, 0.5, WallHalfSize.z() + 0.02), 0.03, 8);
+        }
+        
+        const SimplifiedCase Result = Simplify(Wall);
+        
+        AddCheck("Mesh simplifier wall with bolts keeps the bolts", Result.SimplifiedTriangles > WallTriangles ? 1.0 : 0.0, 1.0, 0.0);
+        AddCheck("Mesh simplifier wall with bolts changed voxels", Result.Changed, 0, 0.0);
+    }
+    
+    // The same bolts over a meter from the wall are dropped
+    {
+        ValidationMesh Wall;
+        Wall.AddBox(Eigen::Vector3d::Zero(), WallHalfSize, 1);
+        
+        for (int i = 0; i < 5; ++i)
+        {
+            Wall.AddSphere(Eigen::Vector3d(-1.4 + 0.5 * i, 0.5, 1.5), 0.03, 8);
+        }
+        
+        const SimplifiedCase Result = Simplify(Wall);
+        
+        AddCheck("Mesh simplifier drops bolts clear of a wall", Result.SimplifiedTriangles, WallTriangles, 0.0);
+        AddCheck("Mesh simplifier bolts clear of a wall changed voxels", Result.Changed, 0, 0.0);
+    }
+    
+    // Overlapping beads, each far below the minimum piece size, fill voxels together
+    {
+        ValidationMesh Beads;
+        
+        for (int i = 0; i < 16; ++i)
+        {
+            for (int j = 0; j < 16; ++j)
+            {
+                for (int k = 0; k < 6; ++k)
+                {
+                    Beads.AddSphere(Eigen::Vector3d(-0.4 + 0.05 * i, -0.4 + 0.05 * j, 0.05 * k), 0.03, 3);
+                }
+            }
+        }
+        
+        const SimplifiedCase Result = Simplify(Beads);
+        
+        AddCheck("Mesh simplifier bead cluster fills voxels", Result.Filled > 0 ? 1.0 : 0.0, 1.0, 0.0);
+        AddCheck("Mesh simplifier bead cluster changed voxels", Result.Changed, 0, 0.0);
+    }
+}
+
+void SimulatorValidation::RunFastWindingNumber()
+{
+    ValidationMesh Closed;
+    Closed.AddSphere(Eigen::Vector3d(0.1, -0.05, 0.02), 1.0, 24);
+    
+    // The same sphere with its top cap cut off, so the winding number falls smoothly from 1 to 0 through the hole
+    ValidationMesh Holed = Closed;
+    Holed.Triangles.erase(Holed.Triangles.begin(), Holed.Triangles.begin() + 4 * 2 * 48);
+    
+    const struct
+    {
+        const char* Name;
+        const ValidationMesh& Mesh;
+    }
+    Cases[] = { { "closed sphere", Closed }, { "sphere with a hole", Holed } };
+    
+    for (const auto& Case : Cases)
+    {
+        const VertexMatrix Vertices = Case.Mesh.GetVertices();
+        const IndiceMatrix Indices = Case.Mesh.GetIndices();
+        const FastWindingNumber Winding (Vertices, Indices);
+        const std::string CaseName = std::string("Fast winding number ") + Case.Name;
+        
+        // Points inside, outside and right by the surface, in packets along X like Fill
+        const int Steps = 24;
+        const double Spacing = 3.0 / Steps;
+        double MaxError = 0.0;
+        
+        for (int z = 0; z < Steps; ++z)
+        {
+            for (int y = 0; y < Steps; ++y)
+            {
+                for (int x = 0; x < Steps; x += FastWindingNumber::PacketSize)
+                {
+                    float X[FastWindingNumber::PacketSize];
+                    float Y[FastWindingNumber::PacketSize];
+                    float Z[FastWindingNumber::PacketSize];
+                    float Evaluated[FastWindingNumber::PacketSize];
+                    const int Count = std::min(FastWindingNumber::PacketSize, Steps - x);
+                    
+                    for (int i = 0; i < Count; ++i)
+                    {
+                        X[i] = static_cast<float>(-1.5 + (x + i + 0.5) * Spacing);
+                        Y[i] = static_cast<float>(-1.5 + (y + 0.5) * Spacing);
+                        Z[i] = static_cast<float>(-1.5 + (z + 0.5) * Spacing);
+                    }
+                    
+                    Winding.Evaluate(X, Y, Z, Count, Evaluated);
+                    
+                    for (int i = 0; i < Count; ++i)
+                    {
+                        const double Expected = BruteForceWinding(Vertices, Indices, Eigen::Vector3d(X[i], Y[i], Z[i]));
+                        MaxError = std::max(MaxError, std::abs(Evaluated[i] - Expected));
+                    }
+                }
+            }
+        }
+        
+        // The far field is a single dipole per node, so it's off by a few hundredths. A tenth of the distance to the 0.5 threshold is plenty
+        AddCheck(CaseName + " largest error against the exact sum", MaxError, 0.0, 0.05);
+        
+        // Fill only looks at the voxel centres, against the 0.5 threshold
+        PL_VOXEL_GRID Grid;
+        Grid.Size << 12, 12, 12;
+        Grid.VoxelSize = 0.25f;
+        Grid.Bounds = Eigen::AlignedBox<double, 3>(Eigen::Vector3d::Constant(-1.5), Eigen::Vector3d::Constant(1.5));
+        
+        PLVoxel Air = PLVoxel();
+        Air.Beta = 1;
+        Grid.Voxels.assign(12 * 12 * 12, Air);
+        
+        Winding.Fill(Grid, PLVector(-1.5f, -1.5f, -1.5f), 0.5f);
+        
+        int Filled = 0;
+        int Changed = 0;
+        
+        for (int i = 0; i < Grid.Voxels.size(); ++i)
+        {
+            int X, Y, Z;
+            IndexToThreeDim(i, 12, 12, X, Y, Z);
+            
+            const Eigen::Vector3d Centre = Eigen::Vector3d::Constant(-1.5) + (Eigen::Vector3d(X, Y, Z) + Eigen::Vector3d::Constant(0.5)) * Grid.VoxelSize;
+            const bool bInside = std::abs(BruteForceWinding(Vertices, Indices, Centre)) >= 0.5;
+            
+            Filled += Grid.Voxels[i].Beta == 0 ? 1 : 0;
+            Changed += (Grid.Voxels[i].Beta == 0) != bInside ? 1 : 0;
+        }
+        
+        AddCheck(CaseName + " fills voxels", Filled > 0 ? 1.0 : 0.0, 1.0, 0.0);
+        AddCheck(CaseName + " voxels filled differently to the exact sum", Changed, 0, 0.0);
+    }
+}
+
+void SimulatorValidation::AddCheck(const std::string& Name, double Measured, double Expected, double Tolerance)
+{
+    const double Error = Expected != 0.0 ? std::abs(Measured - Expected) / std::abs(Expected) : std::abs(Measured);
+    
+    Check NewCheck;
+    NewCheck.Name = Name;
+    NewCheck.Measured = Measured;
+    NewCheck.Expected = Expected;
+    NewCheck.Tolerance = Tolerance;
+    NewCheck.Passed = Error <= Tolerance && std::isfinite(Measured);
+    Checks.push_back(NewCheck);
+    
+    PL_LOG(NewCheck.Passed ? PL_DEBUG_LEVEL_LOG : PL_DEBUG_LEVEL_ERR, (NewCheck.Passed ? "PASS " : "FAIL ") << Name << ": " << Measured << ", expected " << Expected << " within " << Tolerance);
+}
+
+void SimulatorValidation::CompareBackends(const std::string& CaseName, const Backend& ToCompare, const Responses& Compared, double ComparedCourant, const Responses& Reference, double ReferenceCourant)
+{
+    for (int Receiver = 0; Receiver < Reference.size(); ++Receiver)
+    {
+        const std::vector<double>& ComparedResponse = Compared[Receiver];
+        double ErrorEnergy = 0.0;
+        double ReferenceEnergy = 0.0;
+        
+        for (int i = 0; i < Reference[Receiver].size(); ++i)
+        {
+            // Both run on the same voxels, so time in voxels crossed at the speed of sound is i * Courant
+            const double Step = i * ReferenceCourant / ComparedCourant;
+            const int Before = static_cast<int>(Step);
+            
+            if (Before + 1 >= ComparedResponse.size())
+            {
+                break;
+            }
+            
+            const double Fraction = Step - Before;
+            // The pulse is added once a step, so a shorter step adds more pressure in the same time
+            const double Resampled = (ComparedResponse[Before] * (1.0 - Fraction) + ComparedResponse[Before + 1] * Fraction) * ComparedCourant / ReferenceCourant;
+            const double Difference = Resampled - Reference[Receiver][i];
+            ErrorEnergy += Difference * Difference;
+            ReferenceEnergy += Reference[Receiver][i] * Reference[Receiver][i];
+        }
+        
+        const double RelativeError = ReferenceEnergy > 0.0 ? std::sqrt(ErrorEnergy / ReferenceEnergy) : std::sqrt(ErrorEnergy);
+        AddCheck(std::string(ToCompare.Name) + " " + CaseName + " receiver " + std::to_string(Receiver) + " against the reference backend", RelativeError, 0.0, ToCompare.Tolerance);
+    }
+}
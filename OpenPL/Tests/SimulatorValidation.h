@@ -0,0 +1,116 @@
+/*
+  ==============================================================================
+  
+    SimulatorValidation.h
+    Created: 18 Oct 2026 10:02:36pm
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "OpenPLCommonPrivate.h"
+#include <string>
+
+class Simulator;
+
+/**
+ * Runs every simulator backend on small cases with known answers, so a faster kernel can be checked before it's trusted.
+ *
+ * Cases are 2D, like the simulators, and measured in voxels and time steps so they don't depend on the resolution:
+ * - Free field. Peak pressure falls off as 1/sqrt(r) and arrives at the Courant speed.
+ * - Rigid rectangular room. The lowest axial mode sits at the frequency the scheme's dispersion relation predicts, and close to c/2L.
+ * - Single wall. Nothing gets through and the reflection off the face matches the wall's reflection coefficient, exactly for a rigid wall.
+ * Every backend after the first is also compared against the first at each receiver.
+ *
+ * The frequency domain HelmholtzSolver is checked on its own in a 3D free field, against the e^(-ikr) / r of a point source.
+ *
+ * The ADI scheme is meant for voxels much finer than the resolution needs, so it's also run in a free field on voxels 3 times finer.
+ * Its error against the leapfrog on the same voxels is logged next to the leapfrog's on voxels twice as big, which costs about the same.
+ *
+ * MeshSimplifier is checked on meshes with known answers: a finely split box collapses to 12 triangles, bolts on a wall are kept and bolts
+ * clear of it are dropped, and a cluster of tiny beads stays. None of them may change which voxels an exact 3 of 9 voxelisation fills.
+ * FastWindingNumber is compared against the exact sum over every triangle on a closed sphere and one with a hole, point by point and voxel by voxel.
+ */
+class SimulatorValidation
+{
+public:
+
+    struct Check
+    {
+        std::string Name;
+        double Measured;
+        double Expected;
+        double Tolerance;
+        bool Passed;
+    };
+    
+    /**
+     * Runs every case on every backend. Each check is logged as it finishes.
+     *
+     * @return Number of checks that failed.
+     */
+    int Run();
+    
+    const std::vector<Check>& GetChecks() const;
+
+private:
+
+    struct Backend
+    {
+        const char* Name;
+        Simulator* (*Create)();
+        
+        /** Radians per time step of a wave along an axis with Wavenumber radians per voxel. 2 asin(C sin(k/2)) for second order leapfrog in time*/
+        double (*Dispersion)(double Courant, double Wavenumber);
+        
+        /** How the backend stores its state. Compared against the double reference, this is the error the storage adds*/
+        PL_SIMULATION_PRECISION Precision;
+        
+        /** Relative L2 error allowed against the reference backend*/
+        double Tolerance;
+    };
+    
+    /** Pressure at each receiver for every time step, in the order the case listed them*/
+    typedef std::vector<std::vector<double>> Responses;
+    
+    Responses RunFreeField(const Backend& ToRun);
+    
+    Responses RunRoomModes(const Backend& ToRun, double& OutCourant);
+    
+    /**
+     * @param Absorptivity Pressure reflection coefficient of the wall.
+     */
+    Responses RunSingleWall(const Backend& ToRun, double Absorptivity);
+    
+    void RunHelmholtzFreeField();
+    
+    void CompareAtEqualCost();
+    
+    void RunMeshSimplifier();
+    
+    void RunFastWindingNumber();
+    
+    /**
+     * Records a check that passes if Measured is within Tolerance of Expected. Tolerance is relative unless Expected is 0.
+     */
+    void AddCheck(const std::string& Name, double Measured, double Expected, double Tolerance);
+    
+    /**
+     * Compares every receiver of a backend against the reference backend with the relative L2 error.
+     * Backends can run at different time steps, so the compared responses are resampled onto the reference's.
+     *
+     * @param ComparedCourant Courant number of the compared backend.
+     * @param ReferenceCourant Courant number of the reference backend.
+     */
+    void CompareBackends(const std::string& CaseName, const Backend& ToCompare, const Responses& Compared, double ComparedCourant, const Responses& Reference, double ReferenceCourant);
+    
+    /** Backends are allowed to differ by this much relative L2 error, since higher order schemes disperse differently*/
+    static constexpr double BackendTolerance = 0.15;
+    
+    /** The ADI scheme disperses 4 times as much as the leapfrog on the same voxels, and more at its longer steps*/
+    static constexpr double ADITolerance = 0.3;
+    
+    std::vector<Check> Checks;
+};
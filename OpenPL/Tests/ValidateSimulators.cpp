@@ -0,0 +1,45 @@
+/*
+  ==============================================================================
+  
+    ValidateSimulators.cpp
+    Created: 18 Oct 2026 4:12:09pm
+    Author:  James Kelly
+  
+  ==============================================================================
+*/
+
+#include "OpenPL.h"
+#include "SimulatorValidation.h"
+#include <cstdio>
+
+namespace
+{
+    PL_RESULT PrintMessage(const char* Message, PL_DEBUG_LEVEL Level)
+    {
+        std::fprintf(Level == PL_DEBUG_LEVEL_LOG ? stdout : stderr, "%s\n", Message);
+        return PL_OK;
+    }
+}
+
+/**
+ * Runs SimulatorValidation and exits with 1 if any check fails, so it can gate a build. Built and run by "make test".
+ */
+int main()
+{
+    PL_Debug_Initialize(&PrintMessage);
+    
+    SimulatorValidation Validation;
+    const int Failed = Validation.Run();
+    
+    PL_Debug_Flush();
+    
+    for (const SimulatorValidation::Check& Result : Validation.GetChecks())
+    {
+        if (!Result.Passed)
+        {
+            std::fprintf(stderr, "FAILED: %s\n", Result.Name.c_str());
+        }
+    }
+    
+    return Failed == 0 ? 0 : 1;
+}
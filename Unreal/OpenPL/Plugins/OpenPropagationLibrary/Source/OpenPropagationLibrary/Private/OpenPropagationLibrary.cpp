@@ -2,6 +2,7 @@
 
 #include "OpenPropagationLibrary.h"
 #include "OpenPL.hpp"
+#include "Containers/Ticker.h"
 
 #define LOCTEXT_NAMESPACE "FOpenPropagationLibraryModule"
 
@@ -33,17 +34,35 @@ void FOpenPropagationLibraryModule::StartupModule()
     if (SystemCreateResult == PL_OK)
     {
         PL_Debug_Initialize (DebugCallback);
+        
+        // Messages are queued by the library and only reach the callback when flushed, so flush once a frame on the game thread
+        TickDelegateHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FOpenPropagationLibraryModule::Tick));
     }
 }
 
 void FOpenPropagationLibraryModule::ShutdownModule()
 {
+    if (TickDelegateHandle.IsValid())
+    {
+        FTicker::GetCoreTicker().RemoveTicker(TickDelegateHandle);
+        TickDelegateHandle.Reset();
+    }
+    
+    // Whatever was logged since the last frame
+    PL_Debug_Flush();
+    
     if (SystemInstance)
     {
         SystemInstance->Release();
     }
 }
 
+bool FOpenPropagationLibraryModule::Tick(float DeltaTime)
+{
+    PL_Debug_Flush();
+    return true;
+}
+
 OpenPL::PLScene* FOpenPropagationLibraryModule::CreateScene()
 {
     OpenPL::PLScene* Result = nullptr;
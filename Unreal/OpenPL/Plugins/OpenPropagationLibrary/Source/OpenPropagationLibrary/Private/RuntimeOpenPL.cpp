@@ -6,6 +6,7 @@
 #include "Engine/StaticMeshActor.h"
 #include "Components/StaticMeshComponent.h"
 #include "Engine/StaticMesh.h"
+#include "PhysicsEngine/BodySetup.h"
 #include "OpenPLUtils.h"
 #include "Kismet/GameplayStatics.h"
 #include "GameFramework/Pawn.h"
@@ -22,6 +23,9 @@ ARuntimeOpenPL::ARuntimeOpenPL()
  	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
 
+    ProbeSpacing = 300.f;
+    MaxProbes = 256;
+    SimpleCollisionAbsorptivity = 0.25f;
 }
 
 // Called when the game starts or when spawned
@@ -39,11 +43,20 @@ void ARuntimeOpenPL::BeginPlay()
     
     Scene->CreateVoxels(ConvertUnrealVectorToPL(SimulationSize), VoxelSize / 100);
     
+    Scene->SetWarmStartDistance(WarmStartDistance / 100);
+    
+    Scene->SetMeshSimplification(bSimplifyMeshes, 0.1f);
+    
     for (AStaticMeshActor* MeshActor : StaticMeshes)
     {
         TArray<PLVector> Vertices;
         TArray<int> ActualIndices;
         
+        if (bUseSimpleCollision && AddSimpleCollision(MeshActor))
+        {
+            continue;
+        }
+        
         UStaticMeshComponent* StaticMeshComponent = MeshActor->GetStaticMeshComponent();
         UStaticMesh* StaticMesh = StaticMeshComponent->GetStaticMesh();
         
@@ -99,7 +112,16 @@ void ARuntimeOpenPL::BeginPlay()
                                                    
     Scene->FillVoxelsWithGeometry();
     
-    Scene->Simulate(ConvertUnrealVectorToPL(ListenerLocation));
+    if (bUseBakedProbes)
+    {
+        int ProbeCount = 0;
+        Scene->GenerateProbes(PL_PROBE_PLACEMENT_ADAPTIVE, ProbeSpacing / 100, nullptr, 0, MaxProbes, &ProbeCount);
+        Scene->BakeProbes();
+    }
+    else
+    {
+        Scene->Simulate(ConvertUnrealVectorToPL(ListenerLocation));
+    }
     
     if (bShowMeshes)
     {
@@ -122,15 +144,104 @@ void ARuntimeOpenPL::BeginPlay()
         }
         else if (bShowAllVoxels)
         {
-            DrawDebugBox(GetWorld(), UnrealLocation, FVector(VoxelSize,VoxelSize,VoxelSize), FColor::White, true, -1, 0, 10);
+            // Air that isn't connected to the listener isn't simulated
+            int Region;
+            bool bActive = true;
+            Scene->GetVoxelRegion(&Region, &bActive, i);
+            DrawDebugBox(GetWorld(), UnrealLocation, FVector(VoxelSize,VoxelSize,VoxelSize), bActive ? FColor::White : FColor::Red, true, -1, 0, 10);
+        }
+    }
+}
+
+bool ARuntimeOpenPL::AddSimpleCollision(AStaticMeshActor* MeshActor)
+{
+    UStaticMesh* StaticMesh = MeshActor->GetStaticMeshComponent()->GetStaticMesh();
+    UBodySetup* BodySetup = StaticMesh ? StaticMesh->GetBodySetup() : nullptr;
+    
+    if (!BodySetup)
+    {
+        return false;
+    }
+    
+    const FKAggregateGeom& Geometry = BodySetup->AggGeom;
+    const FTransform ActorTransform = MeshActor->GetActorTransform();
+    const FVector Scale = ActorTransform.GetScale3D().GetAbs();
+    
+    int32 AddedCount = 0;
+    int32 AddedIndex = -1;
+    
+    for (const FKBoxElem& Box : Geometry.BoxElems)
+    {
+        const FTransform BoxTransform = Box.GetTransform() * ActorTransform;
+        
+        // Box sizes are full widths along the box's own axes. Scaling them by the actor's is exact unless the box is rotated within the mesh
+        const FVector HalfExtents = FVector(Box.X, Box.Y, Box.Z) * Scale * 0.5f;
+        
+        if (Scene->AddBox(ConvertUnrealVectorToPL(BoxTransform.GetLocation()), ConvertUnrealQuatToPL(BoxTransform.GetRotation()),
+                          ConvertUnrealVectorToPL(HalfExtents), SimpleCollisionAbsorptivity, &AddedIndex) == PL_OK)
+        {
+            AddedCount++;
+        }
+    }
+    
+    for (const FKSphereElem& Sphere : Geometry.SphereElems)
+    {
+        const FTransform SphereTransform = Sphere.GetTransform() * ActorTransform;
+        
+        if (Scene->AddSphere(ConvertUnrealVectorToPL(SphereTransform.GetLocation()), Sphere.Radius * Scale.GetMin() / 100,
+                             SimpleCollisionAbsorptivity, &AddedIndex) == PL_OK)
+        {
+            AddedCount++;
+        }
+    }
+    
+    // Unreal capsules run along their Z axis, which is OpenPL's Y once converted
+    for (const FKSphylElem& Capsule : Geometry.SphylElems)
+    {
+        const FTransform CapsuleTransform = Capsule.GetTransform() * ActorTransform;
+        
+        if (Scene->AddCapsule(ConvertUnrealVectorToPL(CapsuleTransform.GetLocation()), ConvertUnrealQuatToPL(CapsuleTransform.GetRotation()),
+                              Capsule.Radius * FMath::Min(Scale.X, Scale.Y) / 100, Capsule.Length * 0.5f * Scale.Z / 100,
+                              SimpleCollisionAbsorptivity, &AddedIndex) == PL_OK)
+        {
+            AddedCount++;
+        }
+    }
+    
+    for (const FKConvexElem& Convex : Geometry.ConvexElems)
+    {
+        const FTransform ConvexTransform = Convex.GetTransform() * ActorTransform;
+        const FVector ConvexScale = ConvexTransform.GetScale3D();
+        
+        TArray<PLVector> Vertices;
+        TArray<int> Indices (Convex.IndexData);
+        
+        for (const FVector& Vertex : Convex.VertexData)
+        {
+            Vertices.Add(ConvertUnrealVectorToPL(Vertex));
+        }
+        
+        if (Scene->AddConvexHull(ConvertUnrealVectorToPL(ConvexTransform.GetLocation()), ConvertUnrealQuatToPL(ConvexTransform.GetRotation()),
+                                 PLVector(ConvexScale.Y, ConvexScale.Z, ConvexScale.X), Vertices.GetData(), Vertices.Num(), Indices.GetData(), Indices.Num(),
+                                 SimpleCollisionAbsorptivity, &AddedIndex) == PL_OK)
+        {
+            AddedCount++;
         }
     }
+    
+    return AddedCount > 0;
 }
 
 // Called every frame
 void ARuntimeOpenPL::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
+    
+    // The debug window only draws when asked to, from the game thread
+    if (bShowMeshes && Scene)
+    {
+        Scene->DebugUpdate();
+    }
 
     if (Player)
     {
@@ -143,10 +254,17 @@ void ARuntimeOpenPL::Tick(float DeltaTime)
         FOpenPropagationLibraryModule& OpenPLModule = FOpenPropagationLibraryModule::Get();
         OpenPLModule.GetSystem()->SetListenerPosition(ConvertUnrealVectorToPL(ListenerLocation));
         
-        Scene->Simulate(ConvertUnrealVectorToPL(ListenerLocation));
-        
         float OutOcclusion;
-        Scene->GetOcclusion(ConvertUnrealVectorToPL(EmitterLocation), &OutOcclusion);
+        
+        if (bUseBakedProbes)
+        {
+            Scene->GetBakedOcclusion(ConvertUnrealVectorToPL(EmitterLocation), &OutOcclusion);
+        }
+        else
+        {
+            Scene->Simulate(ConvertUnrealVectorToPL(ListenerLocation));
+            Scene->GetOcclusion(ConvertUnrealVectorToPL(EmitterLocation), &OutOcclusion);
+        }
         
         if (OutOcclusion > 1)
         {
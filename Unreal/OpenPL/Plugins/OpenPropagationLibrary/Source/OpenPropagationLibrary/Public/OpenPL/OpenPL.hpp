@@ -15,13 +15,100 @@
 #pragma once
 
 #include "OpenPL.h"
+#include <cstring>
+#include <vector>
 
 namespace OpenPL
 {
     class PLSystem;
     class PLScene;
 
+    /**
+     * Records commands for PLScene::ExecuteCommands. Lives on the caller's side of the ABI, so recording is only a copy into the buffer.
+     * Clear and reuse it every frame to keep its memory.
+     */
+    class PLCommandBuffer
+    {
+    public:
+        
+        void AddMesh(PLVector WorldPosition, PLQuaternion WorldRotation, PLVector WorldScale, const PLVector* Vertices, int VerticesLength, const int* Indices, int IndicesLength)
+        {
+            PL_COMMAND_ADD_MESH_ARGS Mesh;
+            Mesh.WorldPosition = WorldPosition;
+            Mesh.WorldRotation = WorldRotation;
+            Mesh.WorldScale = WorldScale;
+            Mesh.VerticesLength = VerticesLength;
+            Mesh.IndicesLength = IndicesLength;
+            
+            char* Arguments = Record(PL_COMMAND_ADD_MESH, sizeof(Mesh) + VerticesLength * sizeof(PLVector) + IndicesLength * sizeof(int));
+            std::memcpy(Arguments, &Mesh, sizeof(Mesh));
+            std::memcpy(Arguments + sizeof(Mesh), Vertices, VerticesLength * sizeof(PLVector));
+            std::memcpy(Arguments + sizeof(Mesh) + VerticesLength * sizeof(PLVector), Indices, IndicesLength * sizeof(int));
+        }
+        
+        void RemoveMesh(int Index) { RecordValue(PL_COMMAND_REMOVE_MESH, Index); }
+        void AddListenerLocation(PLVector Location) { RecordValue(PL_COMMAND_ADD_LISTENER_LOCATION, Location); }
+        void SetListenerLocation(int Index, PLVector Location) { RecordValue(PL_COMMAND_SET_LISTENER_LOCATION, MakeLocation(Index, Location)); }
+        void RemoveListenerLocation(int Index) { RecordValue(PL_COMMAND_REMOVE_LISTENER_LOCATION, Index); }
+        void AddSourceLocation(PLVector Location) { RecordValue(PL_COMMAND_ADD_SOURCE_LOCATION, Location); }
+        void SetSourceLocation(int Index, PLVector Location) { RecordValue(PL_COMMAND_SET_SOURCE_LOCATION, MakeLocation(Index, Location)); }
+        void RemoveSourceLocation(int Index) { RecordValue(PL_COMMAND_REMOVE_SOURCE_LOCATION, Index); }
+        void GetVoxel(int Index) { RecordValue(PL_COMMAND_GET_VOXEL, Index); }
+        void GetOcclusion(PLVector EmitterLocation) { RecordValue(PL_COMMAND_GET_OCCLUSION, EmitterLocation); }
+        
+        void Clear()
+        {
+            Words.clear();
+            CommandCount = 0;
+        }
+        
+        void* GetData() { return Words.data(); }
+        int GetSize() const { return static_cast<int>(Words.size() * sizeof(int)); }
+        
+        /** Results ExecuteCommands needs room for*/
+        int GetCommandCount() const { return CommandCount; }
+        
+    private:
+        
+        /** Adds a header and room for Size bytes of arguments, padded to a whole word, and returns where the arguments go*/
+        char* Record(PL_COMMAND Type, size_t Size)
+        {
+            const size_t Start = Words.size();
+            const size_t ArgumentWords = (Size + sizeof(int) - 1) / sizeof(int);
+            Words.resize(Start + sizeof(PL_COMMAND_HEADER) / sizeof(int) + ArgumentWords, 0);
+            
+            PL_COMMAND_HEADER Header;
+            Header.Type = Type;
+            Header.Size = static_cast<int>(ArgumentWords * sizeof(int));
+            std::memcpy(&Words[Start], &Header, sizeof(Header));
+            
+            ++CommandCount;
+            return reinterpret_cast<char*>(&Words[Start]) + sizeof(Header);
+        }
+        
+        template <typename T>
+        void RecordValue(PL_COMMAND Type, const T& Value)
+        {
+            std::memcpy(Record(Type, sizeof(T)), &Value, sizeof(T));
+        }
+        
+        static PL_COMMAND_LOCATION_ARGS MakeLocation(int Index, PLVector Location)
+        {
+            PL_COMMAND_LOCATION_ARGS Arguments;
+            Arguments.Index = Index;
+            Arguments.Location = Location;
+            return Arguments;
+        }
+        
+        /** Stored as ints so every header is 4 byte aligned*/
+        std::vector<int> Words;
+        
+        int CommandCount = 0;
+    };
+
     inline PL_RESULT Debug_Initialize(PL_Debug_Callback Callback) { return PL_Debug_Initialize(Callback); }
+    inline PL_RESULT Debug_SetLevel(PL_DEBUG_LEVEL MinimumLevel) { return PL_Debug_SetLevel(MinimumLevel); }
+    inline PL_RESULT Debug_Flush() { return PL_Debug_Flush(); }
     inline PL_RESULT System_Create(PLSystem** OutSystem) { return PL_System_Create((PL_SYSTEM**)OutSystem); }
 
     /**
@@ -46,6 +133,12 @@ namespace OpenPL
 
         // Scenes
         PL_RESULT JUCE_PUBLIC_FUNCTION CreateScene(PLScene** OutScene);
+        
+        // Testing
+        PL_RESULT JUCE_PUBLIC_FUNCTION BenchmarkThreadScaling(int VoxelsInSide, float* OutFirstTouchSpeedup, float* OutSerialTouchSpeedup);
+        
+        // Threads
+        PL_RESULT JUCE_PUBLIC_FUNCTION SetParallelThreads(int MaxThreads, bool PinThreads);
     };
 
     class PLScene
@@ -61,18 +154,53 @@ namespace OpenPL
         PL_RESULT JUCE_PUBLIC_FUNCTION CreateVoxels(PLVector SceneSize, float VoxelSize);
         PL_RESULT JUCE_PUBLIC_FUNCTION AddMesh(PLVector WorldPosition, PLQuaternion WorldRotation, PLVector WorldScale, PLVector* Vertices, int VerticesLength, int* Indices, int IndicesLength, int* OutIndex);
         PL_RESULT JUCE_PUBLIC_FUNCTION RemoveMesh(int IndexToRemove);
+        PL_RESULT JUCE_PUBLIC_FUNCTION AddHeightfield(PLVector Origin, float Spacing, int Rows, int Columns, const float* Heights, float Absorptivity, int* OutIndex);
+        PL_RESULT JUCE_PUBLIC_FUNCTION RemoveHeightfield(int IndexToRemove);
+        PL_RESULT JUCE_PUBLIC_FUNCTION AddBox(PLVector Position, PLQuaternion Rotation, PLVector HalfExtents, float Absorptivity, int* OutIndex);
+        PL_RESULT JUCE_PUBLIC_FUNCTION AddSphere(PLVector Position, float Radius, float Absorptivity, int* OutIndex);
+        PL_RESULT JUCE_PUBLIC_FUNCTION AddCapsule(PLVector Position, PLQuaternion Rotation, float Radius, float HalfHeight, float Absorptivity, int* OutIndex);
+        PL_RESULT JUCE_PUBLIC_FUNCTION AddConvexHull(PLVector Position, PLQuaternion Rotation, PLVector Scale, PLVector* Vertices, int VerticesLength, int* Indices, int IndicesLength, float Absorptivity, int* OutIndex);
+        PL_RESULT JUCE_PUBLIC_FUNCTION RemovePrimitive(int IndexToRemove);
         PL_RESULT JUCE_PUBLIC_FUNCTION FillVoxelsWithGeometry();
         PL_RESULT JUCE_PUBLIC_FUNCTION AddListenerLocation(PLVector Position, int* OutIndex);
         PL_RESULT JUCE_PUBLIC_FUNCTION RemoveListenerLocation(int IndexToRemove);
         PL_RESULT JUCE_PUBLIC_FUNCTION AddSourceLocation(PLVector Position, int* OutIndex);
         PL_RESULT JUCE_PUBLIC_FUNCTION RemoveSourceLocation(int IndexToRemove);
         PL_RESULT JUCE_PUBLIC_FUNCTION Simulate(PLVector SimulationLocation);
+        PL_RESULT JUCE_PUBLIC_FUNCTION GetSimulationRate(float* OutSamplingRate, float* OutMaxFrequency);
+        PL_RESULT JUCE_PUBLIC_FUNCTION SetSimulationScheme(PL_SIMULATION_SCHEME Scheme);
+        PL_RESULT JUCE_PUBLIC_FUNCTION SetSimulationPrecision(PL_SIMULATION_PRECISION Precision);
+        PL_RESULT JUCE_PUBLIC_FUNCTION SetWarmStartDistance(float MaxDistance);
+        PL_RESULT JUCE_PUBLIC_FUNCTION SetMeshSimplification(bool bEnabled, float MaxErrorInVoxels);
+        PL_RESULT JUCE_PUBLIC_FUNCTION SetVoxelisationMode(PL_VOXELISATION_MODE Mode);
+        PL_RESULT JUCE_PUBLIC_FUNCTION BenchmarkWarmStart(PLVector FromLocation, PLVector ToLocation, float* OutRelativeError, float* OutSpeedup);
+        PL_RESULT JUCE_PUBLIC_FUNCTION StartSnapshotRecording(const char* FilePrefix, int Interval, int Stride, PL_SNAPSHOT_REGION Region, int PlaneIndex, PL_SNAPSHOT_PRECISION Precision);
+        PL_RESULT JUCE_PUBLIC_FUNCTION StopSnapshotRecording();
         PL_RESULT JUCE_PUBLIC_FUNCTION Debug();
+        PL_RESULT JUCE_PUBLIC_FUNCTION DebugUpdate();
+        PL_RESULT JUCE_PUBLIC_FUNCTION GenerateProbes(PL_PROBE_PLACEMENT Placement, float Spacing, PLVector* Seeds, int SeedsLength, int MaxProbes, int* OutProbeCount);
+        PL_RESULT JUCE_PUBLIC_FUNCTION BakeProbes();
+        PL_RESULT JUCE_PUBLIC_FUNCTION GetBakedOcclusion(PLVector EmitterLocation, float* OutOcclusion);
         PL_RESULT JUCE_PUBLIC_FUNCTION GetVoxelsCount(int* OutVoxelCount);
         PL_RESULT JUCE_PUBLIC_FUNCTION GetVoxelLocation(PLVector* OutVoxelLocation, int Index);
         PL_RESULT JUCE_PUBLIC_FUNCTION GetVoxelAbsorpivity(float* OutAbsorpivity, int Index);
+        PL_RESULT JUCE_PUBLIC_FUNCTION GetDistanceToGeometry(PLVector Location, float* OutDistance);
+        PL_RESULT JUCE_PUBLIC_FUNCTION GetVoxelRegion(int* OutRegion, bool* OutActive, int Index);
         PL_RESULT JUCE_PUBLIC_FUNCTION DrawGraph(PLVector GraphPosition);
         PL_RESULT JUCE_PUBLIC_FUNCTION Encode(PLVector EncodingPosition, int* OutVoxelIndex);
         PL_RESULT JUCE_PUBLIC_FUNCTION GetOcclusion(PLVector EmitterLocation, float* OutOcclusion);
+        PL_RESULT JUCE_PUBLIC_FUNCTION TraceOcclusion(PLVector* EmitterLocations, int EmitterLocationsLength, float* OutOcclusions);
+        PL_RESULT JUCE_PUBLIC_FUNCTION GetImpulseResponse(PLVector EmitterLocation, int MaxReflectionOrder, int SampleRate, float* OutResponse, int ResponseLength);
+        PL_RESULT JUCE_PUBLIC_FUNCTION SolveFrequencyResponse(PLVector SourceLocation, float* Frequencies, int FrequenciesLength, float* OutReal, float* OutImaginary, int OutLength);
+        PL_RESULT JUCE_PUBLIC_FUNCTION UpdateGeodesicField();
+        PL_RESULT JUCE_PUBLIC_FUNCTION GetGeodesicPath(PLVector EmitterLocation, float* OutDistance, PLVector* OutDirection);
+        PL_RESULT JUCE_PUBLIC_FUNCTION GetRoomGraphSize(int* OutRoomCount, int* OutPortalCount);
+        PL_RESULT JUCE_PUBLIC_FUNCTION GetRoom(PLVector Location, int* OutRoom);
+        PL_RESULT JUCE_PUBLIC_FUNCTION GetPortal(int PortalIndex, int* OutRoomA, int* OutRoomB, PLVector* OutPosition, float* OutArea);
+        PL_RESULT JUCE_PUBLIC_FUNCTION FindRoomPath(PLVector From, PLVector To, int* OutPortals, int MaxPortals, int* OutPortalCount, float* OutDistance);
+        
+        // Command buffers
+        PL_RESULT JUCE_PUBLIC_FUNCTION ExecuteCommands(void* Commands, int CommandsLength, PL_COMMAND_RESULT* OutResults, int ResultsLength, int* OutCommandCount);
+        PL_RESULT JUCE_PUBLIC_FUNCTION ExecuteCommands(PLCommandBuffer& Commands, PL_COMMAND_RESULT* OutResults, int ResultsLength, int* OutCommandCount);
     };
 }
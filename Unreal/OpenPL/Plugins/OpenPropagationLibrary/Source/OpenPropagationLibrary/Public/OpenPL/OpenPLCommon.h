@@ -40,9 +40,117 @@ enum JUCE_API PL_RESULT
  */
 enum JUCE_API PL_DEBUG_LEVEL
 {
+    /** Chatty messages from inside queries. Only built into debug builds*/
+    PL_DEBUG_LEVEL_VERBOSE = -1,
     PL_DEBUG_LEVEL_LOG,
     PL_DEBUG_LEVEL_WARN,
-    PL_DEBUG_LEVEL_ERR
+    PL_DEBUG_LEVEL_ERR,
+    /** Pass to PL_Debug_SetLevel to turn off every message*/
+    PL_DEBUG_LEVEL_OFF
+};
+
+/**
+ * Defines how listener probes are placed when generating probes for a scene.
+ */
+enum JUCE_API PL_PROBE_PLACEMENT
+{
+    /** One probe per column of the probe spacing, on every walkable floor*/
+    PL_PROBE_PLACEMENT_UNIFORM,
+    /** Like uniform, but columns with lots of geometry get four times as many probes*/
+    PL_PROBE_PLACEMENT_ADAPTIVE,
+    /** Only in the air reachable from seed locations. Probes are spread on a lattice, with extra probes in doorways and corridors*/
+    PL_PROBE_PLACEMENT_SEEDED
+};
+
+/**
+ * Defines which part of the lattice a pressure snapshot records.
+ */
+enum JUCE_API PL_SNAPSHOT_REGION
+{
+    /** Every voxel of the lattice*/
+    PL_SNAPSHOT_REGION_VOLUME,
+    /** One plane of voxels facing the X axis*/
+    PL_SNAPSHOT_REGION_PLANE_X,
+    /** One plane of voxels facing the Y axis*/
+    PL_SNAPSHOT_REGION_PLANE_Y,
+    /** One plane of voxels facing the Z axis*/
+    PL_SNAPSHOT_REGION_PLANE_Z
+};
+
+/**
+ * Defines how pressure snapshots are stored.
+ */
+enum JUCE_API PL_SNAPSHOT_PRECISION
+{
+    PL_SNAPSHOT_PRECISION_FLOAT32,
+    /** Half the size of float32. Stored as the UInt16 bits of each half, since VTK has no half type*/
+    PL_SNAPSHOT_PRECISION_FLOAT16
+};
+
+/**
+ * Defines which numerical scheme runs the wave simulation.
+ */
+enum JUCE_API PL_SIMULATION_SCHEME
+{
+    /** Second order staggered FDTD. Needs about 3.5 voxels per wavelength*/
+    PL_SIMULATION_SCHEME_FDTD,
+    /** Fourth order staggered FDTD. Needs about 2.5 voxels per wavelength, so coarser voxels reach the same frequency*/
+    PL_SIMULATION_SCHEME_FDTD_4TH_ORDER,
+    /** Same results as PL_SIMULATION_SCHEME_FDTD, but only keeps pressure. About a third of the state and more than twice as fast*/
+    PL_SIMULATION_SCHEME_LEAPFROG,
+    /** Implicit, so stable at any time step. On voxels much finer than the resolution needs, steps several times longer than the explicit schemes*/
+    PL_SIMULATION_SCHEME_ADI
+};
+
+/**
+ * Defines how meshes are turned into voxels. See PL_Scene_SetVoxelisationMode.
+ */
+enum JUCE_API PL_VOXELISATION_MODE
+{
+    /** Exact inside tests at the centre and corners of each voxel, filled if at least 3 of the 9 are inside. Needs closed meshes*/
+    PL_VOXELISATION_MODE_EXACT,
+    /** Generalised winding number at the centre of each voxel, filled from 0.5. Copes with holes and overlaps, and is much faster*/
+    PL_VOXELISATION_MODE_WINDING_NUMBER
+};
+
+/**
+ * Defines how the simulation state is stored between time steps. Only PL_SIMULATION_SCHEME_LEAPFROG stores anything below double.
+ */
+enum JUCE_API PL_SIMULATION_PRECISION
+{
+    PL_SIMULATION_PRECISION_DOUBLE,
+    /** Stored and worked on as float*/
+    PL_SIMULATION_PRECISION_FLOAT,
+    /** Stored as IEEE half floats and worked on as float. A quarter of the memory of double, with 11 significant bits. Responses stay within a few percent of double in the simulator validation*/
+    PL_SIMULATION_PRECISION_HALF
+};
+
+/**
+ * Defines the operations a command buffer can hold. See PL_Scene_ExecuteCommands.
+ * Each command is a PL_COMMAND_HEADER followed by the arguments listed here, and gets one PL_COMMAND_RESULT.
+ */
+enum JUCE_API PL_COMMAND
+{
+    /** PL_COMMAND_ADD_MESH_ARGS, then VerticesLength PLVectors and IndicesLength ints. Result Index is the new mesh*/
+    PL_COMMAND_ADD_MESH,
+    /** int index of the mesh*/
+    PL_COMMAND_REMOVE_MESH,
+    /** PLVector location. Result Index is the new listener*/
+    PL_COMMAND_ADD_LISTENER_LOCATION,
+    /** PL_COMMAND_LOCATION_ARGS. Moves a listener without changing any indices*/
+    PL_COMMAND_SET_LISTENER_LOCATION,
+    /** int index of the listener*/
+    PL_COMMAND_REMOVE_LISTENER_LOCATION,
+    /** PLVector location. Result Index is the new emitter*/
+    PL_COMMAND_ADD_SOURCE_LOCATION,
+    /** PL_COMMAND_LOCATION_ARGS. Moves an emitter without changing any indices*/
+    PL_COMMAND_SET_SOURCE_LOCATION,
+    /** int index of the emitter*/
+    PL_COMMAND_REMOVE_SOURCE_LOCATION,
+    /** int index of the voxel. Result Vector is its location, Value its absorptivity, Index its air region and Flag 1 if it was simulated*/
+    PL_COMMAND_GET_VOXEL,
+    /** PLVector emitter location. Result Value is the occlusion from the last simulation*/
+    PL_COMMAND_GET_OCCLUSION
 };
 
 // Debugging callback
@@ -95,14 +203,8 @@ struct JUCE_API PLVector
         return X + Y + Z;
     }
     
-    PLVector& operator = (const PLVector& Other)
-    {
-        this->X = Other.X;
-        this->Y = Other.Y;
-        this->Z = Other.Z;
-        
-        return *this;
-    }
+    /** Defaulted so vectors stay trivially copyable, and can be copied in and out of the command buffer's raw bytes*/
+    PLVector& operator = (const PLVector& Other) = default;
     
     //
     
@@ -227,6 +329,51 @@ inline std::ostream& operator << (std::ostream &out, const PLVector& Vector)
     return out;
 }
 
+/**
+ * Starts every command in a command buffer.
+ */
+struct JUCE_API PL_COMMAND_HEADER
+{
+    /** The PL_COMMAND*/
+    int Type;
+    /** Bytes of arguments after the header. A multiple of 4, so the next header stays aligned*/
+    int Size;
+};
+
+/**
+ * Arguments of PL_COMMAND_ADD_MESH, the same as PL_Scene_AddMesh. The vertices and then the indices follow straight after.
+ */
+struct JUCE_API PL_COMMAND_ADD_MESH_ARGS
+{
+    PLVector WorldPosition;
+    PLQuaternion WorldRotation;
+    PLVector WorldScale;
+    int VerticesLength;
+    int IndicesLength;
+};
+
+/**
+ * Arguments of the commands that move a listener or emitter.
+ */
+struct JUCE_API PL_COMMAND_LOCATION_ARGS
+{
+    int Index;
+    PLVector Location;
+};
+
+/**
+ * What one command returned. Fields the command doesn't use are left at 0.
+ */
+struct JUCE_API PL_COMMAND_RESULT
+{
+    /** What the single call the command stands in for would have returned*/
+    PL_RESULT Result;
+    int Index;
+    int Flag;
+    float Value;
+    PLVector Vector;
+};
+
 /**
  * Defines the simulated values of an emitter in the simulation.
  */
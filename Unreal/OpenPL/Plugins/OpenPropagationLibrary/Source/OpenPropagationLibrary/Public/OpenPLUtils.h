@@ -23,6 +23,13 @@ inline PLVector4 ConvertUnrealVectorToPL4(FVector UnrealVector)
     return Result;
 }
 
+inline PLQuaternion ConvertUnrealQuatToPL(FQuat UnrealQuat)
+{
+    // Axes are swapped the same way as ConvertUnrealVectorToPL, which is a rotation, so the quaternion's axis is swapped with them
+    PLQuaternion Result { static_cast<float>(UnrealQuat.Y), static_cast<float>(UnrealQuat.Z), static_cast<float>(UnrealQuat.X), static_cast<float>(UnrealQuat.W) };
+    return Result;
+}
+
 inline FVector ConvertPLToUnreal(PLVector Vector)
 {
     FVector Result(Vector.Z * 100, Vector.X * 100, Vector.Y * 100);
@@ -28,5 +28,10 @@ public:
     
 protected:
     
+    /** Flushes the library's queued debug messages to the log. Called every frame by the core ticker*/
+    bool Tick(float DeltaTime);
+    
     OpenPL::PLSystem* SystemInstance;
+    
+    FDelegateHandle TickDelegateHandle;
 };
@@ -44,15 +44,50 @@ protected:
     UPROPERTY(EditAnywhere, BlueprintReadWrite)
     float VoxelSize;
     
+    /** Listener moves shorter than this (in cm) shift the last simulation instead of running a new one. 0 = always simulate */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float WarmStartDistance;
+    
+    /** Bake listener probes when play begins and look occlusion up from them instead of simulating every tick */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bUseBakedProbes;
+    
+    /** Distance between baked probes (in cm) */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float ProbeSpacing;
+    
+    /** Most probes to bake. The spacing grows if the scene needs more than this */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    int MaxProbes;
+    
     UPROPERTY(EditAnywhere, BlueprintReadWrite)
     TArray<class AStaticMeshActor*> StaticMeshes;
     
+    /** Add the boxes, spheres, capsules and convex hulls of a mesh's simple collision instead of its render triangles, when it has any */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bUseSimpleCollision;
+    
+    /** Absorptivity (0-1) of the voxels filled by simple collision */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float SimpleCollisionAbsorptivity;
+    
+    /** Remove detail smaller than a voxel from render meshes before voxelising them */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bSimplifyMeshes;
+    
     UPROPERTY(EditAnywhere, BlueprintReadWrite)
     AFMODAmbientSound* FMODEvent;
     
     UPROPERTY(EditAnywhere, BlueprintReadWrite)
     AAkAmbientSound* WwiseEvent;
 
+    /**
+     * Adds the simple collision of a mesh to the scene as primitives.
+     *
+     * @return False if the mesh has no simple collision OpenPL can use, so its render triangles should be added instead.
+     */
+    bool AddSimpleCollision(class AStaticMeshActor* MeshActor);
+
     TUniquePtr<OpenPL::PLScene> Scene;
     
     class APawn* Player;